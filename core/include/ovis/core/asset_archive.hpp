@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ovis/utils/memory_mapped_file.hpp"
+#include "ovis/utils/result.hpp"
+#include "ovis/core/asset_library.hpp"
+
+namespace ovis {
+
+enum class AssetArchiveCompression : std::uint32_t {
+  NONE = 0,
+  // Fast to decompress, used for assets that are loaded while playing
+  LZ4 = 1,
+  // Smaller, but slower to decompress than LZ4
+  ZSTD = 2,
+};
+
+// Packs all files of the assets in the library into a single archive. Each file is compressed with the given method,
+// unless that does not make it smaller. The files are stored in the order of their asset ids, so the archive only
+// changes if the assets change.
+Result<> WriteAssetArchive(const AssetLibrary& asset_library, const std::string& filename,
+                           AssetArchiveCompression compression);
+
+// Provides the assets of an archive written by WriteAssetArchive(). The archive is mapped into memory, so opening it
+// only reads the table of contents and files that are stored uncompressed can be accessed without copying them.
+//
+// The archive starts with a header, followed by the table of contents and the contents of the files:
+//   header: "OVISPAK1", u32 entry count, u32 bucket count, u64 offset of the entries, u64 offset of the buckets,
+//           u64 offset of the strings
+//   entries: one per file, see Entry
+//   buckets: u32 index of the first entry whose hash falls into the bucket, entries with the same bucket are chained
+//   strings: the asset ids, types and filenames the entries refer to
+//   data: the contents of the files, each aligned to ENTRY_ALIGNMENT bytes
+// All values are little endian.
+class ArchiveAssetLibrary : public AssetLibrary {
+ public:
+  static constexpr std::size_t ENTRY_ALIGNMENT = 16;
+
+  static Result<std::unique_ptr<ArchiveAssetLibrary>> Open(const std::string& filename);
+
+  bool Contains(std::string_view asset_id) const override;
+  std::vector<std::string> GetAssets() const override;
+  Result<std::string> GetAssetType(std::string_view asset_id) const override;
+  std::vector<std::string> GetAssetFileTypes(std::string_view asset_id) const override;
+  Result<std::string> LoadAssetTextFile(std::string_view asset_id, std::string_view filename) const override;
+  Result<Blob> LoadAssetBinaryFile(std::string_view asset_id, std::string_view filename) const override;
+  // Files that are stored uncompressed refer to the mapped archive, which stays mapped as long as one of them exists
+  Result<AssetView> LoadAssetFile(std::string_view asset_id, std::string_view filename) const override;
+  std::vector<std::string> GetAssetsWithType(std::string_view type) const override;
+
+ private:
+  struct Entry {
+    std::uint64_t hash;
+    std::uint64_t offset;
+    std::uint64_t stored_size;
+    std::uint64_t size;
+    // The strings are referenced by their offset into the strings section and their length
+    std::uint32_t asset_id_offset;
+    std::uint32_t asset_id_length;
+    std::uint32_t type_offset;
+    std::uint32_t type_length;
+    std::uint32_t filename_offset;
+    std::uint32_t filename_length;
+    AssetArchiveCompression compression;
+    // The next entry of the same bucket
+    std::uint32_t next_entry;
+  };
+  static_assert(sizeof(Entry) == 64);
+
+  struct AssetData {
+    std::string_view type;
+    std::vector<std::string> filenames;
+  };
+
+  std::string filename_;
+  std::shared_ptr<const MemoryMappedFile> file_;
+  std::vector<Entry> entries_;
+  std::vector<std::uint32_t> buckets_;
+  std::uint64_t strings_offset_;
+  // The strings refer to the mapped file
+  std::unordered_map<std::string_view, AssetData> assets_;
+
+  ArchiveAssetLibrary(std::string filename, std::unique_ptr<MemoryMappedFile> file);
+
+  Result<> ReadTableOfContents();
+  std::string_view GetString(std::uint32_t offset, std::uint32_t length) const;
+  Result<const Entry*> FindEntry(std::string_view asset_id, std::string_view filename) const;
+  Result<> Decompress(const Entry& entry, std::span<std::byte> destination) const;
+
+  friend Result<> WriteAssetArchive(const AssetLibrary& asset_library, const std::string& filename,
+                                    AssetArchiveCompression compression);
+};
+
+Result<> SetEngineAssetArchive(const std::string& filename);
+Result<> SetApplicationAssetArchive(const std::string& filename);
+
+}  // namespace ovis
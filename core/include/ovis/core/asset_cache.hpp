@@ -0,0 +1,268 @@
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include "ovis/utils/class.hpp"
+#include "ovis/utils/result.hpp"
+#include "ovis/core/asset_loader.hpp"
+#include "ovis/core/asset_view.hpp"
+
+namespace ovis {
+
+struct AssetMemoryUsage {
+  std::size_t cpu_bytes = 0;
+  std::size_t gpu_bytes = 0;
+};
+
+struct AssetCacheStatistics {
+  // Lookups that found the asset in the cache
+  std::uint64_t hit_count = 0;
+  // Lookups that did not find the asset, so it had to be loaded
+  std::uint64_t miss_count = 0;
+  // Requests that did not find the asset, but joined a load of it that was already in progress
+  std::uint64_t joined_load_count = 0;
+  std::uint64_t eviction_count = 0;
+};
+
+// The memory of an asset is determined by calling GetAssetMemoryUsage(asset), which is found via argument dependent
+// lookup. Types without such a function are not counted against the budget.
+inline AssetMemoryUsage GetAssetMemoryUsage(const std::string& text) {
+  return {.cpu_bytes = text.capacity()};
+}
+inline AssetMemoryUsage GetAssetMemoryUsage(const AssetView& view) {
+  return {.cpu_bytes = view.size()};
+}
+
+namespace detail {
+
+template <typename T>
+AssetMemoryUsage GetAssetMemoryUsageIfDefined(const T& asset) {
+  if constexpr (requires { { GetAssetMemoryUsage(asset) } -> std::convertible_to<AssetMemoryUsage>; }) {
+    return GetAssetMemoryUsage(asset);
+  } else {
+    return {};
+  }
+}
+
+}  // namespace detail
+
+// Shares assets that were created from the files of an asset library, so each of them is only loaded once. Assets are
+// identified by their type, the asset id and the file type they were created from, e.g., a FontAtlas from the "ttf"
+// file of a font. They are handed out as shared pointers and stay in the cache after the last user released them, so
+// they can be reused later. Once the memory of the cached assets exceeds the budget, the least recently used ones that
+// are not in use anymore are evicted. The cache is not thread safe and is meant to be used from the main thread, where
+// the completions of the AssetLoader run as well.
+class AssetCache {
+  MAKE_NON_COPY_OR_MOVABLE(AssetCache);
+
+ public:
+  static constexpr AssetMemoryUsage UNLIMITED_BUDGET = {
+      .cpu_bytes = std::numeric_limits<std::size_t>::max(),
+      .gpu_bytes = std::numeric_limits<std::size_t>::max(),
+  };
+
+  explicit AssetCache(AssetMemoryUsage budget = UNLIMITED_BUDGET);
+  // Cancels the pending requests. Assets that are still in use outlive the cache.
+  ~AssetCache();
+
+  // Returns nullptr if the asset is not in the cache
+  template <typename T>
+  std::shared_ptr<T> Find(std::string_view asset_id, std::string_view file_type);
+
+  // Returns the cached asset or creates it on the calling thread
+  template <typename T>
+  Result<std::shared_ptr<T>> Get(std::string_view asset_id, std::string_view file_type,
+                                 const std::function<Result<std::shared_ptr<T>>()>& create);
+
+  // Returns the cached asset via ready() immediately or requests it from the loader. The load function runs on a
+  // thread of the loader, create() and ready() run when the loader completes the request. While the asset is loaded,
+  // further requests for it wait for the same load instead of starting another one, so the priority of the first
+  // request is used. Cancelling the returned handle only drops the call of ready(), the asset is still loaded and
+  // cached if other requests wait for it or the load already started.
+  template <typename T, typename Data>
+  AssetLoadHandle Request(std::string_view asset_id, std::string_view file_type, AssetLoader* loader,
+                          AssetLoadPriority priority, std::function<Result<Data>()> load,
+                          std::function<Result<std::shared_ptr<T>>(Data&&)> create,
+                          std::function<void(Result<std::shared_ptr<T>>&&)> ready);
+
+  // Adds an asset that was created elsewhere, replacing the cached one with the same key
+  template <typename T>
+  void Insert(std::string_view asset_id, std::string_view file_type, std::shared_ptr<T> asset);
+
+  // Evicts the least recently used assets that are not in use until the memory usage is within the budget. This is
+  // done when an asset is inserted, but assets that are released later are only evicted by the next call.
+  void Trim();
+  // Drops all assets and cancels the pending requests
+  void Clear();
+
+  void SetBudget(AssetMemoryUsage budget);
+  AssetMemoryUsage budget() const { return budget_; }
+  AssetMemoryUsage memory_usage() const { return memory_usage_; }
+  std::size_t asset_count() const { return entries_.size(); }
+  std::size_t pending_request_count() const { return pending_loads_.size(); }
+
+  const AssetCacheStatistics& statistics() const { return statistics_; }
+  void ResetStatistics() { statistics_ = {}; }
+
+ private:
+  struct Key {
+    std::type_index type;
+    // The asset id and the file type separated by a dot
+    std::string name;
+
+    bool operator==(const Key&) const = default;
+  };
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+      std::size_t hash = key.type.hash_code();
+      hash ^= std::hash<std::string>()(key.name) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      return hash;
+    }
+  };
+
+  struct Entry {
+    std::shared_ptr<void> asset;
+    AssetMemoryUsage memory_usage;
+    // The position in the least recently used list, which refers to the key of the entry
+    std::list<const Key*>::iterator lru_position;
+  };
+
+  // Either asset is set or error
+  using ReadyFunction = std::function<void(const std::shared_ptr<void>& asset, const Error* error)>;
+  struct Waiter {
+    std::shared_ptr<detail::AssetLoadRequest> request;
+    ReadyFunction ready;
+  };
+  struct PendingLoad {
+    AssetLoadHandle load;
+    std::vector<Waiter> waiters;
+  };
+
+  AssetMemoryUsage budget_;
+  AssetMemoryUsage memory_usage_;
+  AssetCacheStatistics statistics_;
+  std::unordered_map<Key, Entry, KeyHash> entries_;
+  // The most recently used entry is at the front
+  std::list<const Key*> lru_entries_;
+  std::unordered_map<Key, PendingLoad, KeyHash> pending_loads_;
+
+  template <typename T>
+  static Key MakeKey(std::string_view asset_id, std::string_view file_type);
+
+  // Returns the asset and marks it as used or returns nullptr. Only hits are counted, as a miss is counted differently
+  // depending on whether a load is started.
+  std::shared_ptr<void> FindEntry(const Key& key);
+  void InsertEntry(const Key& key, std::shared_ptr<void> asset, AssetMemoryUsage memory_usage);
+  bool IsWithinBudget() const;
+
+  // Returns the handle of the waiter. Sets is_first_waiter if no load of the asset is in progress, the caller has to
+  // start it then.
+  AssetLoadHandle AddWaiter(const Key& key, ReadyFunction ready, bool* is_first_waiter);
+  void CompletePendingLoad(const Key& key, const std::shared_ptr<void>& asset, const Error* error);
+};
+
+template <typename T>
+AssetCache::Key AssetCache::MakeKey(std::string_view asset_id, std::string_view file_type) {
+  std::string name;
+  name.reserve(asset_id.size() + 1 + file_type.size());
+  name += asset_id;
+  name += '.';
+  name += file_type;
+  return {.type = typeid(T), .name = std::move(name)};
+}
+
+template <typename T>
+std::shared_ptr<T> AssetCache::Find(std::string_view asset_id, std::string_view file_type) {
+  std::shared_ptr<void> asset = FindEntry(MakeKey<T>(asset_id, file_type));
+  if (asset == nullptr) {
+    ++statistics_.miss_count;
+  }
+  return std::static_pointer_cast<T>(std::move(asset));
+}
+
+template <typename T>
+Result<std::shared_ptr<T>> AssetCache::Get(std::string_view asset_id, std::string_view file_type,
+                                           const std::function<Result<std::shared_ptr<T>>()>& create) {
+  Key key = MakeKey<T>(asset_id, file_type);
+  if (std::shared_ptr<void> asset = FindEntry(key); asset != nullptr) {
+    return std::static_pointer_cast<T>(std::move(asset));
+  }
+
+  ++statistics_.miss_count;
+  Result<std::shared_ptr<T>> asset = create();
+  if (!asset) {
+    return asset.error();
+  }
+  assert(*asset != nullptr);
+  InsertEntry(key, *asset, detail::GetAssetMemoryUsageIfDefined(**asset));
+  return *asset;
+}
+
+template <typename T, typename Data>
+AssetLoadHandle AssetCache::Request(std::string_view asset_id, std::string_view file_type, AssetLoader* loader,
+                                    AssetLoadPriority priority, std::function<Result<Data>()> load,
+                                    std::function<Result<std::shared_ptr<T>>(Data&&)> create,
+                                    std::function<void(Result<std::shared_ptr<T>>&&)> ready) {
+  assert(loader != nullptr);
+  Key key = MakeKey<T>(asset_id, file_type);
+  if (std::shared_ptr<void> asset = FindEntry(key); asset != nullptr) {
+    ready(std::static_pointer_cast<T>(std::move(asset)));
+    return AssetLoadHandle();
+  }
+
+  bool is_first_waiter;
+  AssetLoadHandle handle = AddWaiter(
+      key,
+      [ready = std::move(ready)](const std::shared_ptr<void>& asset, const Error* error) {
+        if (error != nullptr) {
+          ready(Result<std::shared_ptr<T>>(*error));
+        } else {
+          ready(std::static_pointer_cast<T>(asset));
+        }
+      },
+      &is_first_waiter);
+
+  if (is_first_waiter) {
+    pending_loads_.at(key).load = loader->Load<Data>(
+        priority, std::move(load), [this, key, create = std::move(create)](Result<Data>&& data) {
+          if (!data) {
+            CompletePendingLoad(key, nullptr, &data.error());
+            return;
+          }
+          Result<std::shared_ptr<T>> asset = create(std::move(*data));
+          if (!asset) {
+            CompletePendingLoad(key, nullptr, &asset.error());
+            return;
+          }
+          assert(*asset != nullptr);
+          InsertEntry(key, *asset, detail::GetAssetMemoryUsageIfDefined(**asset));
+          CompletePendingLoad(key, *asset, nullptr);
+        });
+  }
+
+  return handle;
+}
+
+template <typename T>
+void AssetCache::Insert(std::string_view asset_id, std::string_view file_type, std::shared_ptr<T> asset) {
+  assert(asset != nullptr);
+  const AssetMemoryUsage memory_usage = detail::GetAssetMemoryUsageIfDefined(*asset);
+  InsertEntry(MakeKey<T>(asset_id, file_type), std::move(asset), memory_usage);
+}
+
+// The cache for assets that only live in main memory, e.g., parsed JSON files. Assets that are backed by resources of
+// a graphics context are cached by the context instead, see GraphicsContext::asset_cache().
+AssetCache* GetDefaultAssetCache();
+
+}  // namespace ovis
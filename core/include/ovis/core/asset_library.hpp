@@ -8,9 +8,12 @@
 #include "ovis/utils/file.hpp"
 #include "ovis/utils/json.hpp"
 #include "ovis/utils/result.hpp"
+#include "ovis/core/asset_view.hpp"
 
 namespace ovis {
 
+// The files of an asset may be loaded from multiple threads at once, e.g., by the AssetLoader. So the Load*File()
+// methods must be safe to call concurrently as long as the library is not modified at the same time.
 class AssetLibrary {
  public:
   virtual ~AssetLibrary() = default;
@@ -22,6 +25,9 @@ class AssetLibrary {
   virtual Result<std::string> LoadAssetTextFile(std::string_view asset_id, std::string_view filename) const = 0;
   virtual Result<json> LoadAssetJsonFile(std::string_view asset_id, std::string_view filename) const;
   virtual Result<Blob> LoadAssetBinaryFile(std::string_view asset_id, std::string_view filename) const = 0;
+  // Loads the file without copying its contents if the library supports it. The default implementation wraps
+  // LoadAssetBinaryFile().
+  virtual Result<AssetView> LoadAssetFile(std::string_view asset_id, std::string_view filename) const;
   virtual std::vector<std::string> GetAssetsWithType(std::string_view type) const = 0;
 
   virtual Result<> CreateAsset(std::string_view asset_id, std::string_view type,
@@ -39,6 +45,8 @@ class AssetLibrary {
 
 class DirectoryAssetLibrary : public AssetLibrary {
  public:
+  static constexpr std::size_t MIN_MAPPED_FILE_SIZE = 64 * 1024;
+
   DirectoryAssetLibrary(std::string_view directory);
 
   bool Contains(std::string_view asset_id) const override;
@@ -47,6 +55,8 @@ class DirectoryAssetLibrary : public AssetLibrary {
   std::vector<std::string> GetAssetFileTypes(std::string_view asset_id) const override;
   Result<std::string> LoadAssetTextFile(std::string_view asset_id, std::string_view filename) const override;
   Result<Blob> LoadAssetBinaryFile(std::string_view asset_id, std::string_view filename) const override;
+  // Files of at least MIN_MAPPED_FILE_SIZE bytes are memory mapped, smaller ones are read as mapping them costs more
+  Result<AssetView> LoadAssetFile(std::string_view asset_id, std::string_view filename) const override;
   std::vector<std::string> GetAssetsWithType(std::string_view type) const override;
 
   Result<> CreateAsset(std::string_view asset_id, std::string_view type,
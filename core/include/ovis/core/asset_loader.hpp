@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "ovis/utils/class.hpp"
+#include "ovis/utils/file.hpp"
+#include "ovis/utils/result.hpp"
+#include "ovis/utils/thread_pool.hpp"
+#include "ovis/core/asset_library.hpp"
+
+namespace ovis {
+
+enum class AssetLoadPriority : std::uint8_t {
+  // Assets that are not needed yet, e.g., the ones of the next level while the current one is played
+  LOW,
+  NORMAL,
+  // Assets that are needed for the current frame, e.g., the textures of visible sprites
+  HIGH,
+};
+
+namespace detail {
+
+struct AssetLoadRequest {
+  AssetLoadPriority priority;
+  // Requests with the same priority are loaded in the order they were made
+  std::uint64_t sequence_number;
+  std::atomic<bool> cancelled = false;
+  bool completed = false;
+  // Called on a loader thread, returns the function that completes the request on the main thread
+  std::function<std::function<void()>()> load;
+};
+
+}  // namespace detail
+
+// Refers to a request made to the AssetLoader. A default constructed handle does not refer to any request.
+class AssetLoadHandle {
+ public:
+  AssetLoadHandle() = default;
+
+  // True until the request was completed or cancelled
+  bool is_pending() const;
+
+  // The completion function of the request will not be called after this. If the request is still queued, the asset is
+  // not loaded at all. Cancelling a completed request has no effect.
+  void Cancel();
+
+ private:
+  friend class AssetCache;
+  friend class AssetLoader;
+
+  explicit AssetLoadHandle(std::shared_ptr<detail::AssetLoadRequest> request) : request_(std::move(request)) {}
+
+  std::shared_ptr<detail::AssetLoadRequest> request_;
+};
+
+// Loads assets on the threads of a pool, so the calling thread does not wait for the disk. A request consists of two
+// steps: the load function reads and decodes the asset on one of the threads of the pool and must not touch any state
+// of the requester. The completion function receives the result on the thread that calls ProcessCompletions(), which
+// is the main thread for the default loader. Thus, the completion may use the graphics context, e.g., to upload a
+// texture. Requests with a higher priority are loaded first.
+class AssetLoader {
+  MAKE_NON_COPY_OR_MOVABLE(AssetLoader);
+
+ public:
+  // The threads of the pool spend most of their time waiting for the disk, so it should not be the pool that is used for
+  // the work of the engine systems
+  explicit AssetLoader(ThreadPool* thread_pool);
+  // Drops all queued requests and waits for the ones that are currently loaded
+  ~AssetLoader();
+
+  template <typename T>
+  AssetLoadHandle Load(AssetLoadPriority priority, std::function<Result<T>()> load,
+                       std::function<void(Result<T>&&)> complete);
+
+  // Loads a file of the asset. The asset library must not be modified until the request is completed.
+  AssetLoadHandle LoadTextFile(const AssetLibrary* asset_library, std::string asset_id, std::string filename,
+                               AssetLoadPriority priority, std::function<void(Result<std::string>&&)> complete);
+  AssetLoadHandle LoadBinaryFile(const AssetLibrary* asset_library, std::string asset_id, std::string filename,
+                                 AssetLoadPriority priority, std::function<void(Result<Blob>&&)> complete);
+  // Prefer this over the other two, as the asset library may provide the file without copying it
+  AssetLoadHandle LoadFile(const AssetLibrary* asset_library, std::string asset_id, std::string filename,
+                           AssetLoadPriority priority, std::function<void(Result<AssetView>&&)> complete);
+
+  // Calls the completion functions of the requests that were loaded since the last call. Once the time budget is
+  // exceeded, the remaining completions are left for the next call. Returns the number of completed requests.
+  std::size_t ProcessCompletions(std::chrono::microseconds time_budget = std::chrono::microseconds::max());
+
+  // Waits until all requests are loaded and completes them. Used when the assets are needed before the application can
+  // continue, e.g., in tests.
+  void CompleteAll();
+
+  // The number of requests that are either queued, being loaded or waiting for their completion
+  std::size_t pending_request_count() const;
+
+ private:
+  struct CompareRequests {
+    bool operator()(const std::shared_ptr<detail::AssetLoadRequest>& lhs,
+                    const std::shared_ptr<detail::AssetLoadRequest>& rhs) const {
+      if (lhs->priority != rhs->priority) {
+        return lhs->priority < rhs->priority;
+      }
+      return lhs->sequence_number > rhs->sequence_number;
+    }
+  };
+  struct Completion {
+    std::shared_ptr<detail::AssetLoadRequest> request;
+    std::function<void()> complete;
+  };
+
+  ThreadPool* thread_pool_;
+  mutable std::mutex mutex_;
+  std::condition_variable all_loaded_;
+  std::priority_queue<std::shared_ptr<detail::AssetLoadRequest>, std::vector<std::shared_ptr<detail::AssetLoadRequest>>,
+                      CompareRequests>
+      queued_requests_;
+  std::uint64_t next_sequence_number_ = 0;
+  // Requests that are queued or being loaded
+  std::size_t loading_request_count_ = 0;
+  std::vector<Completion> completions_;
+  bool stopping_ = false;
+
+  AssetLoadHandle Enqueue(AssetLoadPriority priority, std::function<std::function<void()>()> load);
+  void LoadNextRequest();
+};
+
+template <typename T>
+AssetLoadHandle AssetLoader::Load(AssetLoadPriority priority, std::function<Result<T>()> load,
+                                  std::function<void(Result<T>&&)> complete) {
+  // Results can neither be copied nor moved, so the value or the error is handed over to the main thread separately
+  return Enqueue(priority, [load = std::move(load), complete = std::move(complete)]() -> std::function<void()> {
+    Result<T> result = load();
+    auto value = result.has_value() ? std::make_shared<std::variant<T, Error>>(std::in_place_index<0>, std::move(*result))
+                                    : std::make_shared<std::variant<T, Error>>(std::in_place_index<1>, result.error());
+    return [complete, value]() {
+      if (value->index() == 0) {
+        complete(Result<T>(std::move(std::get<0>(*value))));
+      } else {
+        complete(Result<T>(std::move(std::get<1>(*value))));
+      }
+    };
+  });
+}
+
+// The loader whose completions are processed by the application loop at the beginning of every frame
+AssetLoader* GetDefaultAssetLoader();
+
+}  // namespace ovis
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "ovis/utils/file.hpp"
+
+namespace ovis {
+
+// A read-only view of the contents of an asset file. All copies of a view share the contents, which stay alive as long
+// as one of them exists. Depending on the asset library, the contents are owned by the view or they are part of a
+// memory mapped file, so loading them does not require a copy.
+class AssetView {
+ public:
+  AssetView() = default;
+  // Takes ownership of the data
+  explicit AssetView(Blob data) {
+    auto owned_data = std::make_shared<const Blob>(std::move(data));
+    data_ = *owned_data;
+    owner_ = std::move(owned_data);
+  }
+  // Refers to data that stays valid as long as the owner exists
+  AssetView(std::span<const std::byte> data, std::shared_ptr<const void> owner)
+      : data_(data), owner_(std::move(owner)) {}
+
+  std::span<const std::byte> data() const { return data_; }
+  std::size_t size() const { return data_.size(); }
+  bool empty() const { return data_.empty(); }
+
+  // The contents interpreted as text. They are not null terminated.
+  std::string_view text() const { return {reinterpret_cast<const char*>(data_.data()), data_.size()}; }
+
+ private:
+  std::span<const std::byte> data_;
+  std::shared_ptr<const void> owner_;
+};
+
+}  // namespace ovis
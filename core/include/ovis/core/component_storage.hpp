@@ -3,6 +3,7 @@
 #include <type_traits>
 #include "ovis/core/main_vm.hpp"
 #include "ovis/core/entity.hpp"
+#include "ovis/core/scene_serialization.hpp"
 #include "ovis/utils/not_null.hpp"
 #include "ovis/utils/result.hpp"
 #include "ovis/vm/contiguous_storage.hpp"
@@ -24,6 +25,19 @@ public:
   NotNull<Type*> component_type() const { return main_vm->GetType(component_type_id_); }
 
   Result<> Resize(ContiguousStorage::SizeType size);
+  // Removes all components and changes the capacity of the storage
+  void Reset(ContiguousStorage::SizeType capacity);
+
+  // Appends the components as a column of the binary scene format, see scene_serialization.hpp
+  Result<> SerializeColumn(SceneBinaryWriter* writer) const;
+  // Checks the header, the entity ranges and the size of a column for a scene with the given capacity and skips the
+  // column. The column header and the type name must already have been read from the reader. The encoded properties of
+  // components are only checked when they are deserialized.
+  Result<> ValidateColumn(const SceneBinaryColumnHeader& header, ContiguousStorage::SizeType capacity,
+                          SceneBinaryReader* reader) const;
+  // Adds the components of a column. The column header and the type name must already have been read from the reader.
+  // Raw columns are copied into the storage in bulk. The storage must not contain any components of the column.
+  Result<> DeserializeColumn(const SceneBinaryColumnHeader& header, SceneBinaryReader* reader);
 
   Result<> AddComponent(EntityId entity_id);
   Result<> RemoveComponent(EntityId entity_id);
@@ -44,10 +58,18 @@ public:
   }
 
 private:
+  struct Column {
+    std::vector<SceneBinaryRange> ranges;
+    std::span<const std::byte> data;
+  };
+
   Scene* scene_;
   TypeId component_type_id_;
   ContiguousStorage storage_;
   std::vector<bool> flags_;
+
+  Result<Column> ReadColumn(const SceneBinaryColumnHeader& header, ContiguousStorage::SizeType capacity,
+                            SceneBinaryReader* reader) const;
 };
 
 template <typename T>
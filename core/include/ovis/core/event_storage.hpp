@@ -1,5 +1,11 @@
 #pragma once
 
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ovis/utils/class.hpp"
 #include "ovis/utils/range.hpp"
 #include "ovis/vm/list.hpp"
 #include "ovis/vm/type_id.hpp"
@@ -7,99 +13,229 @@
 
 namespace ovis {
 
-class EventStorage {
+// Stores the events of a single type together with their propagation state.
+class EventBuffer {
  public:
-  EventStorage(TypeId event_type_id);
+  using SizeType = ContiguousStorage::SizeType;
+
+  EventBuffer(TypeId event_type_id, SizeType initial_capacity);
 
   TypeId event_type_id() const { return events_.element_type(); }
 
+  Result<> Reserve(SizeType capacity);
+
   Result<> Emit(const Value& event) {
     OVIS_CHECK_RESULT(events_.Add(event));
-    propagating_state_.push_back(true);
+    PushPropagationFlag();
     return Success;
   }
 
+  template <typename T>
+  Result<> Emit(const T& event) {
+    assert(main_vm->GetTypeId<T>() == event_type_id());
+    OVIS_CHECK_RESULT(events_.Emplace<T>(event));
+    PushPropagationFlag();
+    return Success;
+  }
+
+  // Appends all events of other, including their propagation state.
+  Result<> Append(const EventBuffer& other);
+
   void Clear() {
     events_.Resize(0);
-    propagating_state_.clear();
+    propagation_mask_.clear();
   }
 
   auto size() const { return events_.size(); }
+  auto capacity() const { return events_.capacity(); }
 
   template <typename T>
-  const T& Get(ContiguousStorage::SizeType index) const {
+  const T& Get(SizeType index) const {
     return events_.Get<T>(index);
   }
 
-  bool IsEventPropagating(ContiguousStorage::SizeType index) const{
-    return propagating_state_[index];
+  bool IsEventPropagating(SizeType index) const {
+    assert(index < size());
+    return (propagation_mask_[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1;
+  }
+
+  void StopPropagating(SizeType index) {
+    assert(index < size());
+    propagation_mask_[index / BITS_PER_WORD] &= ~(std::uint64_t(1) << (index % BITS_PER_WORD));
   }
 
-  void StopPropagating(ContiguousStorage::SizeType index) {
-    propagating_state_[index] = false;
+  // Returns the index of the first event that is still propagating, starting at index. If there is no such event
+  // size() is returned.
+  SizeType FindPropagatingEvent(SizeType index) const {
+    std::size_t word_index = index / BITS_PER_WORD;
+    if (word_index >= propagation_mask_.size()) {
+      return size();
+    }
+    // Mask out the events before index in the first word and then skip whole words of stopped events.
+    std::uint64_t word = propagation_mask_[word_index] & (~std::uint64_t(0) << (index % BITS_PER_WORD));
+    while (word == 0) {
+      ++word_index;
+      if (word_index == propagation_mask_.size()) {
+        return size();
+      }
+      word = propagation_mask_[word_index];
+    }
+    return word_index * BITS_PER_WORD + std::countr_zero(word);
   }
 
  private:
+  static constexpr SizeType BITS_PER_WORD = 64;
+
   List events_;
-  std::vector<bool> propagating_state_;
+  // One bit per event that is set as long as the event is propagating. Bits of events that have not been emitted are
+  // always zero.
+  std::vector<std::uint64_t> propagation_mask_;
+
+  void PushPropagationFlag() {
+    const SizeType index = size() - 1;
+    if (index % BITS_PER_WORD == 0) {
+      propagation_mask_.push_back(0);
+    }
+    propagation_mask_.back() |= std::uint64_t(1) << (index % BITS_PER_WORD);
+  }
+};
+
+// The event storage is double buffered: the events of the current frame are emitted into one buffer while the events
+// of the previous frame stay accessible in the other one. SwapBuffers() exchanges the buffers at the start of a frame
+// without copying any events. Swapping does not change the addresses of the buffers, so emitters and views can keep
+// pointers to them across frames. The scene creates its event storages in Scene::Prepare(), so the pointers are only
+// valid until the scene is prepared again.
+//
+// Jobs that run concurrently must not emit into the same buffer. Instead, each of them emits into its own producer
+// buffer, which only has a single writer and therefore does not need any synchronization. Events in a producer buffer
+// are not part of the current frame: they only become visible to views once MergeProducerBuffers() (or
+// Scene::MergeEventProducerBuffers()) appended the producer buffers in the order of their indices to the current frame,
+// so the result is deterministic regardless of how the jobs were scheduled.
+class EventStorage {
+  MAKE_NON_COPYABLE(EventStorage);
+
+ public:
+  using SizeType = EventBuffer::SizeType;
+
+  // The buffers never release their memory when they are cleared, so their capacity will grow to the peak number of
+  // events per frame during the first few frames. Emitting events afterwards will not allocate anymore.
+  static constexpr SizeType DEFAULT_CAPACITY = 64;
+
+  EventStorage(TypeId event_type_id, SizeType initial_capacity = DEFAULT_CAPACITY);
+  EventStorage(EventStorage&&) = default;
+  EventStorage& operator=(EventStorage&&) = default;
+
+  TypeId event_type_id() const { return current_frame_events_.event_type_id(); }
+
+  EventBuffer* current_frame_events() { return &current_frame_events_; }
+  const EventBuffer* current_frame_events() const { return &current_frame_events_; }
+  EventBuffer* previous_frame_events() { return &previous_frame_events_; }
+  const EventBuffer* previous_frame_events() const { return &previous_frame_events_; }
+
+  Result<> Reserve(SizeType capacity);
+
+  Result<> Emit(const Value& event) { return current_frame_events_.Emit(event); }
+  template <typename T>
+  Result<> Emit(const T& event) {
+    return current_frame_events_.Emit(event);
+  }
+
+  auto size() const { return current_frame_events_.size(); }
+  auto capacity() const { return current_frame_events_.capacity(); }
+
+  // Clears the events of the current frame
+  void Clear() { current_frame_events_.Clear(); }
+
+  // Makes the events of the current frame the events of the previous frame and starts a new, empty frame.
+  void SwapBuffers();
+
+  // Sets the number of producer buffers. This must not be called while events are emitted into them. The addresses of
+  // the remaining buffers do not change.
+  void SetProducerCount(std::size_t producer_count);
+  std::size_t producer_count() const { return producer_buffers_.size(); }
+  EventBuffer* producer_buffer(std::size_t producer_index) {
+    assert(producer_index < producer_buffers_.size());
+    return producer_buffers_[producer_index].get();
+  }
+
+  // Appends the events of all producer buffers to the current frame and clears them.
+  Result<> MergeProducerBuffers();
+
+ private:
+  EventBuffer current_frame_events_;
+  EventBuffer previous_frame_events_;
+  // Heap allocated, so emitters can keep pointers to them when buffers are added
+  std::vector<std::unique_ptr<EventBuffer>> producer_buffers_;
 };
 
 template <typename T>
 class EventEmitter {
  public:
-  EventEmitter(EventStorage* event_storage = nullptr) : event_storage_(event_storage) {
-    assert(!event_storage_ || event_storage_->event_type_id() == main_vm->GetTypeId<T>());
+  EventEmitter(EventStorage* event_storage = nullptr)
+      : EventEmitter(event_storage ? event_storage->current_frame_events() : nullptr) {}
+  EventEmitter(EventBuffer* event_buffer) : event_buffer_(event_buffer) {
+    assert(!event_buffer_ || event_buffer_->event_type_id() == main_vm->GetTypeId<T>());
   }
 
-  Result<> Emit(const T& event) { return event_storage_->Emit(main_vm->CreateValue(event)); }
+  Result<> Emit(const T& event) { return event_buffer_->Emit(event); }
 
  private:
-  EventStorage* event_storage_;
+  EventBuffer* event_buffer_;
 };
 
 template <typename T>
 class Event {
   public:
-   Event(EventStorage* event_storage, ContiguousStorage::SizeType index)
-       : event_storage_(event_storage), index_(index) {}
+   Event(EventBuffer* event_buffer, ContiguousStorage::SizeType index)
+       : event_buffer_(event_buffer), index_(index) {}
 
-  const T& operator*() const { return event_storage_->Get<T>(index_); }
-  const T* operator->() { return &event_storage_->Get<T>(index_); }
+  const T& operator*() const { return event_buffer_->Get<T>(index_); }
+  const T* operator->() { return &event_buffer_->Get<T>(index_); }
 
-  bool is_propagating() const { return event_storage_->IsEventPropagating(index_); }
+  bool is_propagating() const { return event_buffer_->IsEventPropagating(index_); }
 
-  void StopPropagating() { event_storage_->StopPropagating(index_); }
+  void StopPropagating() { event_buffer_->StopPropagating(index_); }
 
   auto index() const { return index_; }
-  auto event_storage() const { return event_storage_; }
+  auto event_buffer() const { return event_buffer_; }
 
  private:
-  EventStorage* event_storage_;
+  EventBuffer* event_buffer_;
   ContiguousStorage::SizeType index_;
 };
 
 template <typename T>
 class EventStorageView {
  public:
-  EventStorageView(EventStorage* event_storage = nullptr) : event_storage_(event_storage) {
-    assert(!event_storage_ || event_storage_->event_type_id() == main_vm->GetTypeId<T>());
+  EventStorageView(EventStorage* event_storage = nullptr)
+      : EventStorageView(event_storage ? event_storage->current_frame_events() : nullptr,
+                         event_storage ? event_storage->previous_frame_events() : nullptr) {}
+  EventStorageView(EventBuffer* event_buffer, EventBuffer* previous_frame_event_buffer = nullptr)
+      : event_buffer_(event_buffer), previous_frame_event_buffer_(previous_frame_event_buffer) {
+    assert(!event_buffer_ || event_buffer_->event_type_id() == main_vm->GetTypeId<T>());
   }
 
-  TypeId event_type_id() const { event_storage_->event_type_id(); }
-  auto size() const { return event_storage_->size(); }
+  TypeId event_type_id() const { return event_buffer_->event_type_id(); }
+  auto size() const { return event_buffer_->size(); }
 
-  Result<> Emit(const T& event) { return event_storage_->Emit(main_vm->CreateValue(event)); }
-  void Clear() { event_storage_->Clear(); }
+  Result<> Emit(const T& event) { return event_buffer_->Emit(event); }
+  void Clear() { event_buffer_->Clear(); }
 
-  Event<T> operator[](ContiguousStorage::SizeType index) { return {event_storage_, index}; }
-  Event<T> At(ContiguousStorage::SizeType index) const { return {event_storage_, index}; }
+  // Returns a view of the events that were emitted during the previous frame.
+  EventStorageView previous_frame() const {
+    assert(previous_frame_event_buffer_);
+    return EventStorageView(previous_frame_event_buffer_);
+  }
+
+  Event<T> operator[](ContiguousStorage::SizeType index) { return {event_buffer_, index}; }
+  Event<T> At(ContiguousStorage::SizeType index) const { return {event_buffer_, index}; }
 
   class Iterator {
     friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
-      return lhs.event_.event_storage() == rhs.event_.event_storage() && lhs.event_.index() == rhs.event_.index();
+      return lhs.event_.event_buffer() == rhs.event_.event_buffer() && lhs.event_.index() == rhs.event_.index();
     }
     friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
-      return lhs.event_.event_storage() != rhs.event_.event_storage() || lhs.event_.index() != rhs.event_.index();
+      return lhs.event_.event_buffer() != rhs.event_.event_buffer() || lhs.event_.index() != rhs.event_.index();
     }
 
    public:
@@ -110,7 +246,7 @@ class EventStorageView {
     using reference = Event<T>&;
 
     Iterator() : event_(nullptr, 0) {}
-    Iterator(EventStorage* event_storage, ContiguousStorage::SizeType index) : event_(event_storage, index) {}
+    Iterator(EventBuffer* event_buffer, ContiguousStorage::SizeType index) : event_(event_buffer, index) {}
 
     Event<T> operator*() const { return event_; }
     pointer operator->() { return &event_; }
@@ -126,29 +262,19 @@ class EventStorageView {
 
    private:
     void Increment() {
-      auto storage = event_.event_storage();
-      const ContiguousStorage::SizeType storage_size = storage->size();
-      ContiguousStorage::SizeType new_index = event_.index();
-      do {
-        ++new_index;
-      } while (new_index < storage_size && !storage->IsEventPropagating(new_index));
-      event_ = Event<T>(storage, new_index);
+      auto buffer = event_.event_buffer();
+      event_ = Event<T>(buffer, buffer->FindPropagatingEvent(event_.index() + 1));
     }
     Event<T> event_;
   };
   static_assert(std::forward_iterator<Iterator>);
-  
-  Iterator begin() {
-    ContiguousStorage::SizeType index = 0;
-    while (index < event_storage_->size() && !event_storage_->IsEventPropagating(index)) {
-      ++index;
-    }
-    return Iterator(event_storage_, index);
-  }
-  Iterator end() { return Iterator(event_storage_, event_storage_->size()); }
+
+  Iterator begin() { return Iterator(event_buffer_, event_buffer_->FindPropagatingEvent(0)); }
+  Iterator end() { return Iterator(event_buffer_, event_buffer_->size()); }
 
  private:
-  EventStorage* event_storage_;
+  EventBuffer* event_buffer_;
+  EventBuffer* previous_frame_event_buffer_;
 };
 
-}  // namespace ovis  
+}  // namespace ovis
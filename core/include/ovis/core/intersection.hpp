@@ -145,6 +145,11 @@ inline constexpr std::optional<RayAABBIntersection> ComputeRayAABBIntersection(R
                         : std::optional<RayAABBIntersection>{};
 }
 
+template <typename VectorType>
+inline constexpr bool DoAABBsOverlap(AxisAlignedBoundingBox<VectorType> lhs, AxisAlignedBoundingBox<VectorType> rhs) {
+  return MinComponent(rhs.max() - lhs.min()) >= 0.0f && MinComponent(lhs.max() - rhs.min()) >= 0.0f;
+}
+
 std::optional<LineSegment2D> ClipLineSegment(const AxisAlignedBoundingBox2D& aabb, const LineSegment2D& line_segment);
 
 template <typename VectorType>
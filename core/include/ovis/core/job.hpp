@@ -1,22 +1,38 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <unordered_set>
 
 #include "ovis/core/main_vm.hpp"
 #include "ovis/utils/result.hpp"
+#include "ovis/utils/trace.hpp"
 #include "ovis/vm/type_id.hpp"
 #include "ovis/vm/virtual_machine.hpp"
 
 namespace ovis {
 
+// Specifies when the scheduler executes a job
+enum class JobTriggerPolicy {
+  // The job is skipped if all resources it reads are events and none of them has been emitted during the current or
+  // the previous frame. Jobs that read anything else are always executed.
+  AUTOMATIC,
+  // The job is executed every frame
+  ALWAYS,
+  // The job is skipped if none of the events it reads has been emitted during the current or the previous frame,
+  // even if it reads other resources.
+  ON_EVENTS,
+};
+
 template <typename PrepareParameters, typename ExecuteParameters>
 class Job {
  public:
-  Job(std::string_view id) : id_(id) {}
+  Job(std::string_view id) : id_(id), trace_name_(RegisterTraceName(id)) {}
   virtual ~Job() = default;
 
   std::string_view id() const { return id_; }
+  // The name of the trace zone the scheduler executes the job in
+  TraceNameId trace_name() const { return trace_name_; }
 
   const std::unordered_set<TypeId>& read_access() const {
     return read_access_;
@@ -33,6 +49,12 @@ class Job {
     return execute_before_;
   }
 
+  JobTriggerPolicy trigger_policy() const { return trigger_policy_; }
+
+  // The number of entities the job processed since it was created. Jobs that iterate over entities report them via
+  // CountProcessedEntities(), so they show up in the statistics of the scheduler.
+  std::uint64_t processed_entity_count() const { return processed_entity_count_; }
+
   virtual Result<> Prepare(const PrepareParameters& parameters) = 0;
   virtual Result<> Execute(const ExecuteParameters& parameters) = 0;
 
@@ -43,15 +65,23 @@ class Job {
   void RequireWriteAccess(TypeId resource_type) { write_access_.insert(resource_type); }
 
   void ExecuteAfter(std::string_view job_id) { execute_after_.emplace(job_id); }
-  void ExecuteBefore(std::string_view job_id) { execute_after_.emplace(job_id); }
+  void ExecuteBefore(std::string_view job_id) { execute_before_.emplace(job_id); }
+
+  void SetTriggerPolicy(JobTriggerPolicy trigger_policy) { trigger_policy_ = trigger_policy; }
+
+  void CountProcessedEntities(std::uint64_t count) { processed_entity_count_ += count; }
 
  private:
   std::string id_;
+  TraceNameId trace_name_;
   std::unordered_set<std::string> execute_after_;
   std::unordered_set<std::string> execute_before_;
 
   std::unordered_set<TypeId> read_access_;
   std::unordered_set<TypeId> write_access_;
+
+  JobTriggerPolicy trigger_policy_ = JobTriggerPolicy::AUTOMATIC;
+  std::uint64_t processed_entity_count_ = 0;
 };
 
 }  // namespace ovis
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ovis {
+
+class ProfilingLog;
+
+// What a job did during a single execution
+struct JobFrameStatistics {
+  double wall_time;  // in milliseconds
+  std::uint64_t processed_entity_count;
+  // The events that were available to the job, i.e., the events of the current and the previous frame of all event
+  // types the job reads
+  std::uint64_t read_event_count;
+  std::uint64_t emitted_event_count;
+  // Only counted if the OVIS_ENABLE_BUILT_IN_PROFILING CMake option is on, see GetThreadAllocationCount()
+  std::uint64_t allocation_count;
+};
+
+struct StatisticSummary {
+  double p50;
+  double p99;
+  double max;
+};
+
+// The statistics of the last executions of a job. Frames the job was skipped in are not recorded.
+class JobStatistics {
+ public:
+  static constexpr std::size_t DEFAULT_WINDOW_SIZE = 300;
+
+  JobStatistics(std::string_view job_id, std::size_t window_size = DEFAULT_WINDOW_SIZE);
+
+  std::string_view job_id() const { return job_id_; }
+  std::size_t window_size() const { return window_size_; }
+  // The number of executions the statistics are computed from, at most the window size
+  std::size_t frame_count() const { return frames_.size(); }
+  // The total number of recorded executions
+  std::uint64_t execution_count() const { return execution_count_; }
+
+  void AddFrame(const JobFrameStatistics& frame);
+  // Returns the most recent execution. Must not be called if no frame was recorded.
+  const JobFrameStatistics& last_frame() const;
+
+  StatisticSummary wall_time() const { return Summarize(&JobFrameStatistics::wall_time); }
+  StatisticSummary processed_entity_count() const { return Summarize(&JobFrameStatistics::processed_entity_count); }
+  StatisticSummary read_event_count() const { return Summarize(&JobFrameStatistics::read_event_count); }
+  StatisticSummary emitted_event_count() const { return Summarize(&JobFrameStatistics::emitted_event_count); }
+  StatisticSummary allocation_count() const { return Summarize(&JobFrameStatistics::allocation_count); }
+
+  // Writes the summaries as Job::<id>::<statistic>::<P50|P99|Max>
+  void Write(ProfilingLog* log) const;
+
+ private:
+  std::string job_id_;
+  std::size_t window_size_;
+  std::vector<JobFrameStatistics> frames_;
+  std::size_t next_frame_index_ = 0;
+  std::uint64_t execution_count_ = 0;
+
+  template <typename T>
+  StatisticSummary Summarize(T JobFrameStatistics::*statistic) const;
+};
+
+}  // namespace ovis
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -8,6 +9,7 @@
 
 #include "ovis/utils/all.hpp"
 #include "ovis/utils/down_cast.hpp"
+#include "ovis/utils/file.hpp"
 #include "ovis/utils/json.hpp"
 #include "ovis/utils/range.hpp"
 #include "ovis/utils/result.hpp"
@@ -17,6 +19,8 @@
 #include "ovis/core/entity.hpp"
 #include "ovis/core/event_storage.hpp"
 #include "ovis/core/job.hpp"
+#include "ovis/core/scene_component_storage.hpp"
+#include "ovis/core/scene_serialization.hpp"
 #include "ovis/core/scheduler.hpp"
 #include "ovis/core/vector.hpp"
 
@@ -80,17 +84,56 @@ class Scene : public Serializable {
   ComponentStorageView<ComponentType> GetComponentStorage() {
     return GetComponentStorage(main_vm->GetTypeId<ComponentType>());
   }
-  ComponentStorage* GetComponentStorage(TypeId component_type);
+  ComponentStorage* GetComponentStorage(TypeId component_type) {
+    if (component_type.index < component_storage_lookup_.size()) {
+      ComponentStorage* storage = component_storage_lookup_[component_type.index];
+      if (storage && storage->component_type_id() == component_type) {
+        return storage;
+      }
+    }
+    return nullptr;
+  }
+
+  template <typename ComponentType>
+  ComponentType* GetSceneComponent() {
+    return scene_components_.GetComponent<ComponentType>();
+  }
+  void* GetSceneComponent(TypeId component_type) { return scene_components_.GetComponent(component_type); }
 
   template <typename EventType>
   EventEmitter<EventType> GetEventEmitter() {
     return GetEventStorage(main_vm->GetTypeId<EventType>());
   }
+  // Returns an emitter that writes into the producer buffer with the given index. Use this for jobs that emit events
+  // concurrently, see EventStorage. The index must be less than event_producer_count(). The emitted events only become
+  // visible after MergeEventProducerBuffers() and the emitter is only valid until the next call to Prepare().
+  template <typename EventType>
+  EventEmitter<EventType> GetEventEmitter(std::size_t producer_index) {
+    assert(producer_index < event_producer_count_);
+    return GetEventStorage(main_vm->GetTypeId<EventType>())->producer_buffer(producer_index);
+  }
   template <typename EventType>
   EventStorageView<EventType> GetEventStorage() {
     return GetEventStorage(main_vm->GetTypeId<EventType>());
   }
-  EventStorage* GetEventStorage(TypeId event_type);
+  EventStorage* GetEventStorage(TypeId event_type) {
+    if (event_type.index < event_storage_lookup_.size()) {
+      EventStorage* storage = event_storage_lookup_[event_type.index];
+      if (storage && storage->event_type_id() == event_type) {
+        return storage;
+      }
+    }
+    return nullptr;
+  }
+
+  // The number of producer buffers of each event storage. Changes take effect on the next call to Prepare(), which
+  // creates the buffers, so the buffers are not reallocated while jobs emit into them.
+  void SetEventProducerCount(std::size_t producer_count) { event_producer_count_ = producer_count; }
+  std::size_t event_producer_count() const { return event_producer_count_; }
+
+  // Appends the events of all producer buffers to their current frame in the order of the producer indices. This is
+  // the synchronization point for jobs that emit events concurrently.
+  Result<> MergeEventProducerBuffers();
 
   Result<> Prepare();
 
@@ -102,6 +145,16 @@ class Scene : public Serializable {
   json Serialize() const override;
   bool Deserialize(const json& serialized_object) override;
 
+  // Writes the entities and the components of the used component storages in the binary scene format, see
+  // scene_serialization.hpp. In contrast to Serialize() it is meant for shipping scenes rather than editing them.
+  Result<Blob> SerializeBinary() const;
+  // Replaces all entities and their components by the ones written by SerializeBinary(). The scene must already be
+  // prepared, columns of components that are not used by the scene are skipped. The data should be aligned to at least
+  // 16 bytes, otherwise the components are copied through a temporary buffer. The entities and all column headers are
+  // validated before the scene is modified, so it stays unchanged if they are invalid. Only if the encoded properties
+  // of a component turn out to be invalid while loading them, the scene is left without entities.
+  Result<> DeserializeBinary(std::span<const std::byte> data);
+
  private:
   FrameScheduler frame_scheduler_;
 
@@ -111,10 +164,24 @@ class Scene : public Serializable {
   std::optional<EntityId> first_inactive_entity_;
 
   std::vector<ComponentStorage> component_storages_;
+  SceneComponentStorage scene_components_;
   std::vector<EventStorage> event_storages_;
+  std::size_t event_producer_count_ = 0;
+
+  // Lookup tables indexed by TypeId::index that are rebuilt in Prepare(). As type ids are versioned, the storage is
+  // only returned if its type id matches the requested one.
+  std::vector<ComponentStorage*> component_storage_lookup_;
+  std::vector<EventStorage*> event_storage_lookup_;
 
   bool is_playing_ = false;
 
+  // Deactivates all entities, changes the number of entity slots and removes all components
+  void ResetEntities(std::size_t capacity);
+  // Reads the component columns of a binary scene. If validate_only is set, the columns are only checked for a scene
+  // with the given capacity and the component storages are not modified.
+  Result<> DeserializeComponentColumns(std::uint32_t column_count, std::uint32_t capacity, bool validate_only,
+                                       SceneBinaryReader* reader);
+
   // Inserts a sibling in an existing sibling chain. All sibling indices in the chain as well as
   // the new entity are corrected. It returns the id of the first sibling after the insertion.
   [[nodiscard]] EntityId InsertSibling(EntityId first_sibling_id, EntityId new_sibling_id);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "ovis/utils/result.hpp"
+#include "ovis/vm/contiguous_storage.hpp"
+#include "ovis/vm/type_id.hpp"
+#include "ovis/vm/virtual_machine.hpp"
+#include "ovis/core/main_vm.hpp"
+
+namespace ovis {
+
+// Stores a single instance of every scene component (types with the Core.SceneComponent attribute) used by a scene.
+// The components are indexed by the index of their type id, so a lookup is a single array access.
+class SceneComponentStorage {
+ public:
+  SceneComponentStorage() = default;
+  SceneComponentStorage(const SceneComponentStorage&) = delete;
+  ~SceneComponentStorage();
+
+  SceneComponentStorage& operator=(const SceneComponentStorage&) = delete;
+
+  // Constructs the component of the given type. Fails if the component already exists.
+  Result<> AddComponent(TypeId component_type);
+  void Clear();
+
+  bool HasComponent(TypeId component_type) const {
+    return component_type.index < components_.size() && components_[component_type.index].storage &&
+           components_[component_type.index].type_id == component_type;
+  }
+
+  void* GetComponent(TypeId component_type) {
+    return HasComponent(component_type) ? (*components_[component_type.index].storage)[0] : nullptr;
+  }
+  const void* GetComponent(TypeId component_type) const {
+    return HasComponent(component_type) ? (*components_[component_type.index].storage)[0] : nullptr;
+  }
+
+  template <typename T>
+  T* GetComponent() {
+    return static_cast<T*>(GetComponent(main_vm->GetTypeId<std::remove_const_t<T>>()));
+  }
+
+ private:
+  struct Component {
+    TypeId type_id;
+    // ContiguousStorage can neither be copied nor moved, so it is stored indirectly
+    std::unique_ptr<ContiguousStorage> storage;
+  };
+  std::vector<Component> components_;
+};
+
+// A reference to a scene component. Use it as a SimpleJob parameter to get direct access to a scene component, e.g.,
+// SceneComponentRef<const SceneViewport> for read access or SceneComponentRef<SceneViewport> for write access.
+template <typename T>
+class SceneComponentRef {
+ public:
+  SceneComponentRef(T* component = nullptr) : component_(component) {}
+
+  T* get() const { return component_; }
+  T& operator*() const { return *component_; }
+  T* operator->() const { return component_; }
+
+  operator bool() const { return component_ != nullptr; }
+
+ private:
+  T* component_;
+};
+
+}  // namespace ovis
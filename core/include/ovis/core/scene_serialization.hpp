@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "ovis/utils/file.hpp"
+#include "ovis/utils/result.hpp"
+#include "ovis/vm/type.hpp"
+#include "ovis/core/entity.hpp"
+
+namespace ovis {
+
+// The binary scene format is meant for shipping levels and loading them quickly, JSON remains the format the editor
+// works with. A binary scene consists of:
+//  - a SceneBinaryHeader,
+//  - one SceneBinaryEntity per entity slot, followed by the length of each entity name and the concatenated names,
+//  - one column per component storage: a SceneBinaryColumnHeader, the reference string of the component type, the
+//    ranges of entity indices that have the component and the encoded components of these ranges. The components start
+//    at an offset that is a multiple of their alignment, so they can be copied directly into the storage.
+// Values are stored in the byte order of the machine, which has to be little endian.
+
+constexpr char SCENE_BINARY_MAGIC[4] = {'O', 'V', 'S', 'C'};
+constexpr std::uint32_t SCENE_BINARY_VERSION = 1;
+constexpr std::uint32_t SCENE_BINARY_COLUMN_VERSION = 1;
+constexpr std::uint32_t SCENE_BINARY_NO_ENTITY = 0xffffffff;
+
+enum class SceneBinaryColumnEncoding : std::uint32_t {
+  // The components are stored as they are in memory. Used for trivially copyable components.
+  RAW = 0,
+  // The components are encoded one after another via SerializeValue().
+  PROPERTIES = 1,
+};
+
+struct SceneBinaryHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t entity_capacity;
+  std::uint32_t column_count;
+  // Indices of the entities or SCENE_BINARY_NO_ENTITY
+  std::uint32_t first_active_entity;
+  std::uint32_t last_active_entity;
+  std::uint32_t first_inactive_entity;
+  std::uint32_t name_size;
+};
+static_assert(sizeof(SceneBinaryHeader) == 32);
+
+struct SceneBinaryEntity {
+  EntityId id;
+  EntityId parent_id;
+  EntityId first_children_id;
+  EntityId previous_sibling_id;
+  EntityId next_sibling_id;
+};
+static_assert(sizeof(SceneBinaryEntity) == 20);
+static_assert(std::is_trivially_copyable_v<SceneBinaryEntity>);
+
+struct SceneBinaryColumnHeader {
+  std::uint32_t version;
+  SceneBinaryColumnEncoding encoding;
+  // The memory layout of the component when the column was written. A RAW column can only be loaded if it still
+  // matches.
+  std::uint32_t component_size;
+  std::uint32_t component_alignment;
+  std::uint32_t type_name_size;
+  std::uint32_t range_count;
+  // Size of the encoded components, excluding the padding in front of them. Allows skipping unknown columns.
+  std::uint64_t data_size;
+};
+static_assert(sizeof(SceneBinaryColumnHeader) == 32);
+
+struct SceneBinaryRange {
+  std::uint32_t first_index;
+  std::uint32_t count;
+};
+static_assert(sizeof(SceneBinaryRange) == 8);
+
+class SceneBinaryWriter {
+ public:
+  explicit SceneBinaryWriter(Blob* data) : data_(data) {}
+
+  std::size_t size() const { return data_->size(); }
+
+  void Write(std::span<const std::byte> bytes) { data_->insert(data_->end(), bytes.begin(), bytes.end()); }
+
+  template <typename T> requires std::is_trivially_copyable_v<T>
+  void Write(const T& value) { Write(std::as_bytes(std::span(&value, 1))); }
+
+  template <typename T> requires std::is_trivially_copyable_v<T>
+  void Write(std::span<const T> values) { Write(std::as_bytes(values)); }
+
+  void WriteString(std::string_view string) {
+    Write(static_cast<std::uint32_t>(string.size()));
+    Write(std::as_bytes(std::span(string)));
+  }
+
+  // Pads the data with zeros until its size is a multiple of alignment
+  void Align(std::size_t alignment) { data_->resize((data_->size() + alignment - 1) / alignment * alignment); }
+
+ private:
+  Blob* data_;
+};
+
+class SceneBinaryReader {
+ public:
+  explicit SceneBinaryReader(std::span<const std::byte> data) : data_(data) {}
+
+  std::size_t offset() const { return offset_; }
+  std::size_t remaining_size() const { return data_.size() - offset_; }
+
+  Result<std::span<const std::byte>> Read(std::size_t size) {
+    if (size > remaining_size()) {
+      return Error("Unexpected end of binary scene data");
+    }
+    const auto bytes = data_.subspan(offset_, size);
+    offset_ += size;
+    return bytes;
+  }
+
+  template <typename T> requires std::is_trivially_copyable_v<T>
+  Result<> Read(T* value) {
+    return Read(std::span(value, 1));
+  }
+
+  template <typename T> requires std::is_trivially_copyable_v<T>
+  Result<> Read(std::span<T> values) {
+    const auto bytes = Read(values.size_bytes());
+    if (!bytes) {
+      return bytes.error();
+    }
+    if (bytes->size() > 0) {
+      std::memcpy(values.data(), bytes->data(), bytes->size());
+    }
+    return Success;
+  }
+
+  // The count is checked against the remaining data before allocating, so a corrupt count is reported as an error
+  template <typename T> requires std::is_trivially_copyable_v<T>
+  Result<std::vector<T>> ReadVector(std::size_t count) {
+    if (count > remaining_size() / sizeof(T)) {
+      return Error("Unexpected end of binary scene data");
+    }
+    std::vector<T> values(count);
+    OVIS_CHECK_RESULT(Read(std::span(values)));
+    return values;
+  }
+
+  Result<std::string_view> ReadString() {
+    std::uint32_t size;
+    OVIS_CHECK_RESULT(Read(&size));
+    const auto bytes = Read(size);
+    if (!bytes) {
+      return bytes.error();
+    }
+    return std::string_view(reinterpret_cast<const char*>(bytes->data()), bytes->size());
+  }
+
+  // Skips the padding inserted by SceneBinaryWriter::Align()
+  Result<> Align(std::size_t alignment) {
+    const std::size_t aligned_offset = (offset_ + alignment - 1) / alignment * alignment;
+    if (aligned_offset > data_.size()) {
+      return Error("Unexpected end of binary scene data");
+    }
+    offset_ = aligned_offset;
+    return Success;
+  }
+
+ private:
+  std::span<const std::byte> data_;
+  std::size_t offset_ = 0;
+};
+
+// Returns true if values of the type can be stored as they are in memory, i.e., the type is trivially copyable and
+// trivially destructible.
+bool IsRawSerializable(const Type* type);
+
+// Appends a value of the given type to the writer. Raw serializable types are stored as they are in memory, strings
+// with their size and other types property by property. Properties that are accessed via functions are not supported.
+Result<> SerializeValue(const Type* type, const void* value, SceneBinaryWriter* writer);
+
+// Reads a value written by SerializeValue() into an already constructed value of the same type.
+Result<> DeserializeValue(const Type* type, void* value, SceneBinaryReader* reader);
+
+}  // namespace ovis
@@ -1,12 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <concepts>
 #include <memory>
+#include <optional>
+#include <span>
 #include <type_traits>
 #include <vector>
 
+#include "ovis/utils/log.hpp"
+#include "ovis/utils/memory.hpp"
+#include "ovis/utils/profiling.hpp"
 #include "ovis/vm/list.hpp"
 #include "ovis/core/event_storage.hpp"
 #include "ovis/core/job.hpp"
+#include "ovis/core/job_statistics.hpp"
 #include "ovis/core/main_vm.hpp"
 
 namespace ovis {
@@ -38,11 +47,44 @@ class Scheduler {
     return nullptr;
   }
 
+  // Records the statistics of every job execution. The summaries are computed from the last window_size executions of
+  // each job. The statistics are reset when the scheduler is prepared again.
+  void EnableStatistics(std::size_t window_size = JobStatistics::DEFAULT_WINDOW_SIZE);
+  void DisableStatistics();
+  bool statistics_enabled() const { return statistics_window_size_.has_value(); }
+
+  // Returns nullptr if statistics are disabled or there is no job with the id
+  const JobStatistics* GetJobStatistics(std::string_view job_id) const;
+  std::span<const JobStatistics> job_statistics() const { return job_statistics_; }
+  // Writes the summaries of all jobs to the log
+  void WriteStatistics(ProfilingLog* log) const;
+
  private:
   std::vector<std::unique_ptr<Job<PrepareParameters, ExecuteParameters>>> jobs_;
 
+  // The event storages that trigger the job at the same index. If the list is empty, the job is always executed.
+  std::vector<std::vector<const EventStorage*>> job_triggers_;
+
+  // The event storages the job at the same index reads and writes, only used for the statistics
+  struct JobEvents {
+    std::vector<const EventStorage*> read;
+    std::vector<const EventStorage*> written;
+  };
+  std::vector<JobEvents> job_events_;
+  std::optional<std::size_t> statistics_window_size_;
+  // Empty if statistics are disabled, otherwise one entry per job in the order of jobs_
+  std::vector<JobStatistics> job_statistics_;
+  std::vector<std::uint64_t> written_event_counts_;
+
   Result<> SortJobs();
   Result<> PrepareJobs(const PrepareParameters& parameters);
+  std::vector<const EventStorage*> GetJobTriggers(const Job<PrepareParameters, ExecuteParameters>& job,
+                                                  const PrepareParameters& parameters) const;
+  JobEvents GetJobEvents(const Job<PrepareParameters, ExecuteParameters>& job,
+                         const PrepareParameters& parameters) const;
+  void ResetStatistics();
+  bool ShouldExecuteJob(std::size_t job_index) const;
+  Result<> ExecuteJobWithStatistics(std::size_t job_index, const ExecuteParameters& parameters);
 };
 
 template <typename PrepareParameters, typename ExecuteParameters>
@@ -54,13 +96,49 @@ Result<> Scheduler<PrepareParameters, ExecuteParameters>::Prepare(const PrepareP
 
 template <typename PrepareParameters, typename ExecuteParameters>
 Result<> Scheduler<PrepareParameters, ExecuteParameters>::operator()(const ExecuteParameters& parameters) {
-  for (const auto& job : jobs_) {
-    OVIS_CHECK_RESULT(job->Execute(parameters));
+  for (std::size_t i = 0; i < jobs_.size(); ++i) {
+    if (ShouldExecuteJob(i)) {
+      const TraceZone zone(jobs_[i]->trace_name());
+      if (job_statistics_.empty()) {
+        OVIS_CHECK_RESULT(jobs_[i]->Execute(parameters));
+      } else {
+        OVIS_CHECK_RESULT(ExecuteJobWithStatistics(i, parameters));
+      }
+    }
   }
 
   return Success;
 }
 
+template <typename PrepareParameters, typename ExecuteParameters>
+void Scheduler<PrepareParameters, ExecuteParameters>::EnableStatistics(std::size_t window_size) {
+  statistics_window_size_ = window_size;
+  ResetStatistics();
+}
+
+template <typename PrepareParameters, typename ExecuteParameters>
+void Scheduler<PrepareParameters, ExecuteParameters>::DisableStatistics() {
+  statistics_window_size_.reset();
+  job_statistics_.clear();
+}
+
+template <typename PrepareParameters, typename ExecuteParameters>
+const JobStatistics* Scheduler<PrepareParameters, ExecuteParameters>::GetJobStatistics(std::string_view job_id) const {
+  for (const JobStatistics& statistics : job_statistics_) {
+    if (statistics.job_id() == job_id) {
+      return &statistics;
+    }
+  }
+  return nullptr;
+}
+
+template <typename PrepareParameters, typename ExecuteParameters>
+void Scheduler<PrepareParameters, ExecuteParameters>::WriteStatistics(ProfilingLog* log) const {
+  for (const JobStatistics& statistics : job_statistics_) {
+    statistics.Write(log);
+  }
+}
+
 template <typename PrepareParameters, typename ExecuteParameters>
 std::unordered_set<TypeId> Scheduler<PrepareParameters, ExecuteParameters>::GetUsedComponentsAndEvents() const {
   std::unordered_set<TypeId> types;
@@ -135,10 +213,133 @@ Result<> Scheduler<PrepareParameters, ExecuteParameters>::SortJobs() {
 
 template <typename PrepareParameters, typename ExecuteParameters>
 Result<> Scheduler<PrepareParameters, ExecuteParameters>::PrepareJobs(const PrepareParameters& parameters) {
+  job_triggers_.clear();
+  job_triggers_.reserve(jobs_.size());
+  job_events_.clear();
+  job_events_.reserve(jobs_.size());
   for (const auto& job : jobs_) {
     OVIS_CHECK_RESULT(job->Prepare(parameters));
+    job_triggers_.push_back(GetJobTriggers(*job, parameters));
+    job_events_.push_back(GetJobEvents(*job, parameters));
   }
+  ResetStatistics();
   return Success;
 }
 
+template <typename PrepareParameters, typename ExecuteParameters>
+std::vector<const EventStorage*> Scheduler<PrepareParameters, ExecuteParameters>::GetJobTriggers(
+    const Job<PrepareParameters, ExecuteParameters>& job, const PrepareParameters& parameters) const {
+  // Only schedulers that have access to event storages can trigger jobs by events
+  if constexpr (requires(TypeId type_id) {
+                  { parameters->GetEventStorage(type_id) } -> std::convertible_to<const EventStorage*>;
+                }) {
+    if (job.trigger_policy() == JobTriggerPolicy::ALWAYS) {
+      return {};
+    }
+
+    std::vector<const EventStorage*> triggers;
+    bool reads_other_resources = false;
+    for (const auto type_id : job.read_access()) {
+      if (main_vm->GetType(type_id)->attributes().contains("Core.Event")) {
+        triggers.push_back(parameters->GetEventStorage(type_id));
+        assert(triggers.back() != nullptr);
+      } else {
+        reads_other_resources = true;
+      }
+    }
+
+    if (job.trigger_policy() == JobTriggerPolicy::AUTOMATIC && reads_other_resources) {
+      return {};
+    }
+    if (job.trigger_policy() == JobTriggerPolicy::ON_EVENTS && triggers.size() == 0) {
+      LogW("Job {} should be triggered by events but does not read any", job.id());
+    }
+    return triggers;
+  } else {
+    return {};
+  }
+}
+
+template <typename PrepareParameters, typename ExecuteParameters>
+typename Scheduler<PrepareParameters, ExecuteParameters>::JobEvents
+Scheduler<PrepareParameters, ExecuteParameters>::GetJobEvents(const Job<PrepareParameters, ExecuteParameters>& job,
+                                                              const PrepareParameters& parameters) const {
+  JobEvents events;
+  if constexpr (requires(TypeId type_id) {
+                  { parameters->GetEventStorage(type_id) } -> std::convertible_to<const EventStorage*>;
+                }) {
+    const auto add_event_storages = [&parameters](const std::unordered_set<TypeId>& access,
+                                                  std::vector<const EventStorage*>* event_storages) {
+      for (const auto type_id : access) {
+        if (main_vm->GetType(type_id)->attributes().contains("Core.Event")) {
+          event_storages->push_back(parameters->GetEventStorage(type_id));
+          assert(event_storages->back() != nullptr);
+        }
+      }
+    };
+    add_event_storages(job.read_access(), &events.read);
+    add_event_storages(job.write_access(), &events.written);
+  }
+  return events;
+}
+
+template <typename PrepareParameters, typename ExecuteParameters>
+void Scheduler<PrepareParameters, ExecuteParameters>::ResetStatistics() {
+  job_statistics_.clear();
+  if (!statistics_window_size_.has_value()) {
+    return;
+  }
+  job_statistics_.reserve(jobs_.size());
+  for (const auto& job : jobs_) {
+    job_statistics_.emplace_back(job->id(), *statistics_window_size_);
+  }
+}
+
+template <typename PrepareParameters, typename ExecuteParameters>
+bool Scheduler<PrepareParameters, ExecuteParameters>::ShouldExecuteJob(std::size_t job_index) const {
+  const auto& triggers = job_triggers_[job_index];
+  if (triggers.size() == 0) {
+    return true;
+  }
+  // Events of the previous frame also count as pending as they may be consumed during this frame
+  return std::any_of(triggers.begin(), triggers.end(), [](const EventStorage* event_storage) {
+    return event_storage->current_frame_events()->size() > 0 || event_storage->previous_frame_events()->size() > 0;
+  });
+}
+
+template <typename PrepareParameters, typename ExecuteParameters>
+Result<> Scheduler<PrepareParameters, ExecuteParameters>::ExecuteJobWithStatistics(
+    std::size_t job_index, const ExecuteParameters& parameters) {
+  auto& job = jobs_[job_index];
+  const JobEvents& events = job_events_[job_index];
+  JobFrameStatistics frame{};
+
+  for (const EventStorage* event_storage : events.read) {
+    frame.read_event_count += event_storage->current_frame_events()->size();
+    frame.read_event_count += event_storage->previous_frame_events()->size();
+  }
+  // Events that are emitted into producer buffers are not counted as they are merged after the job
+  written_event_counts_.clear();
+  for (const EventStorage* event_storage : events.written) {
+    written_event_counts_.push_back(event_storage->size());
+  }
+  const std::uint64_t processed_entity_count = job->processed_entity_count();
+  const std::uint64_t allocation_count = GetThreadAllocationCount();
+  const auto start_time = std::chrono::steady_clock::now();
+
+  Result<> result = job->Execute(parameters);
+
+  frame.wall_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+  frame.allocation_count = GetThreadAllocationCount() - allocation_count;
+  frame.processed_entity_count = job->processed_entity_count() - processed_entity_count;
+  for (std::size_t i = 0; i < events.written.size(); ++i) {
+    // Events may be cleared by the job
+    frame.emitted_event_count += std::max<std::uint64_t>(events.written[i]->size(), written_event_counts_[i]) -
+                                 written_event_counts_[i];
+  }
+  job_statistics_[job_index].AddFrame(frame);
+
+  return result;
+}
+
 }  // namespace ovis
@@ -16,6 +16,7 @@
 #include "ovis/core/job.hpp"
 #include "ovis/core/main_vm.hpp"
 #include "ovis/core/scene.hpp"
+#include "ovis/core/scene_component_storage.hpp"
 
 namespace ovis {
 
@@ -35,11 +36,14 @@ class SimpleJob : public Job<Scene*, SceneUpdate> {
 
   Result<> Execute(const SceneUpdate& parameters) override {
     if constexpr (needs_iteration_) {
+      std::uint64_t processed_entity_count = 0;
       for (Entity& entity : *parameters.scene) {
         if (ShouldExecute(entity, ArgumentTypes{}, std::make_index_sequence<ArgumentTypes::size>())) {
+          ++processed_entity_count;
           OVIS_CHECK_RESULT(Call(&entity, ArgumentTypes{}, std::make_index_sequence<ArgumentTypes::size>()));
         }
       }
+      CountProcessedEntities(processed_entity_count);
       return Success;
     } else {
       OVIS_CHECK_RESULT(Call(nullptr, ArgumentTypes{}, std::make_index_sequence<ArgumentTypes::size>()));
@@ -90,6 +94,22 @@ class SimpleJob : public Job<Scene*, SceneUpdate> {
     static auto GetParameter(Entity* entity, type source) { return source.GetComponent(entity->id); }
   };
   template <typename T>
+  struct ParameterSource<SceneComponentRef<T>> {
+    using type = SceneComponentRef<T>;
+    static constexpr bool needs_iteration = false;
+    static void ParseAccess(SimpleJob* job) {
+      assert(main_vm->GetType<std::remove_const_t<T>>()->attributes().contains("Core.SceneComponent"));
+      if constexpr (std::is_const_v<T>) {
+        job->RequireReadAccess(main_vm->GetTypeId<std::remove_const_t<T>>());
+      } else {
+        job->RequireWriteAccess(main_vm->GetTypeId<T>());
+      }
+    }
+    static type GetSource(Scene* scene) { return scene->GetSceneComponent<T>(); }
+    static bool ShouldExecute(Entity* entity, type source) { return true; }
+    static auto GetParameter(Entity* entity, type source) { return source; }
+  };
+  template <typename T>
   struct ParameterSource<EventEmitter<T>> {
     using type = EventEmitter<T>;
     static constexpr bool is_event_emitter = true;
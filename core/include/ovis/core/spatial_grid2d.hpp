@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ovis/core/intersection.hpp"
+
+namespace ovis {
+
+// A uniform grid that finds the objects overlapping a region without testing every object. Objects are identified by
+// a small integer, e.g., the index of an entity, and are registered in every cell their bounding box overlaps. Moving
+// an object only touches the grid when it crosses a cell boundary. Objects that would cover too many cells are kept in
+// a separate list that is tested by every query instead.
+class SpatialGrid2D {
+ public:
+  static constexpr std::uint32_t MAX_CELLS_PER_OBJECT = 16;
+
+  explicit SpatialGrid2D(float cell_size);
+
+  // Inserts the object or updates its bounds if it is already in the grid
+  void Update(std::uint32_t id, const AxisAlignedBoundingBox2D& bounds);
+  void Remove(std::uint32_t id);
+  void Clear();
+
+  bool Contains(std::uint32_t id) const { return id < objects_.size() && objects_[id].in_grid; }
+  inline float cell_size() const { return cell_size_; }
+
+  // Appends the ids of all objects overlapping the region to ids. Every id is only appended once, the order is
+  // unspecified.
+  void Query(const AxisAlignedBoundingBox2D& region, std::vector<std::uint32_t>* ids) const;
+
+ private:
+  struct CellRange {
+    std::int32_t min_x;
+    std::int32_t min_y;
+    std::int32_t max_x;
+    std::int32_t max_y;
+
+    bool operator==(const CellRange&) const = default;
+    std::uint64_t cell_count() const {
+      return static_cast<std::uint64_t>(max_x - min_x + 1) * static_cast<std::uint64_t>(max_y - min_y + 1);
+    }
+  };
+  struct Object {
+    AxisAlignedBoundingBox2D bounds;
+    CellRange cells;
+    bool in_grid = false;
+    bool large = false;
+  };
+
+  float cell_size_;
+  std::vector<Object> objects_;
+  std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> cells_;
+  std::vector<std::uint32_t> large_objects_;
+  // Marks the objects that were already visited by a query
+  mutable std::vector<std::uint32_t> query_marks_;
+  mutable std::uint32_t query_generation_ = 0;
+
+  CellRange ComputeCellRange(const AxisAlignedBoundingBox2D& bounds) const;
+  static std::uint64_t CellKey(std::int32_t x, std::int32_t y) {
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32 | static_cast<std::uint32_t>(y);
+  }
+  void AddToCells(std::uint32_t id, const Object& object);
+  void RemoveFromCells(std::uint32_t id, const Object& object);
+};
+
+}  // namespace ovis
@@ -1,5 +1,9 @@
 #include "ovis/core/application.hpp"
 
+#include "ovis/utils/trace.hpp"
+#include "ovis/core/asset_cache.hpp"
+#include "ovis/core/asset_loader.hpp"
+
 #if OVIS_EMSCRIPTEN
 #include <emscripten.h>
 #endif
@@ -11,8 +15,11 @@ ApplicationSchedular application_scheduler;
 namespace {
 
 bool quit = false;
+// The time per frame that is spent on completing asset loads, e.g., on uploading textures
+constexpr std::chrono::microseconds ASSET_COMPLETION_TIME_BUDGET{4000};
 
 void Update() {
+  OVIS_TRACE_ZONE("Application::Update");
   using namespace std::chrono;
   static auto time_point_of_last_update = high_resolution_clock::now();
 
@@ -20,7 +27,10 @@ void Update() {
   const double delta_time = duration<double>(now - time_point_of_last_update).count();
   time_point_of_last_update = now;
 
+  GetDefaultAssetLoader()->ProcessCompletions(ASSET_COMPLETION_TIME_BUDGET);
   application_scheduler(delta_time);
+  // Assets that were released during the frame are evicted if the cache exceeds its budget
+  GetDefaultAssetCache()->Trim();
 
 #if OVIS_ENABLE_BUILT_IN_PROFILING
   ProfilingLog::default_log()->AdvanceFrame();
@@ -0,0 +1,376 @@
+#include "ovis/core/asset_archive.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+#include <lz4.h>
+#include <lz4hc.h>
+#include <zstd.h>
+
+#include "ovis/utils/log.hpp"
+#include "ovis/utils/trace.hpp"
+
+namespace ovis {
+
+// The table of contents is read directly from the mapped file
+static_assert(std::endian::native == std::endian::little, "Asset archives are only supported on little endian machines");
+
+namespace {
+
+constexpr char ARCHIVE_MAGIC[8] = {'O', 'V', 'I', 'S', 'P', 'A', 'K', '1'};
+constexpr std::uint32_t NO_ENTRY = 0xffffffff;
+// Packing is done offline, so the compression levels favor the size over the time
+constexpr int ZSTD_COMPRESSION_LEVEL = 19;
+
+struct ArchiveHeader {
+  char magic[8];
+  std::uint32_t entry_count;
+  std::uint32_t bucket_count;
+  std::uint64_t entries_offset;
+  std::uint64_t buckets_offset;
+  std::uint64_t strings_offset;
+};
+static_assert(sizeof(ArchiveHeader) == 40);
+
+// FNV-1a of "<asset_id>.<filename>", which is unique as asset ids cannot contain a '.'
+std::uint64_t HashAssetFile(std::string_view asset_id, std::string_view filename) {
+  std::uint64_t hash = 0xcbf29ce484222325;
+  const auto add = [&hash](std::string_view string) {
+    for (const char character : string) {
+      hash ^= static_cast<std::uint8_t>(character);
+      hash *= 0x100000001b3;
+    }
+  };
+  add(asset_id);
+  add(".");
+  add(filename);
+  return hash;
+}
+
+std::uint64_t Align(std::uint64_t offset, std::uint64_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+Blob Compress(const Blob& data, AssetArchiveCompression compression) {
+  Blob compressed;
+  switch (compression) {
+    case AssetArchiveCompression::NONE:
+      break;
+
+    case AssetArchiveCompression::LZ4: {
+      compressed.resize(LZ4_compressBound(static_cast<int>(data.size())));
+      const int size = LZ4_compress_HC(reinterpret_cast<const char*>(data.data()),
+                                       reinterpret_cast<char*>(compressed.data()), static_cast<int>(data.size()),
+                                       static_cast<int>(compressed.size()), LZ4HC_CLEVEL_MAX);
+      compressed.resize(size);
+      break;
+    }
+
+    case AssetArchiveCompression::ZSTD: {
+      compressed.resize(ZSTD_compressBound(data.size()));
+      const std::size_t size =
+          ZSTD_compress(compressed.data(), compressed.size(), data.data(), data.size(), ZSTD_COMPRESSION_LEVEL);
+      compressed.resize(ZSTD_isError(size) ? 0 : size);
+      break;
+    }
+  }
+  return compressed;
+}
+
+}  // namespace
+
+Result<> WriteAssetArchive(const AssetLibrary& asset_library, const std::string& filename,
+                           AssetArchiveCompression compression) {
+  using Entry = ArchiveAssetLibrary::Entry;
+  std::vector<Entry> entries;
+  std::vector<Blob> contents;
+  std::string strings;
+  std::unordered_map<std::string, std::uint32_t> string_offsets;
+  const auto add_string = [&](const std::string& string) {
+    const auto [iterator, inserted] = string_offsets.insert({string, static_cast<std::uint32_t>(strings.size())});
+    if (inserted) {
+      strings += string;
+    }
+    return iterator->second;
+  };
+
+  std::vector<std::string> asset_ids = asset_library.GetAssets();
+  std::sort(asset_ids.begin(), asset_ids.end());
+  for (const std::string& asset_id : asset_ids) {
+    const Result<std::string> type = asset_library.GetAssetType(asset_id);
+    OVIS_CHECK_RESULT(type);
+    std::vector<std::string> filenames = asset_library.GetAssetFileTypes(asset_id);
+    std::sort(filenames.begin(), filenames.end());
+    for (const std::string& asset_filename : filenames) {
+      Result<Blob> data = asset_library.LoadAssetBinaryFile(asset_id, asset_filename);
+      OVIS_CHECK_RESULT(data);
+
+      Entry& entry = entries.emplace_back();
+      entry.hash = HashAssetFile(asset_id, asset_filename);
+      entry.size = data->size();
+      entry.asset_id_offset = add_string(asset_id);
+      entry.asset_id_length = asset_id.size();
+      entry.type_offset = add_string(*type);
+      entry.type_length = type->size();
+      entry.filename_offset = add_string(asset_filename);
+      entry.filename_length = asset_filename.size();
+
+      Blob compressed = Compress(*data, compression);
+      if (!compressed.empty() && compressed.size() < data->size()) {
+        entry.compression = compression;
+        contents.push_back(std::move(compressed));
+      } else {
+        entry.compression = AssetArchiveCompression::NONE;
+        contents.push_back(std::move(*data));
+      }
+      entry.stored_size = contents.back().size();
+    }
+  }
+
+  ArchiveHeader header;
+  std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+  header.entry_count = entries.size();
+  header.bucket_count = std::bit_ceil(std::max<std::uint32_t>(header.entry_count, 1));
+  header.entries_offset = Align(sizeof(ArchiveHeader), ArchiveAssetLibrary::ENTRY_ALIGNMENT);
+  header.buckets_offset = header.entries_offset + entries.size() * sizeof(Entry);
+  header.strings_offset = header.buckets_offset + header.bucket_count * sizeof(std::uint32_t);
+
+  // Later entries are inserted at the front of their bucket
+  std::vector<std::uint32_t> buckets(header.bucket_count, NO_ENTRY);
+  std::uint64_t offset = header.strings_offset + strings.size();
+  for (std::uint32_t i = 0; i < entries.size(); ++i) {
+    offset = Align(offset, ArchiveAssetLibrary::ENTRY_ALIGNMENT);
+    entries[i].offset = offset;
+    offset += entries[i].stored_size;
+
+    std::uint32_t& bucket = buckets[entries[i].hash % header.bucket_count];
+    entries[i].next_entry = bucket;
+    bucket = i;
+  }
+
+  std::ofstream file(filename, std::ios::binary);
+  if (!file) {
+    return Error("Cannot open file: {}", filename);
+  }
+  const auto write_padding = [&file](std::uint64_t offset) {
+    static constexpr char padding[ArchiveAssetLibrary::ENTRY_ALIGNMENT] = {};
+    file.write(padding, offset - file.tellp());
+  };
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  write_padding(header.entries_offset);
+  file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+  file.write(reinterpret_cast<const char*>(buckets.data()), buckets.size() * sizeof(std::uint32_t));
+  file.write(strings.data(), strings.size());
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    write_padding(entries[i].offset);
+    file.write(reinterpret_cast<const char*>(contents[i].data()), contents[i].size());
+  }
+  if (!file) {
+    return Error("Could not write file: {}", filename);
+  }
+
+  LogI("Wrote {} files into asset archive '{}' ({} bytes)", entries.size(), filename, offset);
+  return Success;
+}
+
+ArchiveAssetLibrary::ArchiveAssetLibrary(std::string filename, std::unique_ptr<MemoryMappedFile> file)
+    : filename_(std::move(filename)), file_(std::move(file)) {}
+
+Result<std::unique_ptr<ArchiveAssetLibrary>> ArchiveAssetLibrary::Open(const std::string& filename) {
+  Result<std::unique_ptr<MemoryMappedFile>> file = MemoryMappedFile::Open(filename);
+  OVIS_CHECK_RESULT(file);
+
+  std::unique_ptr<ArchiveAssetLibrary> library(new ArchiveAssetLibrary(filename, std::move(*file)));
+  OVIS_CHECK_RESULT(library->ReadTableOfContents());
+  return std::move(library);
+}
+
+bool ArchiveAssetLibrary::Contains(std::string_view asset_id) const {
+  return assets_.contains(asset_id);
+}
+
+std::vector<std::string> ArchiveAssetLibrary::GetAssets() const {
+  std::vector<std::string> assets;
+  assets.reserve(assets_.size());
+  for (const auto& asset : assets_) {
+    assets.emplace_back(asset.first);
+  }
+  return assets;
+}
+
+Result<std::string> ArchiveAssetLibrary::GetAssetType(std::string_view asset_id) const {
+  const auto asset = assets_.find(asset_id);
+  if (asset == assets_.end()) {
+    return Error("Asset not found: {}", asset_id);
+  }
+  return std::string(asset->second.type);
+}
+
+std::vector<std::string> ArchiveAssetLibrary::GetAssetFileTypes(std::string_view asset_id) const {
+  const auto asset = assets_.find(asset_id);
+  return asset != assets_.end() ? asset->second.filenames : std::vector<std::string>{};
+}
+
+Result<std::string> ArchiveAssetLibrary::LoadAssetTextFile(std::string_view asset_id,
+                                                           std::string_view filename) const {
+  OVIS_TRACE_DYNAMIC_ZONE(fmt::format("Load asset {}.{}", asset_id, filename));
+  const Result<const Entry*> entry = FindEntry(asset_id, filename);
+  OVIS_CHECK_RESULT(entry);
+
+  std::string text((*entry)->size, '\0');
+  OVIS_CHECK_RESULT(Decompress(**entry, std::as_writable_bytes(std::span(text))));
+  return std::move(text);
+}
+
+Result<Blob> ArchiveAssetLibrary::LoadAssetBinaryFile(std::string_view asset_id, std::string_view filename) const {
+  OVIS_TRACE_DYNAMIC_ZONE(fmt::format("Load asset {}.{}", asset_id, filename));
+  const Result<const Entry*> entry = FindEntry(asset_id, filename);
+  OVIS_CHECK_RESULT(entry);
+
+  Blob data((*entry)->size);
+  OVIS_CHECK_RESULT(Decompress(**entry, data));
+  return std::move(data);
+}
+
+Result<AssetView> ArchiveAssetLibrary::LoadAssetFile(std::string_view asset_id, std::string_view filename) const {
+  const Result<const Entry*> entry = FindEntry(asset_id, filename);
+  OVIS_CHECK_RESULT(entry);
+  if ((*entry)->compression == AssetArchiveCompression::NONE) {
+    return AssetView(file_->data().subspan((*entry)->offset, (*entry)->size), file_);
+  }
+
+  OVIS_TRACE_DYNAMIC_ZONE(fmt::format("Decompress asset {}.{}", asset_id, filename));
+  Blob data((*entry)->size);
+  OVIS_CHECK_RESULT(Decompress(**entry, data));
+  return AssetView(std::move(data));
+}
+
+std::vector<std::string> ArchiveAssetLibrary::GetAssetsWithType(std::string_view type) const {
+  std::vector<std::string> assets;
+  for (const auto& asset : assets_) {
+    if (asset.second.type == type) {
+      assets.emplace_back(asset.first);
+    }
+  }
+  return assets;
+}
+
+Result<> ArchiveAssetLibrary::ReadTableOfContents() {
+  const std::span<const std::byte> data = file_->data();
+  ArchiveHeader header;
+  if (data.size() < sizeof(header)) {
+    return Error("Invalid asset archive '{}': file is too small", filename_);
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0) {
+    return Error("Invalid asset archive '{}': unknown format", filename_);
+  }
+  // Checks the length against the size after the offset, so large offsets cannot overflow
+  const auto is_within_file = [file_size = data.size()](std::uint64_t offset, std::uint64_t length) {
+    return offset <= file_size && length <= file_size - offset;
+  };
+  if (!is_within_file(header.entries_offset, std::uint64_t{header.entry_count} * sizeof(Entry)) ||
+      !is_within_file(header.buckets_offset, std::uint64_t{header.bucket_count} * sizeof(std::uint32_t)) ||
+      header.strings_offset > data.size() || header.bucket_count == 0) {
+    return Error("Invalid asset archive '{}': table of contents exceeds the file", filename_);
+  }
+
+  entries_.resize(header.entry_count);
+  std::memcpy(entries_.data(), data.data() + header.entries_offset, entries_.size() * sizeof(Entry));
+  buckets_.resize(header.bucket_count);
+  std::memcpy(buckets_.data(), data.data() + header.buckets_offset, buckets_.size() * sizeof(std::uint32_t));
+  strings_offset_ = header.strings_offset;
+
+  const std::uint64_t strings_size = data.size() - strings_offset_;
+  const auto is_valid_string = [strings_size](std::uint32_t offset, std::uint32_t length) {
+    return std::uint64_t{offset} + length <= strings_size;
+  };
+  for (const std::uint32_t bucket : buckets_) {
+    if (bucket != NO_ENTRY && bucket >= entries_.size()) {
+      return Error("Invalid asset archive '{}': invalid bucket", filename_);
+    }
+  }
+  for (const Entry& entry : entries_) {
+    if (!is_valid_string(entry.asset_id_offset, entry.asset_id_length) ||
+        !is_valid_string(entry.type_offset, entry.type_length) ||
+        !is_valid_string(entry.filename_offset, entry.filename_length) ||
+        !is_within_file(entry.offset, entry.stored_size) ||
+        (entry.next_entry != NO_ENTRY && entry.next_entry >= entries_.size()) ||
+        (entry.compression == AssetArchiveCompression::NONE && entry.stored_size != entry.size)) {
+      return Error("Invalid asset archive '{}': invalid entry", filename_);
+    }
+
+    AssetData& asset = assets_[GetString(entry.asset_id_offset, entry.asset_id_length)];
+    asset.type = GetString(entry.type_offset, entry.type_length);
+    asset.filenames.emplace_back(GetString(entry.filename_offset, entry.filename_length));
+  }
+
+  LogV("Opened asset archive '{}' with {} assets", filename_, assets_.size());
+  return Success;
+}
+
+std::string_view ArchiveAssetLibrary::GetString(std::uint32_t offset, std::uint32_t length) const {
+  return {reinterpret_cast<const char*>(file_->data().data() + strings_offset_ + offset), length};
+}
+
+Result<const ArchiveAssetLibrary::Entry*> ArchiveAssetLibrary::FindEntry(std::string_view asset_id,
+                                                                         std::string_view filename) const {
+  const std::uint64_t hash = HashAssetFile(asset_id, filename);
+  for (std::uint32_t i = buckets_[hash % buckets_.size()]; i != NO_ENTRY; i = entries_[i].next_entry) {
+    const Entry& entry = entries_[i];
+    if (entry.hash == hash && GetString(entry.asset_id_offset, entry.asset_id_length) == asset_id &&
+        GetString(entry.filename_offset, entry.filename_length) == filename) {
+      return &entry;
+    }
+  }
+  return Error("Asset file not found: {}.{}", asset_id, filename);
+}
+
+Result<> ArchiveAssetLibrary::Decompress(const Entry& entry, std::span<std::byte> destination) const {
+  assert(destination.size() == entry.size);
+  const std::span<const std::byte> source = file_->data().subspan(entry.offset, entry.stored_size);
+
+  switch (entry.compression) {
+    case AssetArchiveCompression::NONE:
+      std::memcpy(destination.data(), source.data(), source.size());
+      return Success;
+
+    case AssetArchiveCompression::LZ4: {
+      const int size =
+          LZ4_decompress_safe(reinterpret_cast<const char*>(source.data()), reinterpret_cast<char*>(destination.data()),
+                              static_cast<int>(source.size()), static_cast<int>(destination.size()));
+      if (size < 0 || static_cast<std::size_t>(size) != destination.size()) {
+        return Error("Failed to decompress asset file in '{}'", filename_);
+      }
+      return Success;
+    }
+
+    case AssetArchiveCompression::ZSTD: {
+      const std::size_t size = ZSTD_decompress(destination.data(), destination.size(), source.data(), source.size());
+      if (ZSTD_isError(size) || size != destination.size()) {
+        return Error("Failed to decompress asset file in '{}'", filename_);
+      }
+      return Success;
+    }
+  }
+  return Error("Unknown compression of asset file in '{}'", filename_);
+}
+
+Result<> SetEngineAssetArchive(const std::string& filename) {
+  Result<std::unique_ptr<ArchiveAssetLibrary>> library = ArchiveAssetLibrary::Open(filename);
+  OVIS_CHECK_RESULT(library);
+  detail::SetEngineAssetLibrary(std::move(*library));
+  return Success;
+}
+
+Result<> SetApplicationAssetArchive(const std::string& filename) {
+  Result<std::unique_ptr<ArchiveAssetLibrary>> library = ArchiveAssetLibrary::Open(filename);
+  OVIS_CHECK_RESULT(library);
+  detail::SetApplicationAssetLibrary(std::move(*library));
+  return Success;
+}
+
+}  // namespace ovis
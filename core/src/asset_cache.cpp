@@ -0,0 +1,120 @@
+#include "ovis/core/asset_cache.hpp"
+
+namespace ovis {
+
+AssetCache::AssetCache(AssetMemoryUsage budget) : budget_(budget) {}
+
+AssetCache::~AssetCache() {
+  Clear();
+}
+
+void AssetCache::Trim() {
+  if (IsWithinBudget()) {
+    return;
+  }
+
+  for (auto position = lru_entries_.end(); position != lru_entries_.begin() && !IsWithinBudget();) {
+    --position;
+    const auto entry = entries_.find(**position);
+    assert(entry != entries_.end());
+    if (entry->second.asset.use_count() > 1) {
+      // Evicting an asset that is still in use would not free its memory, but cause it to be loaded twice
+      continue;
+    }
+    memory_usage_.cpu_bytes -= entry->second.memory_usage.cpu_bytes;
+    memory_usage_.gpu_bytes -= entry->second.memory_usage.gpu_bytes;
+    ++statistics_.eviction_count;
+    // The list refers to the key of the entry, so it has to be erased first
+    position = lru_entries_.erase(position);
+    entries_.erase(entry);
+  }
+}
+
+void AssetCache::Clear() {
+  for (auto& [key, pending_load] : pending_loads_) {
+    pending_load.load.Cancel();
+    for (const auto& waiter : pending_load.waiters) {
+      waiter.request->cancelled = true;
+    }
+  }
+  pending_loads_.clear();
+  lru_entries_.clear();
+  entries_.clear();
+  memory_usage_ = {};
+}
+
+void AssetCache::SetBudget(AssetMemoryUsage budget) {
+  budget_ = budget;
+  Trim();
+}
+
+std::shared_ptr<void> AssetCache::FindEntry(const Key& key) {
+  const auto entry = entries_.find(key);
+  if (entry == entries_.end()) {
+    return nullptr;
+  }
+  ++statistics_.hit_count;
+  lru_entries_.splice(lru_entries_.begin(), lru_entries_, entry->second.lru_position);
+  return entry->second.asset;
+}
+
+void AssetCache::InsertEntry(const Key& key, std::shared_ptr<void> asset, AssetMemoryUsage memory_usage) {
+  auto [entry, inserted] = entries_.try_emplace(key);
+  if (inserted) {
+    lru_entries_.push_front(&entry->first);
+    entry->second.lru_position = lru_entries_.begin();
+  } else {
+    memory_usage_.cpu_bytes -= entry->second.memory_usage.cpu_bytes;
+    memory_usage_.gpu_bytes -= entry->second.memory_usage.gpu_bytes;
+    lru_entries_.splice(lru_entries_.begin(), lru_entries_, entry->second.lru_position);
+  }
+  entry->second.asset = std::move(asset);
+  entry->second.memory_usage = memory_usage;
+  memory_usage_.cpu_bytes += memory_usage.cpu_bytes;
+  memory_usage_.gpu_bytes += memory_usage.gpu_bytes;
+
+  // The new entry is the most recently used one, so it is only evicted if nothing else can be
+  Trim();
+}
+
+bool AssetCache::IsWithinBudget() const {
+  return memory_usage_.cpu_bytes <= budget_.cpu_bytes && memory_usage_.gpu_bytes <= budget_.gpu_bytes;
+}
+
+AssetLoadHandle AssetCache::AddWaiter(const Key& key, ReadyFunction ready, bool* is_first_waiter) {
+  auto [pending_load, inserted] = pending_loads_.try_emplace(key);
+  *is_first_waiter = inserted;
+  if (inserted) {
+    ++statistics_.miss_count;
+  } else {
+    ++statistics_.joined_load_count;
+  }
+
+  // The request of the waiter is never queued in a loader, it only tracks whether the waiter was completed or cancelled
+  auto request = std::make_shared<detail::AssetLoadRequest>();
+  pending_load->second.waiters.push_back({.request = request, .ready = std::move(ready)});
+  return AssetLoadHandle(std::move(request));
+}
+
+void AssetCache::CompletePendingLoad(const Key& key, const std::shared_ptr<void>& asset, const Error* error) {
+  const auto pending_load = pending_loads_.find(key);
+  assert(pending_load != pending_loads_.end());
+  // A ready function may request the asset again, e.g., after an error, which must not modify the waiters that are
+  // currently notified
+  std::vector<Waiter> waiters = std::move(pending_load->second.waiters);
+  pending_loads_.erase(pending_load);
+
+  for (const auto& waiter : waiters) {
+    if (!waiter.request->cancelled) {
+      waiter.ready(asset, error);
+      waiter.request->completed = true;
+    }
+  }
+}
+
+AssetCache* GetDefaultAssetCache() {
+  static AssetCache asset_cache({.cpu_bytes = 256 * 1024 * 1024, .gpu_bytes = 0});
+  return &asset_cache;
+}
+
+}  // namespace ovis
@@ -1,18 +1,26 @@
 #include <ovis/utils/log.hpp>
+#include <ovis/utils/memory_mapped_file.hpp>
+#include <ovis/utils/trace.hpp>
 #include <ovis/core/asset_library.hpp>
 
 namespace ovis {
 
 Result<json> AssetLibrary::LoadAssetJsonFile(std::string_view asset_id, std::string_view filename) const {
-  const auto text_file = LoadAssetTextFile(asset_id, filename);
-  OVIS_CHECK_RESULT(text_file);
-  json value = json::parse(*text_file, nullptr, false);
+  const auto file = LoadAssetFile(asset_id, filename);
+  OVIS_CHECK_RESULT(file);
+  json value = json::parse(file->text(), nullptr, false);
   if (value.is_discarded()) {
     return Error("Invalid json");
   }
   return std::move(value);
 }
 
+Result<AssetView> AssetLibrary::LoadAssetFile(std::string_view asset_id, std::string_view filename) const {
+  Result<Blob> data = LoadAssetBinaryFile(asset_id, filename);
+  OVIS_CHECK_RESULT(data);
+  return AssetView(std::move(*data));
+}
+
 DirectoryAssetLibrary::DirectoryAssetLibrary(std::string_view directory)
     : directory_(std::filesystem::absolute(directory)) {
   Rescan();
@@ -50,6 +58,7 @@ std::vector<std::string> DirectoryAssetLibrary::GetAssetFileTypes(std::string_vi
 
 Result<std::string> DirectoryAssetLibrary::LoadAssetTextFile(std::string_view asset_id,
                                                              std::string_view filename) const {
+  OVIS_TRACE_DYNAMIC_ZONE(fmt::format("Load asset {}.{}", asset_id, filename));
   const auto complete_filename = GetAssetFilename(asset_id, filename);
   OVIS_CHECK_RESULT(complete_filename);
 
@@ -58,6 +67,7 @@ Result<std::string> DirectoryAssetLibrary::LoadAssetTextFile(std::string_view as
 }
 
 Result<Blob> DirectoryAssetLibrary::LoadAssetBinaryFile(std::string_view asset_id, std::string_view filename) const {
+  OVIS_TRACE_DYNAMIC_ZONE(fmt::format("Load asset {}.{}", asset_id, filename));
   const auto complete_filename = GetAssetFilename(asset_id, filename);
   OVIS_CHECK_RESULT(complete_filename);
 
@@ -65,6 +75,27 @@ Result<Blob> DirectoryAssetLibrary::LoadAssetBinaryFile(std::string_view asset_i
   return LoadBinaryFile(*complete_filename);
 }
 
+Result<AssetView> DirectoryAssetLibrary::LoadAssetFile(std::string_view asset_id, std::string_view filename) const {
+  OVIS_TRACE_DYNAMIC_ZONE(fmt::format("Load asset {}.{}", asset_id, filename));
+  const auto complete_filename = GetAssetFilename(asset_id, filename);
+  OVIS_CHECK_RESULT(complete_filename);
+
+  std::error_code error;
+  const std::uintmax_t file_size = std::filesystem::file_size(*complete_filename, error);
+  if (error || file_size < MIN_MAPPED_FILE_SIZE) {
+    LogV("Loading asset file: {}", *complete_filename);
+    Result<Blob> data = LoadBinaryFile(*complete_filename);
+    OVIS_CHECK_RESULT(data);
+    return AssetView(std::move(*data));
+  }
+
+  LogV("Mapping asset file: {}", *complete_filename);
+  Result<std::unique_ptr<MemoryMappedFile>> file = MemoryMappedFile::Open(*complete_filename);
+  OVIS_CHECK_RESULT(file);
+  std::shared_ptr<const MemoryMappedFile> shared_file = std::move(*file);
+  return AssetView(shared_file->data(), shared_file);
+}
+
 std::vector<std::string> DirectoryAssetLibrary::GetAssetsWithType(std::string_view type) const {
   const auto asset_range = assets_with_type_.equal_range(std::string(type));
   std::vector<std::string> assets;
@@ -0,0 +1,169 @@
+#include "ovis/core/asset_loader.hpp"
+
+#include <cassert>
+
+#include "ovis/utils/trace.hpp"
+
+namespace ovis {
+
+bool AssetLoadHandle::is_pending() const {
+  return request_ != nullptr && !request_->completed && !request_->cancelled;
+}
+
+void AssetLoadHandle::Cancel() {
+  if (request_ != nullptr) {
+    request_->cancelled = true;
+  }
+}
+
+AssetLoader::AssetLoader(ThreadPool* thread_pool) : thread_pool_(thread_pool) {
+  assert(thread_pool != nullptr);
+}
+
+AssetLoader::~AssetLoader() {
+  std::unique_lock lock(mutex_);
+  stopping_ = true;
+  // Every request has a task in the pool that refers to the loader, so all of them have to run before it is destroyed
+  all_loaded_.wait(lock, [this]() { return loading_request_count_ == 0; });
+}
+
+AssetLoadHandle AssetLoader::LoadTextFile(const AssetLibrary* asset_library, std::string asset_id,
+                                          std::string filename, AssetLoadPriority priority,
+                                          std::function<void(Result<std::string>&&)> complete) {
+  assert(asset_library != nullptr);
+  return Load<std::string>(
+      priority,
+      [asset_library, asset_id = std::move(asset_id), filename = std::move(filename)]() {
+        return asset_library->LoadAssetTextFile(asset_id, filename);
+      },
+      std::move(complete));
+}
+
+AssetLoadHandle AssetLoader::LoadBinaryFile(const AssetLibrary* asset_library, std::string asset_id,
+                                            std::string filename, AssetLoadPriority priority,
+                                            std::function<void(Result<Blob>&&)> complete) {
+  assert(asset_library != nullptr);
+  return Load<Blob>(
+      priority,
+      [asset_library, asset_id = std::move(asset_id), filename = std::move(filename)]() {
+        return asset_library->LoadAssetBinaryFile(asset_id, filename);
+      },
+      std::move(complete));
+}
+
+AssetLoadHandle AssetLoader::LoadFile(const AssetLibrary* asset_library, std::string asset_id, std::string filename,
+                                      AssetLoadPriority priority,
+                                      std::function<void(Result<AssetView>&&)> complete) {
+  assert(asset_library != nullptr);
+  return Load<AssetView>(
+      priority,
+      [asset_library, asset_id = std::move(asset_id), filename = std::move(filename)]() {
+        return asset_library->LoadAssetFile(asset_id, filename);
+      },
+      std::move(complete));
+}
+
+std::size_t AssetLoader::ProcessCompletions(std::chrono::microseconds time_budget) {
+  OVIS_TRACE_ZONE("AssetLoader::ProcessCompletions");
+  const auto start_time = std::chrono::steady_clock::now();
+
+  std::vector<Completion> completions;
+  {
+    std::lock_guard lock(mutex_);
+    completions.swap(completions_);
+  }
+
+  std::size_t completed_count = 0;
+  std::size_t processed_count = 0;
+  for (; processed_count < completions.size(); ++processed_count) {
+    // At least one request is completed per call, so a single large asset cannot stall the queue
+    if (completed_count > 0 && std::chrono::steady_clock::now() - start_time >= time_budget) {
+      break;
+    }
+    Completion& completion = completions[processed_count];
+    if (!completion.request->cancelled) {
+      completion.complete();
+      completion.request->completed = true;
+      ++completed_count;
+    }
+  }
+
+  if (processed_count < completions.size()) {
+    std::lock_guard lock(mutex_);
+    completions_.insert(completions_.begin(), std::make_move_iterator(completions.begin() + processed_count),
+                        std::make_move_iterator(completions.end()));
+  }
+  return completed_count;
+}
+
+void AssetLoader::CompleteAll() {
+  {
+    std::unique_lock lock(mutex_);
+    all_loaded_.wait(lock, [this]() { return loading_request_count_ == 0; });
+  }
+  ProcessCompletions();
+}
+
+std::size_t AssetLoader::pending_request_count() const {
+  std::lock_guard lock(mutex_);
+  return loading_request_count_ + completions_.size();
+}
+
+AssetLoadHandle AssetLoader::Enqueue(AssetLoadPriority priority, std::function<std::function<void()>()> load) {
+  auto request = std::make_shared<detail::AssetLoadRequest>();
+  request->priority = priority;
+  request->load = std::move(load);
+  {
+    std::lock_guard lock(mutex_);
+    assert(!stopping_);
+    request->sequence_number = next_sequence_number_++;
+    queued_requests_.push(request);
+    ++loading_request_count_;
+  }
+
+  // Each task loads the queued request with the highest priority at the time it runs, which is not necessarily this one
+  thread_pool_->Submit([this]() { LoadNextRequest(); });
+  return AssetLoadHandle(std::move(request));
+}
+
+void AssetLoader::LoadNextRequest() {
+  std::shared_ptr<detail::AssetLoadRequest> request;
+  bool stopping;
+  {
+    std::lock_guard lock(mutex_);
+    assert(!queued_requests_.empty());
+    request = queued_requests_.top();
+    queued_requests_.pop();
+    stopping = stopping_;
+  }
+
+  std::function<void()> complete;
+  if (!stopping && !request->cancelled) {
+    OVIS_TRACE_ZONE("AssetLoader::Load");
+    complete = request->load();
+  }
+  // The load function may hold resources of the request that are not needed anymore
+  request->load = nullptr;
+
+  std::lock_guard lock(mutex_);
+  if (complete) {
+    completions_.push_back({.request = std::move(request), .complete = std::move(complete)});
+  }
+  --loading_request_count_;
+  // Notified while the mutex is locked, so the destructor cannot finish before this returns
+  all_loaded_.notify_all();
+}
+
+AssetLoader* GetDefaultAssetLoader() {
+#if OVIS_EMSCRIPTEN
+  // Without threads the requests are loaded immediately, but they are still completed in ProcessCompletions()
+  static ThreadPool thread_pool(0);
+#else
+  // Loading mostly waits for the disk, so a few threads are enough to keep it busy
+  static ThreadPool thread_pool(2);
+#endif
+  static AssetLoader asset_loader(&thread_pool);
+  return &asset_loader;
+}
+
+}  // namespace ovis
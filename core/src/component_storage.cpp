@@ -1,5 +1,9 @@
 #include "ovis/core/component_storage.hpp"
 
+#include <algorithm>
+#include <string>
+#include <utility>
+
 #include "ovis/core/main_vm.hpp"
 #include "ovis/core/scene.hpp"
 
@@ -51,6 +55,184 @@ Result<> ComponentStorage::Resize(ContiguousStorage::SizeType size) {
   return Success;
 }
 
+void ComponentStorage::Reset(ContiguousStorage::SizeType capacity) {
+  for (ContiguousStorage::SizeType i = 0; i < flags_.size(); ++i) {
+    if (flags_[i]) {
+      storage_.Destruct(i);
+    }
+  }
+  if (capacity != storage_.capacity()) {
+    ContiguousStorage new_storage(component_type()->memory_layout(), capacity);
+    swap(storage_, new_storage);
+  }
+  flags_.assign(capacity, false);
+}
+
+Result<> ComponentStorage::SerializeColumn(SceneBinaryWriter* writer) const {
+  const Type* type = component_type();
+
+  std::vector<SceneBinaryRange> ranges;
+  std::size_t component_count = 0;
+  for (ContiguousStorage::SizeType i = 0; i < flags_.size(); ++i) {
+    if (!flags_[i]) {
+      continue;
+    }
+    if (!ranges.empty() && ranges.back().first_index + ranges.back().count == i) {
+      ++ranges.back().count;
+    } else {
+      ranges.push_back({.first_index = i, .count = 1});
+    }
+    ++component_count;
+  }
+
+  const bool is_raw = IsRawSerializable(type);
+  Blob encoded_components;
+  if (!is_raw) {
+    SceneBinaryWriter component_writer(&encoded_components);
+    for (const auto& range : ranges) {
+      for (ContiguousStorage::SizeType i = range.first_index; i < range.first_index + range.count; ++i) {
+        OVIS_CHECK_RESULT(SerializeValue(type, storage_[i], &component_writer));
+      }
+    }
+  }
+
+  const std::string type_name = type->GetReferenceString();
+  writer->Write(SceneBinaryColumnHeader{
+      .version = SCENE_BINARY_COLUMN_VERSION,
+      .encoding = is_raw ? SceneBinaryColumnEncoding::RAW : SceneBinaryColumnEncoding::PROPERTIES,
+      .component_size = static_cast<std::uint32_t>(type->size_in_bytes()),
+      .component_alignment = static_cast<std::uint32_t>(type->alignment_in_bytes()),
+      .type_name_size = static_cast<std::uint32_t>(type_name.size()),
+      .range_count = static_cast<std::uint32_t>(ranges.size()),
+      .data_size = is_raw ? component_count * type->size_in_bytes() : encoded_components.size(),
+  });
+  writer->Write(std::as_bytes(std::span(type_name)));
+  writer->Write(std::span<const SceneBinaryRange>(ranges));
+  writer->Align(type->alignment_in_bytes());
+  if (is_raw) {
+    for (const auto& range : ranges) {
+      writer->Write(std::span(static_cast<const std::byte*>(storage_[range.first_index]),
+                              range.count * type->size_in_bytes()));
+    }
+  } else {
+    writer->Write(encoded_components);
+  }
+
+  return Success;
+}
+
+Result<ComponentStorage::Column> ComponentStorage::ReadColumn(const SceneBinaryColumnHeader& header,
+                                                              ContiguousStorage::SizeType capacity,
+                                                              SceneBinaryReader* reader) const {
+  const Type* type = component_type();
+  const std::size_t component_size = type->size_in_bytes();
+
+  if (header.version != SCENE_BINARY_COLUMN_VERSION) {
+    return Error("Unsupported version {} of the column {}", header.version, type->GetReferenceString());
+  }
+  if (header.component_alignment == 0) {
+    return Error("Invalid alignment for column {}", type->GetReferenceString());
+  }
+  switch (header.encoding) {
+    case SceneBinaryColumnEncoding::RAW:
+      if (!IsRawSerializable(type) || header.component_size != component_size ||
+          header.component_alignment != type->alignment_in_bytes()) {
+        return Error("The memory layout of {} changed since the scene has been written", type->GetReferenceString());
+      }
+      break;
+
+    case SceneBinaryColumnEncoding::PROPERTIES:
+      if (!type->memory_layout().is_constructible) {
+        return Error("{} is not constructible", type->GetReferenceString());
+      }
+      break;
+
+    default:
+      return Error("Invalid encoding of column {}", type->GetReferenceString());
+  }
+
+  auto ranges = reader->ReadVector<SceneBinaryRange>(header.range_count);
+  if (!ranges) {
+    return ranges.error();
+  }
+  Column column = {.ranges = std::move(*ranges)};
+  std::size_t component_count = 0;
+  std::size_t end_of_previous_range = 0;
+  for (const auto& range : column.ranges) {
+    if (range.first_index < end_of_previous_range || range.count > capacity ||
+        range.first_index > capacity - range.count) {
+      return Error("Invalid entity range in column {}", type->GetReferenceString());
+    }
+    end_of_previous_range = range.first_index + range.count;
+    component_count += range.count;
+  }
+
+  OVIS_CHECK_RESULT(reader->Align(header.component_alignment));
+  const auto data = reader->Read(header.data_size);
+  if (!data) {
+    return data.error();
+  }
+
+  if (header.encoding == SceneBinaryColumnEncoding::RAW && data->size() != component_count * component_size) {
+    return Error("Invalid size of column {}", type->GetReferenceString());
+  }
+  column.data = *data;
+
+  return std::move(column);
+}
+
+Result<> ComponentStorage::ValidateColumn(const SceneBinaryColumnHeader& header, ContiguousStorage::SizeType capacity,
+                                          SceneBinaryReader* reader) const {
+  const auto column = ReadColumn(header, capacity, reader);
+  if (!column) {
+    return column.error();
+  }
+  return Success;
+}
+
+Result<> ComponentStorage::DeserializeColumn(const SceneBinaryColumnHeader& header, SceneBinaryReader* reader) {
+  assert(std::none_of(flags_.begin(), flags_.end(), [](bool flag) { return flag; }));
+  const Type* type = component_type();
+  const std::size_t component_size = type->size_in_bytes();
+
+  const auto column = ReadColumn(header, storage_.capacity(), reader);
+  if (!column) {
+    return column.error();
+  }
+
+  if (header.encoding == SceneBinaryColumnEncoding::RAW) {
+    // The columns are aligned relative to the start of the scene data, so this only copies if the data itself is not
+    // sufficiently aligned
+    Blob aligned_data;
+    const std::byte* source = column->data.data();
+    if (reinterpret_cast<std::uintptr_t>(source) % type->alignment_in_bytes() != 0) {
+      aligned_data.assign(column->data.begin(), column->data.end());
+      source = aligned_data.data();
+    }
+
+    // Raw components are trivially copyable, so they do not need to be constructed before copying into them
+    for (const auto& range : column->ranges) {
+      OVIS_CHECK_RESULT(storage_.CopyToRange(range.first_index, range.count, source));
+      std::fill_n(flags_.begin() + range.first_index, range.count, true);
+      source += range.count * component_size;
+    }
+  } else {
+    SceneBinaryReader component_reader(column->data);
+    for (const auto& range : column->ranges) {
+      OVIS_CHECK_RESULT(storage_.ConstructRange(range.first_index, range.count));
+      std::fill_n(flags_.begin() + range.first_index, range.count, true);
+      for (ContiguousStorage::SizeType i = range.first_index; i < range.first_index + range.count; ++i) {
+        OVIS_CHECK_RESULT(DeserializeValue(type, storage_[i], &component_reader));
+      }
+    }
+    if (component_reader.remaining_size() != 0) {
+      return Error("Invalid size of column {}", type->GetReferenceString());
+    }
+  }
+
+  return Success;
+}
+
 Result<> ComponentStorage::AddComponent(EntityId object_id) {
   if (!scene()->IsEntityIdValid(object_id)) {
     return Error("Invalid entity id");
@@ -1,8 +1,87 @@
 #include "ovis/core/event_storage.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
 #include "ovis/core/main_vm.hpp"
 
 namespace ovis {
 
-EventStorage::EventStorage(TypeId event_type_id) : events_(event_type_id, main_vm) {}
+EventBuffer::EventBuffer(TypeId event_type_id, SizeType initial_capacity) : events_(event_type_id, main_vm) {
+  const auto result = Reserve(initial_capacity);
+  assert(result);  // Reserving can only fail when copying existing events, but the buffer is still empty
+}
+
+Result<> EventBuffer::Reserve(SizeType capacity) {
+  propagation_mask_.reserve((capacity + BITS_PER_WORD - 1) / BITS_PER_WORD);
+  return events_.Reserve(capacity);
+}
+
+Result<> EventBuffer::Append(const EventBuffer& other) {
+  const SizeType offset = size();
+  OVIS_CHECK_RESULT(events_.Append(other.events_));
+  for (SizeType i = 0; i < other.size(); ++i) {
+    const SizeType index = offset + i;
+    if (index % BITS_PER_WORD == 0) {
+      propagation_mask_.push_back(0);
+    }
+    if (other.IsEventPropagating(i)) {
+      propagation_mask_.back() |= std::uint64_t(1) << (index % BITS_PER_WORD);
+    }
+  }
+  return Success;
+}
+
+EventStorage::EventStorage(TypeId event_type_id, SizeType initial_capacity)
+    : current_frame_events_(event_type_id, initial_capacity), previous_frame_events_(event_type_id, initial_capacity) {}
+
+Result<> EventStorage::Reserve(SizeType capacity) {
+  OVIS_CHECK_RESULT(current_frame_events_.Reserve(capacity));
+  OVIS_CHECK_RESULT(previous_frame_events_.Reserve(capacity));
+  return Success;
+}
+
+void EventStorage::SwapBuffers() {
+  using std::swap;
+  swap(current_frame_events_, previous_frame_events_);
+  current_frame_events_.Clear();
+}
+
+void EventStorage::SetProducerCount(std::size_t producer_count) {
+  if (producer_count < producer_buffers_.size()) {
+    producer_buffers_.erase(producer_buffers_.begin() + producer_count, producer_buffers_.end());
+  }
+  producer_buffers_.reserve(producer_count);
+  while (producer_buffers_.size() < producer_count) {
+    producer_buffers_.push_back(std::make_unique<EventBuffer>(event_type_id(), 0));
+  }
+}
+
+Result<> EventStorage::MergeProducerBuffers() {
+  const auto is_not_empty = [](const std::unique_ptr<EventBuffer>& buffer) { return buffer->size() > 0; };
+  const auto non_empty_buffers = std::count_if(producer_buffers_.begin(), producer_buffers_.end(), is_not_empty);
+  if (non_empty_buffers == 0) {
+    return Success;
+  }
+
+  if (non_empty_buffers == 1 && current_frame_events_.size() == 0) {
+    // Only a single producer emitted events, so just take its buffer.
+    EventBuffer* producer_buffer =
+        std::find_if(producer_buffers_.begin(), producer_buffers_.end(), is_not_empty)->get();
+    using std::swap;
+    swap(current_frame_events_, *producer_buffer);
+    producer_buffer->Clear();
+    return Success;
+  }
+
+  for (auto& producer_buffer : producer_buffers_) {
+    if (producer_buffer->size() > 0) {
+      OVIS_CHECK_RESULT(current_frame_events_.Append(*producer_buffer));
+      producer_buffer->Clear();
+    }
+  }
+  return Success;
+}
 
 }  // namespace ovis
@@ -0,0 +1,72 @@
+#include "ovis/core/job_statistics.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <fmt/format.h>
+
+#include "ovis/utils/profiling.hpp"
+
+namespace ovis {
+
+JobStatistics::JobStatistics(std::string_view job_id, std::size_t window_size)
+    : job_id_(job_id), window_size_(window_size) {
+  assert(window_size > 0);
+  frames_.reserve(window_size);
+}
+
+void JobStatistics::AddFrame(const JobFrameStatistics& frame) {
+  if (frames_.size() < window_size_) {
+    frames_.push_back(frame);
+  } else {
+    frames_[next_frame_index_] = frame;
+  }
+  next_frame_index_ = (next_frame_index_ + 1) % window_size_;
+  ++execution_count_;
+}
+
+const JobFrameStatistics& JobStatistics::last_frame() const {
+  assert(!frames_.empty());
+  return frames_[(next_frame_index_ + window_size_ - 1) % window_size_];
+}
+
+void JobStatistics::Write(ProfilingLog* log) const {
+  assert(log != nullptr);
+
+  const auto write = [this, log](std::string_view name, const StatisticSummary& summary, const std::string& unit) {
+    log->Write(fmt::format("Job::{}::{}::P50", job_id_, name), summary.p50, unit);
+    log->Write(fmt::format("Job::{}::{}::P99", job_id_, name), summary.p99, unit);
+    log->Write(fmt::format("Job::{}::{}::Max", job_id_, name), summary.max, unit);
+  };
+  write("WallTime", wall_time(), "ms");
+  write("ProcessedEntities", processed_entity_count(), "count");
+  write("ReadEvents", read_event_count(), "count");
+  write("EmittedEvents", emitted_event_count(), "count");
+  write("Allocations", allocation_count(), "count");
+}
+
+template <typename T>
+StatisticSummary JobStatistics::Summarize(T JobFrameStatistics::*statistic) const {
+  if (frames_.empty()) {
+    return {0.0, 0.0, 0.0};
+  }
+
+  std::vector<double> values(frames_.size());
+  std::transform(frames_.begin(), frames_.end(), values.begin(),
+                 [statistic](const JobFrameStatistics& frame) { return static_cast<double>(frame.*statistic); });
+  std::sort(values.begin(), values.end());
+
+  // Nearest-rank percentiles
+  const auto percentile = [&values](double p) {
+    const auto rank = static_cast<std::size_t>(std::ceil(p * values.size()));
+    return values[std::max<std::size_t>(rank, 1) - 1];
+  };
+  return {
+      .p50 = percentile(0.5),
+      .p99 = percentile(0.99),
+      .max = values.back(),
+  };
+}
+
+}  // namespace ovis
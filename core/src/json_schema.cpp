@@ -26,13 +26,13 @@ std::shared_ptr<json> LoadJsonSchema(AssetLibrary* asset_library, const std::str
     return nullptr;
   }
 
-  Result<std::string> serialized_schema = asset_library->LoadAssetTextFile(name, "json");
-  if (!serialized_schema) {
+  Result<json> schema = asset_library->LoadAssetJsonFile(name, "json");
+  if (!schema) {
     LogE("Cannot load schema: {}", name);
     return nullptr;
   }
 
-  return cached_schemas[name] = std::make_shared<json>(json::parse(*serialized_schema));
+  return cached_schemas[name] = std::make_shared<json>(std::move(*schema));
 }
 
 std::shared_ptr<json> LoadJsonSchema(const std::string& name, bool use_cache) {
@@ -1,8 +1,11 @@
 #include "ovis/core/scene.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <iterator>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "ovis/utils/log.hpp"
 #include "ovis/utils/utf8.hpp"
@@ -13,17 +16,7 @@
 namespace ovis {
 
 Scene::Scene(std::size_t initial_entity_capacity) {
-  entities_.reserve(initial_entity_capacity);
-  for (std::size_t i = 0; i < initial_entity_capacity; ++i) {
-    entities_.push_back(Entity {
-      .id = EntityId::CreateInactive(i),
-      .parent_id = EntityId::CreateInactive(i),
-      .first_children_id = EntityId::CreateInactive(i),
-      .previous_sibling_id = EntityId::CreateInactive(i > 0 ? i - 1 : initial_entity_capacity - 1),
-      .next_sibling_id = EntityId::CreateInactive((i + 1) % initial_entity_capacity),
-    });
-  }
-  first_inactive_entity_.emplace(EntityId::CreateInactive(0));
+  ResetEntities(initial_entity_capacity);
 }
 
 Scene::~Scene() {
@@ -49,6 +42,7 @@ Entity* Scene::CreateEntity(std::string_view object_name, std::optional<EntityId
   }
 
   entity->id.flags = 1;
+  entity->name = object_name;
 
   if (parent_id) {
     Entity* parent = GetEntity(*parent_id);
@@ -106,6 +100,10 @@ Entity* Scene::GetEntityUnchecked(EntityId id) {
 // }
 
 
+void Scene::ClearEntities() {
+  ResetEntities(entities_.size());
+}
+
 Scene::EntityIterator Scene::begin() {
   return {
     .scene = this,
@@ -120,22 +118,11 @@ Scene::EntityIterator Scene::end() {
   };
 }
 
-ComponentStorage* Scene::GetComponentStorage(TypeId component_type) {
-  for (auto& storage : component_storages_) {
-    if (storage.component_type_id() == component_type) {
-      return &storage;
-    }
-  }
-  return nullptr;
-}
-
-EventStorage* Scene::GetEventStorage(TypeId event_type) {
+Result<> Scene::MergeEventProducerBuffers() {
   for (auto& storage : event_storages_) {
-    if (storage.event_type_id() == event_type) {
-      return &storage;
-    }
+    OVIS_CHECK_RESULT(storage.MergeProducerBuffers());
   }
-  return nullptr;
+  return Success;
 }
 
 // void Scene::ClearEntities() {
@@ -171,6 +158,25 @@ Result<> Scene::Prepare() {
       component_storages_.emplace_back(this, component_type, entities_.size());
       LogV(" - {}", main_vm->GetType(component_type)->GetReferenceString());
     }
+
+    component_storage_lookup_.clear();
+    for (auto& storage : component_storages_) {
+      const auto index = storage.component_type_id().index;
+      if (index >= component_storage_lookup_.size()) {
+        component_storage_lookup_.resize(index + 1, nullptr);
+      }
+      component_storage_lookup_[index] = &storage;
+    }
+  }
+  {
+    const auto scene_component_types = frame_scheduler().GetUsedSceneComponents();
+    scene_components_.Clear();
+
+    LogV(" Used scene components:");
+    for (const auto component_type : scene_component_types) {
+      OVIS_CHECK_RESULT(scene_components_.AddComponent(component_type));
+      LogV(" - {}", main_vm->GetType(component_type)->GetReferenceString());
+    }
   }
   {
     const auto event_types = frame_scheduler().GetUsedEvents();
@@ -179,9 +185,18 @@ Result<> Scene::Prepare() {
 
     LogV(" Used events:");
     for (const auto event_type : event_types) {
-      event_storages_.emplace_back(event_type);
+      event_storages_.emplace_back(event_type).SetProducerCount(event_producer_count_);
       LogV(" - {}", main_vm->GetType(event_type)->GetReferenceString());
     }
+
+    event_storage_lookup_.clear();
+    for (auto& storage : event_storages_) {
+      const auto index = storage.event_type_id().index;
+      if (index >= event_storage_lookup_.size()) {
+        event_storage_lookup_.resize(index + 1, nullptr);
+      }
+      event_storage_lookup_[index] = &storage;
+    }
   }
   return frame_scheduler_.Prepare(this);
 }
@@ -197,9 +212,10 @@ void Scene::Stop() {
 void Scene::Update(float delta_time) {
   assert(is_playing() && "Call Play() before calling Update().");
   for (auto& event_storage : event_storages_) {
-    event_storage.Clear();
+    event_storage.SwapBuffers();
   }
   frame_scheduler_(SceneUpdate{.scene = this, .delta_time = delta_time});
+  LogOnError(MergeEventProducerBuffers());
 }
 
 json Scene::Serialize() const {
@@ -269,6 +285,202 @@ bool Scene::Deserialize(const json& serialized_object) {
  return true;
 }
 
+Result<Blob> Scene::SerializeBinary() const {
+  const auto get_index = [](const std::optional<EntityId>& id) { return id ? id->index : SCENE_BINARY_NO_ENTITY; };
+
+  std::vector<SceneBinaryEntity> binary_entities;
+  std::vector<std::uint32_t> name_sizes;
+  binary_entities.reserve(entities_.size());
+  name_sizes.reserve(entities_.size());
+  std::size_t name_size = 0;
+  for (const auto& entity : entities_) {
+    binary_entities.push_back({
+        .id = entity.id,
+        .parent_id = entity.parent_id,
+        .first_children_id = entity.first_children_id,
+        .previous_sibling_id = entity.previous_sibling_id,
+        .next_sibling_id = entity.next_sibling_id,
+    });
+    name_sizes.push_back(static_cast<std::uint32_t>(entity.name.size()));
+    name_size += entity.name.size();
+  }
+
+  SceneBinaryHeader header = {
+      .version = SCENE_BINARY_VERSION,
+      .entity_capacity = static_cast<std::uint32_t>(entities_.size()),
+      .column_count = static_cast<std::uint32_t>(component_storages_.size()),
+      .first_active_entity = get_index(first_active_entity_),
+      .last_active_entity = get_index(last_active_entity_),
+      .first_inactive_entity = get_index(first_inactive_entity_),
+      .name_size = static_cast<std::uint32_t>(name_size),
+  };
+  std::memcpy(header.magic, SCENE_BINARY_MAGIC, sizeof(header.magic));
+
+  Blob data;
+  data.reserve(sizeof(header) + binary_entities.size() * sizeof(SceneBinaryEntity) +
+               name_sizes.size() * sizeof(std::uint32_t) + name_size);
+  SceneBinaryWriter writer(&data);
+  writer.Write(header);
+  writer.Write(std::span<const SceneBinaryEntity>(binary_entities));
+  writer.Write(std::span<const std::uint32_t>(name_sizes));
+  for (const auto& entity : entities_) {
+    writer.Write(std::as_bytes(std::span(entity.name)));
+  }
+  for (const auto& storage : component_storages_) {
+    OVIS_CHECK_RESULT(storage.SerializeColumn(&writer));
+  }
+
+  return std::move(data);
+}
+
+Result<> Scene::DeserializeBinary(std::span<const std::byte> data) {
+  SceneBinaryReader reader(data);
+
+  SceneBinaryHeader header;
+  OVIS_CHECK_RESULT(reader.Read(&header));
+  if (std::memcmp(header.magic, SCENE_BINARY_MAGIC, sizeof(header.magic)) != 0) {
+    return Error("Invalid binary scene");
+  }
+  if (header.version != SCENE_BINARY_VERSION) {
+    return Error("Unsupported binary scene version {}, expected {}", header.version, SCENE_BINARY_VERSION);
+  }
+  const std::uint32_t capacity = header.entity_capacity;
+  const auto is_valid_index = [capacity](std::uint32_t index) {
+    return index == SCENE_BINARY_NO_ENTITY || index < capacity;
+  };
+  if (capacity == 0 || !is_valid_index(header.first_active_entity) || !is_valid_index(header.last_active_entity) ||
+      !is_valid_index(header.first_inactive_entity)) {
+    return Error("Invalid binary scene header");
+  }
+
+  // Validate everything that can be validated up front, so the scene is not modified if the data is invalid
+  const auto binary_entities_result = reader.ReadVector<SceneBinaryEntity>(capacity);
+  if (!binary_entities_result) {
+    return binary_entities_result.error();
+  }
+  const std::vector<SceneBinaryEntity>& binary_entities = *binary_entities_result;
+  for (std::uint32_t i = 0; i < capacity; ++i) {
+    const auto& entity = binary_entities[i];
+    if (entity.id.index != i || entity.parent_id.index >= capacity || entity.first_children_id.index >= capacity ||
+        entity.previous_sibling_id.index >= capacity || entity.next_sibling_id.index >= capacity) {
+      return Error("Invalid entity at index {} in binary scene", i);
+    }
+  }
+  const auto name_sizes_result = reader.ReadVector<std::uint32_t>(capacity);
+  if (!name_sizes_result) {
+    return name_sizes_result.error();
+  }
+  const std::vector<std::uint32_t>& name_sizes = *name_sizes_result;
+  std::size_t name_size = 0;
+  for (const auto size : name_sizes) {
+    name_size += size;
+  }
+  if (name_size != header.name_size) {
+    return Error("Invalid entity names in binary scene");
+  }
+  const auto names = reader.Read(name_size);
+  if (!names) {
+    return names.error();
+  }
+  // The columns are validated on a copy of the reader, as they are read again when loading the components
+  SceneBinaryReader column_reader = reader;
+  OVIS_CHECK_RESULT(DeserializeComponentColumns(header.column_count, capacity, true, &column_reader));
+
+  ResetEntities(capacity);
+  const char* name = reinterpret_cast<const char*>(names->data());
+  for (std::uint32_t i = 0; i < capacity; ++i) {
+    const auto& binary_entity = binary_entities[i];
+    Entity& entity = entities_[i];
+    entity.id = binary_entity.id;
+    entity.parent_id = binary_entity.parent_id;
+    entity.first_children_id = binary_entity.first_children_id;
+    entity.previous_sibling_id = binary_entity.previous_sibling_id;
+    entity.next_sibling_id = binary_entity.next_sibling_id;
+    entity.name.assign(name, name_sizes[i]);
+    name += name_sizes[i];
+  }
+  const auto get_id = [this](std::uint32_t index) -> std::optional<EntityId> {
+    return index == SCENE_BINARY_NO_ENTITY ? std::nullopt : std::make_optional(entities_[index].id);
+  };
+  first_active_entity_ = get_id(header.first_active_entity);
+  last_active_entity_ = get_id(header.last_active_entity);
+  first_inactive_entity_ = get_id(header.first_inactive_entity);
+
+  if (auto result = DeserializeComponentColumns(header.column_count, capacity, false, &reader); !result) {
+    ResetEntities(capacity);
+    return result.error();
+  }
+
+  return Success;
+}
+
+void Scene::ResetEntities(std::size_t capacity) {
+  entities_.clear();
+  entities_.reserve(capacity);
+  for (std::size_t i = 0; i < capacity; ++i) {
+    entities_.push_back(Entity {
+      .id = EntityId::CreateInactive(i),
+      .parent_id = EntityId::CreateInactive(i),
+      .first_children_id = EntityId::CreateInactive(i),
+      .previous_sibling_id = EntityId::CreateInactive(i > 0 ? i - 1 : capacity - 1),
+      .next_sibling_id = EntityId::CreateInactive((i + 1) % capacity),
+    });
+  }
+  first_active_entity_.reset();
+  last_active_entity_.reset();
+  if (capacity > 0) {
+    first_inactive_entity_.emplace(EntityId::CreateInactive(0));
+  } else {
+    first_inactive_entity_.reset();
+  }
+
+  for (auto& storage : component_storages_) {
+    storage.Reset(capacity);
+  }
+}
+
+Result<> Scene::DeserializeComponentColumns(std::uint32_t column_count, std::uint32_t capacity, bool validate_only,
+                                            SceneBinaryReader* reader) {
+  // A second column of the same type would add components that already exist
+  std::vector<const ComponentStorage*> deserialized_storages;
+  for (std::uint32_t i = 0; i < column_count; ++i) {
+    SceneBinaryColumnHeader header;
+    OVIS_CHECK_RESULT(reader->Read(&header));
+    const auto type_name_bytes = reader->Read(header.type_name_size);
+    if (!type_name_bytes) {
+      return type_name_bytes.error();
+    }
+    const std::string type_name(reinterpret_cast<const char*>(type_name_bytes->data()), type_name_bytes->size());
+
+    const Type* type = main_vm->GetType(json(type_name));
+    ComponentStorage* storage = type ? GetComponentStorage(type->id()) : nullptr;
+    if (storage) {
+      if (std::find(deserialized_storages.begin(), deserialized_storages.end(), storage) !=
+          deserialized_storages.end()) {
+        return Error("Duplicate column for components of type {}", type_name);
+      }
+      deserialized_storages.push_back(storage);
+    }
+    if (storage && validate_only) {
+      OVIS_CHECK_RESULT(storage->ValidateColumn(header, capacity, reader));
+    } else if (storage) {
+      OVIS_CHECK_RESULT(storage->DeserializeColumn(header, reader));
+    } else {
+      if (!validate_only) {
+        LogW("Skipping the components of type {} as they are not used by the scene", type_name);
+      }
+      if (header.component_alignment == 0) {
+        return Error("Invalid alignment for column {}", type_name);
+      }
+      OVIS_CHECK_RESULT(reader->Read(header.range_count * sizeof(SceneBinaryRange)));
+      OVIS_CHECK_RESULT(reader->Align(header.component_alignment));
+      OVIS_CHECK_RESULT(reader->Read(header.data_size));
+    }
+  }
+
+  return Success;
+}
+
 EntityId Scene::InsertSibling(EntityId first_sibling_id, EntityId new_sibling_id) {
   Entity* first_sibling = GetEntityUnchecked(first_sibling_id);
   EntityId last_sibling_id = first_sibling->previous_sibling_id;
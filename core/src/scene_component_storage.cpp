@@ -0,0 +1,35 @@
+#include "ovis/core/scene_component_storage.hpp"
+
+namespace ovis {
+
+SceneComponentStorage::~SceneComponentStorage() {
+  Clear();
+}
+
+Result<> SceneComponentStorage::AddComponent(TypeId component_type) {
+  if (HasComponent(component_type)) {
+    return Error("Scene component {} already exists", main_vm->GetType(component_type)->name());
+  }
+  if (component_type.index >= components_.size()) {
+    components_.resize(component_type.index + 1);
+  }
+
+  auto storage = std::make_unique<ContiguousStorage>(main_vm->GetType(component_type)->memory_layout(), 1);
+  OVIS_CHECK_RESULT(storage->Construct(0));
+  components_[component_type.index] = {
+    .type_id = component_type,
+    .storage = std::move(storage),
+  };
+  return Success;
+}
+
+void SceneComponentStorage::Clear() {
+  for (auto& component : components_) {
+    if (component.storage) {
+      component.storage->Destruct(0);
+    }
+  }
+  components_.clear();
+}
+
+}  // namespace ovis
@@ -0,0 +1,76 @@
+#include "ovis/core/scene_serialization.hpp"
+
+#include <string>
+#include <variant>
+
+#include "ovis/utils/memory.hpp"
+#include "ovis/vm/virtual_machine.hpp"
+
+namespace ovis {
+
+bool IsRawSerializable(const Type* type) {
+  return type->memory_layout().is_copyable && type->trivially_copyable() && type->trivially_destructible();
+}
+
+Result<> SerializeValue(const Type* type, const void* value, SceneBinaryWriter* writer) {
+  if (IsRawSerializable(type)) {
+    writer->Write(std::span(static_cast<const std::byte*>(value), type->size_in_bytes()));
+    return Success;
+  }
+
+  if (type->id() == type->virtual_machine()->GetTypeId<std::string>()) {
+    writer->WriteString(*static_cast<const std::string*>(value));
+    return Success;
+  }
+
+  if (type->properties().empty()) {
+    return Error("Values of type {} cannot be serialized", type->GetReferenceString());
+  }
+  for (const auto& property : type->properties()) {
+    const auto* primitive_access = std::get_if<TypePropertyDescription::PrimitiveAccess>(&property.access);
+    if (!primitive_access) {
+      return Error("Cannot serialize property {} of {}: only properties without getter and setter are supported",
+                   property.name, type->GetReferenceString());
+    }
+    const Type* property_type = type->virtual_machine()->GetType(property.type);
+    if (!property_type) {
+      return Error("Cannot serialize property {} of {}: invalid type", property.name, type->GetReferenceString());
+    }
+    OVIS_CHECK_RESULT(SerializeValue(property_type, OffsetAddress(value, primitive_access->offset), writer));
+  }
+  return Success;
+}
+
+Result<> DeserializeValue(const Type* type, void* value, SceneBinaryReader* reader) {
+  if (IsRawSerializable(type)) {
+    return reader->Read(std::span(static_cast<std::byte*>(value), type->size_in_bytes()));
+  }
+
+  if (type->id() == type->virtual_machine()->GetTypeId<std::string>()) {
+    const auto string = reader->ReadString();
+    if (!string) {
+      return string.error();
+    }
+    static_cast<std::string*>(value)->assign(*string);
+    return Success;
+  }
+
+  if (type->properties().empty()) {
+    return Error("Values of type {} cannot be deserialized", type->GetReferenceString());
+  }
+  for (const auto& property : type->properties()) {
+    const auto* primitive_access = std::get_if<TypePropertyDescription::PrimitiveAccess>(&property.access);
+    if (!primitive_access) {
+      return Error("Cannot deserialize property {} of {}: only properties without getter and setter are supported",
+                   property.name, type->GetReferenceString());
+    }
+    const Type* property_type = type->virtual_machine()->GetType(property.type);
+    if (!property_type) {
+      return Error("Cannot deserialize property {} of {}: invalid type", property.name, type->GetReferenceString());
+    }
+    OVIS_CHECK_RESULT(DeserializeValue(property_type, OffsetAddress(value, primitive_access->offset), reader));
+  }
+  return Success;
+}
+
+}  // namespace ovis
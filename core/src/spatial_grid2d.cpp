@@ -0,0 +1,147 @@
+#include "ovis/core/spatial_grid2d.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ovis {
+
+SpatialGrid2D::SpatialGrid2D(float cell_size) : cell_size_(cell_size) {
+  assert(cell_size > 0.0f);
+}
+
+void SpatialGrid2D::Update(std::uint32_t id, const AxisAlignedBoundingBox2D& bounds) {
+  if (id >= objects_.size()) {
+    objects_.resize(id + 1);
+  }
+  Object& object = objects_[id];
+  const CellRange cells = ComputeCellRange(bounds);
+
+  if (object.in_grid && object.cells == cells) {
+    object.bounds = bounds;
+    return;
+  }
+
+  if (object.in_grid) {
+    RemoveFromCells(id, object);
+  }
+  object.bounds = bounds;
+  object.cells = cells;
+  object.in_grid = true;
+  object.large = cells.cell_count() > MAX_CELLS_PER_OBJECT;
+  AddToCells(id, object);
+}
+
+void SpatialGrid2D::Remove(std::uint32_t id) {
+  if (!Contains(id)) {
+    return;
+  }
+  RemoveFromCells(id, objects_[id]);
+  objects_[id].in_grid = false;
+}
+
+void SpatialGrid2D::Clear() {
+  objects_.clear();
+  cells_.clear();
+  large_objects_.clear();
+}
+
+void SpatialGrid2D::Query(const AxisAlignedBoundingBox2D& region, std::vector<std::uint32_t>* ids) const {
+  assert(ids != nullptr);
+
+  if (query_marks_.size() < objects_.size()) {
+    query_marks_.resize(objects_.size(), 0);
+  }
+  ++query_generation_;
+  if (query_generation_ == 0) {
+    std::fill(query_marks_.begin(), query_marks_.end(), 0);
+    query_generation_ = 1;
+  }
+
+  const auto visit = [&](std::uint32_t id) {
+    if (query_marks_[id] != query_generation_) {
+      query_marks_[id] = query_generation_;
+      if (DoAABBsOverlap(objects_[id].bounds, region)) {
+        ids->push_back(id);
+      }
+    }
+  };
+
+  const CellRange cells = ComputeCellRange(region);
+  if (cells.cell_count() > cells_.size()) {
+    // The region covers more cells than are occupied, so iterate the occupied cells instead
+    for (const auto& [key, cell] : cells_) {
+      const std::int32_t x = static_cast<std::int32_t>(static_cast<std::uint32_t>(key >> 32));
+      const std::int32_t y = static_cast<std::int32_t>(static_cast<std::uint32_t>(key));
+      if (x >= cells.min_x && x <= cells.max_x && y >= cells.min_y && y <= cells.max_y) {
+        std::for_each(cell.begin(), cell.end(), visit);
+      }
+    }
+  } else {
+    for (std::int32_t y = cells.min_y; y <= cells.max_y; ++y) {
+      for (std::int32_t x = cells.min_x; x <= cells.max_x; ++x) {
+        const auto cell = cells_.find(CellKey(x, y));
+        if (cell != cells_.end()) {
+          std::for_each(cell->second.begin(), cell->second.end(), visit);
+        }
+      }
+    }
+  }
+  std::for_each(large_objects_.begin(), large_objects_.end(), visit);
+}
+
+SpatialGrid2D::CellRange SpatialGrid2D::ComputeCellRange(const AxisAlignedBoundingBox2D& bounds) const {
+  // Clamp the cell coordinates, so huge bounds neither overflow nor get registered in billions of cells
+  static constexpr float LIMIT = 1 << 30;
+  const auto cell_coordinate = [this](float value) {
+    return static_cast<std::int32_t>(std::clamp(std::floor(value / cell_size_), -LIMIT, LIMIT));
+  };
+  const Vector2 min = bounds.min();
+  const Vector2 max = bounds.max();
+  return {
+      .min_x = cell_coordinate(min.x),
+      .min_y = cell_coordinate(min.y),
+      .max_x = cell_coordinate(max.x),
+      .max_y = cell_coordinate(max.y),
+  };
+}
+
+void SpatialGrid2D::AddToCells(std::uint32_t id, const Object& object) {
+  if (object.large) {
+    large_objects_.push_back(id);
+    return;
+  }
+
+  for (std::int32_t y = object.cells.min_y; y <= object.cells.max_y; ++y) {
+    for (std::int32_t x = object.cells.min_x; x <= object.cells.max_x; ++x) {
+      cells_[CellKey(x, y)].push_back(id);
+    }
+  }
+}
+
+void SpatialGrid2D::RemoveFromCells(std::uint32_t id, const Object& object) {
+  const auto remove_id = [id](std::vector<std::uint32_t>* ids) {
+    const auto position = std::find(ids->begin(), ids->end(), id);
+    assert(position != ids->end());
+    *position = ids->back();
+    ids->pop_back();
+  };
+
+  if (object.large) {
+    remove_id(&large_objects_);
+    return;
+  }
+
+  for (std::int32_t y = object.cells.min_y; y <= object.cells.max_y; ++y) {
+    for (std::int32_t x = object.cells.min_x; x <= object.cells.max_x; ++x) {
+      const auto cell = cells_.find(CellKey(x, y));
+      assert(cell != cells_.end());
+      remove_id(&cell->second);
+      if (cell->second.empty()) {
+        cells_.erase(cell);
+      }
+    }
+  }
+}
+
+}  // namespace ovis
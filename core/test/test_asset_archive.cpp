@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+
+#include "ovis/utils/file.hpp"
+#include "ovis/core/asset_archive.hpp"
+#include "ovis/test/require_result.hpp"
+
+using namespace ovis;
+
+TEST_CASE("Pack assets into an archive", "[ovis][core][ArchiveAssetLibrary]") {
+  const AssetArchiveCompression compression =
+      GENERATE(AssetArchiveCompression::NONE, AssetArchiveCompression::LZ4, AssetArchiveCompression::ZSTD);
+  const std::string filename = (std::filesystem::temp_directory_path() / "ovis_test_assets.pak").string();
+
+  const AssetLibrary* directory_library = GetEngineAssetLibrary();
+  REQUIRE(directory_library != nullptr);
+  REQUIRE_RESULT(WriteAssetArchive(*directory_library, filename, compression));
+
+  auto archive_library = ArchiveAssetLibrary::Open(filename);
+  REQUIRE_RESULT(archive_library);
+  REQUIRE((*archive_library)->GetAssets().size() == directory_library->GetAssets().size());
+  REQUIRE((*archive_library)->GetAssetsWithType("scene_object").size() ==
+          directory_library->GetAssetsWithType("scene_object").size());
+  REQUIRE(!(*archive_library)->Contains("does_not_exist"));
+  REQUIRE(!(*archive_library)->LoadAssetBinaryFile("template", "does_not_exist"));
+
+  for (const std::string& asset_id : directory_library->GetAssets()) {
+    REQUIRE((*archive_library)->Contains(asset_id));
+    const auto type = directory_library->GetAssetType(asset_id);
+    REQUIRE_RESULT(type);
+    REQUIRE((*archive_library)->GetAssetType(asset_id) == *type);
+
+    for (const std::string& asset_filename : directory_library->GetAssetFileTypes(asset_id)) {
+      const auto expected_data = directory_library->LoadAssetBinaryFile(asset_id, asset_filename);
+      REQUIRE_RESULT(expected_data);
+      REQUIRE((*archive_library)->LoadAssetBinaryFile(asset_id, asset_filename) == *expected_data);
+
+      const auto view = (*archive_library)->LoadAssetFile(asset_id, asset_filename);
+      REQUIRE_RESULT(view);
+      REQUIRE(Blob(view->data().begin(), view->data().end()) == *expected_data);
+      if (compression == AssetArchiveCompression::NONE) {
+        // The view refers to the mapped archive
+        REQUIRE(reinterpret_cast<std::uintptr_t>(view->data().data()) % ArchiveAssetLibrary::ENTRY_ALIGNMENT == 0);
+      }
+    }
+  }
+
+  std::filesystem::remove(filename);
+}
+
+TEST_CASE("Reject files that are not asset archives", "[ovis][core][ArchiveAssetLibrary]") {
+  const std::string filename = (std::filesystem::temp_directory_path() / "ovis_test_invalid.pak").string();
+  REQUIRE_RESULT(WriteTextFile(filename, "This is not an asset archive"));
+  REQUIRE(!ArchiveAssetLibrary::Open(filename));
+  REQUIRE(!ArchiveAssetLibrary::Open(filename + ".does_not_exist"));
+  std::filesystem::remove(filename);
+}
+
+TEST_CASE("Reject asset archives with entries outside of the file", "[ovis][core][ArchiveAssetLibrary]") {
+  const std::string filename = (std::filesystem::temp_directory_path() / "ovis_test_corrupt.pak").string();
+  const AssetLibrary* directory_library = GetEngineAssetLibrary();
+  REQUIRE(directory_library != nullptr);
+  REQUIRE_RESULT(WriteAssetArchive(*directory_library, filename, AssetArchiveCompression::NONE));
+  auto archive = LoadBinaryFile(filename);
+  REQUIRE_RESULT(archive);
+
+  // The entries offset follows the magic and the entry and bucket counts. An entry starts with its hash, the offset of
+  // its data, the stored size and the size.
+  std::uint64_t entries_offset;
+  std::memcpy(&entries_offset, archive->data() + 16, sizeof(entries_offset));
+  // The end of the data wraps around to the start of the file
+  const std::uint64_t offset = ~std::uint64_t{0};
+  const std::uint64_t size = 2;
+  std::memcpy(archive->data() + entries_offset + 8, &offset, sizeof(offset));
+  std::memcpy(archive->data() + entries_offset + 16, &size, sizeof(size));
+  std::memcpy(archive->data() + entries_offset + 24, &size, sizeof(size));
+  REQUIRE_RESULT(WriteBinaryFile(filename, *archive));
+  REQUIRE(!ArchiveAssetLibrary::Open(filename));
+
+  std::filesystem::remove(filename);
+}
@@ -0,0 +1,131 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/utils/thread_pool.hpp"
+#include "ovis/core/asset_cache.hpp"
+#include "ovis/core/asset_loader.hpp"
+
+using namespace ovis;
+
+namespace {
+
+struct CachedTexture {
+  std::size_t size;
+};
+
+AssetMemoryUsage GetAssetMemoryUsage(const CachedTexture& texture) {
+  return {.gpu_bytes = texture.size};
+}
+
+std::function<Result<std::shared_ptr<CachedTexture>>()> CreateTexture(std::size_t size, int* create_count) {
+  return [size, create_count]() -> Result<std::shared_ptr<CachedTexture>> {
+    ++*create_count;
+    return std::make_shared<CachedTexture>(CachedTexture{size});
+  };
+}
+
+}  // namespace
+
+TEST_CASE("Cache assets", "[ovis][core][AssetCache]") {
+  AssetCache asset_cache;
+  int create_count = 0;
+
+  REQUIRE(asset_cache.Find<CachedTexture>("grass", "0") == nullptr);
+  Result<std::shared_ptr<CachedTexture>> grass =
+      asset_cache.Get<CachedTexture>("grass", "0", CreateTexture(16, &create_count));
+  REQUIRE(grass.has_value());
+  Result<std::shared_ptr<CachedTexture>> cached_grass =
+      asset_cache.Get<CachedTexture>("grass", "0", CreateTexture(16, &create_count));
+  REQUIRE(cached_grass.has_value());
+  REQUIRE(*grass == *cached_grass);
+  REQUIRE(create_count == 1);
+
+  // Assets of different types or files are cached separately
+  REQUIRE(asset_cache.Find<std::string>("grass", "0") == nullptr);
+  REQUIRE(asset_cache.Find<CachedTexture>("grass", "1") == nullptr);
+
+  REQUIRE(asset_cache.statistics().hit_count == 1);
+  REQUIRE(asset_cache.statistics().miss_count == 4);
+  REQUIRE(asset_cache.memory_usage().gpu_bytes == 16);
+  REQUIRE(asset_cache.memory_usage().cpu_bytes == 0);
+}
+
+TEST_CASE("Evict the least recently used assets", "[ovis][core][AssetCache]") {
+  AssetCache asset_cache({.cpu_bytes = 0, .gpu_bytes = 30});
+
+  asset_cache.Insert("a", "0", std::make_shared<CachedTexture>(CachedTexture{10}));
+  asset_cache.Insert("b", "0", std::make_shared<CachedTexture>(CachedTexture{10}));
+  std::shared_ptr<CachedTexture> c = std::make_shared<CachedTexture>(CachedTexture{10});
+  asset_cache.Insert("c", "0", c);
+  REQUIRE(asset_cache.Find<CachedTexture>("a", "0") != nullptr);
+
+  // b is the least recently used asset
+  asset_cache.Insert("d", "0", std::make_shared<CachedTexture>(CachedTexture{10}));
+  REQUIRE(asset_cache.asset_count() == 3);
+  REQUIRE(asset_cache.statistics().eviction_count == 1);
+  REQUIRE(asset_cache.Find<CachedTexture>("b", "0") == nullptr);
+
+  // c is in use, so it is kept even though it is used less recently than a and d
+  asset_cache.SetBudget({.cpu_bytes = 0, .gpu_bytes = 10});
+  REQUIRE(asset_cache.asset_count() == 1);
+  REQUIRE(asset_cache.Find<CachedTexture>("c", "0") == c);
+  REQUIRE(asset_cache.memory_usage().gpu_bytes == 10);
+
+  // Once released, it is evicted by the next trim that exceeds the budget
+  c.reset();
+  asset_cache.SetBudget({.cpu_bytes = 0, .gpu_bytes = 0});
+  REQUIRE(asset_cache.asset_count() == 0);
+  REQUIRE(asset_cache.statistics().eviction_count == 4);
+}
+
+TEST_CASE("Load cached assets only once", "[ovis][core][AssetCache]") {
+  ThreadPool thread_pool(1);
+  AssetLoader asset_loader(&thread_pool);
+  AssetCache asset_cache;
+
+  int load_count = 0;
+  std::vector<std::shared_ptr<std::string>> ready_assets;
+  const auto request = [&]() {
+    return asset_cache.Request<std::string, std::string>(
+        "template", "json", &asset_loader, AssetLoadPriority::NORMAL,
+        [&load_count]() -> Result<std::string> {
+          ++load_count;
+          return std::string("{}");
+        },
+        [](std::string&& text) -> Result<std::shared_ptr<std::string>> {
+          return std::make_shared<std::string>(std::move(text));
+        },
+        [&ready_assets](Result<std::shared_ptr<std::string>>&& text) {
+          REQUIRE(text.has_value());
+          ready_assets.push_back(*text);
+        });
+  };
+
+  AssetLoadHandle first = request();
+  AssetLoadHandle second = request();
+  AssetLoadHandle cancelled = request();
+  cancelled.Cancel();
+  REQUIRE(asset_cache.pending_request_count() == 1);
+  REQUIRE(first.is_pending());
+
+  asset_loader.CompleteAll();
+  REQUIRE(load_count == 1);
+  REQUIRE(ready_assets.size() == 2);
+  REQUIRE(ready_assets[0] == ready_assets[1]);
+  REQUIRE(!first.is_pending());
+  REQUIRE(!second.is_pending());
+
+  // Requests for cached assets are ready immediately
+  AssetLoadHandle cached = request();
+  REQUIRE(!cached.is_pending());
+  REQUIRE(ready_assets.size() == 3);
+  REQUIRE(load_count == 1);
+
+  REQUIRE(asset_cache.statistics().miss_count == 1);
+  REQUIRE(asset_cache.statistics().joined_load_count == 2);
+  REQUIRE(asset_cache.statistics().hit_count == 1);
+  REQUIRE(asset_cache.memory_usage().cpu_bytes == ready_assets[0]->capacity());
+}
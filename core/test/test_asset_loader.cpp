@@ -0,0 +1,71 @@
+#include <future>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/utils/thread_pool.hpp"
+#include "ovis/core/asset_library.hpp"
+#include "ovis/core/asset_loader.hpp"
+
+using namespace ovis;
+
+TEST_CASE("Load asset files in the background", "[ovis][core][AssetLoader]") {
+  ThreadPool thread_pool(1);
+  AssetLoader asset_loader(&thread_pool);
+
+  std::optional<bool> loaded;
+  asset_loader.LoadTextFile(GetEngineAssetLibrary(), "template", "json", AssetLoadPriority::NORMAL,
+                            [&loaded](Result<std::string>&& text) { loaded = text.has_value() && !text->empty(); });
+  bool failed = false;
+  asset_loader.LoadBinaryFile(GetEngineAssetLibrary(), "does_not_exist", "json", AssetLoadPriority::NORMAL,
+                              [&failed](Result<Blob>&& data) { failed = !data.has_value(); });
+
+  // The completions are only called on the thread that processes them
+  REQUIRE(!loaded.has_value());
+  asset_loader.CompleteAll();
+  REQUIRE(loaded == true);
+  REQUIRE(failed);
+  REQUIRE(asset_loader.pending_request_count() == 0);
+}
+
+TEST_CASE("Load assets by priority", "[ovis][core][AssetLoader]") {
+  ThreadPool thread_pool(1);
+  AssetLoader asset_loader(&thread_pool);
+
+  // Keep the only thread busy, so the other requests are queued
+  std::promise<void> started;
+  std::promise<void> unblock;
+  std::shared_future<void> unblocked = unblock.get_future().share();
+  std::vector<int> completion_order;
+  const auto load = [](int value) {
+    return [value]() -> Result<int> { return value; };
+  };
+  const auto complete = [&completion_order](Result<int>&& value) { completion_order.push_back(*value); };
+
+  asset_loader.Load<int>(
+      AssetLoadPriority::LOW,
+      [&started, unblocked]() -> Result<int> {
+        started.set_value();
+        unblocked.wait();
+        return 0;
+      },
+      complete);
+  started.get_future().wait();
+  asset_loader.Load<int>(AssetLoadPriority::LOW, load(1), complete);
+  asset_loader.Load<int>(AssetLoadPriority::HIGH, load(2), complete);
+  AssetLoadHandle cancelled = asset_loader.Load<int>(AssetLoadPriority::HIGH, load(3), complete);
+  asset_loader.Load<int>(AssetLoadPriority::NORMAL, load(4), complete);
+  asset_loader.Load<int>(AssetLoadPriority::HIGH, load(5), complete);
+
+  REQUIRE(cancelled.is_pending());
+  cancelled.Cancel();
+  REQUIRE(!cancelled.is_pending());
+  unblock.set_value();
+  asset_loader.CompleteAll();
+
+  // The first request was already being loaded when the others were made
+  REQUIRE(completion_order == std::vector<int>{0, 2, 5, 4, 1});
+  REQUIRE(asset_loader.pending_request_count() == 0);
+}
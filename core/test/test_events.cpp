@@ -52,6 +52,197 @@ class NumberEventListener : public FrameJob {
     double sum_ = 0.0;
 };
 
+struct NumberComponent {
+  double number;
+
+  OVIS_VM_DECLARE_TYPE_BINDING();
+};
+
+OVIS_VM_DEFINE_TYPE_BINDING(Test, NumberComponent) {
+  NumberComponent_type->AddAttribute("Core.EntityComponent");
+}
+
+// Emits a number event in the frames it is told to
+class ControlledNumberEventEmitter : public FrameJob {
+  public:
+    ControlledNumberEventEmitter() : FrameJob("ControlledNumberEventEmitter") {
+      RequireWriteAccess<NumberEvent>();
+      ExecuteBefore("CountingNumberEventListener");
+    }
+
+    Result<> Prepare(Scene* const& update) override { return Success; }
+    Result<> Execute(const SceneUpdate& update) override {
+      if (emit_) {
+        OVIS_CHECK_RESULT(update.scene->GetEventEmitter<NumberEvent>().Emit({.number = 1}));
+        emit_ = false;
+      }
+      return Success;
+    }
+
+    void EmitInNextFrame() { emit_ = true; }
+
+   private:
+    bool emit_ = false;
+};
+
+class CountingNumberEventListener : public FrameJob {
+  public:
+    CountingNumberEventListener(JobTriggerPolicy trigger_policy, bool read_component = false)
+        : FrameJob("CountingNumberEventListener") {
+      RequireReadAccess(main_vm->GetTypeId<NumberEvent>());
+      if (read_component) {
+        RequireReadAccess<NumberComponent>();
+      }
+      SetTriggerPolicy(trigger_policy);
+    }
+
+    Result<> Prepare(Scene* const& update) override { return Success; }
+    Result<> Execute(const SceneUpdate& update) override {
+      ++execution_count_;
+      return Success;
+    }
+
+    int execution_count() { return execution_count_; }
+
+   private:
+    int execution_count_ = 0;
+};
+
+TEST_CASE("Skip jobs without pending events", "[ovis][core][Events]") {
+  for (const auto policy : {JobTriggerPolicy::AUTOMATIC, JobTriggerPolicy::ALWAYS, JobTriggerPolicy::ON_EVENTS}) {
+    Scene scene;
+    scene.frame_scheduler().AddJob<CountingNumberEventListener>(policy);
+    REQUIRE_RESULT(scene.Prepare());
+    scene.Play();
+
+    for (int i = 0; i < 3; ++i) {
+      scene.Update(1.0);
+    }
+    auto listener =
+        static_cast<CountingNumberEventListener*>(scene.frame_scheduler().GetJob("CountingNumberEventListener"));
+    REQUIRE(listener->execution_count() == (policy == JobTriggerPolicy::ALWAYS ? 3 : 0));
+  }
+}
+
+TEST_CASE("Execute jobs while events are pending", "[ovis][core][Events]") {
+  for (const bool read_component : {false, true}) {
+    for (const auto policy : {JobTriggerPolicy::AUTOMATIC, JobTriggerPolicy::ALWAYS, JobTriggerPolicy::ON_EVENTS}) {
+      Scene scene;
+      scene.frame_scheduler().AddJob<ControlledNumberEventEmitter>();
+      scene.frame_scheduler().AddJob<CountingNumberEventListener>(policy, read_component);
+      REQUIRE_RESULT(scene.Prepare());
+      scene.Play();
+
+      auto emitter =
+          static_cast<ControlledNumberEventEmitter*>(scene.frame_scheduler().GetJob("ControlledNumberEventEmitter"));
+      auto listener =
+          static_cast<CountingNumberEventListener*>(scene.frame_scheduler().GetJob("CountingNumberEventListener"));
+      // Automatically triggered jobs that read other resources than events are always executed
+      const bool is_triggered_by_events =
+          policy == JobTriggerPolicy::ON_EVENTS || (policy == JobTriggerPolicy::AUTOMATIC && !read_component);
+
+      // Nothing was emitted yet
+      scene.Update(1.0);
+      REQUIRE(listener->execution_count() == (is_triggered_by_events ? 0 : 1));
+
+      // Emitted during this frame
+      emitter->EmitInNextFrame();
+      scene.Update(1.0);
+      REQUIRE(listener->execution_count() == (is_triggered_by_events ? 1 : 2));
+
+      // The events of the previous frame are still pending
+      scene.Update(1.0);
+      REQUIRE(listener->execution_count() == (is_triggered_by_events ? 2 : 3));
+
+      // All events have been consumed
+      scene.Update(1.0);
+      REQUIRE(listener->execution_count() == (is_triggered_by_events ? 2 : 4));
+    }
+  }
+}
+
+TEST_CASE("Skip events that stopped propagating", "[ovis][core][Events]") {
+  EventStorage event_storage(main_vm->GetTypeId<NumberEvent>());
+  for (int i = 0; i < 200; ++i) {
+    REQUIRE_RESULT(event_storage.Emit(NumberEvent{.number = static_cast<double>(i)}));
+  }
+  REQUIRE(event_storage.size() == 200);
+
+  EventStorageView<NumberEvent> view(&event_storage);
+  for (auto event : view) {
+    // Stop all events of the second mask word and every odd event
+    if ((event->number >= 64 && event->number < 128) || static_cast<int>(event->number) % 2 == 1) {
+      event.StopPropagating();
+    }
+  }
+
+  int count = 0;
+  for (auto event : view) {
+    REQUIRE(event.is_propagating());
+    REQUIRE((event->number < 64 || event->number >= 128));
+    REQUIRE(static_cast<int>(event->number) % 2 == 0);
+    ++count;
+  }
+  REQUIRE(count == 68);
+
+  event_storage.Clear();
+  REQUIRE(event_storage.size() == 0);
+  REQUIRE(event_storage.capacity() >= 200);
+  REQUIRE(view.begin() == view.end());
+}
+
+TEST_CASE("Double buffered events and producer buffers", "[ovis][core][Events]") {
+  EventStorage event_storage(main_vm->GetTypeId<NumberEvent>());
+  event_storage.SetProducerCount(3);
+
+  // Emit in "reverse" producer order, the merged result must still be ordered by the producer index
+  EventEmitter<NumberEvent> third_producer(event_storage.producer_buffer(2));
+  EventEmitter<NumberEvent> first_producer(event_storage.producer_buffer(0));
+  REQUIRE_RESULT(third_producer.Emit({.number = 3}));
+  REQUIRE_RESULT(first_producer.Emit({.number = 1}));
+  REQUIRE_RESULT(first_producer.Emit({.number = 2}));
+  REQUIRE_RESULT(event_storage.Emit(NumberEvent{.number = 0}));
+  REQUIRE_RESULT(event_storage.MergeProducerBuffers());
+  REQUIRE(event_storage.producer_buffer(0)->size() == 0);
+  REQUIRE(event_storage.producer_buffer(2)->size() == 0);
+
+  EventStorageView<NumberEvent> view(&event_storage);
+  REQUIRE(view.size() == 4);
+  double expected_number = 0.0;
+  for (auto event : view) {
+    REQUIRE(event->number == expected_number);
+    expected_number += 1.0;
+  }
+
+  event_storage.SwapBuffers();
+  REQUIRE(view.size() == 0);
+  REQUIRE(view.previous_frame().size() == 4);
+  REQUIRE(view.previous_frame()[3]->number == 3);
+
+  event_storage.SwapBuffers();
+  REQUIRE(view.previous_frame().size() == 0);
+}
+
+TEST_CASE("Producer emitters stay valid", "[ovis][core][Events]") {
+  Scene scene;
+  scene.SetEventProducerCount(4);
+  scene.frame_scheduler().AddJob<NumberEventListener>();
+  REQUIRE_RESULT(scene.Prepare());
+  REQUIRE(scene.GetEventStorage(main_vm->GetTypeId<NumberEvent>())->producer_count() == 4);
+
+  // Requesting emitters for later producers must not move the buffers of earlier ones
+  auto first_producer = scene.GetEventEmitter<NumberEvent>(0);
+  auto last_producer = scene.GetEventEmitter<NumberEvent>(3);
+  REQUIRE_RESULT(last_producer.Emit({.number = 2}));
+  REQUIRE_RESULT(first_producer.Emit({.number = 1}));
+  REQUIRE_RESULT(scene.MergeEventProducerBuffers());
+
+  auto events = scene.GetEventStorage<NumberEvent>();
+  REQUIRE(events.size() == 2);
+  REQUIRE(events[0]->number == 1);
+  REQUIRE(events[1]->number == 2);
+}
+
 TEST_CASE("Emit and receive events", "[ovis][core][Events]") {
   Scene scene;
   // Insert the jobs in the "wrong" order on purpose
@@ -0,0 +1,107 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/core/event_storage.hpp"
+#include "ovis/core/job_statistics.hpp"
+#include "ovis/core/scene.hpp"
+#include "ovis/core/simple_job.hpp"
+#include "ovis/core/vm_bindings.hpp"
+#include "ovis/test/require_result.hpp"
+
+using namespace ovis;
+
+struct Health {
+  float value = 100;
+
+  OVIS_VM_DECLARE_TYPE_BINDING();
+};
+
+OVIS_VM_DEFINE_TYPE_BINDING(Test, Health) {
+  Health_type->AddAttribute("Core.EntityComponent");
+}
+
+struct DamageEvent {
+  float amount;
+
+  OVIS_VM_DECLARE_TYPE_BINDING();
+};
+
+OVIS_VM_DEFINE_TYPE_BINDING(Test, DamageEvent) {
+  DamageEvent_type->AddAttribute("Core.Event");
+}
+
+void EmitDamage(const Health& health, EventEmitter<DamageEvent> damage_emitter) {
+  damage_emitter.Emit({.amount = health.value});
+}
+OVIS_CREATE_SIMPLE_JOB(EmitDamage)
+
+class DamageListener : public FrameJob {
+ public:
+  DamageListener() : FrameJob("DamageListener") {
+    RequireReadAccess(main_vm->GetTypeId<DamageEvent>());
+    ExecuteAfter("EmitDamage");
+  }
+
+  Result<> Prepare(Scene* const& scene) override { return Success; }
+  Result<> Execute(const SceneUpdate& update) override { return Success; }
+};
+
+TEST_CASE("Summarize job statistics", "[ovis][core][JobStatistics]") {
+  JobStatistics statistics("Job", 50);
+  REQUIRE(statistics.wall_time().max == 0.0);
+
+  for (int i = 1; i <= 100; ++i) {
+    statistics.AddFrame({.wall_time = static_cast<double>(i)});
+  }
+  REQUIRE(statistics.execution_count() == 100);
+  REQUIRE(statistics.frame_count() == 50);
+  REQUIRE(statistics.last_frame().wall_time == 100.0);
+
+  // Only the last 50 frames are kept
+  const StatisticSummary wall_time = statistics.wall_time();
+  REQUIRE(wall_time.p50 == 75.0);
+  REQUIRE(wall_time.p99 == 100.0);
+  REQUIRE(wall_time.max == 100.0);
+  REQUIRE(statistics.processed_entity_count().max == 0.0);
+}
+
+TEST_CASE("Record job statistics in the scheduler", "[ovis][core][JobStatistics]") {
+  Scene scene;
+  scene.frame_scheduler().AddJob<EmitDamageJob>();
+  scene.frame_scheduler().AddJob<DamageListener>();
+  REQUIRE(!scene.frame_scheduler().statistics_enabled());
+  scene.frame_scheduler().EnableStatistics(10);
+  REQUIRE_RESULT(scene.Prepare());
+
+  for (int i = 0; i < 5; ++i) {
+    auto entity = scene.CreateEntity("Entity");
+    if (i % 2 == 0) {
+      REQUIRE(scene.GetComponentStorage<Health>().AddComponent(entity->id));
+    }
+  }
+
+  scene.Play();
+  for (int i = 0; i < 20; ++i) {
+    scene.Update(0.0);
+  }
+
+  const JobStatistics* emit_damage = scene.frame_scheduler().GetJobStatistics("EmitDamage");
+  REQUIRE(emit_damage != nullptr);
+  REQUIRE(emit_damage->execution_count() == 20);
+  REQUIRE(emit_damage->frame_count() == 10);
+  REQUIRE(emit_damage->last_frame().processed_entity_count == 3);
+  REQUIRE(emit_damage->last_frame().emitted_event_count == 3);
+  REQUIRE(emit_damage->processed_entity_count().p50 == 3.0);
+  REQUIRE(emit_damage->wall_time().p50 <= emit_damage->wall_time().p99);
+  REQUIRE(emit_damage->wall_time().p99 <= emit_damage->wall_time().max);
+#if !OVIS_ENABLE_BUILT_IN_PROFILING
+  REQUIRE(emit_damage->allocation_count().max == 0.0);
+#endif
+
+  // The events of the current and the previous frame
+  const JobStatistics* damage_listener = scene.frame_scheduler().GetJobStatistics("DamageListener");
+  REQUIRE(damage_listener != nullptr);
+  REQUIRE(damage_listener->last_frame().read_event_count == 6);
+
+  scene.frame_scheduler().DisableStatistics();
+  REQUIRE(scene.frame_scheduler().GetJobStatistics("EmitDamage") == nullptr);
+}
@@ -0,0 +1,219 @@
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/core/scene.hpp"
+#include "ovis/core/vm_bindings.hpp"
+#include "ovis/test/require_result.hpp"
+
+using namespace ovis;
+
+struct SerializedPosition {
+  double x;
+  double y;
+
+  OVIS_VM_DECLARE_TYPE_BINDING();
+};
+
+OVIS_VM_DEFINE_TYPE_BINDING(Test, SerializedPosition) {
+  SerializedPosition_type->AddAttribute("Core.EntityComponent");
+  SerializedPosition_type->AddProperty<&SerializedPosition::x>("x");
+  SerializedPosition_type->AddProperty<&SerializedPosition::y>("y");
+}
+
+struct SerializedLabel {
+  std::string text;
+  double size;
+
+  OVIS_VM_DECLARE_TYPE_BINDING();
+};
+
+OVIS_VM_DEFINE_TYPE_BINDING(Test, SerializedLabel) {
+  SerializedLabel_type->AddAttribute("Core.EntityComponent");
+  SerializedLabel_type->AddProperty<&SerializedLabel::text>("text");
+  SerializedLabel_type->AddProperty<&SerializedLabel::size>("size");
+}
+
+class SerializedComponentsJob : public FrameJob {
+ public:
+  SerializedComponentsJob(bool use_labels = true) : FrameJob("SerializedComponentsJob") {
+    RequireWriteAccess<SerializedPosition>();
+    if (use_labels) {
+      RequireWriteAccess<SerializedLabel>();
+    }
+  }
+
+  Result<> Prepare(Scene* const& update) override { return Success; }
+  Result<> Execute(const SceneUpdate& update) override { return Success; }
+};
+
+TEST_CASE("Binary scene round trip", "[ovis][core][Scene]") {
+  Scene scene;
+  scene.frame_scheduler().AddJob<SerializedComponentsJob>();
+  REQUIRE_RESULT(scene.Prepare());
+
+  auto positions = scene.GetComponentStorage<SerializedPosition>();
+  auto labels = scene.GetComponentStorage<SerializedLabel>();
+
+  Entity* parent = scene.CreateEntity("Parent");
+  Entity* child = scene.CreateEntity("Child", parent->id);
+  Entity* unlabeled = scene.CreateEntity("Unlabeled");
+  for (Entity* entity : {parent, child, unlabeled}) {
+    REQUIRE_RESULT(positions.AddComponent(entity->id));
+    positions[entity->id] = {.x = static_cast<double>(entity->id.index), .y = -1.0};
+  }
+  REQUIRE_RESULT(labels.AddComponent(parent->id));
+  labels[parent->id] = {.text = "I am the parent", .size = 12.0};
+  REQUIRE_RESULT(labels.AddComponent(child->id));
+  labels[child->id] = {.text = "", .size = 8.0};
+
+  const auto data = scene.SerializeBinary();
+  REQUIRE_RESULT(data);
+
+  SECTION("Load into a scene with the same components") {
+    Scene loaded_scene(10);
+    loaded_scene.frame_scheduler().AddJob<SerializedComponentsJob>();
+    REQUIRE_RESULT(loaded_scene.Prepare());
+    REQUIRE_RESULT(loaded_scene.DeserializeBinary(*data));
+
+    auto loaded_positions = loaded_scene.GetComponentStorage<SerializedPosition>();
+    auto loaded_labels = loaded_scene.GetComponentStorage<SerializedLabel>();
+
+    Entity* loaded_parent = loaded_scene.GetEntity(parent->id);
+    Entity* loaded_child = loaded_scene.GetEntity(child->id);
+    Entity* loaded_unlabeled = loaded_scene.GetEntity(unlabeled->id);
+    REQUIRE(loaded_parent != nullptr);
+    REQUIRE(loaded_child != nullptr);
+    REQUIRE(loaded_unlabeled != nullptr);
+    REQUIRE(loaded_parent->name == "Parent");
+    REQUIRE(loaded_child->name == "Child");
+    REQUIRE(loaded_child->parent_id == parent->id);
+    REQUIRE(loaded_parent->first_children_id == child->id);
+
+    std::size_t entity_count = 0;
+    for (auto& entity : loaded_scene) {
+      REQUIRE(loaded_positions.EntityHasComponent(entity.id));
+      REQUIRE(loaded_positions[entity.id].x == entity.id.index);
+      REQUIRE(loaded_positions[entity.id].y == -1.0);
+      ++entity_count;
+    }
+    REQUIRE(entity_count == 3);
+
+    REQUIRE(loaded_labels[parent->id].text == "I am the parent");
+    REQUIRE(loaded_labels[parent->id].size == 12.0);
+    REQUIRE(loaded_labels[child->id].text == "");
+    REQUIRE(loaded_labels[child->id].size == 8.0);
+    REQUIRE(!loaded_labels.EntityHasComponent(unlabeled->id));
+
+    // The free list is restored as well
+    Entity* new_entity = loaded_scene.CreateEntity("New");
+    REQUIRE(new_entity != nullptr);
+    REQUIRE(!loaded_positions.EntityHasComponent(new_entity->id));
+  }
+
+  SECTION("Skip components that are not used by the scene") {
+    Scene loaded_scene;
+    loaded_scene.frame_scheduler().AddJob<SerializedComponentsJob>(false);
+    REQUIRE_RESULT(loaded_scene.Prepare());
+    REQUIRE_RESULT(loaded_scene.DeserializeBinary(*data));
+    REQUIRE(!loaded_scene.GetComponentStorage<SerializedLabel>());
+    REQUIRE(loaded_scene.GetComponentStorage<SerializedPosition>()[child->id].x == child->id.index);
+  }
+
+  SECTION("Reject invalid data without modifying the scene") {
+    Scene loaded_scene;
+    loaded_scene.frame_scheduler().AddJob<SerializedComponentsJob>();
+    REQUIRE_RESULT(loaded_scene.Prepare());
+    Entity* existing = loaded_scene.CreateEntity("Existing");
+    REQUIRE_RESULT(loaded_scene.GetComponentStorage<SerializedPosition>().AddComponent(existing->id));
+
+    // The last column is truncated
+    REQUIRE(!loaded_scene.DeserializeBinary(std::span(*data).first(data->size() - 1)));
+    // The first column has an unsupported version
+    SceneBinaryHeader header;
+    std::memcpy(&header, data->data(), sizeof(header));
+    const std::size_t entity_table_size = header.entity_capacity * (sizeof(SceneBinaryEntity) + sizeof(std::uint32_t));
+    const std::size_t first_column_offset = sizeof(header) + entity_table_size + header.name_size;
+    Blob invalid_column = *data;
+    invalid_column[first_column_offset] = std::byte{0xff};
+    REQUIRE(!loaded_scene.DeserializeBinary(invalid_column));
+
+    REQUIRE(loaded_scene.GetEntity(existing->id) == existing);
+    REQUIRE(existing->name == "Existing");
+    REQUIRE(loaded_scene.GetComponentStorage<SerializedPosition>().EntityHasComponent(existing->id));
+  }
+}
+
+TEST_CASE("Reject corrupt binary scenes", "[ovis][core][Scene]") {
+  Scene scene;
+  scene.frame_scheduler().AddJob<SerializedComponentsJob>(false);
+  REQUIRE_RESULT(scene.Prepare());
+  Entity* entity = scene.CreateEntity("Entity");
+  REQUIRE_RESULT(scene.GetComponentStorage<SerializedPosition>().AddComponent(entity->id));
+  const auto data = scene.SerializeBinary();
+  REQUIRE_RESULT(data);
+
+  SceneBinaryHeader header;
+  std::memcpy(&header, data->data(), sizeof(header));
+  REQUIRE(header.column_count == 1);
+  const std::size_t entity_table_size = header.entity_capacity * (sizeof(SceneBinaryEntity) + sizeof(std::uint32_t));
+  const std::size_t column_offset = sizeof(header) + entity_table_size + header.name_size;
+
+  Scene loaded_scene;
+  loaded_scene.frame_scheduler().AddJob<SerializedComponentsJob>(false);
+  REQUIRE_RESULT(loaded_scene.Prepare());
+
+  SECTION("Counts that exceed the data are rejected before allocating") {
+    Blob invalid_capacity = *data;
+    const std::uint32_t entity_capacity = 0xfffffff0;
+    std::memcpy(&invalid_capacity[offsetof(SceneBinaryHeader, entity_capacity)], &entity_capacity,
+                sizeof(entity_capacity));
+    REQUIRE(!loaded_scene.DeserializeBinary(invalid_capacity));
+
+    Blob invalid_range_count = *data;
+    const std::uint32_t range_count = 0xffffffff;
+    std::memcpy(&invalid_range_count[column_offset + offsetof(SceneBinaryColumnHeader, range_count)], &range_count,
+                sizeof(range_count));
+    REQUIRE(!loaded_scene.DeserializeBinary(invalid_range_count));
+  }
+
+  SECTION("Duplicate columns are rejected") {
+    Blob duplicate_column = *data;
+    // Keep the alignment of the copied column relative to the start of the data
+    while (duplicate_column.size() % 16 != column_offset % 16) {
+      duplicate_column.push_back(std::byte{0});
+    }
+    duplicate_column.insert(duplicate_column.end(), data->begin() + column_offset, data->end());
+    const std::uint32_t column_count = 2;
+    std::memcpy(&duplicate_column[offsetof(SceneBinaryHeader, column_count)], &column_count, sizeof(column_count));
+    REQUIRE(!loaded_scene.DeserializeBinary(duplicate_column));
+    REQUIRE(!loaded_scene.GetComponentStorage<SerializedPosition>().EntityHasComponent(entity->id));
+  }
+}
+
+TEST_CASE("Load binary scenes", "[ovis][core][Scene]") {
+  // Entity ids have 16 index bits, so this is the largest possible scene
+  constexpr std::size_t ENTITY_COUNT = 1 << 16;
+
+  Scene scene(ENTITY_COUNT);
+  scene.frame_scheduler().AddJob<SerializedComponentsJob>(false);
+  REQUIRE_RESULT(scene.Prepare());
+  auto positions = scene.GetComponentStorage<SerializedPosition>();
+  for (std::size_t i = 0; i < ENTITY_COUNT; ++i) {
+    Entity* entity = scene.CreateEntity("Entity");
+    REQUIRE_RESULT(positions.AddComponent(entity->id));
+  }
+  const auto data = scene.SerializeBinary();
+  REQUIRE_RESULT(data);
+
+  Scene loaded_scene(ENTITY_COUNT);
+  loaded_scene.frame_scheduler().AddJob<SerializedComponentsJob>(false);
+  REQUIRE_RESULT(loaded_scene.Prepare());
+
+  BENCHMARK("Load entities with a raw component column") {
+    return static_cast<bool>(loaded_scene.DeserializeBinary(*data));
+  };
+}
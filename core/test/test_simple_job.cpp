@@ -106,3 +106,47 @@ TEST_CASE("Test SimpleSceneController", "[ovis][core][SimpleSceneController]") {
 
   s.Stop();
 }
+
+struct Gravity {
+  float y = -10;
+
+  OVIS_VM_DECLARE_TYPE_BINDING();
+};
+
+OVIS_VM_DEFINE_TYPE_BINDING(Test, Gravity) {
+  Gravity_type->AddAttribute("Core.SceneComponent");
+}
+
+void Accelerate(SceneComponentRef<const Gravity> gravity, Speed* speed) {
+  speed->y += gravity->y;
+}
+
+OVIS_CREATE_SIMPLE_JOB(Accelerate);
+
+TEST_CASE("Access scene components in SimpleJob", "[ovis][core][SimpleSceneController]") {
+  {
+    AccelerateJob accelerate_job;
+    REQUIRE(accelerate_job.read_access().contains(main_vm->GetTypeId<Gravity>()));
+    REQUIRE(!accelerate_job.write_access().contains(main_vm->GetTypeId<Gravity>()));
+  }
+
+  Scene s;
+  s.frame_scheduler().AddJob<AccelerateJob>();
+  s.Prepare();
+
+  REQUIRE(s.frame_scheduler().GetUsedSceneComponents().contains(main_vm->GetTypeId<Gravity>()));
+  Gravity* gravity = s.GetSceneComponent<Gravity>();
+  REQUIRE(gravity != nullptr);
+  REQUIRE(gravity->y == -10);
+  REQUIRE(s.GetSceneComponent(main_vm->GetTypeId<Gravity>()) == gravity);
+  gravity->y = -1;
+
+  auto speed_storage = s.GetComponentStorage<Speed>();
+  auto entity = s.CreateEntity("Obj");
+  REQUIRE(speed_storage.AddComponent(entity->id));
+
+  s.Play();
+  s.Update(0.1);
+  REQUIRE(speed_storage[entity->id].y == 1);
+  s.Stop();
+}
@@ -0,0 +1,50 @@
+#include <algorithm>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/core/spatial_grid2d.hpp"
+
+using namespace ovis;
+
+namespace {
+
+std::vector<std::uint32_t> Query(const SpatialGrid2D& grid, Vector2 min, Vector2 max) {
+  std::vector<std::uint32_t> ids;
+  grid.Query(AxisAlignedBoundingBox2D::FromMinMax(min, max), &ids);
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+}  // namespace
+
+TEST_CASE("Query objects in a spatial grid", "[ovis][core][SpatialGrid2D]") {
+  SpatialGrid2D grid(10.0f);
+  grid.Update(0, AxisAlignedBoundingBox2D::FromMinMax({1.0f, 1.0f}, {2.0f, 2.0f}));
+  grid.Update(1, AxisAlignedBoundingBox2D::FromMinMax({15.0f, 1.0f}, {25.0f, 2.0f}));
+  grid.Update(2, AxisAlignedBoundingBox2D::FromMinMax({-35.0f, -35.0f}, {-31.0f, -31.0f}));
+
+  REQUIRE(Query(grid, {0.0f, 0.0f}, {20.0f, 5.0f}) == std::vector<std::uint32_t>{0, 1});
+  // Objects in the same cell that do not overlap the region are not returned
+  REQUIRE(Query(grid, {3.0f, 3.0f}, {5.0f, 5.0f}).empty());
+  REQUIRE(Query(grid, {-100.0f, -100.0f}, {100.0f, 100.0f}) == std::vector<std::uint32_t>{0, 1, 2});
+
+  SECTION("Moving objects") {
+    grid.Update(0, AxisAlignedBoundingBox2D::FromMinMax({-34.0f, -34.0f}, {-33.0f, -33.0f}));
+    REQUIRE(Query(grid, {0.0f, 0.0f}, {20.0f, 5.0f}) == std::vector<std::uint32_t>{1});
+    REQUIRE(Query(grid, {-40.0f, -40.0f}, {-30.0f, -30.0f}) == std::vector<std::uint32_t>{0, 2});
+  }
+
+  SECTION("Removing objects") {
+    grid.Remove(1);
+    REQUIRE(!grid.Contains(1));
+    REQUIRE(Query(grid, {0.0f, 0.0f}, {20.0f, 5.0f}) == std::vector<std::uint32_t>{0});
+  }
+
+  SECTION("Large objects") {
+    grid.Update(3, AxisAlignedBoundingBox2D::FromMinMax({-1000.0f, -1000.0f}, {1000.0f, 1000.0f}));
+    REQUIRE(Query(grid, {500.0f, 500.0f}, {501.0f, 501.0f}) == std::vector<std::uint32_t>{3});
+    grid.Update(3, AxisAlignedBoundingBox2D::FromMinMax({500.0f, 500.0f}, {501.0f, 501.0f}));
+    REQUIRE(Query(grid, {500.0f, 500.0f}, {501.0f, 501.0f}) == std::vector<std::uint32_t>{3});
+    REQUIRE(Query(grid, {0.0f, 0.0f}, {20.0f, 5.0f}) == std::vector<std::uint32_t>{0, 1});
+  }
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
 
 #include <ovis/graphics/gl.hpp>
 
@@ -63,7 +65,10 @@ struct BlendState {
 };
 static_assert(sizeof(BlendState) == 32, "Invalid Padding");
 
-inline void ApplyBlendState(BlendState* current_state, BlendState new_state) {
+// Applies the new blend state and only issues the calls for the parts that differ from the current state. Returns
+// whether any call was issued.
+inline bool ApplyBlendState(BlendState* current_state, const BlendState& new_state) {
+  bool changed = false;
   if (current_state->enabled != new_state.enabled) {
     if (new_state.enabled) {
       glEnable(GL_BLEND);
@@ -71,18 +76,40 @@ inline void ApplyBlendState(BlendState* current_state, BlendState new_state) {
       glDisable(GL_BLEND);
     }
     current_state->enabled = new_state.enabled;
+    changed = true;
   }
   if (new_state.enabled) {
-    // TODO: Only update necessary states
-    glBlendFuncSeparate(
-        static_cast<GLenum>(new_state.source_color_factor), static_cast<GLenum>(new_state.destination_color_factor),
-        static_cast<GLenum>(new_state.source_alpha_factor), static_cast<GLenum>(new_state.destination_alpha_factor));
-    glBlendEquationSeparate(static_cast<GLenum>(new_state.color_function),
-                            static_cast<GLenum>(new_state.alpha_function));
-    glBlendColor(new_state.constant_color[0], new_state.constant_color[1], new_state.constant_color[2],
-                 new_state.constant_color[3]);
-    *current_state = new_state;
+    if (current_state->source_color_factor != new_state.source_color_factor ||
+        current_state->destination_color_factor != new_state.destination_color_factor ||
+        current_state->source_alpha_factor != new_state.source_alpha_factor ||
+        current_state->destination_alpha_factor != new_state.destination_alpha_factor) {
+      glBlendFuncSeparate(
+          static_cast<GLenum>(new_state.source_color_factor), static_cast<GLenum>(new_state.destination_color_factor),
+          static_cast<GLenum>(new_state.source_alpha_factor), static_cast<GLenum>(new_state.destination_alpha_factor));
+      current_state->source_color_factor = new_state.source_color_factor;
+      current_state->destination_color_factor = new_state.destination_color_factor;
+      current_state->source_alpha_factor = new_state.source_alpha_factor;
+      current_state->destination_alpha_factor = new_state.destination_alpha_factor;
+      changed = true;
+    }
+    if (current_state->color_function != new_state.color_function ||
+        current_state->alpha_function != new_state.alpha_function) {
+      glBlendEquationSeparate(static_cast<GLenum>(new_state.color_function),
+                              static_cast<GLenum>(new_state.alpha_function));
+      current_state->color_function = new_state.color_function;
+      current_state->alpha_function = new_state.alpha_function;
+      changed = true;
+    }
+    if (!std::equal(std::begin(current_state->constant_color), std::end(current_state->constant_color),
+                    std::begin(new_state.constant_color))) {
+      glBlendColor(new_state.constant_color[0], new_state.constant_color[1], new_state.constant_color[2],
+                   new_state.constant_color[3]);
+      std::copy(std::begin(new_state.constant_color), std::end(new_state.constant_color),
+                std::begin(current_state->constant_color));
+      changed = true;
+    }
   }
+  return changed;
 }
 
 }  // namespace ovis
\ No newline at end of file
@@ -26,7 +26,10 @@ struct DepthBufferState {
 };
 static_assert(sizeof(DepthBufferState) == 4, "Invalid padding");
 
-inline void ApplyDepthBufferState(DepthBufferState* current_state, DepthBufferState new_state) {
+// Applies the new depth buffer state and only issues the calls for the parts that differ from the current state. Returns
+// whether any call was issued.
+inline bool ApplyDepthBufferState(DepthBufferState* current_state, DepthBufferState new_state) {
+  bool changed = false;
   if (current_state->test_enabled != new_state.test_enabled) {
     if (new_state.test_enabled) {
       glEnable(GL_DEPTH_TEST);
@@ -34,18 +37,22 @@ inline void ApplyDepthBufferState(DepthBufferState* current_state, DepthBufferSt
       glDisable(GL_DEPTH_TEST);
     }
     current_state->test_enabled = new_state.test_enabled;
+    changed = true;
   }
 
   if (new_state.test_enabled) {
     if (current_state->write_enabled != new_state.write_enabled) {
       glDepthMask(new_state.write_enabled);
       current_state->write_enabled = new_state.write_enabled;
+      changed = true;
     }
     if (current_state->function != new_state.function) {
       glDepthFunc(static_cast<GLenum>(new_state.function));
       current_state->function = new_state.function;
+      changed = true;
     }
   }
+  return changed;
 }
 
 }  // namespace ovis
\ No newline at end of file
@@ -12,3 +12,12 @@
 #define GL_GLEXT_PROTOTYPES
 #include <GL/glcorearb.h>
 #endif
+
+// The S3TC formats are an extension that is not part of the core headers. Nearly all desktop drivers support it and
+// WebGL exposes it via WEBGL_compressed_texture_s3tc.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
@@ -5,6 +5,15 @@
 
 namespace ovis {
 
+enum class BufferUsage : GLenum {
+  // The contents are written once and drawn many times
+  STATIC = GL_STATIC_DRAW,
+  // The contents are written repeatedly and drawn many times
+  DYNAMIC = GL_DYNAMIC_DRAW,
+  // The contents are written once and drawn at most a few times, e.g., the geometry of a single frame
+  STREAM = GL_STREAM_DRAW,
+};
+
 class GraphicsBuffer : public GraphicsResource {
  protected:
   GraphicsBuffer(GraphicsContext* context, Type type);
@@ -6,14 +6,18 @@
 #include <vector>
 
 #include "ovis/utils/class.hpp"
+#include "ovis/utils/profiling.hpp"
 #include "ovis/core/rect.hpp"
 #include "ovis/graphics/blend_state.hpp"
 #include "ovis/graphics/depth_buffer_state.hpp"
 #include "ovis/graphics/gl.hpp"
+#include "ovis/graphics/texture.hpp"
 #include "ovis/graphics/uniform_buffer.hpp"
 
 namespace ovis {
 
+class AssetCache;
+class GraphicsRecording;
 class GraphicsResource;
 class IndexBuffer;
 class RenderTargetConfiguration;
@@ -40,6 +44,10 @@ struct DrawItem {
   uint32_t start = 0;
   uint32_t count = 3;
   uint32_t base_vertex = 0;
+  // Attributes with an instance divisor advance per instance instead of per vertex, see VertexAttributeDescription.
+  // Instancing is not supported on WebGL.
+  uint32_t instance_count = 1;
+  uint32_t base_instance = 0;
   DepthBufferState depth_buffer_state;
   BlendState blend_state;
   std::optional<Rect<int>> scissor_rect;
@@ -47,6 +55,12 @@ struct DrawItem {
   bool enable_culling = false;
 };
 
+struct GraphicsStateStatistics {
+  std::uint64_t issued_state_changes = 0;
+  // State changes that were not sent to OpenGL because the state was already set
+  std::uint64_t skipped_state_changes = 0;
+};
+
 class GraphicsContext final {
   friend class GraphicsResource;
   friend class IndexBuffer;
@@ -67,6 +81,22 @@ class GraphicsContext final {
   void Draw(const DrawItem& draw_item);
 
   void SetFramebufferSize(int width, int height);
+
+  // Formats that are not block compressed are always supported. Block compressed formats depend on the GPU.
+  bool SupportsTextureFormat(TextureFormat format) const;
+  // Returns the commands recorded by the headless backend or nullptr if the context uses OpenGL, see
+  // GraphicsRecording.
+  inline GraphicsRecording* recording() const { return recording_.get(); }
+
+  // The context keeps a copy of the OpenGL state and only issues the calls that actually change it. When built-in
+  // profiling is enabled, the counts are also written to the default ProfilingLog per frame.
+  inline const GraphicsStateStatistics& state_statistics() const { return state_statistics_; }
+  inline void ResetStateStatistics() { state_statistics_ = {}; }
+
+  // Shares the resources that are created from assets, e.g., textures and font atlases, between the users of the
+  // context. It is cleared when the context is destroyed, so the resources must not be used anymore after that.
+  inline AssetCache* asset_cache() const { return asset_cache_.get(); }
+
   inline RenderTargetConfiguration* default_render_target_configuration() const {
     return m_default_render_target_configuration.get();
   }
@@ -81,18 +111,23 @@ class GraphicsContext final {
 
  private:
   std::vector<GraphicsResource*> resources_;
+  std::unique_ptr<GraphicsRecording> recording_;
+  std::unique_ptr<AssetCache> asset_cache_;
   std::unique_ptr<RenderTargetConfiguration> m_default_render_target_configuration;
 
   struct {
     GLint max_vertex_attribs;
     GLint num_texture_units;
     GLint num_vertex_texture_units;
+    std::vector<GLint> compressed_texture_formats;
   } m_caps;
 
   GLuint m_bound_frame_buffer;
   GLuint m_bound_array_buffer;
   GLuint m_bound_element_array_buffer;
   GLuint m_bound_program;
+  VertexInput* m_bound_vertex_input = nullptr;
+  std::uint32_t m_bound_vertex_input_base_instance = 0;
   GLuint m_active_texture_unit;
   DepthBufferState depth_buffer_state_;
   BlendState blend_state_;
@@ -104,6 +139,22 @@ class GraphicsContext final {
   int x1, x2, x3;  // TODO: figure out why these three padding members are necessary oO
   size_t viewport_width_;
   size_t viewport_height_;
+  GraphicsStateStatistics state_statistics_;
+#if OVIS_ENABLE_BUILT_IN_PROFILING
+  CounterProfiler issued_state_changes_profiler_{"Graphics::IssuedStateChanges"};
+  CounterProfiler skipped_state_changes_profiler_{"Graphics::SkippedStateChanges"};
+#endif
+
+  inline void CountStateChange(bool issued) {
+    if (issued) {
+      ++state_statistics_.issued_state_changes;
+    } else {
+      ++state_statistics_.skipped_state_changes;
+    }
+#if OVIS_ENABLE_BUILT_IN_PROFILING
+    (issued ? issued_state_changes_profiler_ : skipped_state_changes_profiler_).Count();
+#endif
+  }
 
   inline void BindTexture(GLenum texture_type, GLuint texture_name, GLuint texture_unit) {
     assert(texture_unit < m_bound_textures.size());
@@ -111,6 +162,9 @@ class GraphicsContext final {
       ActivateTextureUnit(texture_unit);
       glBindTexture(texture_type, texture_name);
       m_bound_textures[texture_unit] = texture_name;
+      CountStateChange(true);
+    } else {
+      CountStateChange(false);
     }
   }
 
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "ovis/graphics/gl.hpp"
+#include "ovis/graphics/graphics_context.hpp"
+
+namespace ovis {
+
+struct GraphicsCommand {
+  enum class Type : std::uint8_t {
+    // Creation, deletion and queries of objects
+    RESOURCE,
+    // Any call that changes the pipeline state, e.g., binding buffers, setting uniforms or changing the blend state
+    STATE_CHANGE,
+    TEXTURE_BIND,
+    BUFFER_UPLOAD,
+    TEXTURE_UPLOAD,
+    CLEAR,
+    DRAW,
+  };
+
+  Type type;
+  // The name of the OpenGL function that issued the command
+  const char* function;
+  // The object that was bound, or the object the data was uploaded to
+  GLuint object = 0;
+  std::size_t size_in_bytes = 0;
+  // The number of vertices or indices for draw commands
+  std::size_t count = 0;
+};
+
+struct GraphicsStatistics {
+  std::size_t clears = 0;
+  std::size_t draw_calls = 0;
+  std::size_t drawn_elements = 0;
+  std::size_t state_changes = 0;
+  std::size_t texture_binds = 0;
+  std::size_t buffer_uploads = 0;
+  std::size_t texture_uploads = 0;
+  std::size_t uploaded_bytes = 0;
+};
+
+// Records the commands a GraphicsContext issues. When Ovis is built with OVIS_HEADLESS_GRAPHICS the OpenGL functions
+// are replaced by a backend that does not touch the GPU and only records the calls into the recording of the current
+// context. This allows measuring the renderers without a window or a GPU, e.g., in CI:
+//
+//   GraphicsContext context(Vector2(1280, 720));
+//   ... render a frame ...
+//   const GraphicsStatistics& statistics = context.recording()->statistics();
+//   context.recording()->Clear();
+class GraphicsRecording {
+ public:
+  void Record(const GraphicsCommand& command);
+  void RecordDrawItem(const DrawItem& draw_item) { draw_items_.push_back(draw_item); }
+
+  // Removes all commands and resets the statistics, e.g., at the start of a frame
+  void Clear();
+
+  std::span<const GraphicsCommand> commands() const { return commands_; }
+  std::span<const DrawItem> draw_items() const { return draw_items_; }
+  const GraphicsStatistics& statistics() const { return statistics_; }
+
+ private:
+  std::vector<GraphicsCommand> commands_;
+  std::vector<DrawItem> draw_items_;
+  GraphicsStatistics statistics_;
+};
+
+#if OVIS_HEADLESS_GRAPHICS
+// Sets the recording the headless backend writes to. This is done by the GraphicsContext when it is created.
+void MakeGraphicsRecordingCurrent(GraphicsRecording* recording);
+#endif
+
+}  // namespace ovis
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "ovis/graphics/gl.hpp"
+#include "ovis/graphics/vertex_buffer.hpp"
+
+namespace ovis {
+
+struct StreamingVertexBufferDescription {
+  std::size_t vertex_size_in_bytes;
+  // The maximum number of vertices that can be written at once
+  std::size_t segment_vertex_count;
+  // The number of segments in the ring, i.e., roughly the number of frames the CPU may be ahead of the GPU
+  std::size_t segment_count = 3;
+};
+
+// A vertex buffer for geometry that is generated every frame. Overwriting vertices that are still read by a previous
+// draw forces the driver to either wait for the draw to finish or to copy the buffer. Instead, every Write() goes into
+// a region of the buffer that was not written before and returns the index of its first vertex, which is then passed
+// to the draw as DrawItem::start.
+//
+// The buffer is used as a ring of segments. When a segment is full, a fence is inserted and writing continues in the
+// next segment once the GPU finished reading it. If it did not finish yet, the buffer storage is orphaned instead of
+// waiting for it. On WebGL, which has neither fences nor unsynchronized mapping, the storage is orphaned every time the
+// ring wraps around.
+//
+// The vertices of a region must be drawn before the next call to Write().
+class StreamingVertexBuffer {
+ public:
+  StreamingVertexBuffer(GraphicsContext* context, const StreamingVertexBufferDescription& description);
+  ~StreamingVertexBuffer();
+
+  std::size_t Write(const void* vertex_data, std::size_t vertex_count);
+
+  template <typename T>
+  std::size_t Write(std::span<const T> vertices) {
+    assert(sizeof(T) == description_.vertex_size_in_bytes);
+    return Write(vertices.data(), vertices.size());
+  }
+
+  // Use this buffer in the VertexInputDescription of the draws
+  inline VertexBuffer* vertex_buffer() const { return vertex_buffer_.get(); }
+  inline const StreamingVertexBufferDescription& description() const { return description_; }
+
+ private:
+  StreamingVertexBufferDescription description_;
+  std::unique_ptr<VertexBuffer> vertex_buffer_;
+  std::size_t current_segment_ = 0;
+  // The index of the next vertex that can be written
+  std::size_t write_position_ = 0;
+#if !OVIS_EMSCRIPTEN
+  std::vector<GLsync> segment_fences_;
+#endif
+
+  void BeginNextSegment();
+  void Orphan();
+};
+
+}  // namespace ovis
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+
 #include <ovis/graphics/gl.hpp>
 #include <ovis/graphics/graphics_resource.hpp>
 
@@ -7,14 +10,36 @@ namespace ovis {
 
 // TODO: change to pixel format
 enum class TextureFormat {
+  R_UINT8,
   RGB_UINT8,
   RGBA_UINT8,
   RGBA_FLOAT32,
   DEPTH_UINT16,
   DEPTH_UINT24,
   DEPTH_FLOAT32,
+  // Block compressed formats that store 4x4 pixels in 8 (BC1, also known as DXT1) or 16 (BC3, also known as DXT5)
+  // bytes. They are uploaded as they are where the GPU supports them and are decompressed on the CPU otherwise.
+  RGB_BC1,
+  RGBA_BC3,
 };
 
+// The size of a single pixel in bytes, only valid for formats that are not block compressed
+std::size_t GetTexturePixelSize(TextureFormat format);
+
+bool IsBlockCompressed(TextureFormat format);
+
+// The size of a mip map level with the given dimensions in bytes. Rows of uncompressed formats are tightly packed and
+// blocks of compressed formats are stored row by row, with partial blocks at the borders padded to full blocks.
+std::size_t GetTextureLevelSize(TextureFormat format, std::size_t width, std::size_t height);
+
+// The width or height of a mip map level, where level 0 has the given extent
+inline std::size_t GetMipMapLevelExtent(std::size_t extent, std::size_t level) {
+  return std::max<std::size_t>(extent >> level, 1);
+}
+
+// The number of levels down to a size of 1x1
+std::size_t GetCompleteMipMapCount(std::size_t width, std::size_t height);
+
 enum class TextureFilter {
   POINT,
   BILINEAR,
@@ -2,8 +2,11 @@
 
 #include <cstdlib>
 #include <memory>
+#include <span>
+#include <vector>
 
 #include <ovis/utils/result.hpp>
+#include <ovis/core/asset_cache.hpp>
 #include <ovis/core/asset_library.hpp>
 #include <ovis/graphics/texture.hpp>
 
@@ -14,16 +17,29 @@ class ResourceManager;
 struct Texture2DDescription {
   std::size_t width;
   std::size_t height;
+  // The number of mip map levels that are provided, including the first one. If it is 0, the complete chain is
+  // generated from the first level when the texture is created, which is not possible for block compressed formats.
   std::size_t mip_map_count;
   TextureFormat format;
   TextureFilter filter;
 };
 
+// The description and the levels of a texture asset, starting with the full resolution. Loading them does not require
+// the graphics context, so it can be done on any thread, e.g., by the AssetLoader.
+struct Texture2DData {
+  Texture2DDescription description;
+  std::vector<AssetView> levels;
+};
+
 class Texture2D : public Texture {
   friend class RenderTargetTexture2D;
 
  public:
   Texture2D(GraphicsContext* context, const Texture2DDescription& description, const void* pixels = nullptr);
+  // Uploads the given mip map levels, see GetTextureLevelSize() for their layout. Levels of a block compressed format
+  // that the GPU does not support are decompressed, which changes the format of the description to RGBA_UINT8.
+  Texture2D(GraphicsContext* context, const Texture2DDescription& description, std::span<const void* const> levels);
+  Texture2D(GraphicsContext* context, const Texture2DData& data);
 
   void GenerateMipMaps();
 
@@ -37,9 +53,18 @@ class Texture2D : public Texture {
   virtual void Bind(int texture_unit) override;
 };
 
+// The memory of the texture on the GPU, including the mip maps, for the AssetCache
+AssetMemoryUsage GetAssetMemoryUsage(const Texture2D& texture);
+
+// The "json" file of a texture asset contains the "width", the "height", the "format" (e.g., "RGBA_UINT8" or "RGB_BC1"),
+// the "filter" ("point", "bilinear" or "trilinear") and optionally the "mip_map_count", see Texture2DDescription.
 Result<Texture2DDescription> LoadTexture2DDescription(const std::string& asset_id);
 Result<Texture2DDescription> LoadTexture2DDescription(AssetLibrary* asset_library, const std::string& asset_id);
 
+// Loads the description from the "json" file and the levels from the files "0", "1", etc.
+Result<Texture2DData> LoadTexture2DData(AssetLibrary* asset_library, const std::string& asset_id);
+
+// Blocks until the texture is loaded. See LoadTexture2DData() for loading it in the background.
 std::unique_ptr<Texture2D> LoadTexture2D(const std::string& asset_id, GraphicsContext* graphics_context);
 std::unique_ptr<Texture2D> LoadTexture2D(AssetLibrary* asset_library, const std::string& asset_id,
                                          GraphicsContext* graphics_context);
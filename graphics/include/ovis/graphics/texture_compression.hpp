@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "ovis/utils/file.hpp"
+#include "ovis/graphics/texture.hpp"
+
+namespace ovis {
+
+// Encodes a level of RGBA_UINT8 pixels into the block compressed format, which must be RGB_BC1 or RGBA_BC3. The alpha
+// channel is ignored for RGB_BC1. Blocks at the right and bottom border are padded by repeating the last column and
+// row. The encoder fits the endpoints of each block to the principal axis of its colors, so it is meant to be run
+// offline, e.g., by the texture cooker.
+Blob CompressTextureLevel(TextureFormat format, std::size_t width, std::size_t height,
+                          std::span<const std::byte> rgba_pixels);
+
+// Decodes a level of a block compressed format into RGBA_UINT8 pixels. Used when the GPU does not support the format.
+Blob DecompressTextureLevel(TextureFormat format, std::size_t width, std::size_t height,
+                            std::span<const std::byte> blocks);
+
+}  // namespace ovis
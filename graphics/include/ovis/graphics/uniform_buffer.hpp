@@ -44,7 +44,11 @@ class UniformBuffer : public GraphicsResource {
       return;
     }
     assert(m_uniform_descriptions[it_uniform->second].type == OpenGLType<std::remove_reference_t<T>>);
-    memcpy(GetUniformPointer(it_uniform->second), &value, sizeof(value));
+    void* const uniform_pointer = GetUniformPointer(it_uniform->second);
+    if (memcmp(uniform_pointer, &value, sizeof(value)) != 0) {
+      memcpy(uniform_pointer, &value, sizeof(value));
+      m_dirty_uniforms[it_uniform->second] = true;
+    }
   }
 
   inline void SetTexture(const std::string& sampler_name, Texture2D* texture) {
@@ -70,6 +74,8 @@ class UniformBuffer : public GraphicsResource {
   std::unordered_map<std::string, std::size_t> m_uniform_indices;
   std::vector<UniformDesciption> m_uniform_descriptions;
   std::vector<GLbyte> m_uniform_buffer;
+  // Uniform values are part of the program state, so only the ones that changed since the last Bind() are uploaded
+  std::vector<bool> m_dirty_uniforms;
   std::vector<Texture*> m_textures;
 
   inline void* GetUniformBufferPointer(std::size_t offset) { return m_uniform_buffer.data() + offset; }
@@ -9,9 +9,11 @@ namespace ovis {
 struct VertexBufferDescription {
   std::size_t size_in_bytes;
   std::size_t vertex_size_in_bytes;
+  BufferUsage usage = BufferUsage::STATIC;
 };
 
 class VertexBuffer final : public GraphicsBuffer {
+  friend class StreamingVertexBuffer;
   friend class VertexInput;
 
  public:
@@ -63,6 +63,9 @@ struct VertexAttributeDescription {
   std::size_t offset_in_bytes;
   std::size_t buffer_index;
   VertexAttributeType type;
+  // If not zero, the attribute advances once every instance_divisor instances instead of once per vertex. This is not
+  // supported on WebGL.
+  std::size_t instance_divisor = 0;
 };
 
 struct VertexInputDescription {
@@ -79,6 +82,7 @@ class VertexInput final : public GraphicsResource {
     GLuint array_buffer;
     GLenum type;
     GLint size;
+    GLuint divisor;
     GLboolean normalized;
     GLboolean enabled;
   };
@@ -91,8 +95,9 @@ class VertexInput final : public GraphicsResource {
  private:
   VertexInputDescription m_description;
   std::vector<AttributeGlDesc> m_attribute_gl_descriptions;
+  bool m_has_instanced_attributes = false;
 
-  void Bind();
+  void Bind(std::uint32_t base_instance);
 };
 
 }  // namespace ovis
@@ -1,6 +1,10 @@
 #include "ovis/graphics/graphics_context.hpp"
 
+#include <algorithm>
+
 #include "ovis/utils/log.hpp"
+#include "ovis/core/asset_cache.hpp"
+#include "ovis/graphics/graphics_recording.hpp"
 #include "ovis/graphics/index_buffer.hpp"
 #include "ovis/graphics/render_target_configuration.hpp"
 #include "ovis/graphics/shader_program.hpp"
@@ -8,12 +12,25 @@
 
 namespace ovis {
 
+namespace {
+
+// Assets that are not in use anymore are kept until they exceed this
+constexpr AssetMemoryUsage ASSET_CACHE_BUDGET = {.cpu_bytes = 64 * 1024 * 1024, .gpu_bytes = 256 * 1024 * 1024};
+
+}  // namespace
+
 GraphicsContext::GraphicsContext(Vector2 framebuffer_dimensions)
     : m_bound_array_buffer(0),
       m_bound_element_array_buffer(0),
       m_bound_program(0),
       m_active_texture_unit(0),
       scissoring_enabled_(false) {
+  asset_cache_ = std::make_unique<AssetCache>(ASSET_CACHE_BUDGET);
+
+#if OVIS_HEADLESS_GRAPHICS
+  recording_ = std::make_unique<GraphicsRecording>();
+  MakeGraphicsRecordingCurrent(recording_.get());
+#endif
 
 #if _WIN32
   glewInit();
@@ -29,7 +46,21 @@ GraphicsContext::GraphicsContext(Vector2 framebuffer_dimensions)
 
   glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &m_caps.num_vertex_texture_units);
 
+  GLint compressed_texture_format_count = 0;
+  glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &compressed_texture_format_count);
+  m_caps.compressed_texture_formats.resize(compressed_texture_format_count);
+  if (compressed_texture_format_count > 0) {
+    glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, m_caps.compressed_texture_formats.data());
+  }
+
+  // Rows of single channel and RGB textures are usually not aligned to 4 bytes
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  blend_state_.source_color_factor = SourceBlendFactor::SOURCE_ALPHA;
+  blend_state_.source_alpha_factor = SourceBlendFactor::SOURCE_ALPHA;
+  blend_state_.destination_color_factor = DestinationBlendFactor::ONE_MINUS_SOURCE_ALPHA;
+  blend_state_.destination_alpha_factor = DestinationBlendFactor::ONE_MINUS_SOURCE_ALPHA;
 
   viewport_width_ = framebuffer_dimensions.x;
   viewport_height_ = framebuffer_dimensions.y;
@@ -44,10 +75,31 @@ GraphicsContext::GraphicsContext(Vector2 framebuffer_dimensions)
 }
 
 GraphicsContext::~GraphicsContext() {
+  // The cached assets own resources of the context
+  asset_cache_.reset();
   m_default_render_target_configuration.reset();
   for (auto& resource : resources_) {
     assert(resource->type() == GraphicsResource::Type::NONE);
   }
+#if OVIS_HEADLESS_GRAPHICS
+  MakeGraphicsRecordingCurrent(nullptr);
+#endif
+}
+
+bool GraphicsContext::SupportsTextureFormat(TextureFormat format) const {
+  GLint compressed_format;
+  switch (format) {
+    case TextureFormat::RGB_BC1:
+      compressed_format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+      break;
+    case TextureFormat::RGBA_BC3:
+      compressed_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+      break;
+    default:
+      return true;
+  }
+  return std::find(m_caps.compressed_texture_formats.begin(), m_caps.compressed_texture_formats.end(),
+                   compressed_format) != m_caps.compressed_texture_formats.end();
 }
 
 void GraphicsContext::SetFramebufferSize(int width, int height) {
@@ -59,8 +111,12 @@ void GraphicsContext::Draw(const DrawItem& draw_item) {
   assert(draw_item.shader_program != nullptr);
   // assert(draw_item.vertex_input != nullptr);
 
-  ApplyBlendState(&blend_state_, draw_item.blend_state);
-  ApplyDepthBufferState(&depth_buffer_state_, draw_item.depth_buffer_state);
+  if (recording_) {
+    recording_->RecordDrawItem(draw_item);
+  }
+
+  CountStateChange(ApplyBlendState(&blend_state_, draw_item.blend_state));
+  CountStateChange(ApplyDepthBufferState(&depth_buffer_state_, draw_item.depth_buffer_state));
 
   auto targets = draw_item.render_target_configuration != nullptr ? draw_item.render_target_configuration
                                                                   : default_render_target_configuration();
@@ -69,6 +125,9 @@ void GraphicsContext::Draw(const DrawItem& draw_item) {
     glViewport(0, 0, targets->width(), targets->height());
     viewport_width_ = targets->width();
     viewport_height_ = targets->height();
+    CountStateChange(true);
+  } else {
+    CountStateChange(false);
   }
 
   if (draw_item.scissor_rect.has_value() != scissoring_enabled_) {
@@ -79,11 +138,19 @@ void GraphicsContext::Draw(const DrawItem& draw_item) {
       glDisable(GL_SCISSOR_TEST);
       scissoring_enabled_ = false;
     }
+    CountStateChange(true);
+  } else {
+    CountStateChange(false);
   }
-  if (draw_item.scissor_rect.has_value() && *draw_item.scissor_rect != current_scissor_rect_) {
-    const int bottom = targets->height() - draw_item.scissor_rect->top - draw_item.scissor_rect->height;
-    glScissor(draw_item.scissor_rect->left, bottom, draw_item.scissor_rect->width, draw_item.scissor_rect->height);
-    current_scissor_rect_ = *draw_item.scissor_rect;
+  if (draw_item.scissor_rect.has_value()) {
+    if (*draw_item.scissor_rect != current_scissor_rect_) {
+      const int bottom = targets->height() - draw_item.scissor_rect->top - draw_item.scissor_rect->height;
+      glScissor(draw_item.scissor_rect->left, bottom, draw_item.scissor_rect->width, draw_item.scissor_rect->height);
+      current_scissor_rect_ = *draw_item.scissor_rect;
+      CountStateChange(true);
+    } else {
+      CountStateChange(false);
+    }
   }
 
   if (culling_enabled_ != draw_item.enable_culling) {
@@ -93,11 +160,14 @@ void GraphicsContext::Draw(const DrawItem& draw_item) {
       glDisable(GL_CULL_FACE);
     }
     culling_enabled_ = draw_item.enable_culling;
+    CountStateChange(true);
+  } else {
+    CountStateChange(false);
   }
 
   draw_item.shader_program->Bind();
   if (draw_item.vertex_input != nullptr) {
-    draw_item.vertex_input->Bind();
+    draw_item.vertex_input->Bind(draw_item.base_instance);
   }
   const GLenum primitive_topology = static_cast<GLenum>(draw_item.primitive_topology);
 
@@ -109,7 +179,15 @@ void GraphicsContext::Draw(const DrawItem& draw_item) {
     assert(validation_status == GL_TRUE);
 #endif
 
-    glDrawArrays(primitive_topology, draw_item.start, draw_item.count);
+    if (draw_item.instance_count == 1) {
+      glDrawArrays(primitive_topology, draw_item.start, draw_item.count);
+    } else {
+#if !OVIS_EMSCRIPTEN
+      glDrawArraysInstanced(primitive_topology, draw_item.start, draw_item.count, draw_item.instance_count);
+#else
+      assert(false && "Instancing is not supported on WebGL");
+#endif
+    }
   } else {
     draw_item.index_buffer->Bind();
 
@@ -123,10 +201,17 @@ void GraphicsContext::Draw(const DrawItem& draw_item) {
     const GLenum index_type = static_cast<GLenum>(draw_item.index_buffer->description().index_format);
     const auto index_offset_in_bytes = draw_item.start * draw_item.index_buffer->bytes_per_index();
 #if !OVIS_EMSCRIPTEN
-    glDrawElementsBaseVertex(primitive_topology, draw_item.count, index_type,
-                             reinterpret_cast<GLvoid*>(index_offset_in_bytes), draw_item.base_vertex);
+    if (draw_item.instance_count == 1) {
+      glDrawElementsBaseVertex(primitive_topology, draw_item.count, index_type,
+                               reinterpret_cast<GLvoid*>(index_offset_in_bytes), draw_item.base_vertex);
+    } else {
+      glDrawElementsInstancedBaseVertex(primitive_topology, draw_item.count, index_type,
+                                        reinterpret_cast<GLvoid*>(index_offset_in_bytes), draw_item.instance_count,
+                                        draw_item.base_vertex);
+    }
 #else
     assert(draw_item.base_vertex == 0);
+    assert(draw_item.instance_count == 1);
     glDrawElements(primitive_topology, draw_item.count, index_type, reinterpret_cast<GLvoid*>(index_offset_in_bytes));
 #endif
   }
@@ -0,0 +1,48 @@
+#include "ovis/graphics/graphics_recording.hpp"
+
+namespace ovis {
+
+void GraphicsRecording::Record(const GraphicsCommand& command) {
+  commands_.push_back(command);
+
+  switch (command.type) {
+    case GraphicsCommand::Type::RESOURCE:
+      break;
+
+    case GraphicsCommand::Type::STATE_CHANGE:
+      ++statistics_.state_changes;
+      break;
+
+    case GraphicsCommand::Type::TEXTURE_BIND:
+      ++statistics_.state_changes;
+      ++statistics_.texture_binds;
+      break;
+
+    case GraphicsCommand::Type::BUFFER_UPLOAD:
+      ++statistics_.buffer_uploads;
+      statistics_.uploaded_bytes += command.size_in_bytes;
+      break;
+
+    case GraphicsCommand::Type::TEXTURE_UPLOAD:
+      ++statistics_.texture_uploads;
+      statistics_.uploaded_bytes += command.size_in_bytes;
+      break;
+
+    case GraphicsCommand::Type::CLEAR:
+      ++statistics_.clears;
+      break;
+
+    case GraphicsCommand::Type::DRAW:
+      ++statistics_.draw_calls;
+      statistics_.drawn_elements += command.count;
+      break;
+  }
+}
+
+void GraphicsRecording::Clear() {
+  commands_.clear();
+  draw_items_.clear();
+  statistics_ = {};
+}
+
+}  // namespace ovis
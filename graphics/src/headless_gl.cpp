@@ -0,0 +1,513 @@
+// Implementation of the OpenGL functions used by Ovis that does not require a GPU. It is compiled instead of linking
+// against OpenGL when OVIS_HEADLESS_GRAPHICS is enabled. All calls are recorded into the current GraphicsRecording.
+// Objects only exist as names and shaders are not compiled. However, the attribute and uniform declarations are parsed
+// from the shader sources, so shader programs report the same attributes and uniforms as they would with a real
+// driver.
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ovis/graphics/gl.hpp"
+#include "ovis/graphics/graphics_recording.hpp"
+
+namespace ovis {
+
+namespace {
+
+GraphicsRecording* current_recording = nullptr;
+GLuint next_object_name = 1;
+
+struct Variable {
+  std::string name;
+  GLenum type;
+  GLint size;
+};
+
+struct Shader {
+  GLenum type;
+  std::string source;
+};
+
+struct Program {
+  std::vector<GLuint> shaders;
+  std::vector<Variable> attributes;
+  std::vector<Variable> uniforms;
+};
+
+std::unordered_map<GLuint, Shader> shaders;
+std::unordered_map<GLuint, Program> programs;
+// Mapped buffer ranges point into this memory, the data written to it is discarded
+std::vector<std::byte> mapped_buffer_range;
+std::uintptr_t next_sync_object = 1;
+
+void Record(GraphicsCommand::Type type, const char* function, GLuint object = 0, std::size_t size_in_bytes = 0,
+            std::size_t count = 0) {
+  if (current_recording != nullptr) {
+    current_recording->Record({
+        .type = type,
+        .function = function,
+        .object = object,
+        .size_in_bytes = size_in_bytes,
+        .count = count,
+    });
+  }
+}
+
+void GenerateNames(const char* function, GLsizei n, GLuint* names) {
+  for (GLsizei i = 0; i < n; ++i) {
+    names[i] = next_object_name++;
+    Record(GraphicsCommand::Type::RESOURCE, function, names[i]);
+  }
+}
+
+GLenum GetVariableType(const std::string& type) {
+  static const std::unordered_map<std::string, GLenum> types = {
+      {"float", GL_FLOAT},          {"vec2", GL_FLOAT_VEC2},   {"vec3", GL_FLOAT_VEC3},
+      {"vec4", GL_FLOAT_VEC4},      {"int", GL_INT},           {"ivec2", GL_INT_VEC2},
+      {"ivec3", GL_INT_VEC3},       {"ivec4", GL_INT_VEC4},    {"bool", GL_BOOL},
+      {"bvec2", GL_BOOL_VEC2},      {"bvec3", GL_BOOL_VEC3},   {"bvec4", GL_BOOL_VEC4},
+      {"mat2", GL_FLOAT_MAT2},      {"mat3", GL_FLOAT_MAT3},   {"mat4", GL_FLOAT_MAT4},
+      {"sampler2D", GL_SAMPLER_2D}, {"samplerCube", GL_SAMPLER_CUBE},
+  };
+  const auto type_iterator = types.find(type);
+  return type_iterator != types.end() ? type_iterator->second : GL_NONE;
+}
+
+// Parses the global declarations with the given qualifier, e.g., "uniform mat4 u_Transform;" or "in vec2 a_Position;"
+void ParseDeclarations(const std::string& source, const std::string& qualifier, std::vector<Variable>* variables) {
+  // Remove preprocessor directives and split the source into statements
+  std::string code;
+  std::istringstream lines(source);
+  for (std::string line; std::getline(lines, line);) {
+    if (line.find_first_not_of(" \t") != std::string::npos && line[line.find_first_not_of(" \t")] == '#') {
+      continue;
+    }
+    code += line;
+    code += '\n';
+  }
+  for (char& c : code) {
+    if (c == '{' || c == '}') {
+      c = ';';
+    }
+  }
+
+  std::istringstream statements(code);
+  for (std::string statement; std::getline(statements, statement, ';');) {
+    std::istringstream tokens(statement);
+    std::vector<std::string> words;
+    for (std::string token; tokens >> token;) {
+      if (token.starts_with("layout") || token == "lowp" || token == "mediump" || token == "highp" ||
+          token == "flat") {
+        continue;
+      }
+      words.push_back(token);
+    }
+    if (words.size() != 3 || words[0] != qualifier) {
+      continue;
+    }
+
+    Variable variable{.name = words[2], .type = GetVariableType(words[1]), .size = 1};
+    if (const auto bracket = variable.name.find('['); bracket != std::string::npos) {
+      variable.size = std::stoi(variable.name.substr(bracket + 1));
+      variable.name = variable.name.substr(0, bracket);
+    }
+    if (variable.type != GL_NONE) {
+      variables->push_back(variable);
+    }
+  }
+}
+
+void GetVariable(const std::vector<Variable>& variables, GLuint index, GLsizei buffer_size, GLsizei* length,
+                 GLint* size, GLenum* type, GLchar* name) {
+  assert(index < variables.size());
+  const Variable& variable = variables[index];
+  *size = variable.size;
+  *type = variable.type;
+  const auto name_length = std::min<std::size_t>(buffer_size - 1, variable.name.size());
+  std::memcpy(name, variable.name.data(), name_length);
+  name[name_length] = '\0';
+  if (length != nullptr) {
+    *length = name_length;
+  }
+}
+
+GLint FindVariable(const std::vector<Variable>& variables, const GLchar* name) {
+  for (std::size_t i = 0; i < variables.size(); ++i) {
+    if (variables[i].name == name) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+GLint GetMaxNameLength(const std::vector<Variable>& variables) {
+  std::size_t max_length = 0;
+  for (const auto& variable : variables) {
+    max_length = std::max(max_length, variable.name.size() + 1);
+  }
+  return max_length;
+}
+
+std::size_t GetPixelSize(GLenum format, GLenum type) {
+  std::size_t component_count = 4;
+  switch (format) {
+    case GL_RED:
+    case GL_DEPTH_COMPONENT:
+      component_count = 1;
+      break;
+    case GL_RG:
+      component_count = 2;
+      break;
+    case GL_RGB:
+      component_count = 3;
+      break;
+  }
+  switch (type) {
+    case GL_FLOAT:
+      return component_count * 4;
+    case GL_HALF_FLOAT:
+    case GL_UNSIGNED_SHORT:
+      return component_count * 2;
+    default:
+      return component_count;
+  }
+}
+
+}  // namespace
+
+void MakeGraphicsRecordingCurrent(GraphicsRecording* recording) {
+  current_recording = recording;
+}
+
+}  // namespace ovis
+
+using ovis::GraphicsCommand;
+using ovis::Record;
+
+extern "C" {
+
+// Objects
+void APIENTRY glGenBuffers(GLsizei n, GLuint* buffers) { ovis::GenerateNames("glGenBuffers", n, buffers); }
+void APIENTRY glGenFramebuffers(GLsizei n, GLuint* framebuffers) {
+  ovis::GenerateNames("glGenFramebuffers", n, framebuffers);
+}
+void APIENTRY glGenQueries(GLsizei n, GLuint* ids) { ovis::GenerateNames("glGenQueries", n, ids); }
+void APIENTRY glGenTextures(GLsizei n, GLuint* textures) { ovis::GenerateNames("glGenTextures", n, textures); }
+void APIENTRY glGenVertexArrays(GLsizei n, GLuint* arrays) { ovis::GenerateNames("glGenVertexArrays", n, arrays); }
+void APIENTRY glDeleteBuffers(GLsizei n, const GLuint*) { Record(GraphicsCommand::Type::RESOURCE, "glDeleteBuffers"); }
+void APIENTRY glDeleteFramebuffers(GLsizei n, const GLuint*) {
+  Record(GraphicsCommand::Type::RESOURCE, "glDeleteFramebuffers");
+}
+void APIENTRY glDeleteQueries(GLsizei n, const GLuint*) { Record(GraphicsCommand::Type::RESOURCE, "glDeleteQueries"); }
+void APIENTRY glDeleteTextures(GLsizei n, const GLuint*) {
+  Record(GraphicsCommand::Type::RESOURCE, "glDeleteTextures");
+}
+GLenum APIENTRY glCheckFramebufferStatus(GLenum) { return GL_FRAMEBUFFER_COMPLETE; }
+
+// Shaders and programs
+GLuint APIENTRY glCreateShader(GLenum type) {
+  const GLuint name = ovis::next_object_name++;
+  ovis::shaders[name] = {.type = type};
+  Record(GraphicsCommand::Type::RESOURCE, "glCreateShader", name);
+  return name;
+}
+void APIENTRY glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) {
+  auto& source = ovis::shaders[shader].source;
+  source.clear();
+  for (GLsizei i = 0; i < count; ++i) {
+    source += length ? std::string(string[i], length[i]) : std::string(string[i]);
+  }
+  Record(GraphicsCommand::Type::RESOURCE, "glShaderSource", shader);
+}
+void APIENTRY glCompileShader(GLuint shader) { Record(GraphicsCommand::Type::RESOURCE, "glCompileShader", shader); }
+void APIENTRY glGetShaderiv(GLuint, GLenum pname, GLint* params) {
+  *params = pname == GL_COMPILE_STATUS ? 1 : 0;
+}
+void APIENTRY glGetShaderInfoLog(GLuint, GLsizei buffer_size, GLsizei* length, GLchar* info_log) {
+  if (buffer_size > 0) {
+    info_log[0] = '\0';
+  }
+  if (length != nullptr) {
+    *length = 0;
+  }
+}
+void APIENTRY glDeleteShader(GLuint shader) { Record(GraphicsCommand::Type::RESOURCE, "glDeleteShader", shader); }
+
+GLuint APIENTRY glCreateProgram() {
+  const GLuint name = ovis::next_object_name++;
+  ovis::programs[name] = {};
+  Record(GraphicsCommand::Type::RESOURCE, "glCreateProgram", name);
+  return name;
+}
+void APIENTRY glAttachShader(GLuint program, GLuint shader) {
+  ovis::programs[program].shaders.push_back(shader);
+  Record(GraphicsCommand::Type::RESOURCE, "glAttachShader", program);
+}
+void APIENTRY glLinkProgram(GLuint program) {
+  auto& linked_program = ovis::programs[program];
+  for (const GLuint shader_name : linked_program.shaders) {
+    const auto& shader = ovis::shaders[shader_name];
+    if (shader.type == GL_VERTEX_SHADER) {
+      ovis::ParseDeclarations(shader.source, "in", &linked_program.attributes);
+      ovis::ParseDeclarations(shader.source, "attribute", &linked_program.attributes);
+    }
+    std::vector<ovis::Variable> uniforms;
+    ovis::ParseDeclarations(shader.source, "uniform", &uniforms);
+    for (const auto& uniform : uniforms) {
+      if (ovis::FindVariable(linked_program.uniforms, uniform.name.c_str()) < 0) {
+        linked_program.uniforms.push_back(uniform);
+      }
+    }
+  }
+  Record(GraphicsCommand::Type::RESOURCE, "glLinkProgram", program);
+}
+void APIENTRY glValidateProgram(GLuint) {}
+void APIENTRY glGetProgramiv(GLuint program, GLenum pname, GLint* params) {
+  const auto& queried_program = ovis::programs[program];
+  switch (pname) {
+    case GL_LINK_STATUS:
+    case GL_VALIDATE_STATUS:
+      *params = 1;
+      break;
+    case GL_ACTIVE_ATTRIBUTES:
+      *params = queried_program.attributes.size();
+      break;
+    case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:
+      *params = ovis::GetMaxNameLength(queried_program.attributes);
+      break;
+    case GL_ACTIVE_UNIFORMS:
+      *params = queried_program.uniforms.size();
+      break;
+    case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+      *params = ovis::GetMaxNameLength(queried_program.uniforms);
+      break;
+    default:
+      *params = 0;
+      break;
+  }
+}
+void APIENTRY glGetProgramInfoLog(GLuint, GLsizei buffer_size, GLsizei* length, GLchar* info_log) {
+  if (buffer_size > 0) {
+    info_log[0] = '\0';
+  }
+  if (length != nullptr) {
+    *length = 0;
+  }
+}
+void APIENTRY glGetActiveAttrib(GLuint program, GLuint index, GLsizei buffer_size, GLsizei* length, GLint* size,
+                                GLenum* type, GLchar* name) {
+  ovis::GetVariable(ovis::programs[program].attributes, index, buffer_size, length, size, type, name);
+}
+void APIENTRY glGetActiveUniform(GLuint program, GLuint index, GLsizei buffer_size, GLsizei* length, GLint* size,
+                                 GLenum* type, GLchar* name) {
+  ovis::GetVariable(ovis::programs[program].uniforms, index, buffer_size, length, size, type, name);
+}
+GLint APIENTRY glGetAttribLocation(GLuint program, const GLchar* name) {
+  return ovis::FindVariable(ovis::programs[program].attributes, name);
+}
+GLint APIENTRY glGetUniformLocation(GLuint program, const GLchar* name) {
+  return ovis::FindVariable(ovis::programs[program].uniforms, name);
+}
+void APIENTRY glDeleteProgram(GLuint program) {
+  ovis::programs.erase(program);
+  Record(GraphicsCommand::Type::RESOURCE, "glDeleteProgram", program);
+}
+
+// Queries
+void APIENTRY glGetIntegerv(GLenum pname, GLint* data) {
+  switch (pname) {
+    case GL_MAX_VERTEX_ATTRIBS:
+      *data = 16;
+      break;
+    case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+      *data = 32;
+      break;
+    case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS:
+      *data = 16;
+      break;
+    case GL_NUM_COMPRESSED_TEXTURE_FORMATS:
+      *data = 2;
+      break;
+    case GL_COMPRESSED_TEXTURE_FORMATS:
+      data[0] = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+      data[1] = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+      break;
+    default:
+      *data = 0;
+      break;
+  }
+}
+const GLubyte* APIENTRY glGetString(GLenum) { return reinterpret_cast<const GLubyte*>("Ovis Headless"); }
+void APIENTRY glBeginQuery(GLenum, GLuint id) { Record(GraphicsCommand::Type::RESOURCE, "glBeginQuery", id); }
+void APIENTRY glEndQuery(GLenum) { Record(GraphicsCommand::Type::RESOURCE, "glEndQuery"); }
+void APIENTRY glGetQueryObjectiv(GLuint, GLenum pname, GLint* params) {
+  *params = pname == GL_QUERY_RESULT_AVAILABLE ? 1 : 0;
+}
+void APIENTRY glGetQueryObjectui64v(GLuint, GLenum, GLuint64* params) { *params = 0; }
+void APIENTRY glReadPixels(GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels) {
+  std::memset(pixels, 0, width * height * ovis::GetPixelSize(format, type));
+}
+
+// State changes
+void APIENTRY glActiveTexture(GLenum texture) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glActiveTexture", texture - GL_TEXTURE0);
+}
+void APIENTRY glBindBuffer(GLenum, GLuint buffer) { Record(GraphicsCommand::Type::STATE_CHANGE, "glBindBuffer", buffer); }
+void APIENTRY glBindFramebuffer(GLenum, GLuint framebuffer) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glBindFramebuffer", framebuffer);
+}
+void APIENTRY glBindTexture(GLenum, GLuint texture) {
+  Record(GraphicsCommand::Type::TEXTURE_BIND, "glBindTexture", texture);
+}
+void APIENTRY glBindVertexArray(GLuint array) { Record(GraphicsCommand::Type::STATE_CHANGE, "glBindVertexArray", array); }
+void APIENTRY glBlendColor(GLfloat, GLfloat, GLfloat, GLfloat) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glBlendColor");
+}
+void APIENTRY glBlendEquationSeparate(GLenum, GLenum) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glBlendEquationSeparate");
+}
+void APIENTRY glBlendFunc(GLenum, GLenum) { Record(GraphicsCommand::Type::STATE_CHANGE, "glBlendFunc"); }
+void APIENTRY glBlendFuncSeparate(GLenum, GLenum, GLenum, GLenum) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glBlendFuncSeparate");
+}
+void APIENTRY glDepthFunc(GLenum) { Record(GraphicsCommand::Type::STATE_CHANGE, "glDepthFunc"); }
+void APIENTRY glDepthMask(GLboolean) { Record(GraphicsCommand::Type::STATE_CHANGE, "glDepthMask"); }
+void APIENTRY glEnable(GLenum cap) { Record(GraphicsCommand::Type::STATE_CHANGE, "glEnable", cap); }
+void APIENTRY glDisable(GLenum cap) { Record(GraphicsCommand::Type::STATE_CHANGE, "glDisable", cap); }
+void APIENTRY glEnableVertexAttribArray(GLuint index) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glEnableVertexAttribArray", index);
+}
+void APIENTRY glDisableVertexAttribArray(GLuint index) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glDisableVertexAttribArray", index);
+}
+void APIENTRY glVertexAttribPointer(GLuint index, GLint, GLenum, GLboolean, GLsizei, const void*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glVertexAttribPointer", index);
+}
+void APIENTRY glVertexAttribDivisor(GLuint index, GLuint) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glVertexAttribDivisor", index);
+}
+void APIENTRY glDrawBuffers(GLsizei, const GLenum*) { Record(GraphicsCommand::Type::STATE_CHANGE, "glDrawBuffers"); }
+void APIENTRY glFramebufferTexture2D(GLenum, GLenum, GLenum, GLuint texture, GLint) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glFramebufferTexture2D", texture);
+}
+void APIENTRY glScissor(GLint, GLint, GLsizei, GLsizei) { Record(GraphicsCommand::Type::STATE_CHANGE, "glScissor"); }
+void APIENTRY glViewport(GLint, GLint, GLsizei, GLsizei) { Record(GraphicsCommand::Type::STATE_CHANGE, "glViewport"); }
+void APIENTRY glTexParameteri(GLenum, GLenum, GLint) { Record(GraphicsCommand::Type::STATE_CHANGE, "glTexParameteri"); }
+void APIENTRY glUseProgram(GLuint program) { Record(GraphicsCommand::Type::STATE_CHANGE, "glUseProgram", program); }
+void APIENTRY glUniform1i(GLint location, GLint) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniform1i", location, sizeof(GLint));
+}
+void APIENTRY glUniform1iv(GLint location, GLsizei count, const GLint*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniform1iv", location, count * sizeof(GLint));
+}
+void APIENTRY glUniform2iv(GLint location, GLsizei count, const GLint*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniform2iv", location, count * 2 * sizeof(GLint));
+}
+void APIENTRY glUniform3iv(GLint location, GLsizei count, const GLint*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniform3iv", location, count * 3 * sizeof(GLint));
+}
+void APIENTRY glUniform4iv(GLint location, GLsizei count, const GLint*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniform4iv", location, count * 4 * sizeof(GLint));
+}
+void APIENTRY glUniform1fv(GLint location, GLsizei count, const GLfloat*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniform1fv", location, count * sizeof(GLfloat));
+}
+void APIENTRY glUniform2fv(GLint location, GLsizei count, const GLfloat*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniform2fv", location, count * 2 * sizeof(GLfloat));
+}
+void APIENTRY glUniform3fv(GLint location, GLsizei count, const GLfloat*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniform3fv", location, count * 3 * sizeof(GLfloat));
+}
+void APIENTRY glUniform4fv(GLint location, GLsizei count, const GLfloat*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniform4fv", location, count * 4 * sizeof(GLfloat));
+}
+void APIENTRY glUniformMatrix2fv(GLint location, GLsizei count, GLboolean, const GLfloat*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniformMatrix2fv", location, count * 4 * sizeof(GLfloat));
+}
+void APIENTRY glUniformMatrix3fv(GLint location, GLsizei count, GLboolean, const GLfloat*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniformMatrix3fv", location, count * 9 * sizeof(GLfloat));
+}
+void APIENTRY glUniformMatrix4fv(GLint location, GLsizei count, GLboolean, const GLfloat*) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glUniformMatrix4fv", location, count * 16 * sizeof(GLfloat));
+}
+
+// Uploads
+void APIENTRY glBufferData(GLenum, GLsizeiptr size, const void* data, GLenum) {
+  // Allocating the buffer storage without any data does not upload anything
+  Record(GraphicsCommand::Type::BUFFER_UPLOAD, "glBufferData", 0, data != nullptr ? size : 0);
+}
+void APIENTRY glBufferSubData(GLenum, GLintptr, GLsizeiptr size, const void*) {
+  Record(GraphicsCommand::Type::BUFFER_UPLOAD, "glBufferSubData", 0, size);
+}
+void* APIENTRY glMapBufferRange(GLenum, GLintptr, GLsizeiptr length, GLbitfield) {
+  Record(GraphicsCommand::Type::BUFFER_UPLOAD, "glMapBufferRange", 0, length);
+  ovis::mapped_buffer_range.resize(std::max<std::size_t>(ovis::mapped_buffer_range.size(), length));
+  return ovis::mapped_buffer_range.data();
+}
+GLboolean APIENTRY glUnmapBuffer(GLenum) {
+  Record(GraphicsCommand::Type::RESOURCE, "glUnmapBuffer");
+  return GL_TRUE;
+}
+void APIENTRY glTexImage2D(GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum format, GLenum type,
+                           const void* pixels) {
+  Record(GraphicsCommand::Type::TEXTURE_UPLOAD, "glTexImage2D", 0,
+         pixels != nullptr ? width * height * ovis::GetPixelSize(format, type) : 0);
+}
+void APIENTRY glCompressedTexImage2D(GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei image_size,
+                                     const void*) {
+  Record(GraphicsCommand::Type::TEXTURE_UPLOAD, "glCompressedTexImage2D", 0, image_size);
+}
+void APIENTRY glTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type,
+                              const void*) {
+  Record(GraphicsCommand::Type::TEXTURE_UPLOAD, "glTexSubImage2D", 0,
+         width * height * ovis::GetPixelSize(format, type));
+}
+void APIENTRY glPixelStorei(GLenum, GLint) { Record(GraphicsCommand::Type::STATE_CHANGE, "glPixelStorei"); }
+void APIENTRY glTexStorage2D(GLenum, GLsizei, GLenum, GLsizei, GLsizei) {
+  Record(GraphicsCommand::Type::RESOURCE, "glTexStorage2D");
+}
+void APIENTRY glGenerateMipmap(GLenum) { Record(GraphicsCommand::Type::RESOURCE, "glGenerateMipmap"); }
+
+// Synchronization, the GPU is always done
+GLsync APIENTRY glFenceSync(GLenum, GLbitfield) {
+  Record(GraphicsCommand::Type::RESOURCE, "glFenceSync");
+  return reinterpret_cast<GLsync>(ovis::next_sync_object++);
+}
+GLenum APIENTRY glClientWaitSync(GLsync, GLbitfield, GLuint64) {
+  Record(GraphicsCommand::Type::RESOURCE, "glClientWaitSync");
+  return GL_ALREADY_SIGNALED;
+}
+void APIENTRY glDeleteSync(GLsync) { Record(GraphicsCommand::Type::RESOURCE, "glDeleteSync"); }
+
+// Clearing and drawing
+void APIENTRY glClear(GLbitfield) { Record(GraphicsCommand::Type::CLEAR, "glClear"); }
+void APIENTRY glClearBufferfv(GLenum, GLint, const GLfloat*) { Record(GraphicsCommand::Type::CLEAR, "glClearBufferfv"); }
+void APIENTRY glClearColor(GLfloat, GLfloat, GLfloat, GLfloat) {
+  Record(GraphicsCommand::Type::STATE_CHANGE, "glClearColor");
+}
+void APIENTRY glClearDepthf(GLfloat) { Record(GraphicsCommand::Type::STATE_CHANGE, "glClearDepthf"); }
+void APIENTRY glDrawArrays(GLenum, GLint, GLsizei count) {
+  Record(GraphicsCommand::Type::DRAW, "glDrawArrays", 0, 0, count);
+}
+void APIENTRY glDrawElements(GLenum, GLsizei count, GLenum, const void*) {
+  Record(GraphicsCommand::Type::DRAW, "glDrawElements", 0, 0, count);
+}
+void APIENTRY glDrawElementsBaseVertex(GLenum, GLsizei count, GLenum, const void*, GLint) {
+  Record(GraphicsCommand::Type::DRAW, "glDrawElementsBaseVertex", 0, 0, count);
+}
+void APIENTRY glDrawArraysInstanced(GLenum, GLint, GLsizei count, GLsizei instance_count) {
+  Record(GraphicsCommand::Type::DRAW, "glDrawArraysInstanced", 0, 0, count * instance_count);
+}
+void APIENTRY glDrawElementsInstancedBaseVertex(GLenum, GLsizei count, GLenum, const void*, GLsizei instance_count,
+                                                GLint) {
+  Record(GraphicsCommand::Type::DRAW, "glDrawElementsInstancedBaseVertex", 0, 0, count * instance_count);
+}
+
+}  // extern "C"
@@ -93,6 +93,9 @@ void RenderTargetConfiguration::Bind() {
 #if !OVIS_EMSCRIPTEN
     glDrawBuffers(draw_buffers_.size(), draw_buffers_.data());
 #endif
+    context()->CountStateChange(true);
+  } else {
+    context()->CountStateChange(false);
   }
 }
 
@@ -130,6 +130,9 @@ void ShaderProgram::Bind() {
   if (context()->m_bound_program != m_program_name) {
     glUseProgram(m_program_name);
     context()->m_bound_program = m_program_name;
+    context()->CountStateChange(true);
+  } else {
+    context()->CountStateChange(false);
   }
   m_uniform_buffer->Bind();
 }
@@ -0,0 +1,112 @@
+#include "ovis/graphics/streaming_vertex_buffer.hpp"
+
+#include <cstring>
+
+#include "ovis/utils/log.hpp"
+#include "ovis/graphics/graphics_context.hpp"
+
+namespace ovis {
+
+StreamingVertexBuffer::StreamingVertexBuffer(GraphicsContext* context,
+                                             const StreamingVertexBufferDescription& description)
+    : description_(description) {
+  assert(description.segment_vertex_count > 0);
+  assert(description.segment_count > 0);
+
+  VertexBufferDescription buffer_description;
+  buffer_description.vertex_size_in_bytes = description.vertex_size_in_bytes;
+  buffer_description.size_in_bytes =
+      description.vertex_size_in_bytes * description.segment_vertex_count * description.segment_count;
+  buffer_description.usage = BufferUsage::STREAM;
+  vertex_buffer_ = std::make_unique<VertexBuffer>(context, buffer_description);
+
+#if !OVIS_EMSCRIPTEN
+  segment_fences_.resize(description.segment_count, nullptr);
+#endif
+}
+
+StreamingVertexBuffer::~StreamingVertexBuffer() {
+#if !OVIS_EMSCRIPTEN
+  for (GLsync fence : segment_fences_) {
+    if (fence != nullptr) {
+      glDeleteSync(fence);
+    }
+  }
+#endif
+}
+
+std::size_t StreamingVertexBuffer::Write(const void* vertex_data, std::size_t vertex_count) {
+  assert(vertex_count <= description_.segment_vertex_count);
+
+  const std::size_t segment_end = (current_segment_ + 1) * description_.segment_vertex_count;
+  if (write_position_ + vertex_count > segment_end) {
+    BeginNextSegment();
+  }
+
+  const std::size_t first_vertex = write_position_;
+  const std::size_t offset_in_bytes = first_vertex * description_.vertex_size_in_bytes;
+  const std::size_t length_in_bytes = vertex_count * description_.vertex_size_in_bytes;
+  write_position_ += vertex_count;
+
+  vertex_buffer_->Bind();
+#if OVIS_EMSCRIPTEN
+  glBufferSubData(GL_ARRAY_BUFFER, offset_in_bytes, length_in_bytes, vertex_data);
+#else
+  // The region is not used by any draw that may still be in flight, so there is no need for the driver to synchronize
+  void* mapped_vertices =
+      glMapBufferRange(GL_ARRAY_BUFFER, offset_in_bytes, length_in_bytes,
+                       GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  if (mapped_vertices != nullptr) {
+    std::memcpy(mapped_vertices, vertex_data, length_in_bytes);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+  } else {
+    LogW("Failed to map streaming vertex buffer, falling back to glBufferSubData()");
+    glBufferSubData(GL_ARRAY_BUFFER, offset_in_bytes, length_in_bytes, vertex_data);
+  }
+#endif
+
+  return first_vertex;
+}
+
+void StreamingVertexBuffer::BeginNextSegment() {
+#if OVIS_EMSCRIPTEN
+  current_segment_ = (current_segment_ + 1) % description_.segment_count;
+  if (current_segment_ == 0) {
+    Orphan();
+  }
+#else
+  segment_fences_[current_segment_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  current_segment_ = (current_segment_ + 1) % description_.segment_count;
+
+  GLsync& fence = segment_fences_[current_segment_];
+  if (fence != nullptr) {
+    const GLenum wait_result = glClientWaitSync(fence, 0, 0);
+    glDeleteSync(fence);
+    fence = nullptr;
+    if (wait_result != GL_ALREADY_SIGNALED && wait_result != GL_CONDITION_SATISFIED) {
+      LogV("Streaming vertex buffer segment is still in use, orphaning the buffer");
+      Orphan();
+    }
+  }
+#endif
+  write_position_ = current_segment_ * description_.segment_vertex_count;
+}
+
+void StreamingVertexBuffer::Orphan() {
+  // The driver allocates new storage for the buffer while the draws that are still in flight keep using the old one
+  vertex_buffer_->Bind();
+  glBufferData(GL_ARRAY_BUFFER, vertex_buffer_->description().size_in_bytes, nullptr,
+               static_cast<GLenum>(BufferUsage::STREAM));
+
+#if !OVIS_EMSCRIPTEN
+  // The fences guard the old storage
+  for (GLsync& fence : segment_fences_) {
+    if (fence != nullptr) {
+      glDeleteSync(fence);
+      fence = nullptr;
+    }
+  }
+#endif
+}
+
+}  // namespace ovis
@@ -1,7 +1,59 @@
 #include <ovis/graphics/texture.hpp>
 
+#include <cassert>
+
 namespace ovis {
 
+std::size_t GetTexturePixelSize(TextureFormat format) {
+  switch (format) {
+    case TextureFormat::R_UINT8:
+      return 1;
+    case TextureFormat::RGB_UINT8:
+      return 3;
+    case TextureFormat::RGBA_UINT8:
+      return 4;
+    case TextureFormat::RGBA_FLOAT32:
+      return 16;
+    case TextureFormat::DEPTH_UINT16:
+      return 2;
+    case TextureFormat::DEPTH_UINT24:
+      // Usually stored in 32 bits
+      return 4;
+    case TextureFormat::DEPTH_FLOAT32:
+      return 4;
+    case TextureFormat::RGB_BC1:
+    case TextureFormat::RGBA_BC3:
+      // Block compressed formats do not have a size per pixel, use GetTextureLevelSize() instead
+      assert(false && "Block compressed formats do not have a pixel size");
+      return 0;
+  }
+  assert(false && "Invalid texture format");
+  return 0;
+}
+
+bool IsBlockCompressed(TextureFormat format) {
+  return format == TextureFormat::RGB_BC1 || format == TextureFormat::RGBA_BC3;
+}
+
+std::size_t GetTextureLevelSize(TextureFormat format, std::size_t width, std::size_t height) {
+  switch (format) {
+    case TextureFormat::RGB_BC1:
+      return ((width + 3) / 4) * ((height + 3) / 4) * 8;
+    case TextureFormat::RGBA_BC3:
+      return ((width + 3) / 4) * ((height + 3) / 4) * 16;
+    default:
+      return width * height * GetTexturePixelSize(format);
+  }
+}
+
+std::size_t GetCompleteMipMapCount(std::size_t width, std::size_t height) {
+  std::size_t count = 1;
+  while (GetMipMapLevelExtent(width, count - 1) > 1 || GetMipMapLevelExtent(height, count - 1) > 1) {
+    ++count;
+  }
+  return count;
+}
+
 Texture::Texture(GraphicsContext* context, Type type) : GraphicsResource(context, type) {
   glGenTextures(1, &name_);
 }
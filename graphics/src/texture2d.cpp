@@ -3,17 +3,69 @@
 #include "ovis/utils/file.hpp"
 #include "ovis/utils/log.hpp"
 #include "ovis/graphics/graphics_context.hpp"
+#include "ovis/graphics/texture_compression.hpp"
 
 namespace ovis {
 
+namespace {
+
+std::vector<const void*> GetLevelPointers(const Texture2DData& data) {
+  std::vector<const void*> levels;
+  levels.reserve(data.levels.size());
+  for (const AssetView& level : data.levels) {
+    levels.push_back(level.data().data());
+  }
+  return levels;
+}
+
+}  // namespace
+
 Texture2D::Texture2D(GraphicsContext* context, const Texture2DDescription& description, const void* pixels)
+    : Texture2D(context, description, std::span<const void* const>(&pixels, 1)) {}
+
+Texture2D::Texture2D(GraphicsContext* context, const Texture2DData& data)
+    : Texture2D(context, data.description, GetLevelPointers(data)) {}
+
+Texture2D::Texture2D(GraphicsContext* context, const Texture2DDescription& description,
+                     std::span<const void* const> levels)
     : Texture(context, Type::TEXTURE_2D), m_description(description) {
+  assert(!levels.empty());
+  assert(description.mip_map_count == 0 || levels.size() == 1 || levels.size() == description.mip_map_count);
   Bind(0);
 
+  // The decompressed levels have to exist until they are uploaded
+  std::vector<Blob> decompressed_levels;
+  std::vector<const void*> decompressed_level_pointers;
+  if (IsBlockCompressed(description.format) && !context->SupportsTextureFormat(description.format)) {
+    LogV("Block compressed texture format is not supported by the GPU, decompressing the texture");
+    for (std::size_t level = 0; level < levels.size(); ++level) {
+      const std::size_t width = GetMipMapLevelExtent(description.width, level);
+      const std::size_t height = GetMipMapLevelExtent(description.height, level);
+      decompressed_levels.push_back(DecompressTextureLevel(
+          description.format, width, height,
+          {static_cast<const std::byte*>(levels[level]), GetTextureLevelSize(description.format, width, height)}));
+      decompressed_level_pointers.push_back(decompressed_levels.back().data());
+    }
+    levels = decompressed_level_pointers;
+    m_description.format = TextureFormat::RGBA_UINT8;
+  }
+
   GLenum internal_format;
   GLenum source_format;
   GLenum source_type;
-  switch (description.format) {
+  switch (m_description.format) {
+    case TextureFormat::R_UINT8:
+#if OVIS_EMSCRIPTEN
+      // WebGL 1 has no red textures, luminance textures return the value in the red channel as well
+      internal_format = GL_LUMINANCE;
+      source_format = GL_LUMINANCE;
+#else
+      internal_format = GL_R8;
+      source_format = GL_RED;
+#endif
+      source_type = GL_UNSIGNED_BYTE;
+      break;
+
     case TextureFormat::RGB_UINT8:
       internal_format = GL_RGB;
       source_format = GL_RGB;
@@ -34,47 +86,67 @@ Texture2D::Texture2D(GraphicsContext* context, const Texture2DDescription& descr
       break;
 
     case TextureFormat::DEPTH_UINT16:
-      assert(pixels == nullptr);
+      assert(levels[0] == nullptr);
       internal_format = GL_DEPTH_COMPONENT16;
       source_format = GL_DEPTH_COMPONENT;
       source_type = GL_FLOAT;
       break;
 
     case TextureFormat::DEPTH_UINT24:
-      assert(pixels == nullptr);
+      assert(levels[0] == nullptr);
       internal_format = GL_DEPTH_COMPONENT24;
       source_format = GL_DEPTH_COMPONENT;
       source_type = GL_FLOAT;
       break;
 
     case TextureFormat::DEPTH_FLOAT32:
-      assert(pixels == nullptr);
+      assert(levels[0] == nullptr);
       internal_format = GL_DEPTH_COMPONENT32F;
       source_format = GL_DEPTH_COMPONENT;
       source_type = GL_FLOAT;
       break;
 #endif
 
+    case TextureFormat::RGB_BC1:
+      internal_format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+      source_format = GL_RGB;
+      source_type = GL_UNSIGNED_BYTE;
+      break;
+
+    case TextureFormat::RGBA_BC3:
+      internal_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+      source_format = GL_RGBA;
+      source_type = GL_UNSIGNED_BYTE;
+      break;
+
     default:
       assert(false && "Invalid texture format");
       break;
   }
 
-  if (pixels == nullptr) {
-#if 0
-    glTexStorage2D(GL_TEXTURE_2D, 0, internal_format,
-                   static_cast<GLsizei>(description.width),
-                   static_cast<GLsizei>(description.height));
-#else
-    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, static_cast<GLsizei>(description.width),
-                 static_cast<GLsizei>(description.height), 0, source_format, source_type, pixels);
-#endif
-  } else {
-    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, static_cast<GLsizei>(description.width),
-                 static_cast<GLsizei>(description.height), 0, source_format, source_type, pixels);
+  for (std::size_t level = 0; level < levels.size(); ++level) {
+    const std::size_t width = GetMipMapLevelExtent(m_description.width, level);
+    const std::size_t height = GetMipMapLevelExtent(m_description.height, level);
+    if (IsBlockCompressed(m_description.format)) {
+      assert(levels[level] != nullptr);
+      glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), internal_format, static_cast<GLsizei>(width),
+                             static_cast<GLsizei>(height), 0,
+                             static_cast<GLsizei>(GetTextureLevelSize(m_description.format, width, height)),
+                             levels[level]);
+    } else {
+      glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), internal_format, static_cast<GLsizei>(width),
+                   static_cast<GLsizei>(height), 0, source_format, source_type, levels[level]);
+    }
   }
-  if (description.mip_map_count != 1) {
+  if (levels.size() == 1 && description.mip_map_count != 1) {
+    // Mip maps of block compressed textures are generated by the texture cooker instead
+    assert(!IsBlockCompressed(m_description.format));
     glGenerateMipmap(GL_TEXTURE_2D);
+  } else {
+#if !defined(__IPHONEOS__) && !OVIS_EMSCRIPTEN
+    // Only the uploaded levels are sampled, so they do not have to go down to 1x1
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size() - 1));
+#endif
   }
 
   GLenum min_filter;
@@ -114,6 +186,15 @@ void Texture2D::Write(std::size_t level, std::size_t x, std::size_t y, std::size
   GLenum source_format;
   GLenum source_type;
   switch (m_description.format) {
+    case TextureFormat::R_UINT8:
+#if OVIS_EMSCRIPTEN
+      source_format = GL_LUMINANCE;
+#else
+      source_format = GL_RED;
+#endif
+      source_type = GL_UNSIGNED_BYTE;
+      break;
+
     case TextureFormat::RGB_UINT8:
       source_format = GL_RGB;
       source_type = GL_UNSIGNED_BYTE;
@@ -137,21 +218,34 @@ void Texture2D::Bind(int texture_unit) {
   context()->BindTexture(GL_TEXTURE_2D, name(), texture_unit);
 }
 
+AssetMemoryUsage GetAssetMemoryUsage(const Texture2D& texture) {
+  const Texture2DDescription& description = texture.description();
+  const std::size_t level_count = description.mip_map_count == 0
+                                      ? GetCompleteMipMapCount(description.width, description.height)
+                                      : description.mip_map_count;
+  std::size_t gpu_bytes = 0;
+  for (std::size_t level = 0; level < level_count; ++level) {
+    gpu_bytes += GetTextureLevelSize(description.format, GetMipMapLevelExtent(description.width, level),
+                                     GetMipMapLevelExtent(description.height, level));
+  }
+  return {.gpu_bytes = gpu_bytes};
+}
+
 Result<Texture2DDescription> LoadTexture2DDescription(const std::string& asset_id) {
   return LoadTexture2DDescription(GetAssetLibraryForAsset(asset_id), asset_id);
 }
 
 Result<Texture2DDescription> LoadTexture2DDescription(AssetLibrary* asset_library, const std::string& asset_id) {
-  const Result<std::string> parameters_file = asset_library->LoadAssetTextFile(asset_id, "json");
+  const Result<AssetView> parameters_file = asset_library->LoadAssetFile(asset_id, "json");
   OVIS_CHECK_RESULT(parameters_file);
 
   try {
-    const json parameters = json::parse(*parameters_file);
+    const json parameters = json::parse(parameters_file->text());
 
     Texture2DDescription description;
     description.width = parameters["width"];
     description.height = parameters["height"];
-    description.mip_map_count = 0;
+    description.mip_map_count = parameters.value("mip_map_count", std::size_t{0});
 
     std::string filter = parameters["filter"];
     if (filter == "point") {
@@ -169,10 +263,21 @@ Result<Texture2DDescription> LoadTexture2DDescription(AssetLibrary* asset_librar
       description.format = TextureFormat::RGB_UINT8;
     } else if (format == "RGBA_UINT8") {
       description.format = TextureFormat::RGBA_UINT8;
+    } else if (format == "RGB_BC1") {
+      description.format = TextureFormat::RGB_BC1;
+    } else if (format == "RGBA_BC3") {
+      description.format = TextureFormat::RGBA_BC3;
     } else {
       return Error("Failed to load texture '{}': invalid format ()", asset_id, format);
     }
 
+    if (IsBlockCompressed(description.format) && description.mip_map_count == 0) {
+      return Error("Failed to load texture '{}': mip maps of compressed textures cannot be generated", asset_id);
+    }
+    if (description.mip_map_count > GetCompleteMipMapCount(description.width, description.height)) {
+      return Error("Failed to load texture '{}': too many mip maps ({})", asset_id, description.mip_map_count);
+    }
+
     return description;
   } catch (const json::parse_error& error) {
     return Error("Invalid json: {}", error.what());
@@ -183,17 +288,39 @@ std::unique_ptr<Texture2D> LoadTexture2D(const std::string& asset_id, GraphicsCo
   return LoadTexture2D(GetAssetLibraryForAsset(asset_id), asset_id, graphics_context);
 }
 
+Result<Texture2DData> LoadTexture2DData(AssetLibrary* asset_library, const std::string& asset_id) {
+  Result<Texture2DDescription> description = LoadTexture2DDescription(asset_library, asset_id);
+  OVIS_CHECK_RESULT(description);
+
+  Texture2DData data = {.description = *description};
+  const std::size_t level_count = std::max<std::size_t>(description->mip_map_count, 1);
+  data.levels.reserve(level_count);
+  for (std::size_t level = 0; level < level_count; ++level) {
+    Result<AssetView> pixels = asset_library->LoadAssetFile(asset_id, std::to_string(level));
+    OVIS_CHECK_RESULT(pixels);
+
+    // The upload reads exactly this many bytes, so shorter files must not be passed on
+    const std::size_t expected_size =
+        GetTextureLevelSize(description->format, GetMipMapLevelExtent(description->width, level),
+                            GetMipMapLevelExtent(description->height, level));
+    if (pixels->size() != expected_size) {
+      return Error("Failed to load texture '{}': level {} has {} bytes instead of {}", asset_id, level, pixels->size(),
+                   expected_size);
+    }
+    data.levels.push_back(std::move(*pixels));
+  }
+  return std::move(data);
+}
+
 std::unique_ptr<Texture2D> LoadTexture2D(AssetLibrary* asset_library, const std::string& asset_id,
                                          GraphicsContext* graphics_context) {
   assert(graphics_context != nullptr);
 
-  Result<Texture2DDescription> description = LoadTexture2DDescription(asset_library, asset_id);
-  Result<Blob> mip_level_data = asset_library->LoadAssetBinaryFile(asset_id, "0");
-
-  if (description.has_value() && mip_level_data.has_value()) {
-    return std::make_unique<Texture2D>(graphics_context, *description, mip_level_data->data());
+  Result<Texture2DData> data = LoadTexture2DData(asset_library, asset_id);
+  if (data.has_value()) {
+    return std::make_unique<Texture2D>(graphics_context, *data);
   } else {
-    LogE("Failed to load texture '{}'", asset_id);
+    LogE("Failed to load texture '{}': {}", asset_id, data.error().message);
     return {};
   }
 }
@@ -0,0 +1,356 @@
+#include "ovis/graphics/texture_compression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace ovis {
+
+namespace {
+
+constexpr std::size_t BLOCK_SIZE = 4;
+constexpr std::size_t BLOCK_PIXEL_COUNT = BLOCK_SIZE * BLOCK_SIZE;
+
+using BlockPixels = std::array<std::array<std::uint8_t, 4>, BLOCK_PIXEL_COUNT>;
+using Color = std::array<float, 3>;
+
+float Dot(const Color& lhs, const Color& rhs) {
+  return lhs[0] * rhs[0] + lhs[1] * rhs[1] + lhs[2] * rhs[2];
+}
+
+std::uint16_t PackRGB565(const Color& color) {
+  const auto quantize = [](float value, int max) {
+    return static_cast<std::uint16_t>(std::clamp(static_cast<int>(std::lround(value / 255.0f * max)), 0, max));
+  };
+  return static_cast<std::uint16_t>(quantize(color[0], 31) << 11 | quantize(color[1], 63) << 5 |
+                                    quantize(color[2], 31));
+}
+
+std::array<std::uint8_t, 3> UnpackRGB565(std::uint16_t color) {
+  const std::uint8_t red = (color >> 11) & 0x1f;
+  const std::uint8_t green = (color >> 5) & 0x3f;
+  const std::uint8_t blue = color & 0x1f;
+  return {
+      static_cast<std::uint8_t>(red << 3 | red >> 2),
+      static_cast<std::uint8_t>(green << 2 | green >> 4),
+      static_cast<std::uint8_t>(blue << 3 | blue >> 2),
+  };
+}
+
+// The four colors of a block in the order of their indices. BC3 always uses this mode, BC1 only if the first endpoint
+// is greater than the second one.
+std::array<std::array<std::uint8_t, 3>, 4> GetColorPalette(std::uint16_t color0, std::uint16_t color1) {
+  const auto endpoint0 = UnpackRGB565(color0);
+  const auto endpoint1 = UnpackRGB565(color1);
+  std::array<std::array<std::uint8_t, 3>, 4> palette = {endpoint0, endpoint1};
+  for (int channel = 0; channel < 3; ++channel) {
+    palette[2][channel] = static_cast<std::uint8_t>((2 * endpoint0[channel] + endpoint1[channel]) / 3);
+    palette[3][channel] = static_cast<std::uint8_t>((endpoint0[channel] + 2 * endpoint1[channel]) / 3);
+  }
+  return palette;
+}
+
+std::uint32_t SelectColorIndices(const BlockPixels& pixels, std::uint16_t color0, std::uint16_t color1,
+                                 float* total_error) {
+  const auto palette = GetColorPalette(color0, color1);
+  std::uint32_t indices = 0;
+  *total_error = 0.0f;
+  for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i) {
+    float best_error = std::numeric_limits<float>::infinity();
+    std::uint32_t best_index = 0;
+    for (std::uint32_t index = 0; index < 4; ++index) {
+      float error = 0.0f;
+      for (int channel = 0; channel < 3; ++channel) {
+        const float difference = static_cast<float>(pixels[i][channel]) - palette[index][channel];
+        error += difference * difference;
+      }
+      if (error < best_error) {
+        best_error = error;
+        best_index = index;
+      }
+    }
+    indices |= best_index << (2 * i);
+    *total_error += best_error;
+  }
+  return indices;
+}
+
+// Solves for the endpoints that minimize the squared error of the pixels with the given indices
+bool RefineEndpoints(const BlockPixels& pixels, std::uint32_t indices, Color* endpoint0, Color* endpoint1) {
+  constexpr std::array<float, 4> WEIGHTS = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+  float aa = 0.0f;
+  float bb = 0.0f;
+  float ab = 0.0f;
+  Color ax = {};
+  Color bx = {};
+  for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i) {
+    const float a = WEIGHTS[(indices >> (2 * i)) & 3];
+    const float b = 1.0f - a;
+    aa += a * a;
+    bb += b * b;
+    ab += a * b;
+    for (int channel = 0; channel < 3; ++channel) {
+      ax[channel] += a * pixels[i][channel];
+      bx[channel] += b * pixels[i][channel];
+    }
+  }
+  const float determinant = aa * bb - ab * ab;
+  if (std::abs(determinant) < 1e-6f) {
+    return false;
+  }
+  for (int channel = 0; channel < 3; ++channel) {
+    (*endpoint0)[channel] = std::clamp((ax[channel] * bb - bx[channel] * ab) / determinant, 0.0f, 255.0f);
+    (*endpoint1)[channel] = std::clamp((bx[channel] * aa - ax[channel] * ab) / determinant, 0.0f, 255.0f);
+  }
+  return true;
+}
+
+void EncodeColorBlock(const BlockPixels& pixels, std::byte* block) {
+  Color mean = {};
+  for (const auto& pixel : pixels) {
+    for (int channel = 0; channel < 3; ++channel) {
+      mean[channel] += pixel[channel] / static_cast<float>(BLOCK_PIXEL_COUNT);
+    }
+  }
+
+  // The principal axis of the colors is found by power iteration on their covariance matrix
+  std::array<float, 6> covariance = {};
+  for (const auto& pixel : pixels) {
+    const Color offset = {pixel[0] - mean[0], pixel[1] - mean[1], pixel[2] - mean[2]};
+    covariance[0] += offset[0] * offset[0];
+    covariance[1] += offset[0] * offset[1];
+    covariance[2] += offset[0] * offset[2];
+    covariance[3] += offset[1] * offset[1];
+    covariance[4] += offset[1] * offset[2];
+    covariance[5] += offset[2] * offset[2];
+  }
+  // Starting at the column of the channel with the largest variance instead of a fixed vector, which could be orthogonal
+  // to the principal axis, e.g., (1, 1, 1) for blocks where red increases as green decreases.
+  Color axis = {covariance[0], covariance[1], covariance[2]};
+  if (covariance[3] > covariance[0] && covariance[3] >= covariance[5]) {
+    axis = {covariance[1], covariance[3], covariance[4]};
+  } else if (covariance[5] > covariance[0] && covariance[5] > covariance[3]) {
+    axis = {covariance[2], covariance[4], covariance[5]};
+  }
+  for (int iteration = 0; iteration < 8; ++iteration) {
+    const Color next = {
+        covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+        covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+        covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2],
+    };
+    const float length = std::sqrt(Dot(next, next));
+    if (length < 1e-6f) {
+      break;
+    }
+    axis = {next[0] / length, next[1] / length, next[2] / length};
+  }
+
+  float min_projection = std::numeric_limits<float>::infinity();
+  float max_projection = -std::numeric_limits<float>::infinity();
+  for (const auto& pixel : pixels) {
+    const Color offset = {pixel[0] - mean[0], pixel[1] - mean[1], pixel[2] - mean[2]};
+    const float projection = Dot(offset, axis);
+    min_projection = std::min(min_projection, projection);
+    max_projection = std::max(max_projection, projection);
+  }
+  Color endpoint0;
+  Color endpoint1;
+  for (int channel = 0; channel < 3; ++channel) {
+    endpoint0[channel] = std::clamp(mean[channel] + axis[channel] * max_projection, 0.0f, 255.0f);
+    endpoint1[channel] = std::clamp(mean[channel] + axis[channel] * min_projection, 0.0f, 255.0f);
+  }
+
+  std::uint16_t color0 = PackRGB565(endpoint0);
+  std::uint16_t color1 = PackRGB565(endpoint1);
+  float error;
+  std::uint32_t indices = SelectColorIndices(pixels, color0, color1, &error);
+
+  // A least squares fit to the selected indices usually reduces the error further
+  if (RefineEndpoints(pixels, indices, &endpoint0, &endpoint1)) {
+    const std::uint16_t refined_color0 = PackRGB565(endpoint0);
+    const std::uint16_t refined_color1 = PackRGB565(endpoint1);
+    float refined_error;
+    const std::uint32_t refined_indices = SelectColorIndices(pixels, refined_color0, refined_color1, &refined_error);
+    if (refined_error < error) {
+      color0 = refined_color0;
+      color1 = refined_color1;
+      indices = refined_indices;
+    }
+  }
+
+  // BC1 only uses four colors if the first endpoint is greater, swapping the endpoints swaps indices 0 and 1 as well as
+  // 2 and 3. Equal endpoints always decode to the first one with index 0.
+  if (color0 < color1) {
+    std::swap(color0, color1);
+    indices ^= 0x55555555;
+  } else if (color0 == color1) {
+    indices = 0;
+  }
+
+  // All values are little endian
+  block[0] = static_cast<std::byte>(color0 & 0xff);
+  block[1] = static_cast<std::byte>(color0 >> 8);
+  block[2] = static_cast<std::byte>(color1 & 0xff);
+  block[3] = static_cast<std::byte>(color1 >> 8);
+  for (int i = 0; i < 4; ++i) {
+    block[4 + i] = static_cast<std::byte>((indices >> (8 * i)) & 0xff);
+  }
+}
+
+std::array<std::uint8_t, 8> GetAlphaPalette(std::uint8_t alpha0, std::uint8_t alpha1) {
+  std::array<std::uint8_t, 8> palette = {alpha0, alpha1};
+  if (alpha0 > alpha1) {
+    for (int i = 1; i < 7; ++i) {
+      palette[i + 1] = static_cast<std::uint8_t>(((7 - i) * alpha0 + i * alpha1) / 7);
+    }
+  } else {
+    for (int i = 1; i < 5; ++i) {
+      palette[i + 1] = static_cast<std::uint8_t>(((5 - i) * alpha0 + i * alpha1) / 5);
+    }
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+  return palette;
+}
+
+void EncodeAlphaBlock(const BlockPixels& pixels, std::byte* block) {
+  std::uint8_t alpha0 = 0;
+  std::uint8_t alpha1 = 255;
+  for (const auto& pixel : pixels) {
+    alpha0 = std::max(alpha0, pixel[3]);
+    alpha1 = std::min(alpha1, pixel[3]);
+  }
+
+  std::uint64_t indices = 0;
+  if (alpha0 != alpha1) {
+    const auto palette = GetAlphaPalette(alpha0, alpha1);
+    for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i) {
+      std::uint64_t best_index = 0;
+      int best_error = std::numeric_limits<int>::max();
+      for (std::uint64_t index = 0; index < 8; ++index) {
+        const int error = std::abs(static_cast<int>(pixels[i][3]) - palette[index]);
+        if (error < best_error) {
+          best_error = error;
+          best_index = index;
+        }
+      }
+      indices |= best_index << (3 * i);
+    }
+  }
+
+  block[0] = static_cast<std::byte>(alpha0);
+  block[1] = static_cast<std::byte>(alpha1);
+  for (int i = 0; i < 6; ++i) {
+    block[2 + i] = static_cast<std::byte>((indices >> (8 * i)) & 0xff);
+  }
+}
+
+void DecodeColorBlock(const std::byte* block, bool allow_transparency, BlockPixels* pixels) {
+  const auto read16 = [block](int offset) {
+    return static_cast<std::uint16_t>(std::to_integer<std::uint16_t>(block[offset]) |
+                                      std::to_integer<std::uint16_t>(block[offset + 1]) << 8);
+  };
+  const std::uint16_t color0 = read16(0);
+  const std::uint16_t color1 = read16(2);
+  auto palette = GetColorPalette(color0, color1);
+  // BC1 blocks whose first endpoint is not greater use three colors and transparent black
+  const bool has_transparency = allow_transparency && color0 <= color1;
+  if (has_transparency) {
+    for (int channel = 0; channel < 3; ++channel) {
+      palette[2][channel] = static_cast<std::uint8_t>((palette[0][channel] + palette[1][channel]) / 2);
+      palette[3][channel] = 0;
+    }
+  }
+
+  const std::uint32_t indices = static_cast<std::uint32_t>(read16(4)) | static_cast<std::uint32_t>(read16(6)) << 16;
+  for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i) {
+    const std::uint32_t index = (indices >> (2 * i)) & 3;
+    (*pixels)[i] = {palette[index][0], palette[index][1], palette[index][2],
+                    static_cast<std::uint8_t>(has_transparency && index == 3 ? 0 : 255)};
+  }
+}
+
+void DecodeAlphaBlock(const std::byte* block, BlockPixels* pixels) {
+  const auto palette =
+      GetAlphaPalette(std::to_integer<std::uint8_t>(block[0]), std::to_integer<std::uint8_t>(block[1]));
+  std::uint64_t indices = 0;
+  for (int i = 0; i < 6; ++i) {
+    indices |= std::to_integer<std::uint64_t>(block[2 + i]) << (8 * i);
+  }
+  for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i) {
+    (*pixels)[i][3] = palette[(indices >> (3 * i)) & 7];
+  }
+}
+
+std::size_t GetBlockByteCount(TextureFormat format) {
+  assert(IsBlockCompressed(format));
+  return format == TextureFormat::RGB_BC1 ? 8 : 16;
+}
+
+}  // namespace
+
+Blob CompressTextureLevel(TextureFormat format, std::size_t width, std::size_t height,
+                          std::span<const std::byte> rgba_pixels) {
+  assert(rgba_pixels.size() == width * height * 4);
+  const std::size_t block_byte_count = GetBlockByteCount(format);
+  Blob blocks(GetTextureLevelSize(format, width, height));
+  std::byte* block = blocks.data();
+
+  for (std::size_t block_y = 0; block_y < height; block_y += BLOCK_SIZE) {
+    for (std::size_t block_x = 0; block_x < width; block_x += BLOCK_SIZE) {
+      BlockPixels pixels;
+      for (std::size_t y = 0; y < BLOCK_SIZE; ++y) {
+        for (std::size_t x = 0; x < BLOCK_SIZE; ++x) {
+          const std::size_t source_x = std::min(block_x + x, width - 1);
+          const std::size_t source_y = std::min(block_y + y, height - 1);
+          std::memcpy(pixels[y * BLOCK_SIZE + x].data(), &rgba_pixels[(source_y * width + source_x) * 4], 4);
+        }
+      }
+
+      if (format == TextureFormat::RGBA_BC3) {
+        EncodeAlphaBlock(pixels, block);
+        EncodeColorBlock(pixels, block + 8);
+      } else {
+        EncodeColorBlock(pixels, block);
+      }
+      block += block_byte_count;
+    }
+  }
+
+  return blocks;
+}
+
+Blob DecompressTextureLevel(TextureFormat format, std::size_t width, std::size_t height,
+                            std::span<const std::byte> blocks) {
+  assert(blocks.size() == GetTextureLevelSize(format, width, height));
+  const std::size_t block_byte_count = GetBlockByteCount(format);
+  Blob rgba_pixels(width * height * 4);
+  const std::byte* block = blocks.data();
+
+  for (std::size_t block_y = 0; block_y < height; block_y += BLOCK_SIZE) {
+    for (std::size_t block_x = 0; block_x < width; block_x += BLOCK_SIZE) {
+      BlockPixels pixels;
+      if (format == TextureFormat::RGBA_BC3) {
+        DecodeColorBlock(block + 8, false, &pixels);
+        DecodeAlphaBlock(block, &pixels);
+      } else {
+        DecodeColorBlock(block, true, &pixels);
+      }
+      block += block_byte_count;
+
+      for (std::size_t y = 0; y < BLOCK_SIZE && block_y + y < height; ++y) {
+        for (std::size_t x = 0; x < BLOCK_SIZE && block_x + x < width; ++x) {
+          std::memcpy(&rgba_pixels[((block_y + y) * width + block_x + x) * 4], pixels[y * BLOCK_SIZE + x].data(), 4);
+        }
+      }
+    }
+  }
+
+  return rgba_pixels;
+}
+
+}  // namespace ovis
@@ -96,13 +96,22 @@ UniformBuffer::UniformBuffer(GraphicsContext* context, const UniformBufferDescri
   }
 
   m_uniform_buffer.resize(current_size, 0);
+  m_dirty_uniforms.resize(num_uniforms, true);
   m_textures.resize(texture_count, nullptr);
 }
 
 UniformBuffer::~UniformBuffer() {}
 
 void UniformBuffer::Bind() {
-  for (const auto& uniform_desc : m_uniform_descriptions) {
+  for (auto it : IndexRange(m_uniform_descriptions)) {
+    if (!m_dirty_uniforms[it.index()]) {
+      context()->CountStateChange(false);
+      continue;
+    }
+    m_dirty_uniforms[it.index()] = false;
+    context()->CountStateChange(true);
+
+    const auto& uniform_desc = it.value();
     const void* const data = GetUniformBufferPointer(uniform_desc.offset);
     const GLint location = uniform_desc.location;
     const GLsizei count = uniform_desc.size;
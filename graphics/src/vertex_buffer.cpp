@@ -9,7 +9,7 @@ VertexBuffer::VertexBuffer(GraphicsContext* context, const VertexBufferDescripti
     : GraphicsBuffer(context, Type::VERTEX_BUFFER), m_description(description) {
   assert(description.vertex_size_in_bytes <= description.size_in_bytes);
   Bind();
-  glBufferData(GL_ARRAY_BUFFER, description.size_in_bytes, vertex_data, GL_STATIC_DRAW);
+  glBufferData(GL_ARRAY_BUFFER, description.size_in_bytes, vertex_data, static_cast<GLenum>(description.usage));
 }
 
 VertexBuffer::~VertexBuffer() {
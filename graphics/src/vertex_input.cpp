@@ -26,6 +26,13 @@ VertexInput::VertexInput(GraphicsContext* context, const VertexInputDescription&
     attribute.offset = reinterpret_cast<const GLvoid*>(vertex_attribute.offset_in_bytes);
     attribute.stride = vertex_buffer->description().vertex_size_in_bytes;
     attribute.array_buffer = vertex_buffer->name();
+    attribute.divisor = vertex_attribute.instance_divisor;
+#if OVIS_EMSCRIPTEN
+    assert(attribute.divisor == 0);
+#endif
+    if (attribute.divisor != 0) {
+      m_has_instanced_attributes = true;
+    }
 
     switch (vertex_attribute.type) {
       case VertexAttributeType::FLOAT32:
@@ -249,22 +256,45 @@ VertexInput::VertexInput(GraphicsContext* context, const VertexInputDescription&
   }
 }
 
-VertexInput::~VertexInput() {}
+VertexInput::~VertexInput() {
+  if (context()->m_bound_vertex_input == this) {
+    context()->m_bound_vertex_input = nullptr;
+  }
+}
+
+void VertexInput::Bind(std::uint32_t base_instance) {
+  if (!m_has_instanced_attributes) {
+    base_instance = 0;
+  }
+
+  // The attribute pointers keep referencing their buffers, so there is nothing to do if the input is already bound.
+  if (context()->m_bound_vertex_input == this && context()->m_bound_vertex_input_base_instance == base_instance) {
+    context()->CountStateChange(false);
+    return;
+  }
 
-void VertexInput::Bind() {
   for (auto gl_desc : IndexRange<GLuint>(m_attribute_gl_descriptions)) {
     if (gl_desc.value().enabled) {
       if (context()->m_bound_array_buffer != gl_desc->array_buffer) {
         glBindBuffer(GL_ARRAY_BUFFER, gl_desc->array_buffer);
         context()->m_bound_array_buffer = gl_desc->array_buffer;
       }
+      // There is no base instance in OpenGL ES and OpenGL 4.1, so instanced attributes start at the base instance
+      const std::size_t instance_offset_in_bytes =
+          gl_desc->divisor != 0 ? base_instance / gl_desc->divisor * gl_desc->stride : 0;
       glVertexAttribPointer(gl_desc.index(), gl_desc->size, gl_desc->type, gl_desc->normalized, gl_desc->stride,
-                            gl_desc->offset);
+                            static_cast<const GLbyte*>(gl_desc->offset) + instance_offset_in_bytes);
+#if !OVIS_EMSCRIPTEN
+      glVertexAttribDivisor(gl_desc.index(), gl_desc->divisor);
+#endif
       context()->EnableVertexAttribArray(gl_desc.index());
     } else {
       context()->DisableVertexAttribArray(gl_desc.index());
     }
   }
+  context()->m_bound_vertex_input = this;
+  context()->m_bound_vertex_input_base_instance = base_instance;
+  context()->CountStateChange(true);
 }
 
 }  // namespace ovis
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <span>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/graphics/texture.hpp"
+#include "ovis/graphics/texture_compression.hpp"
+
+using namespace ovis;
+
+namespace {
+
+// A diagonal gradient, so the colors of each block lie on a line, which block compression represents well. Images may
+// be at most 16x16 pixels.
+Blob CreateGradient(std::size_t width, std::size_t height) {
+  Blob rgba_pixels(width * height * 4);
+  for (std::size_t y = 0; y < height; ++y) {
+    for (std::size_t x = 0; x < width; ++x) {
+      const std::size_t t = (x + y) * 8;
+      std::byte* pixel = &rgba_pixels[(y * width + x) * 4];
+      pixel[0] = static_cast<std::byte>(t);
+      pixel[1] = static_cast<std::byte>(255 - t);
+      pixel[2] = static_cast<std::byte>(128);
+      pixel[3] = static_cast<std::byte>(x * 16);
+    }
+  }
+  return rgba_pixels;
+}
+
+int GetMaxChannelError(std::span<const std::byte> expected, std::span<const std::byte> actual, int channel) {
+  int max_error = 0;
+  for (std::size_t i = channel; i < expected.size(); i += 4) {
+    const int error = std::abs(std::to_integer<int>(expected[i]) - std::to_integer<int>(actual[i]));
+    max_error = std::max(max_error, error);
+  }
+  return max_error;
+}
+
+}  // namespace
+
+TEST_CASE("Compress texture levels", "[ovis][graphics][TextureCompression]") {
+  SECTION("BC1 round trip") {
+    const Blob rgba_pixels = CreateGradient(16, 16);
+    const Blob blocks = CompressTextureLevel(TextureFormat::RGB_BC1, 16, 16, rgba_pixels);
+    REQUIRE(blocks.size() == 4 * 4 * 8);
+    REQUIRE(blocks.size() == GetTextureLevelSize(TextureFormat::RGB_BC1, 16, 16));
+
+    const Blob decompressed = DecompressTextureLevel(TextureFormat::RGB_BC1, 16, 16, blocks);
+    REQUIRE(decompressed.size() == rgba_pixels.size());
+    for (int channel = 0; channel < 3; ++channel) {
+      REQUIRE(GetMaxChannelError(rgba_pixels, decompressed, channel) <= 16);
+    }
+    // BC1 does not store the alpha channel, opaque blocks decode to opaque pixels
+    for (std::size_t i = 3; i < decompressed.size(); i += 4) {
+      REQUIRE(std::to_integer<int>(decompressed[i]) == 255);
+    }
+  }
+
+  SECTION("BC3 round trip") {
+    const Blob rgba_pixels = CreateGradient(16, 16);
+    const Blob blocks = CompressTextureLevel(TextureFormat::RGBA_BC3, 16, 16, rgba_pixels);
+    REQUIRE(blocks.size() == 4 * 4 * 16);
+    REQUIRE(blocks.size() == GetTextureLevelSize(TextureFormat::RGBA_BC3, 16, 16));
+
+    const Blob decompressed = DecompressTextureLevel(TextureFormat::RGBA_BC3, 16, 16, blocks);
+    REQUIRE(decompressed.size() == rgba_pixels.size());
+    for (int channel = 0; channel < 3; ++channel) {
+      REQUIRE(GetMaxChannelError(rgba_pixels, decompressed, channel) <= 16);
+    }
+    REQUIRE(GetMaxChannelError(rgba_pixels, decompressed, 3) <= 8);
+  }
+
+  SECTION("Sizes that are not a multiple of the block size") {
+    for (const TextureFormat format : {TextureFormat::RGB_BC1, TextureFormat::RGBA_BC3}) {
+      const Blob rgba_pixels = CreateGradient(7, 5);
+      const Blob blocks = CompressTextureLevel(format, 7, 5, rgba_pixels);
+      // The partial blocks at the borders are padded to full blocks
+      REQUIRE(blocks.size() == 2 * 2 * (format == TextureFormat::RGB_BC1 ? 8 : 16));
+      REQUIRE(blocks.size() == GetTextureLevelSize(format, 7, 5));
+
+      const Blob decompressed = DecompressTextureLevel(format, 7, 5, blocks);
+      REQUIRE(decompressed.size() == 7 * 5 * 4);
+      for (int channel = 0; channel < 3; ++channel) {
+        REQUIRE(GetMaxChannelError(rgba_pixels, decompressed, channel) <= 16);
+      }
+    }
+  }
+
+  SECTION("Single pixel") {
+    const Blob rgba_pixels = {std::byte{200}, std::byte{100}, std::byte{50}, std::byte{150}};
+
+    const Blob bc1_blocks = CompressTextureLevel(TextureFormat::RGB_BC1, 1, 1, rgba_pixels);
+    REQUIRE(bc1_blocks.size() == 8);
+    const Blob bc1_pixel = DecompressTextureLevel(TextureFormat::RGB_BC1, 1, 1, bc1_blocks);
+    REQUIRE(bc1_pixel.size() == 4);
+    for (int channel = 0; channel < 3; ++channel) {
+      REQUIRE(GetMaxChannelError(rgba_pixels, bc1_pixel, channel) <= 4);
+    }
+
+    const Blob bc3_blocks = CompressTextureLevel(TextureFormat::RGBA_BC3, 1, 1, rgba_pixels);
+    REQUIRE(bc3_blocks.size() == 16);
+    const Blob bc3_pixel = DecompressTextureLevel(TextureFormat::RGBA_BC3, 1, 1, bc3_blocks);
+    REQUIRE(bc3_pixel.size() == 4);
+    for (int channel = 0; channel < 3; ++channel) {
+      REQUIRE(GetMaxChannelError(rgba_pixels, bc3_pixel, channel) <= 4);
+    }
+    REQUIRE(bc3_pixel[3] == rgba_pixels[3]);
+  }
+}
+
+TEST_CASE("Texture level sizes", "[ovis][graphics][Texture]") {
+  REQUIRE(GetCompleteMipMapCount(1, 1) == 1);
+  REQUIRE(GetCompleteMipMapCount(16, 16) == 5);
+  REQUIRE(GetCompleteMipMapCount(7, 5) == 3);
+  REQUIRE(GetCompleteMipMapCount(8, 1) == 4);
+
+  REQUIRE(GetTextureLevelSize(TextureFormat::RGBA_UINT8, 7, 5) == 7 * 5 * 4);
+  REQUIRE(GetTextureLevelSize(TextureFormat::RGB_BC1, 1, 1) == 8);
+  REQUIRE(GetTextureLevelSize(TextureFormat::RGBA_BC3, 1, 1) == 16);
+  REQUIRE(GetTextureLevelSize(TextureFormat::RGB_BC1, 5, 4) == 2 * 8);
+}
@@ -0,0 +1,131 @@
+#include <string_view>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/utils/log.hpp"
+#include "ovis/utils/thread_pool.hpp"
+#include "ovis/core/scene.hpp"
+#include "ovis/graphics/graphics_recording.hpp"
+#include "ovis/rendering/primitive_renderer.hpp"
+#include "ovis/test/require_result.hpp"
+
+using namespace ovis;
+
+namespace {
+
+class DebugDrawRenderer : public PrimitiveRenderer {
+ public:
+  static constexpr int SHAPE_COUNT = 1000;
+
+  DebugDrawRenderer(GraphicsContext* graphics_context, bool parallel = false,
+                    std::string_view job_id = "DebugDrawRenderer")
+      : PrimitiveRenderer(job_id, graphics_context), parallel_(parallel) {}
+
+  void Render(const SceneUpdate& update, const SceneViewport&) override {
+    SceneViewport viewport;
+    viewport.dimensions = {1280.0f, 720.0f};
+    SetDrawSpace(DrawSpace::SCREEN);
+    BeginDraw(viewport);
+    if (parallel_) {
+      // Like physics or AI jobs drawing their debug overlays from the worker threads
+      GetDefaultThreadPool()->ParallelFor(SHAPE_COUNT, [this](std::size_t i) { DrawShape(static_cast<int>(i)); });
+    } else {
+      for (int i = 0; i < SHAPE_COUNT; ++i) {
+        DrawShape(i);
+      }
+    }
+    EndDraw();
+  }
+
+ private:
+  bool parallel_;
+
+  void DrawShape(int i) {
+    const Vector3 position = {static_cast<float>(i % 1280), static_cast<float>(i % 720), 0.0f};
+    DrawLine(position, position + Vector3{10.0f, 10.0f, 0.0f}, Color::Red());
+    DrawCircle(position, 5.0f, Color::Green(), 1.0f, 16);
+    DrawDisc(position, 5.0f, Color::Blue(), 16);
+    DrawArrow(position, position + Vector3{0.0f, 20.0f, 0.0f}, Color::Yellow());
+  }
+};
+
+// Line: 6 vertices, circle: 16 lines, disc: 16 triangles, arrow: line + triangle
+constexpr std::size_t VERTICES_PER_SHAPE = 6 + 16 * 6 + 16 * 3 + 6 + 3;
+
+}  // namespace
+
+TEST_CASE("PrimitiveRenderer draw calls for debug shapes", "[ovis][rendering][PrimitiveRenderer][benchmark]") {
+  GraphicsContext context(Vector2(1280, 720));
+  REQUIRE(context.recording() != nullptr);
+
+  Scene scene;
+  scene.frame_scheduler().AddJob<DebugDrawRenderer>(&context);
+  REQUIRE_RESULT(scene.Prepare());
+  scene.Play();
+  scene.Update(0.0);
+
+  context.recording()->Clear();
+  scene.Update(0.0);
+  const GraphicsStatistics statistics = context.recording()->statistics();
+  LogI("PrimitiveRenderer: {} draw calls, {} state changes, {} bytes uploaded", statistics.draw_calls,
+       statistics.state_changes, statistics.uploaded_bytes);
+
+  REQUIRE(statistics.drawn_elements == DebugDrawRenderer::SHAPE_COUNT * VERTICES_PER_SHAPE);
+  REQUIRE(statistics.uploaded_bytes == statistics.drawn_elements * 16);
+
+  BENCHMARK("PrimitiveRenderer frame") {
+    context.recording()->Clear();
+    scene.Update(0.0);
+  };
+}
+
+TEST_CASE("PrimitiveRenderer debug shapes recorded from multiple threads",
+          "[ovis][rendering][PrimitiveRenderer][benchmark]") {
+  GraphicsContext context(Vector2(1280, 720));
+  REQUIRE(context.recording() != nullptr);
+
+  Scene scene;
+  scene.frame_scheduler().AddJob<DebugDrawRenderer>(&context, true);
+  REQUIRE_RESULT(scene.Prepare());
+  scene.Play();
+  scene.Update(0.0);
+
+  context.recording()->Clear();
+  scene.Update(0.0);
+  const GraphicsStatistics statistics = context.recording()->statistics();
+  LogI("PrimitiveRenderer parallel: {} draw calls, {} bytes uploaded on {} worker threads", statistics.draw_calls,
+       statistics.uploaded_bytes, GetDefaultThreadPool()->thread_count());
+
+  // The lists of all threads are uploaded together, so every draw but the last one fills a whole segment
+  constexpr std::size_t VERTEX_COUNT = DebugDrawRenderer::SHAPE_COUNT * VERTICES_PER_SHAPE;
+  constexpr std::size_t SEGMENT_VERTEX_COUNT = 1024 * 1024 / 16 / 3 * 3;
+  REQUIRE(statistics.drawn_elements == VERTEX_COUNT);
+  REQUIRE(statistics.uploaded_bytes == statistics.drawn_elements * 16);
+  REQUIRE(statistics.draw_calls == (VERTEX_COUNT + SEGMENT_VERTEX_COUNT - 1) / SEGMENT_VERTEX_COUNT);
+
+  BENCHMARK("PrimitiveRenderer frame recorded from multiple threads") {
+    context.recording()->Clear();
+    scene.Update(0.0);
+  };
+}
+
+TEST_CASE("PrimitiveRenderer debug shapes of multiple renderers recorded from the same threads",
+          "[ovis][rendering][PrimitiveRenderer]") {
+  GraphicsContext context(Vector2(1280, 720));
+  REQUIRE(context.recording() != nullptr);
+
+  // The worker threads cache a command list for each renderer, so the commands must end up at the right renderer
+  Scene scene;
+  scene.frame_scheduler().AddJob<DebugDrawRenderer>(&context, true, "FirstDebugDrawRenderer");
+  scene.frame_scheduler().AddJob<DebugDrawRenderer>(&context, true, "SecondDebugDrawRenderer");
+  REQUIRE_RESULT(scene.Prepare());
+  scene.Play();
+
+  for (int frame = 0; frame < 3; ++frame) {
+    context.recording()->Clear();
+    scene.Update(0.0);
+    const GraphicsStatistics statistics = context.recording()->statistics();
+    REQUIRE(statistics.drawn_elements == 2 * DebugDrawRenderer::SHAPE_COUNT * VERTICES_PER_SHAPE);
+  }
+}
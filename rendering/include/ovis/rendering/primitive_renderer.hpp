@@ -4,7 +4,10 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <span>
+#include <thread>
+#include <vector>
 
 #include "ovis/core/color.hpp"
 #include "ovis/core/intersection.hpp"
@@ -12,12 +15,17 @@
 #include "ovis/core/vector.hpp"
 #include "ovis/graphics/graphics_context.hpp"
 #include "ovis/graphics/shader_program.hpp"
-#include "ovis/graphics/vertex_buffer.hpp"
+#include "ovis/graphics/streaming_vertex_buffer.hpp"
 #include "ovis/graphics/vertex_input.hpp"
 #include "ovis/rendering/render_pass.hpp"
 
 namespace ovis {
 
+// Draws debug primitives like lines, circles and arrows. The Draw*() methods only record a command into a list of the
+// calling thread, so they can be called from any job and from multiple threads at the same time. The commands are
+// tessellated in parallel by EndDraw() and uploaded in as few writes as possible. Commands recorded before BeginDraw()
+// are drawn by the next EndDraw(). Commands of different threads are drawn in an unspecified order and no command may
+// be recorded while EndDraw() runs.
 class PrimitiveRenderer : public RenderPass {
  public:
   enum class DrawSpace { WORLD, SCREEN };
@@ -30,16 +38,6 @@ class PrimitiveRenderer : public RenderPass {
   void SetDrawSpace(DrawSpace space);
   inline DrawSpace draw_space() const { return draw_space_; }
 
- protected:
-  void BeginDraw(const SceneViewport& viewport);
-  void EndDraw();
-
-  struct Vertex {
-    float position[3];
-    uint32_t color;
-  };
-  static_assert(sizeof(Vertex) == 16);
-
   // Point Drawing
   void DrawPoint(const Vector3& position, float size, const Color& color);
 
@@ -64,10 +62,15 @@ class PrimitiveRenderer : public RenderPass {
                 const Vector3& support_vector1 = Vector3::PositiveY());
   void DrawConvexPolygon(const Vector3* positions, size_t num_positions, const Color& color);
 
-  //
-  void AddVertices(std::span<const Vertex> vertices);
-  void AddLineVerticesWithControlPoints(const Vector3& previous, const Vector3& start, const Vector3& end,
-                                        const Vector3& next, uint32_t color, float half_thickness);
+ protected:
+  void BeginDraw(const SceneViewport& viewport);
+  void EndDraw();
+
+  struct Vertex {
+    float position[3];
+    uint32_t color;
+  };
+  static_assert(sizeof(Vertex) == 16);
 
   bool enable_alpha_blending_ = false;
 
@@ -80,18 +83,72 @@ class PrimitiveRenderer : public RenderPass {
   static constexpr size_t VERTEX_BUFFER_ELEMENT_COUNT = 1024 * 1024 / sizeof(Vertex);
   struct Resources {
     std::vector<Vertex> vertices;
-    std::unique_ptr<VertexBuffer> vertex_buffer;
+    std::unique_ptr<StreamingVertexBuffer> vertex_buffer;
     std::unique_ptr<VertexInput> vertex_input;
     std::unique_ptr<ShaderProgram> shader;
   };
   static std::map<GraphicsContext*, std::weak_ptr<Resources>> resources;
   std::shared_ptr<Resources> resources_;
 
-  void Flush();
-  void DrawLineInternal(const Vector3& start, const Vector3& end, const Vector3& orthogonal, uint32_t color,
-                        float half_thickness);
+  // The positions are in the draw space and are transformed when the command is tessellated
+  struct Command {
+    enum class Type : std::uint8_t { POINT, LINE, DASHED_LINE, CIRCLE, ARROW, TRIANGLE, DISC };
+    Type type;
+    std::uint32_t color;
+    std::uint32_t segment_count;
+    // The start and end of lines and arrows, the corners of triangles or the center and the two support vectors of
+    // circles and discs
+    std::array<Vector3, 3> positions;
+    // The thickness of lines followed by the dash length or the arrow width and length, the size of points or the
+    // radius of circles followed by their thickness
+    std::array<float, 3> parameters;
+  };
+  struct CommandList {
+    std::thread::id thread_id;
+    std::vector<Command> commands;
+  };
+  // Every renderer gets a unique id, so a cached command list can never belong to a destroyed renderer at the same
+  // address
+  struct CachedCommandList {
+    std::uint64_t renderer_id = 0;
+    CommandList* command_list = nullptr;
+  };
+  // The command lists of each thread sorted by the renderer id, so threads drawing with several renderers do not have
+  // to look up their list under the mutex on every switch. Entries of destroyed renderers are never used again and the
+  // oldest entry is dropped once the cache is full.
+  static constexpr std::size_t MAX_CACHED_COMMAND_LISTS = 16;
+  static thread_local std::vector<CachedCommandList> cached_command_lists;
+  std::uint64_t id_;
+  std::mutex command_lists_mutex_;
+  // The lists are kept when they are emptied, so the pointers cached by the threads stay valid
+  std::vector<std::unique_ptr<CommandList>> command_lists_;
+
+  // The commands are tessellated in parallel in chunks of this many commands
+  static constexpr std::size_t COMMANDS_PER_CHUNK = 256;
+  std::vector<std::span<const Command>> command_chunks_;
+  std::vector<std::vector<Vertex>> chunk_vertices_;
+
+  void Record(const Command& command);
+  CommandList* GetCommandList();
+
+  void Tessellate(const Command& command, std::vector<Vertex>* vertices) const;
+  void TessellatePoint(const Vector3& position, float size, uint32_t color, std::vector<Vertex>* vertices) const;
+  void TessellateLine(const Vector3& start, const Vector3& end, uint32_t color, float thickness,
+                      std::vector<Vertex>* vertices) const;
+  void TessellateDashedLine(const Vector3& start, const Vector3& end, uint32_t color, float thickness,
+                            float dash_length, std::vector<Vertex>* vertices) const;
+  void TessellateCircle(const Command& command, bool filled, std::vector<Vertex>* vertices) const;
+  void TessellateArrow(const Vector3& start, const Vector3& end, uint32_t color, float thickness, float arrow_width,
+                       float arrow_length, std::vector<Vertex>* vertices) const;
+  void TessellateTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, uint32_t color,
+                          std::vector<Vertex>* vertices) const;
+  static void TessellateLineInternal(const Vector3& start, const Vector3& end, const Vector3& orthogonal,
+                                     uint32_t color, float half_thickness, std::vector<Vertex>* vertices);
   size_t CalculateSmoothCircleSegmentCount(const Vector3& center, float radius, const Vector3& support_vector0,
-                                           const Vector3& support_vector1);
+                                           const Vector3& support_vector1) const;
+
+  void AddVertices(std::span<const Vertex> vertices);
+  void Flush();
 };
 
 }  // namespace ovis
@@ -3,6 +3,9 @@
 #include "ovis/core/scene_viewport.hpp"
 #include "ovis/graphics/graphics_context.hpp"
 #include "ovis/core/scene.hpp"
+#if OVIS_ENABLE_BUILT_IN_PROFILING
+#include "ovis/graphics/gpu_time_profiler.hpp"
+#endif
 
 namespace ovis {
 
@@ -1,11 +1,23 @@
+#include <algorithm>
+#include <atomic>
+
+#include "ovis/utils/thread_pool.hpp"
 #include "ovis/core/math_constants.hpp"
 #include "ovis/rendering/primitive_renderer.hpp"
 
 namespace ovis {
+
+namespace {
+
+std::atomic<std::uint64_t> next_renderer_id = 1;
+
+}  // namespace
+
 std::map<GraphicsContext*, std::weak_ptr<PrimitiveRenderer::Resources>> PrimitiveRenderer::resources;
+thread_local std::vector<PrimitiveRenderer::CachedCommandList> PrimitiveRenderer::cached_command_lists;
 
 PrimitiveRenderer::PrimitiveRenderer(std::string_view job_id, GraphicsContext* graphics_context)
-    : RenderPass(job_id, graphics_context) {}
+    : RenderPass(job_id, graphics_context), id_(next_renderer_id++) {}
 
 void PrimitiveRenderer::CreateResources() {
   assert(!is_drawing_);
@@ -24,13 +36,13 @@ void PrimitiveRenderer::CreateResources() {
   resources_ = std::make_shared<Resources>();
   resources_->shader = LoadShaderProgram("primitive_rendering", context());
 
-  VertexBufferDescription buffer_desc;
+  StreamingVertexBufferDescription buffer_desc;
   buffer_desc.vertex_size_in_bytes = sizeof(Vertex);
-  buffer_desc.size_in_bytes = sizeof(Vertex) * VERTEX_BUFFER_ELEMENT_COUNT;
-  resources_->vertex_buffer = std::make_unique<ovis::VertexBuffer>(context(), buffer_desc);
+  buffer_desc.segment_vertex_count = VERTEX_BUFFER_ELEMENT_COUNT;
+  resources_->vertex_buffer = std::make_unique<StreamingVertexBuffer>(context(), buffer_desc);
 
   VertexInputDescription vertex_input_desc;
-  vertex_input_desc.vertex_buffers = {resources_->vertex_buffer.get()};
+  vertex_input_desc.vertex_buffers = {resources_->vertex_buffer->vertex_buffer()};
   vertex_input_desc.vertex_attributes = {
       {*resources_->shader->GetAttributeLocation("Position"), 0, 0, VertexAttributeType::FLOAT32_VECTOR3},
       {*resources_->shader->GetAttributeLocation("Color"), 12, 0, VertexAttributeType::UINT8_NORM_VECTOR4}};
@@ -76,55 +88,219 @@ void PrimitiveRenderer::EndDraw() {
   assert(is_drawing_);
   assert(resources_);
 
+  std::lock_guard lock(command_lists_mutex_);
+  command_chunks_.clear();
+  for (const auto& command_list : command_lists_) {
+    const std::span<const Command> commands = command_list->commands;
+    for (std::size_t offset = 0; offset < commands.size(); offset += COMMANDS_PER_CHUNK) {
+      command_chunks_.push_back(commands.subspan(offset, std::min(COMMANDS_PER_CHUNK, commands.size() - offset)));
+    }
+  }
+
+  if (chunk_vertices_.size() < command_chunks_.size()) {
+    chunk_vertices_.resize(command_chunks_.size());
+  }
+  GetDefaultThreadPool()->ParallelFor(command_chunks_.size(), [this](std::size_t chunk_index) {
+    std::vector<Vertex>* vertices = &chunk_vertices_[chunk_index];
+    vertices->clear();
+    for (const Command& command : command_chunks_[chunk_index]) {
+      Tessellate(command, vertices);
+    }
+  });
+
+  // The chunks are collected in the vertex array of the resources, so they are uploaded in writes of a whole segment
+  for (std::size_t chunk_index = 0; chunk_index < command_chunks_.size(); ++chunk_index) {
+    AddVertices(chunk_vertices_[chunk_index]);
+  }
   Flush();
+
+  for (const auto& command_list : command_lists_) {
+    command_list->commands.clear();
+  }
   is_drawing_ = false;
 }
 
 void PrimitiveRenderer::DrawPoint(const Vector3& position, float size, const Color& color) {
-  std::array<Vertex, 6> vertices;
-  const Vector2 extend = {size, size};
+  Record({
+      .type = Command::Type::POINT,
+      .color = ConvertToRGBA8(color),
+      .positions = {position},
+      .parameters = {size},
+  });
+}
 
-  const Vector3 p = TransformPosition(to_screen_space_, position);
-  const Vector3 p00 = p + Vector3::FromVector2(extend * Vector2::UnitSquare()[0]);
-  const Vector3 p01 = p + Vector3::FromVector2(extend * Vector2::UnitSquare()[1]);
-  const Vector3 p10 = p + Vector3::FromVector2(extend * Vector2::UnitSquare()[2]);
-  const Vector3 p11 = p + Vector3::FromVector2(extend * Vector2::UnitSquare()[3]);
-  const uint32_t converted_color = ConvertToRGBA8(color);
+void PrimitiveRenderer::DrawLine(const Vector3& start, const Vector3& end, const Color& color, float thickness) {
+  Record({
+      .type = Command::Type::LINE,
+      .color = ConvertToRGBA8(color),
+      .positions = {start, end},
+      .parameters = {thickness},
+  });
+}
+
+void PrimitiveRenderer::DrawDashedLine(const Vector3& start, const Vector3& end, const Color& color, float thickness,
+                                       float dash_length) {
+  Record({
+      .type = Command::Type::DASHED_LINE,
+      .color = ConvertToRGBA8(color),
+      .positions = {start, end},
+      .parameters = {thickness, dash_length},
+  });
+}
+
+void PrimitiveRenderer::DrawLineStip(std::span<const Vector3> positions, const Color& color, float thickness) {
+  assert(positions.size() >= 2);
+
+  for (size_t i = 0; i < positions.size() - 1; ++i) {
+    DrawLine(positions[i], positions[i + 1], color, thickness);
+  }
+}
+
+void PrimitiveRenderer::DrawLoop(std::span<const Vector3> positions, const Color& color, float thickness) {
+  assert(positions.size() > 2);
+  DrawLineStip(positions, color, thickness);
+  DrawLine(positions.back(), positions.front(), color, thickness);
+}
+
+void PrimitiveRenderer::DrawCircle(const Vector3& center, float radius, const Color& color, float thickness,
+                                   size_t num_segments, const Vector3& support_vector0,
+                                   const Vector3& support_vector1) {
+  Record({
+      .type = Command::Type::CIRCLE,
+      .color = ConvertToRGBA8(color),
+      .segment_count = static_cast<std::uint32_t>(num_segments),
+      .positions = {center, support_vector0, support_vector1},
+      .parameters = {radius, thickness},
+  });
+}
+
+void PrimitiveRenderer::DrawArrow(const Vector3& start, const Vector3& end, const Color& color, float thickness,
+                                  float arrow_width, float arrow_length) {
+  Record({
+      .type = Command::Type::ARROW,
+      .color = ConvertToRGBA8(color),
+      .positions = {start, end},
+      .parameters = {thickness, arrow_width, arrow_length},
+  });
+}
+
+void PrimitiveRenderer::DrawTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, const Color& color) {
+  Record({
+      .type = Command::Type::TRIANGLE,
+      .color = ConvertToRGBA8(color),
+      .positions = {v0, v1, v2},
+  });
+}
+
+void PrimitiveRenderer::DrawDisc(const Vector3& center, float radius, const Color& color, size_t num_segments,
+                                 const Vector3& support_vector0, const Vector3& support_vector1) {
+  Record({
+      .type = Command::Type::DISC,
+      .color = ConvertToRGBA8(color),
+      .segment_count = static_cast<std::uint32_t>(num_segments),
+      .positions = {center, support_vector0, support_vector1},
+      .parameters = {radius},
+  });
+}
 
-  memcpy(vertices[0].position, p00.data, sizeof(float) * 3);
-  vertices[0].color = converted_color;
+void PrimitiveRenderer::DrawConvexPolygon(const Vector3* positions, size_t num_positions, const Color& color) {
+  assert(num_positions > 2);
 
-  memcpy(vertices[1].position, p11.data, sizeof(float) * 3);
-  vertices[1].color = converted_color;
+  for (size_t i = 0; i < num_positions - 1; ++i) {
+    DrawTriangle(positions[0], positions[i], positions[i + 1], color);
+  }
+}
 
-  memcpy(vertices[2].position, p10.data, sizeof(float) * 3);
-  vertices[2].color = converted_color;
+void PrimitiveRenderer::Record(const Command& command) {
+  GetCommandList()->commands.push_back(command);
+}
 
-  memcpy(vertices[3].position, p00.data, sizeof(float) * 3);
-  vertices[3].color = converted_color;
+PrimitiveRenderer::CommandList* PrimitiveRenderer::GetCommandList() {
+  const auto is_less = [](const CachedCommandList& cached_list, std::uint64_t renderer_id) {
+    return cached_list.renderer_id < renderer_id;
+  };
+  auto cached_list = std::lower_bound(cached_command_lists.begin(), cached_command_lists.end(), id_, is_less);
+  if (cached_list != cached_command_lists.end() && cached_list->renderer_id == id_) {
+    return cached_list->command_list;
+  }
 
-  memcpy(vertices[4].position, p01.data, sizeof(float) * 3);
-  vertices[4].color = converted_color;
+  CommandList* command_list;
+  {
+    std::lock_guard lock(command_lists_mutex_);
+    const std::thread::id thread_id = std::this_thread::get_id();
+    auto list = std::find_if(command_lists_.begin(), command_lists_.end(),
+                             [thread_id](const auto& list) { return list->thread_id == thread_id; });
+    if (list == command_lists_.end()) {
+      command_lists_.push_back(std::make_unique<CommandList>(CommandList{.thread_id = thread_id}));
+      list = command_lists_.end() - 1;
+    }
+    command_list = list->get();
+  }
 
-  memcpy(vertices[5].position, p11.data, sizeof(float) * 3);
-  vertices[5].color = converted_color;
+  if (cached_command_lists.size() == MAX_CACHED_COMMAND_LISTS) {
+    // The renderer with the smallest id was created first and is the most likely one to be destroyed already
+    cached_command_lists.erase(cached_command_lists.begin());
+    cached_list = std::lower_bound(cached_command_lists.begin(), cached_command_lists.end(), id_, is_less);
+  }
+  cached_command_lists.insert(cached_list, {.renderer_id = id_, .command_list = command_list});
+  return command_list;
+}
 
-  AddVertices(vertices);
+void PrimitiveRenderer::Tessellate(const Command& command, std::vector<Vertex>* vertices) const {
+  const auto& [v0, v1, v2] = command.positions;
+  switch (command.type) {
+    case Command::Type::POINT:
+      TessellatePoint(v0, command.parameters[0], command.color, vertices);
+      break;
+    case Command::Type::LINE:
+      TessellateLine(v0, v1, command.color, command.parameters[0], vertices);
+      break;
+    case Command::Type::DASHED_LINE:
+      TessellateDashedLine(v0, v1, command.color, command.parameters[0], command.parameters[1], vertices);
+      break;
+    case Command::Type::CIRCLE:
+      TessellateCircle(command, false, vertices);
+      break;
+    case Command::Type::ARROW:
+      TessellateArrow(v0, v1, command.color, command.parameters[0], command.parameters[1], command.parameters[2],
+                      vertices);
+      break;
+    case Command::Type::TRIANGLE:
+      TessellateTriangle(v0, v1, v2, command.color, vertices);
+      break;
+    case Command::Type::DISC:
+      TessellateCircle(command, true, vertices);
+      break;
+  }
 }
 
-void PrimitiveRenderer::DrawLine(const Vector3& start, const Vector3& end, const Color& color, float thickness) {
-  const uint32_t converted_color = ConvertToRGBA8(color);
+void PrimitiveRenderer::TessellatePoint(const Vector3& position, float size, uint32_t converted_color,
+                                        std::vector<Vertex>* vertices) const {
+  const Vector2 extend = {size, size};
+
+  const Vector3 p = TransformPosition(to_screen_space_, position);
+  const Vector3 p00 = p + Vector3::FromVector2(extend * Vector2::UnitSquare()[0]);
+  const Vector3 p01 = p + Vector3::FromVector2(extend * Vector2::UnitSquare()[1]);
+  const Vector3 p10 = p + Vector3::FromVector2(extend * Vector2::UnitSquare()[2]);
+  const Vector3 p11 = p + Vector3::FromVector2(extend * Vector2::UnitSquare()[3]);
+
+  for (const Vector3& corner : {p00, p11, p10, p00, p01, p11}) {
+    vertices->push_back({{corner.x, corner.y, corner.z}, converted_color});
+  }
+}
+
+void PrimitiveRenderer::TessellateLine(const Vector3& start, const Vector3& end, uint32_t converted_color,
+                                       float thickness, std::vector<Vertex>* vertices) const {
   const Vector3 p0 = TransformPosition(to_screen_space_, start);
   const Vector3 p1 = TransformPosition(to_screen_space_, end);
   const Vector3 orthogonal = Vector3::FromVector2(ConstructOrthogonalVectorCCW(Normalize<Vector2>(p1 - p0)));
   const float half_thickness = thickness * 0.5f;
 
-  DrawLineInternal(p0, p1, orthogonal, converted_color, half_thickness);
+  TessellateLineInternal(p0, p1, orthogonal, converted_color, half_thickness, vertices);
 }
 
-void PrimitiveRenderer::DrawDashedLine(const Vector3& start, const Vector3& end, const Color& color, float thickness,
-                                       float dash_length) {
-  const uint32_t converted_color = ConvertToRGBA8(color);
+void PrimitiveRenderer::TessellateDashedLine(const Vector3& start, const Vector3& end, uint32_t converted_color,
+                                             float thickness, float dash_length, std::vector<Vertex>* vertices) const {
   const float half_thickness = thickness * 0.5f;
 
   const LineSegment2D line_segment = {TransformPosition(to_screen_space_, start),
@@ -151,37 +327,33 @@ void PrimitiveRenderer::DrawDashedLine(const Vector3& start, const Vector3& end,
   for (int i = 0; i < complete_dashes; ++i) {
     const Vector3 dash_start = p0 + line_direction * dash_interval * i;
     const Vector3 dash_end = dash_start + line_direction * actual_dash_length;
-    DrawLineInternal(dash_start, dash_end, orthogonal, converted_color, half_thickness);
+    TessellateLineInternal(dash_start, dash_end, orthogonal, converted_color, half_thickness, vertices);
   }
 
   {
     const float remaining_dash_fraction = std::min(1.0f, 2.0f * (dash_count - complete_dashes));
     const Vector3 final_dash_start = p0 + line_direction * dash_interval * complete_dashes;
     const Vector3 final_dash_end = final_dash_start + line_direction * actual_dash_length * remaining_dash_fraction;
-    DrawLineInternal(final_dash_start, final_dash_end, orthogonal, converted_color, half_thickness);
-  }
-}
-
-void PrimitiveRenderer::DrawLineStip(std::span<const Vector3> positions, const Color& color, float thickness) {
-  assert(positions.size() >= 2);
-
-  for (size_t i = 0; i < positions.size() - 1; ++i) {
-    DrawLine(positions[i], positions[i + 1], color, thickness);
+    TessellateLineInternal(final_dash_start, final_dash_end, orthogonal, converted_color, half_thickness, vertices);
   }
 }
 
-void PrimitiveRenderer::DrawLoop(std::span<const Vector3> positions, const Color& color, float thickness) {
-  assert(positions.size() > 2);
-  DrawLineStip(positions, color, thickness);
-  DrawLine(positions.back(), positions.front(), color, thickness);
-}
-
-void PrimitiveRenderer::DrawCircle(const Vector3& center, float radius, const Color& color, float thickness,
-                                   size_t num_segments, const Vector3& support_vector0,
-                                   const Vector3& support_vector1) {
+void PrimitiveRenderer::TessellateCircle(const Command& command, bool filled, std::vector<Vertex>* vertices) const {
+  const auto& [center, support_vector0, support_vector1] = command.positions;
+  const float radius = command.parameters[0];
+  const float thickness = command.parameters[1];
   const size_t final_segment_count =
-      num_segments < 2 ? CalculateSmoothCircleSegmentCount(center, radius, support_vector0, support_vector1)
-                       : num_segments;
+      command.segment_count < 2
+          ? CalculateSmoothCircleSegmentCount(center, radius, support_vector0, support_vector1)
+          : command.segment_count;
+
+  const auto add_segment = [&](const Vector3& start, const Vector3& end) {
+    if (filled) {
+      TessellateTriangle(start, end, center, command.color, vertices);
+    } else {
+      TessellateLine(start, end, command.color, thickness, vertices);
+    }
+  };
 
   const Vector3 base_position = center + radius * support_vector1;
   Vector3 previous_position = base_position;
@@ -190,69 +362,56 @@ void PrimitiveRenderer::DrawCircle(const Vector3& center, float radius, const Co
 
     const Vector3 new_position =
         center + radius * (std::sin(angle) * support_vector0 + std::cos(angle) * support_vector1);
-    DrawLine(previous_position, new_position, color, thickness);
+    add_segment(previous_position, new_position);
     previous_position = new_position;
   }
-  DrawLine(previous_position, base_position, color, thickness);
+  add_segment(previous_position, base_position);
 }
 
-void PrimitiveRenderer::DrawArrow(const Vector3& start, const Vector3& end, const Color& color, float thickness,
-                                  float arrow_width, float arrow_length) {
+void PrimitiveRenderer::TessellateArrow(const Vector3& start, const Vector3& end, uint32_t converted_color,
+                                        float thickness, float arrow_width, float arrow_length,
+                                        std::vector<Vertex>* vertices) const {
   const Vector3 start_to_end = end - start;
   const float start_to_end_length = Length(start_to_end);
   const Vector3 line_end =
       start + start_to_end * (start_to_end_length - thickness * arrow_length) / start_to_end_length;
 
-  DrawLine(start, line_end, color, thickness);
+  TessellateLine(start, line_end, converted_color, thickness, vertices);
 
   const Vector3 orthogonal = Vector3::FromVector2(Normalize(ConstructOrthogonalVectorCCW(start_to_end)));
   const float offset = 0.5f * thickness * arrow_width;
 
   // clang-format off
-  DrawTriangle(
+  TessellateTriangle(
     line_end + orthogonal * offset,
     line_end - orthogonal * offset,
     end,
-    color
+    converted_color,
+    vertices
   );
   // clang-format on
 }
 
-void PrimitiveRenderer::DrawTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, const Color& color) {
-  uint32_t converted_color = ConvertToRGBA8(color);
+void PrimitiveRenderer::TessellateTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2,
+                                           uint32_t converted_color, std::vector<Vertex>* vertices) const {
   const Vector3 screen_space_v0 = TransformPosition(to_screen_space_, v0);
   const Vector3 screen_space_v1 = TransformPosition(to_screen_space_, v1);
   const Vector3 screen_space_v2 = TransformPosition(to_screen_space_, v2);
-  Vertex vertices[3] = {{{screen_space_v0.x, screen_space_v0.y, screen_space_v0.z}, converted_color},
-                        {{screen_space_v1.x, screen_space_v1.y, screen_space_v1.z}, converted_color},
-                        {{screen_space_v2.x, screen_space_v2.y, screen_space_v2.z}, converted_color}};
-  AddVertices(vertices);
+  vertices->push_back({{screen_space_v0.x, screen_space_v0.y, screen_space_v0.z}, converted_color});
+  vertices->push_back({{screen_space_v1.x, screen_space_v1.y, screen_space_v1.z}, converted_color});
+  vertices->push_back({{screen_space_v2.x, screen_space_v2.y, screen_space_v2.z}, converted_color});
 }
 
-void PrimitiveRenderer::DrawDisc(const Vector3& center, float radius, const Color& color, size_t num_segments,
-                                 const Vector3& support_vector0, const Vector3& support_vector1) {
-  const size_t final_segment_count =
-      num_segments < 2 ? CalculateSmoothCircleSegmentCount(center, radius, support_vector0, support_vector1)
-                       : num_segments;
-
-  const Vector3 base_position = center + radius * support_vector1;
-  Vector3 previous_position = base_position;
-  for (int i = 1; i < final_segment_count; ++i) {
-    const float angle = i * 2.0f * Pi<float>() / final_segment_count;
-
-    const Vector3 new_position =
-        center + radius * (std::sin(angle) * support_vector0 + std::cos(angle) * support_vector1);
-    DrawTriangle(previous_position, new_position, center, color);
-    previous_position = new_position;
-  }
-  DrawTriangle(previous_position, base_position, center, color);
-}
-
-void PrimitiveRenderer::DrawConvexPolygon(const Vector3* positions, size_t num_positions, const Color& color) {
-  assert(num_positions > 2);
+void PrimitiveRenderer::TessellateLineInternal(const Vector3& p0, const Vector3& p1, const Vector3& orthogonal,
+                                               uint32_t converted_color, float half_thickness,
+                                               std::vector<Vertex>* vertices) {
+  const Vector3 p00 = p0 + half_thickness * orthogonal;
+  const Vector3 p01 = p0 - half_thickness * orthogonal;
+  const Vector3 p10 = p1 + half_thickness * orthogonal;
+  const Vector3 p11 = p1 - half_thickness * orthogonal;
 
-  for (size_t i = 0; i < num_positions - 1; ++i) {
-    DrawTriangle(positions[0], positions[i], positions[i + 1], color);
+  for (const Vector3& corner : {p00, p11, p10, p00, p01, p11}) {
+    vertices->push_back({{corner.x, corner.y, corner.z}, converted_color});
   }
 }
 
@@ -261,14 +420,16 @@ void PrimitiveRenderer::AddVertices(std::span<const Vertex> vertices) {
   assert(resources_);
   assert(vertices.size() % 3 == 0);
 
-  const size_t remaining_space = VERTEX_BUFFER_ELEMENT_COUNT - resources_->vertices.size();
-  const size_t vertices_to_copy = (std::min(vertices.size(), remaining_space) / 3) * 3;
-  resources_->vertices.insert(resources_->vertices.end(), vertices.begin(), vertices.begin() + vertices_to_copy);
+  while (!vertices.empty()) {
+    const size_t remaining_space = VERTEX_BUFFER_ELEMENT_COUNT - resources_->vertices.size();
+    const size_t vertices_to_copy = (std::min(vertices.size(), remaining_space) / 3) * 3;
+    resources_->vertices.insert(resources_->vertices.end(), vertices.begin(), vertices.begin() + vertices_to_copy);
+    vertices = vertices.subspan(vertices_to_copy);
 
-  if (vertices_to_copy < vertices.size()) {
-    // We could fit all vertices, flush buffer and try again
-    Flush();
-    AddVertices(vertices.subspan(vertices_to_copy));
+    if (!vertices.empty()) {
+      // Not all vertices fit, flush the buffer and continue with the remaining ones
+      Flush();
+    }
   }
 }
 
@@ -277,20 +438,21 @@ void PrimitiveRenderer::Flush() {
   assert(resources_);
 
   const size_t vertex_count = resources_->vertices.size();
-  assert(vertex_count < VERTEX_BUFFER_ELEMENT_COUNT);
+  assert(vertex_count <= VERTEX_BUFFER_ELEMENT_COUNT);
   assert(vertex_count % 3 == 0);
 
   if (resources_->vertices.size() == 0) {
     return;
   }
 
-  resources_->vertex_buffer->Write(0, vertex_count * sizeof(Vertex), resources_->vertices.data());
+  const size_t first_vertex = resources_->vertex_buffer->Write(std::span<const Vertex>(resources_->vertices));
 
   DrawItem draw_item;
   draw_item.vertex_input = resources_->vertex_input.get();
   draw_item.shader_program = resources_->shader.get();
   draw_item.primitive_topology = PrimitiveTopology::TRIANGLE_LIST;
   // draw_item.render_target_configuration = viewport()->GetDefaultRenderTargetConfiguration();
+  draw_item.start = first_vertex;
   draw_item.count = vertex_count;
   if (enable_alpha_blending_) {
     draw_item.blend_state.enabled = true;
@@ -302,39 +464,10 @@ void PrimitiveRenderer::Flush() {
   resources_->vertices.clear();
 }
 
-void PrimitiveRenderer::DrawLineInternal(const Vector3& p0, const Vector3& p1, const Vector3& orthogonal,
-                                         uint32_t converted_color, float half_thickness) {
-  const Vector3 p00 = p0 + half_thickness * orthogonal;
-  const Vector3 p01 = p0 - half_thickness * orthogonal;
-  const Vector3 p10 = p1 + half_thickness * orthogonal;
-  const Vector3 p11 = p1 - half_thickness * orthogonal;
-
-  std::array<Vertex, 6> vertices;
-
-  memcpy(vertices[0].position, p00.data, sizeof(float) * 3);
-  vertices[0].color = converted_color;
-
-  memcpy(vertices[1].position, p11.data, sizeof(float) * 3);
-  vertices[1].color = converted_color;
-
-  memcpy(vertices[2].position, p10.data, sizeof(float) * 3);
-  vertices[2].color = converted_color;
-
-  memcpy(vertices[3].position, p00.data, sizeof(float) * 3);
-  vertices[3].color = converted_color;
-
-  memcpy(vertices[4].position, p01.data, sizeof(float) * 3);
-  vertices[4].color = converted_color;
-
-  memcpy(vertices[5].position, p11.data, sizeof(float) * 3);
-  vertices[5].color = converted_color;
-
-  AddVertices(vertices);
-}
 
 size_t PrimitiveRenderer::CalculateSmoothCircleSegmentCount(const Vector3& center, float radius,
                                                             const Vector3& support_vector0,
-                                                            const Vector3& support_vector1) {
+                                                            const Vector3& support_vector1) const {
   // To create a smooth circle we need enough segments. The number of segments depends on the pixels the circle covers.
   // We approximately want one segment per pixel which can be approximated by the radius of the circle in screen space.
   // However, the radius definition given here can be in an arbitrary space and cannot be converted to screen space.
@@ -349,7 +482,7 @@ size_t PrimitiveRenderer::CalculateSmoothCircleSegmentCount(const Vector3& cente
       std::sqrt(std::max(squared_screen_space_radius0, squared_screen_space_radius1));
 
   // Minimum and maximum is a little arbitrary but why shouldn't that be?
-  return std::clamp<size_t>(8, 512, std::ceil(TwoPi<float>() * approximate_screen_space_radius));
+  return std::clamp<size_t>(std::ceil(TwoPi<float>() * approximate_screen_space_radius), 8, 512);
 }
 
 }  // namespace ovis
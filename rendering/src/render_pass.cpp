@@ -15,8 +15,20 @@ Result<> RenderPass::Prepare(Scene* const& scene) {
 }
 
 Result<> RenderPass::Execute(const SceneUpdate& parameters) {
-  SceneViewport viewport;
-  Render(parameters, viewport);
+  if (const SceneViewport* scene_viewport = parameters.scene->GetSceneComponent<SceneViewport>(); scene_viewport) {
+    Render(parameters, *scene_viewport);
+  } else {
+    // Without a camera the world coordinates are used as clip space coordinates
+    SceneViewport viewport;
+    viewport.world_to_view = Matrix3x4::IdentityTransformation();
+    viewport.view_to_world = Matrix3x4::IdentityTransformation();
+    viewport.view_to_clip = Matrix4::Identity();
+    viewport.clip_to_view = Matrix4::Identity();
+    viewport.world_to_clip = Matrix4::Identity();
+    viewport.clip_to_world = Matrix4::Identity();
+    viewport.dimensions = Vector2::One();
+    Render(parameters, viewport);
+  }
   return Success;
 }
 
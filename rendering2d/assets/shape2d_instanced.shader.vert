@@ -0,0 +1,19 @@
+in vec2 a_Position;
+in vec2 a_TextureCoordinates;
+in vec4 a_Color;
+
+in vec3 a_TransformRow0;
+in vec3 a_TransformRow1;
+in vec2 a_Size;
+in vec4 a_TextureRect;
+in vec4 a_InstanceColor;
+
+out vec2 vs_TextureCoordinates;
+out vec4 vs_Color;
+
+void main() {
+  vec3 position = vec3(a_Position * a_Size, 1.0);
+  gl_Position = vec4(dot(a_TransformRow0, position), dot(a_TransformRow1, position), 0.0, 1.0);
+  vs_Color = a_Color * a_InstanceColor;
+  vs_TextureCoordinates = mix(a_TextureRect.xy, a_TextureRect.zw, a_TextureCoordinates);
+}
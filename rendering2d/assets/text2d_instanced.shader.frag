@@ -0,0 +1,17 @@
+uniform sampler2D u_Texture;
+
+in vec2 vs_TextureCoordinates;
+in vec4 vs_Color;
+
+void main() {
+  // The signed distance field of the glyphs is 0.5 on their outline
+  float field = texture2D(u_Texture, vs_TextureCoordinates).r;
+#ifdef OVIS_EMSCRIPTEN
+  // Screen space derivatives require an extension in WebGL 1
+  float smoothing = 0.0625;
+#else
+  float smoothing = 0.7 * fwidth(field);
+#endif
+  float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, field);
+  gl_FragColor = vec4(vs_Color.rgb, vs_Color.a * alpha);
+}
@@ -0,0 +1,159 @@
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/utils/log.hpp"
+#include "ovis/utils/thread_pool.hpp"
+#include "ovis/core/asset_loader.hpp"
+#include "ovis/core/scene.hpp"
+#include "ovis/core/transform.hpp"
+#include "ovis/graphics/graphics_recording.hpp"
+#include "ovis/rendering/clear_pass.hpp"
+#include "ovis/rendering2d/renderer2d.hpp"
+#include "ovis/rendering2d/text.hpp"
+#include "ovis/test/require_result.hpp"
+
+using namespace ovis;
+
+namespace {
+
+void LogFrameStatistics(std::string_view name, const GraphicsStatistics& statistics) {
+  LogI("{}: {} draw calls, {} state changes, {} texture binds, {} bytes uploaded", name, statistics.draw_calls,
+       statistics.state_changes, statistics.texture_binds, statistics.uploaded_bytes);
+}
+
+}  // namespace
+
+TEST_CASE("Renderer2D draw calls for sprites mixed with text", "[ovis][rendering2d][Renderer2D][benchmark]") {
+  GraphicsContext context(Vector2(1280, 720));
+  REQUIRE(context.recording() != nullptr);
+
+  Scene scene;
+  scene.frame_scheduler().AddJob<ClearPass>(&context, Color::Aqua());
+  scene.frame_scheduler().AddJob<Renderer2D>(&context);
+  REQUIRE_RESULT(scene.Prepare());
+
+  constexpr int ENTITY_COUNT = 1000;
+  for (int i = 0; i < ENTITY_COUNT; ++i) {
+    auto entity = scene.CreateEntity(fmt::format("Entity{}", i));
+    if (i % 2 == 0) {
+      scene.GetComponentStorage<Shape2D>().AddComponent(entity->id);
+      auto& shape = scene.GetComponentStorage<Shape2D>()[entity->id];
+      shape.SetRectangle({.size = {0.01f, 0.01f}});
+    } else {
+      scene.GetComponentStorage<Text>().AddComponent(entity->id);
+      scene.GetComponentStorage<Text>()[entity->id].text = "Hello";
+      // Commands of the same depth are drawn in the order they were submitted, so the texts are moved in front of the
+      // shapes to allow batching them
+      scene.GetComponentStorage<GlobalTransformMatrices>().AddComponent(entity->id);
+      scene.GetComponentStorage<GlobalTransformMatrices>()[entity->id].local_to_world =
+          Matrix3x4::FromTranslation({0.0f, 0.0f, -1.0f});
+    }
+  }
+
+  scene.Play();
+  // The first frame also contains the creation of the resources and requests the font, which is loaded in the
+  // background
+  scene.Update(0.0);
+  GetDefaultAssetLoader()->CompleteAll();
+  scene.Update(0.0);
+
+  context.recording()->Clear();
+  context.ResetStateStatistics();
+  scene.Update(0.0);
+  const GraphicsStatistics statistics = context.recording()->statistics();
+  LogFrameStatistics("Renderer2D", statistics);
+  LogI("Renderer2D: {} state changes issued, {} redundant state changes skipped",
+       context.state_statistics().issued_state_changes, context.state_statistics().skipped_state_changes);
+
+  // Shapes and texts are batched by their depth. All texts share one glyph run whose mesh was uploaded in the first
+  // frame, so only one instance per entity is uploaded.
+  REQUIRE(statistics.draw_calls == 2);
+  REQUIRE(statistics.uploaded_bytes == ENTITY_COUNT * sizeof(RenderQueue2D::Instance));
+  // Texts use their own program, but both batches use the same blend state, so the second one must not set it again
+  REQUIRE(context.state_statistics().skipped_state_changes > 0);
+
+  BENCHMARK("Renderer2D frame") {
+    context.recording()->Clear();
+    scene.Update(0.0);
+  };
+}
+
+TEST_CASE("Renderer2D culls entities outside of the viewport", "[ovis][rendering2d][Renderer2D][benchmark]") {
+  GraphicsContext context(Vector2(1280, 720));
+  REQUIRE(context.recording() != nullptr);
+
+  Scene scene;
+  scene.frame_scheduler().AddJob<Renderer2D>(&context);
+  REQUIRE_RESULT(scene.Prepare());
+
+  // A row of rectangles that is ten times wider than the viewport, which spans [-1, 1] without a camera
+  constexpr int ENTITY_COUNT = 10000;
+  constexpr float SPACING = 0.002f;
+  int visible_count = 0;
+  for (int i = 0; i < ENTITY_COUNT; ++i) {
+    auto entity = scene.CreateEntity(fmt::format("Entity{}", i));
+    scene.GetComponentStorage<Shape2D>().AddComponent(entity->id);
+    scene.GetComponentStorage<Shape2D>()[entity->id].SetRectangle({.size = {0.001f, 0.001f}});
+    scene.GetComponentStorage<GlobalTransformMatrices>().AddComponent(entity->id);
+    // Offset by half the spacing, so no rectangle touches the border of the viewport
+    const float x = (i - ENTITY_COUNT / 2 + 0.5f) * SPACING;
+    scene.GetComponentStorage<GlobalTransformMatrices>()[entity->id].local_to_world =
+        Matrix3x4::FromTranslation({x, 0.0f, 0.0f});
+    if (std::abs(x) <= 1.0f) {
+      ++visible_count;
+    }
+  }
+
+  scene.Play();
+  scene.Update(0.0);
+
+  context.recording()->Clear();
+  scene.Update(0.0);
+  const GraphicsStatistics statistics = context.recording()->statistics();
+  LogFrameStatistics("Renderer2D culling", statistics);
+
+  REQUIRE(statistics.draw_calls == 1);
+  REQUIRE(statistics.uploaded_bytes == visible_count * sizeof(RenderQueue2D::Instance));
+
+  BENCHMARK("Renderer2D frame with culling") {
+    context.recording()->Clear();
+    scene.Update(0.0);
+  };
+}
+
+TEST_CASE("Renderer2D vertex generation for many texts", "[ovis][rendering2d][Renderer2D][benchmark]") {
+  GraphicsContext context(Vector2(1280, 720));
+  REQUIRE(context.recording() != nullptr);
+
+  Scene scene;
+  scene.frame_scheduler().AddJob<Renderer2D>(&context);
+  REQUIRE_RESULT(scene.Prepare());
+
+  // Enough texts to be split into several chunks that are generated in parallel. They are all drawn from the same glyph
+  // run.
+  constexpr int ENTITY_COUNT = 20000;
+  for (int i = 0; i < ENTITY_COUNT; ++i) {
+    auto entity = scene.CreateEntity(fmt::format("Entity{}", i));
+    scene.GetComponentStorage<Text>().AddComponent(entity->id);
+    scene.GetComponentStorage<Text>()[entity->id].text = "Hello";
+  }
+
+  scene.Play();
+  scene.Update(0.0);
+  GetDefaultAssetLoader()->CompleteAll();
+  scene.Update(0.0);
+
+  context.recording()->Clear();
+  scene.Update(0.0);
+  const GraphicsStatistics statistics = context.recording()->statistics();
+  LogFrameStatistics("Renderer2D texts", statistics);
+  LogI("Renderer2D texts: generated on {} worker threads", GetDefaultThreadPool()->thread_count());
+
+  REQUIRE(statistics.drawn_elements == ENTITY_COUNT * 5 * 6);
+  REQUIRE(statistics.uploaded_bytes == ENTITY_COUNT * sizeof(RenderQueue2D::Instance));
+
+  BENCHMARK("Renderer2D frame with many texts") {
+    context.recording()->Clear();
+    scene.Update(0.0);
+  };
+}
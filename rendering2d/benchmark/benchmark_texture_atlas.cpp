@@ -0,0 +1,46 @@
+#include <random>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/utils/log.hpp"
+#include "ovis/rendering2d/texture_atlas.hpp"
+
+using namespace ovis;
+
+TEST_CASE("Pack thousands of sprites", "[ovis][rendering2d][SkylinePacker][benchmark]") {
+  constexpr std::uint32_t PAGE_SIZE = 2048;
+  constexpr std::size_t SPRITE_COUNT = 10000;
+
+  std::mt19937 random_engine(42);
+  std::uniform_int_distribution<std::uint32_t> sprite_size(8, 96);
+  std::vector<RectangleSize> sizes(SPRITE_COUNT);
+  std::uint64_t sprite_area = 0;
+  for (RectangleSize& size : sizes) {
+    size = {.width = sprite_size(random_engine), .height = sprite_size(random_engine)};
+    sprite_area += static_cast<std::uint64_t>(size.width) * size.height;
+  }
+
+  const auto packed_rectangles = PackRectangles(sizes, PAGE_SIZE, PAGE_SIZE);
+  std::uint32_t page_count = 0;
+  for (const auto& packed_rectangle : packed_rectangles) {
+    REQUIRE(packed_rectangle.has_value());
+    page_count = std::max(page_count, packed_rectangle->page + 1);
+  }
+  const double occupancy = static_cast<double>(sprite_area) / (static_cast<double>(PAGE_SIZE) * PAGE_SIZE * page_count);
+  LogI("Packed {} sprites into {} pages with an occupancy of {:.1f}%", SPRITE_COUNT, page_count, occupancy * 100.0);
+  REQUIRE(occupancy > 0.85);
+
+  BENCHMARK("Pack sorted sprites") { return PackRectangles(sizes, PAGE_SIZE, PAGE_SIZE); };
+
+  BENCHMARK("Insert sprites one by one") {
+    std::vector<SkylinePacker> pages;
+    for (const RectangleSize& size : sizes) {
+      if (pages.empty() || !pages.back().Insert(size.width, size.height).has_value()) {
+        pages.emplace_back(PAGE_SIZE, PAGE_SIZE);
+        pages.back().Insert(size.width, size.height);
+      }
+    }
+    return pages.size();
+  };
+}
@@ -1,30 +1,123 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "stb_truetype.h"
 
+#include "ovis/core/asset_view.hpp"
+#include "ovis/core/vector.hpp"
 #include "ovis/graphics/texture2d.hpp"
-#include "ovis/rendering2d/shape2d.hpp"
 
 namespace ovis {
 
+// Renders the glyphs of a font on demand as signed distance fields into a single channel texture. A distance field
+// stays sharp when it is scaled, so texts of any size are drawn from the same atlas. The texture is divided into cells
+// of equal size that hold one glyph each. When all cells are occupied, the least recently used glyph is replaced by the
+// new one. Glyphs that were used in the current frame are never replaced.
+//
+// All metrics are in units of the font size with the y axis pointing up. See LayoutText() for positioning the glyphs of
+// a text.
 class FontAtlas {
-  public:
-    FontAtlas(GraphicsContext* context, std::string_view asset, float height);
+ public:
+  static constexpr std::uint32_t TEXTURE_SIZE = 512;
+  static constexpr std::uint32_t CELL_SIZE = 32;
+  static constexpr std::uint32_t CELL_COUNT = (TEXTURE_SIZE / CELL_SIZE) * (TEXTURE_SIZE / CELL_SIZE);
+  // The font size the distance fields are rendered with and how far they extend beyond the outlines (in pixels)
+  static constexpr float SDF_FONT_SIZE = 24.0f;
+  static constexpr int SDF_PADDING = 4;
 
-    std::string_view asset() const { return asset_; }
-    float height() const { return height_; }
-    Texture2D* texture() { return texture_.get(); }
+  struct GlyphMetrics {
+    float advance;
+    // The bounding box of the outline relative to the origin of the glyph on the baseline
+    Vector2 outline_min;
+    Vector2 outline_max;
+    bool has_outline;
+  };
 
-    std::array<Shape2D::Vertex, 6> GetCharacterVertices(char character, Vector2* current_position, Color color);
+  // The quad a glyph is drawn with relative to its origin and the region of the texture it is mapped to (s0, t0, s1,
+  // t1). The quad is larger than the outline as it includes the padding of the distance field.
+  struct GlyphQuad {
+    Vector2 min;
+    Vector2 max;
+    std::array<float, 4> texture_rect;
+  };
 
-  private:
-    std::string asset_;
-    float height_;
-    std::unique_ptr<Texture2D> texture_;
-    std::array<stbtt_bakedchar, 96> baked_characters; // Storage for printable ASCII characters
+  FontAtlas(GraphicsContext* context, std::string_view asset, AssetView font_data);
+  FontAtlas(const FontAtlas&) = delete;
+
+  FontAtlas& operator=(const FontAtlas&) = delete;
+
+  std::string_view asset() const { return asset_; }
+  Texture2D* texture() const { return texture_.get(); }
+  const AssetView& font_data() const { return font_data_; }
+  std::size_t occupied_cell_count() const { return CELL_COUNT - free_cells_.size(); }
+  // The distance between the baselines of two lines
+  float line_height() const { return line_height_; }
+  // Incremented whenever a glyph is replaced, which invalidates the quads of the glyphs returned before
+  std::uint32_t generation() const { return generation_; }
+
+  const GlyphMetrics& GetGlyphMetrics(char32_t codepoint);
+  // The adjustment of the advance of the previous glyph if it is followed by the glyph
+  float GetKerning(char32_t previous_codepoint, char32_t codepoint);
+
+  // Starts a new frame. The glyphs used in previous frames may be replaced again.
+  void BeginFrame();
+
+  // Renders the glyph if it is not in the atlas yet and marks it as used in the current frame. This has to be called
+  // every frame the glyph is drawn.
+  void PrepareGlyph(char32_t codepoint);
+
+  // Returns nullptr if the glyph is not in the atlas, e.g., if it has no outline or did not fit into the atlas. This
+  // only reads from the atlas, so it can be called from multiple threads as long as no other method is called at the
+  // same time.
+  const GlyphQuad* FindGlyphQuad(char32_t codepoint) const;
+
+ private:
+  struct Glyph {
+    int index;
+    GlyphMetrics metrics;
+    // Only valid if the glyph currently occupies a cell
+    std::optional<std::uint16_t> cell;
+    GlyphQuad quad;
+    std::uint32_t last_used_frame;
+  };
+
+  std::string asset_;
+  // The font is read directly from the asset file
+  AssetView font_data_;
+  stbtt_fontinfo font_info_;
+  // Scales font units to units of the font size
+  float font_scale_;
+  float line_height_;
+  std::unique_ptr<Texture2D> texture_;
+  std::unordered_map<char32_t, Glyph> glyphs_;
+  // The codepoint of the glyph in each cell
+  std::array<char32_t, CELL_COUNT> cell_codepoints_;
+  std::vector<std::uint16_t> free_cells_;
+  std::vector<std::uint8_t> cell_pixels_;
+  std::uint32_t frame_ = 1;
+  std::uint32_t generation_ = 0;
+  bool logged_full_atlas_ = false;
+
+  Glyph& GetGlyph(char32_t codepoint);
+  std::optional<std::uint16_t> AllocateCell();
+  void RenderGlyph(char32_t codepoint, Glyph* glyph, std::uint16_t cell);
 };
 
-}
+// The texture on the GPU and the font file in main memory, for the AssetCache
+AssetMemoryUsage GetAssetMemoryUsage(const FontAtlas& font_atlas);
+
+// Creates an atlas for the contents of a TrueType font file. Returns nullptr if the file is not a valid font.
+std::unique_ptr<FontAtlas> CreateFontAtlas(GraphicsContext* context, std::string_view asset, AssetView font_data);
+
+// Loads the TrueType font asset and creates an atlas for it. Returns nullptr if the font could not be loaded.
+std::unique_ptr<FontAtlas> LoadFontAtlas(GraphicsContext* context, std::string_view asset);
+
+}  // namespace ovis
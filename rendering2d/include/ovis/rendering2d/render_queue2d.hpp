@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "ovis/graphics/blend_state.hpp"
+#include "ovis/graphics/texture2d.hpp"
+#include "ovis/rendering2d/shape2d.hpp"
+
+namespace ovis {
+
+enum class BlendMode2D : std::uint8_t {
+  ALPHA,
+  ADDITIVE,
+};
+BlendState GetBlendState(BlendMode2D blend_mode);
+
+// Collects the draw commands of the 2D renderer for a frame and merges them into as few batches as possible. A command
+// either consists of triangles or of a single instance of a mesh, see Instance. Every command gets a sort key that
+// consists of (from the most to the least significant bits):
+//   - the layer (8 bits): commands on lower layers are drawn first.
+//   - the depth (32 bits): commands with a larger depth are drawn first.
+// The commands are radix sorted and adjacent commands of the same kind that use the same texture, blend mode and mesh
+// form a batch that can be drawn with a single draw call. The sort is stable, so commands with the same key are drawn
+// in the order they were submitted. The texture, the blend mode, the mesh and whether a command is instanced are
+// deliberately not part of the key: the queue does not know which commands overlap, so reordering commands of the same
+// depth by their state could draw a sprite over one that was submitted after it, or a shape over its own text.
+class RenderQueue2D {
+ public:
+  using Vertex = Shape2D::Vertex;
+
+  // An instance of a mesh whose vertices were uploaded by the renderer, e.g., the geometry of a shape or a quad for
+  // rectangles. The mesh is identified by an id that is chosen by the renderer.
+  struct Instance {
+    // The first two rows of the affine transformation from the scaled mesh to clip space
+    float transform[2][3];
+    float size[2];
+    // The region of the texture the texture coordinates of the mesh are mapped to (s0, t0, s1, t1)
+    float texture_rect[4];
+    // Multiplied with the vertex colors of the mesh
+    std::uint32_t color;
+  };
+  static_assert(sizeof(Instance) == 52);
+
+  struct Batch {
+    Texture2D* texture;
+    BlendMode2D blend_mode;
+    bool instanced;
+    // Drawn with the text program, as the texture is the signed distance field of a font atlas
+    bool is_text;
+    std::uint16_t mesh;
+    // Ranges in sorted_vertices() for triangle batches
+    std::uint32_t first_vertex;
+    std::uint32_t vertex_count;
+    // Ranges in sorted_instances() for instanced batches
+    std::uint32_t first_instance;
+    std::uint32_t instance_count;
+  };
+
+  static std::uint64_t CreateSortKey(std::uint8_t layer, float depth);
+
+  // Removes all commands. The memory of the queue is kept, so it will not allocate again once it has grown to the
+  // size of a typical frame.
+  void Clear();
+
+  // Adds a draw command and returns the vertices of it which must be filled in by the caller. The returned span is only
+  // valid until the next call to Submit(). Texts are never merged into a batch with other commands.
+  std::span<Vertex> Submit(std::uint8_t layer, float depth, Texture2D* texture, BlendMode2D blend_mode,
+                           std::size_t vertex_count, bool is_text = false);
+
+  // Adds an instance of a mesh that must be filled in by the caller. The returned reference is only valid until the
+  // next call to SubmitInstance().
+  Instance& SubmitInstance(std::uint8_t layer, float depth, Texture2D* texture, BlendMode2D blend_mode,
+                           std::uint16_t mesh, bool is_text = false);
+
+  // Adds all commands of the other queue as if they were submitted to this queue in the same order. This allows
+  // generating the commands on multiple threads, each into its own queue.
+  void Append(const RenderQueue2D& other);
+
+  // Sorts the submitted commands and merges them into batches. The vertices and instances of all batches are stored
+  // consecutively in sorted_vertices() and sorted_instances() in the order of the batches.
+  void Sort();
+
+  std::size_t command_count() const { return commands_.size(); }
+  std::span<const Batch> batches() const { return batches_; }
+  std::span<const Vertex> sorted_vertices() const { return sorted_vertices_; }
+  std::span<const Instance> sorted_instances() const { return sorted_instances_; }
+
+ private:
+  struct Command {
+    std::uint64_t sort_key;
+    Texture2D* texture;
+    BlendMode2D blend_mode;
+    // The index of the instance for instanced commands, otherwise the index of the first vertex
+    std::uint32_t first_element;
+    std::uint32_t vertex_count;
+    std::uint16_t mesh;
+    bool instanced;
+    bool is_text;
+  };
+  // The bits below the depth are always zero and do not have to be sorted
+  static constexpr int SORT_KEY_SHIFT = 24;
+
+  std::vector<Command> commands_;
+  std::vector<Command> sort_buffer_;
+  std::vector<Vertex> vertices_;
+  std::vector<Vertex> sorted_vertices_;
+  std::vector<Instance> instances_;
+  std::vector<Instance> sorted_instances_;
+  std::vector<Batch> batches_;
+
+  void RadixSortCommands();
+  template <typename DigitFunction>
+  void SortCommandsByDigit(DigitFunction digit);
+};
+
+}  // namespace ovis
@@ -1,18 +1,35 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ovis/core/asset_loader.hpp"
+#include "ovis/core/color.hpp"
+#include "ovis/core/entity.hpp"
+#include "ovis/core/matrix.hpp"
+#include "ovis/core/spatial_grid2d.hpp"
 #include "ovis/graphics/shader_program.hpp"
 #include "ovis/graphics/texture2d.hpp"
-#include "ovis/graphics/vertex_buffer.hpp"
+#include "ovis/graphics/streaming_vertex_buffer.hpp"
 #include "ovis/graphics/vertex_input.hpp"
 #include "ovis/rendering/render_pass.hpp"
 #include "ovis/rendering2d/font_atlas.hpp"
+#include "ovis/rendering2d/render_queue2d.hpp"
 #include "ovis/rendering2d/shape2d.hpp"
+#include "ovis/rendering2d/text.hpp"
+#include "ovis/rendering2d/text_layout.hpp"
+#include "ovis/rendering2d/texture_atlas.hpp"
 
 namespace ovis {
 
 class Renderer2D : public RenderPass {
  public:
   Renderer2D(GraphicsContext* graphics_context);
+  ~Renderer2D() override;
 
   void CreateResources() override;
   void ReleaseResources() override;
@@ -21,17 +38,161 @@ class Renderer2D : public RenderPass {
 
  private:
   static constexpr size_t VERTEX_BUFFER_ELEMENT_COUNT = 64 * 1024;
-  std::array<Shape2D::Vertex, VERTEX_BUFFER_ELEMENT_COUNT> shape_vertices_;
-  size_t shape_vertex_count_ = 0;
-  std::unique_ptr<VertexBuffer> vertex_buffer_;
+  static constexpr size_t INSTANCE_BUFFER_ELEMENT_COUNT = 16 * 1024;
+  RenderQueue2D render_queue_;
+  std::unique_ptr<StreamingVertexBuffer> vertex_buffer_;
   std::unique_ptr<VertexInput> vertex_input_;
   std::unique_ptr<ShaderProgram> shape_shader_;
-  std::unique_ptr<Texture2D> empty_texture_;
-  std::unordered_map<std::string, std::unique_ptr<Texture2D>> textures_;
 
-  std::vector<FontAtlas> font_atlases_;
+  // The geometry of the shapes is uploaded once into the geometry buffer and drawn by instancing it for as long as it
+  // is used. Rectangles without an outline all share a quad that is scaled and colored per instance. These resources
+  // are not created on WebGL, where all shapes are transformed on the CPU and drawn as triangles.
+  static constexpr size_t GEOMETRY_BUFFER_ELEMENT_COUNT = 64 * 1024;
+  static constexpr std::uint16_t QUAD_MESH = 0;
+  struct Mesh {
+    std::uint32_t first_vertex;
+    std::uint32_t vertex_count;
+  };
+  std::unique_ptr<VertexBuffer> geometry_buffer_;
+  std::size_t geometry_buffer_vertex_count_ = 0;
+  std::vector<Mesh> meshes_;
+  // Maps Shape2DGeometry::id to the index into meshes_
+  std::unordered_map<std::uint64_t, std::uint16_t> geometry_meshes_;
+  std::unique_ptr<StreamingVertexBuffer> instance_buffer_;
+  std::unique_ptr<VertexInput> instanced_vertex_input_;
+  std::unique_ptr<ShaderProgram> instanced_shape_shader_;
+
+  // The mesh of a shape is only looked up again when the version of the shape changes or the meshes were reset
+  struct CachedShape {
+    std::uint64_t version = 0;
+    std::uint32_t mesh_generation = 0;
+    std::optional<std::uint16_t> mesh;
+  };
+  std::vector<CachedShape> cached_shapes_;
+  std::uint32_t mesh_generation_ = 0;
+
+  // Sprites are packed into one texture atlas per filter, so shapes with different textures still share a batch as long
+  // as their textures are on the same atlas page. Shapes without a texture use a white pixel in the bilinear atlas.
+  // Textures that do not fit into a page or require mip maps are kept as separate textures, which are shared with other
+  // renderers via the asset cache of the context. They are released when they were not drawn for a while, so the cache
+  // can evict them. Textures are loaded by the default AssetLoader in the background and shapes are drawn with the
+  // white pixel until their texture is loaded.
+  static constexpr std::uint32_t ATLAS_PAGE_SIZE = 2048;
+  static constexpr std::uint32_t TEXTURE_LIFETIME = 300;
+  // Indexed by TextureFilter::POINT and TextureFilter::BILINEAR
+  std::array<std::unique_ptr<TextureAtlas>, 2> texture_atlases_;
+  TextureAtlasRegion white_region_;
+  struct TextureEntry {
+    std::optional<TextureAtlasRegion> region;
+    // Only set if the texture is not packed into an atlas
+    std::shared_ptr<Texture2D> texture;
+    std::uint32_t last_used_frame = 0;
+  };
+  // Indexed by TextureAssetId
+  std::vector<TextureEntry> textures_;
+
+  // Texts are drawn from one signed distance field atlas per font with a separate program. Fonts are loaded in the
+  // background as well and texts are not drawn until their font is loaded. Fonts that are loading or failed to load are
+  // kept as nullptr, so loading them is not attempted again every frame. The atlases are shared with other renderers
+  // via the asset cache of the context.
+  static constexpr const char* DEFAULT_FONT = "NotoSans-Regular";
+  std::unique_ptr<ShaderProgram> text_shader_;
+  std::unique_ptr<VertexInput> text_vertex_input_;
+  std::unique_ptr<ShaderProgram> instanced_text_shader_;
+  std::unique_ptr<VertexInput> instanced_text_vertex_input_;
+  std::unordered_map<std::string, std::shared_ptr<FontAtlas>> font_atlases_;
+  // The loads of textures and fonts that may still be pending. They are cancelled when the resources are released, as
+  // their completions refer to the renderer.
+  std::vector<AssetLoadHandle> asset_loads_;
+
+  // The layout and the vertices of a text are cached in a glyph run that is shared by all texts with the same content
+  // and appearance, so static texts are only laid out once. The vertices are generated again if a glyph of the atlas
+  // was replaced and they are uploaded as a mesh to be drawn as an instance where supported. Glyph runs that were not
+  // used for a while are removed.
+  static constexpr std::uint32_t GLYPH_RUN_LIFETIME = 60;
+  // Everything that affects the vertices of a glyph run
+  struct GlyphRunKey {
+    FontAtlas* font_atlas;
+    std::string text;
+    float size;
+    float max_width;
+    TextAlignment alignment;
+    std::uint32_t color;
+
+    bool operator==(const GlyphRunKey& other) const = default;
+  };
+  struct GlyphRunKeyHash {
+    std::size_t operator()(const GlyphRunKey& key) const;
+  };
+  struct GlyphRun {
+    FontAtlas* font_atlas = nullptr;
+    Color color;
+
+    TextLayout layout;
+    std::uint32_t last_used_frame = 0;
+    std::uint32_t prepared_frame = 0;
+    std::optional<std::uint32_t> atlas_generation;
+    std::vector<Shape2D::Vertex> vertices;
+    std::uint32_t mesh_generation = 0;
+    std::optional<std::uint16_t> mesh;
+  };
+  // The runs are not moved when other runs are added or removed, so culling entries can keep pointers to them
+  std::unordered_map<GlyphRunKey, GlyphRun, GlyphRunKeyHash> glyph_runs_;
+  std::vector<GlyphRun*> prepared_glyph_runs_;
+
+  // Entities are culled against the viewport with a spatial grid of their world space bounds. The bounds of an entity
+  // are only computed again if its transform, its shape or its text changed, so static entities outside of the viewport
+  // cost a comparison per frame. The glyph run of a text is only looked up again when the text differs from the one the
+  // run was created for.
+  static constexpr float SPATIAL_GRID_CELL_SIZE = 256.0f;
+  struct CullingEntry {
+    EntityId id = EntityId::CreateInactive(0);
+    Matrix3x4 local_to_world;
+    std::uint64_t shape_version = 0;
+    float depth = 0.0f;
+    std::uint32_t last_seen_frame = 0;
+    // Kept alive by marking it as used every frame the entity is seen
+    GlyphRun* glyph_run = nullptr;
+    // The text the glyph run was created for
+    Text text;
+  };
+  SpatialGrid2D spatial_grid_{SPATIAL_GRID_CELL_SIZE};
+  std::vector<CullingEntry> culling_entries_;
+  std::vector<std::uint32_t> visible_entity_indices_;
+  std::uint32_t frame_index_ = 0;
+
+  // The draw commands of the visible entities are generated in parallel in chunks of this many entities
+  static constexpr std::size_t ENTITIES_PER_CHUNK = 1024;
+  struct VisibleEntity {
+    std::uint32_t index;
+    // The texture and mesh of the shape and the glyph run of the text are prepared beforehand on the render thread
+    TextureAtlasRegion texture_region;
+    std::optional<std::uint16_t> mesh;
+    const GlyphRun* glyph_run = nullptr;
+  };
+  std::vector<VisibleEntity> visible_entities_;
+  std::vector<RenderQueue2D> chunk_queues_;
+
+  void UpdateSpatialGrid(Scene* scene);
+  void GenerateDrawCommands(const SceneUpdate& update, const SceneViewport& viewport,
+                            std::span<const VisibleEntity> entities, RenderQueue2D* render_queue);
+
+  const TextureAtlasRegion& GetTextureRegion(TextureAssetId texture_asset_id);
+  void RequestTexture(TextureAssetId texture_asset_id);
+  void AddTexture(TextureAssetId texture_asset_id, const std::string& asset_id, const Texture2DData& data);
+  void ReleaseUnusedTextures();
+  std::optional<std::uint16_t> GetShapeMesh(std::uint32_t entity_index, const Shape2D& shape);
+  std::optional<std::uint16_t> UploadMesh(std::span<const Shape2D::Vertex> vertices);
+  void ResetMeshes();
+  FontAtlas* GetFontAtlas(const std::string& font);
+  void RequestFontAtlas(const std::string& font);
+  void AddAssetLoad(AssetLoadHandle asset_load);
+  void CancelAssetLoads();
+  GlyphRun* GetGlyphRun(const Text& text);
+  void UpdateGlyphRun(GlyphRun* glyph_run);
 
-  void DrawShapeVertices();
+  void DrawRenderQueue();
+  void DrawInstances(const RenderQueue2D::Batch& batch);
 };
 
 }  // namespace ovis
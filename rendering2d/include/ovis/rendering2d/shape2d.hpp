@@ -1,15 +1,29 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "ovis/core/color.hpp"
 #include "ovis/core/entity.hpp"
+#include "ovis/core/intersection.hpp"
 #include "ovis/core/vector.hpp"
 #include "ovis/core/vm_bindings.hpp"
 #include "ovis/graphics/texture2d.hpp"
 
 namespace ovis {
 
+// Texture assets are interned so they can be identified by an index instead of their name. The id 0 refers to no
+// texture.
+using TextureAssetId = std::uint32_t;
+TextureAssetId InternTextureAsset(std::string_view texture_asset);
+std::string GetTextureAssetName(TextureAssetId texture_asset_id);
+
+struct Shape2DGeometry;
+
 class Shape2D {
  public:
   enum class Type {
@@ -31,6 +45,7 @@ class Shape2D {
     uint32_t color;
   };
   static_assert(sizeof(Vertex) == 20);
+  using Geometry = Shape2DGeometry;
 
   Color color() const { return color_; }
   Color outline_color() const { return outline_color_; }
@@ -38,16 +53,25 @@ class Shape2D {
   Type type() const { return type_; }
   Rectangle rectangle() const { assert(type_ == Type::RECTANGLE); return rectangle_; }
   Ellipse ellipse() const { assert(type_ == Type::ELLIPSE); return ellipse_; }
-  std::string texture_asset() const { return texture_asset_; }
+  const std::string& texture_asset() const { return texture_asset_; }
+  TextureAssetId texture_asset_id() const { return texture_asset_id_; }
+
+  // The tessellated shape. Shapes with the same parameters share their geometry, see Shape2DGeometry.
+  const Geometry* geometry() const { return geometry_.get(); }
+  std::span<const Vertex> vertices() const;
+  // The bounding box of the geometry in local space
+  AxisAlignedBoundingBox2D bounds() const;
 
-  std::span<const Vertex> vertices() const { return vertices_; }
+  // Changes whenever a property of the shape changes. Versions are unique across all shapes, so two shapes with the
+  // same version are guaranteed to be identical.
+  std::uint64_t version() const { return version_; }
 
   void SetColor(const Color& color);
   void SetOutlineColor(const Color& color);
   void SetOutlineWidth(float width);
   void SetRectangle(const Rectangle& rectangle);
   void SetEllipse(const Ellipse& ellipse);
-  void SetTexture(const std::string& texture_asset) { texture_asset_ = texture_asset; }
+  void SetTexture(const std::string& texture_asset);
 
   OVIS_VM_DECLARE_TYPE_BINDING();
 
@@ -55,18 +79,27 @@ class Shape2D {
   Color color_ = Color::White();
   Type type_ = Type::RECTANGLE;
   union {
-    Rectangle rectangle_;
+    Rectangle rectangle_{};
     Ellipse ellipse_;
   };
   float outline_width_ = 1.0f;
   Color outline_color_ = Color::Black();
   std::string texture_asset_;
+  TextureAssetId texture_asset_id_ = 0;
 
-  std::vector<Vertex> vertices_;
+  std::shared_ptr<const Geometry> geometry_;
+  std::uint64_t version_ = 0;
 
   void Update();
-  void UpdateRectangle();
-  void UpdateEllipse();
+  void UpdateVersion();
+};
+
+// Tessellated shapes are kept in a global cache for as long as a shape uses them. The id is never reused, so it can be
+// used to identify the geometry, e.g., when uploading it to the GPU.
+struct Shape2DGeometry {
+  std::uint64_t id;
+  std::vector<Shape2D::Vertex> vertices;
+  AxisAlignedBoundingBox2D bounds;
 };
 
 void to_json(json& data, const Shape2D& shape2d);
@@ -2,6 +2,7 @@
 
 #include "ovis/core/color.hpp"
 #include "ovis/core/vm_bindings.hpp"
+#include "ovis/rendering2d/text_layout.hpp"
 
 namespace ovis {
 
@@ -9,6 +10,11 @@ struct Text {
   Color color = Color::White();
   std::string text = "";
   std::string font = "";
+  // The height of the font in world units
+  float size = 32.0f;
+  // Lines are broken at spaces to stay within this width, zero disables breaking lines
+  float max_width = 0.0f;
+  TextAlignment alignment = TextAlignment::LEFT;
 
   OVIS_VM_DECLARE_TYPE_BINDING();
 };
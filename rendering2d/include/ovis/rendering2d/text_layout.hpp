@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "ovis/core/color.hpp"
+#include "ovis/core/intersection.hpp"
+#include "ovis/core/vector.hpp"
+#include "ovis/rendering2d/shape2d.hpp"
+
+namespace ovis {
+
+class FontAtlas;
+
+enum class TextAlignment : std::uint8_t {
+  LEFT,
+  CENTER,
+  RIGHT,
+};
+
+struct TextLayoutOptions {
+  float size = 32.0f;
+  // Lines are broken at spaces so they do not get wider than this. Words that are wider on their own are not broken.
+  float max_width = std::numeric_limits<float>::infinity();
+  TextAlignment alignment = TextAlignment::LEFT;
+};
+
+// The positions of the glyphs of a text. The baseline of the first line is at y = 0 and the following lines are below
+// it. Left aligned lines start at x = 0, centered lines are centered around it and right aligned lines end there.
+struct TextLayout {
+  struct Glyph {
+    char32_t codepoint;
+    // The origin of the glyph on the baseline
+    Vector2 position;
+  };
+
+  float size = 0.0f;
+  // Only the glyphs with an outline, e.g., spaces are not included
+  std::vector<Glyph> glyphs;
+  std::size_t line_count = 0;
+  // The bounding box of the outlines of all glyphs
+  AxisAlignedBoundingBox2D bounds = AxisAlignedBoundingBox2D::Empty();
+};
+
+// Lays out the UTF-8 encoded text. Lines are separated by '\n' and additionally broken at spaces according to the
+// options. The advances of the glyphs are adjusted by the kerning of the font.
+void LayoutText(FontAtlas* font_atlas, std::string_view text, const TextLayoutOptions& options, TextLayout* layout);
+
+// Calls FontAtlas::PrepareGlyph() for every glyph of the layout
+void PrepareGlyphs(FontAtlas* font_atlas, const TextLayout& layout);
+
+// Appends two triangles for every glyph of the layout that is in the atlas
+void GenerateTextVertices(const FontAtlas& font_atlas, const TextLayout& layout, Color color,
+                          std::vector<Shape2D::Vertex>* vertices);
+
+}  // namespace ovis
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "ovis/graphics/texture2d.hpp"
+
+namespace ovis {
+
+struct RectangleSize {
+  std::uint32_t width;
+  std::uint32_t height;
+};
+
+struct PackedRectangle {
+  std::uint32_t page = 0;
+  std::uint32_t x;
+  std::uint32_t y;
+};
+
+// Packs rectangles into a page using the skyline bottom-left heuristic: the skyline is the upper contour of the
+// rectangles that were inserted so far and every rectangle is placed where its top edge ends up lowest. This packs
+// sprites nearly as tight as a maxrects packer, but only has to look at the skyline segments instead of all free
+// rectangles, which keeps insertion cheap enough for atlases that are filled at runtime.
+class SkylinePacker {
+ public:
+  SkylinePacker(std::uint32_t width, std::uint32_t height);
+
+  // Returns the position of the rectangle or std::nullopt if it does not fit into the page anymore
+  std::optional<PackedRectangle> Insert(std::uint32_t width, std::uint32_t height);
+  void Clear();
+
+  inline std::uint32_t width() const { return width_; }
+  inline std::uint32_t height() const { return height_; }
+  // The ratio of the area covered by rectangles to the area of the page
+  inline float occupancy() const { return static_cast<float>(used_area_) / (static_cast<float>(width_) * height_); }
+
+ private:
+  struct Segment {
+    std::uint32_t x;
+    std::uint32_t y;
+    std::uint32_t width;
+  };
+
+  std::uint32_t width_;
+  std::uint32_t height_;
+  std::uint64_t used_area_ = 0;
+  std::vector<Segment> skyline_;
+
+  // Returns the lowest y coordinate a rectangle can be placed at when its left edge starts at the segment
+  std::optional<std::uint32_t> Fit(std::size_t segment_index, std::uint32_t width, std::uint32_t height) const;
+  void AddRectangle(std::size_t segment_index, std::uint32_t x, std::uint32_t y, std::uint32_t width,
+                    std::uint32_t height);
+};
+
+// Packs all rectangles at once into as many pages as necessary. Inserting the rectangles sorted by decreasing height
+// packs considerably better than inserting them in arbitrary order, so this should be preferred when all rectangles
+// are known upfront, e.g., when building atlases offline. The result has the same order as the sizes. Rectangles that
+// are larger than a page are std::nullopt.
+std::vector<std::optional<PackedRectangle>> PackRectangles(std::span<const RectangleSize> sizes,
+                                                           std::uint32_t page_width, std::uint32_t page_height);
+
+struct TextureAtlasDescription {
+  std::uint32_t page_width = 2048;
+  std::uint32_t page_height = 2048;
+  // The edge pixels of every image are repeated this many times around it, so filtering does not bleed in neighbouring
+  // images.
+  std::uint32_t padding = 1;
+  TextureFilter filter = TextureFilter::BILINEAR;
+};
+
+struct TextureAtlasRegion {
+  Texture2D* texture;
+  // The texture coordinates of the image: s0, t0, s1, t1
+  std::array<float, 4> texture_rect;
+};
+
+// Collects many small RGBA_UINT8 images in a few large textures, so sprites using different images can still be drawn
+// in a single batch. Images are packed as they are added and are never removed.
+class TextureAtlas {
+ public:
+  TextureAtlas(GraphicsContext* context, const TextureAtlasDescription& description);
+
+  // Returns std::nullopt if the image does not fit into a page
+  std::optional<TextureAtlasRegion> Add(std::uint32_t width, std::uint32_t height, const void* rgba_pixels);
+
+  inline const TextureAtlasDescription& description() const { return description_; }
+  inline std::size_t page_count() const { return pages_.size(); }
+  inline Texture2D* page(std::size_t index) const { return pages_[index].texture.get(); }
+
+ private:
+  struct Page {
+    std::unique_ptr<Texture2D> texture;
+    SkylinePacker packer;
+  };
+
+  GraphicsContext* context_;
+  TextureAtlasDescription description_;
+  std::vector<Page> pages_;
+  std::vector<std::uint32_t> padded_pixels_;
+};
+
+}  // namespace ovis
@@ -1,68 +1,210 @@
 #include "ovis/rendering2d/font_atlas.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "ovis/utils/log.hpp"
+#include "ovis/core/asset_library.hpp"
+
 namespace ovis {
 
-FontAtlas::FontAtlas(GraphicsContext* context, std::string_view asset, float height) : asset_(asset), height_(height) {
+FontAtlas::FontAtlas(GraphicsContext* context, std::string_view asset, AssetView font_data)
+    : asset_(asset), font_data_(std::move(font_data)) {
   assert(context != nullptr);
 
+  const auto* data = reinterpret_cast<const unsigned char*>(font_data_.data().data());
+  [[maybe_unused]] const int result = stbtt_InitFont(&font_info_, data, stbtt_GetFontOffsetForIndex(data, 0));
+  assert(result != 0);
+  font_scale_ = stbtt_ScaleForPixelHeight(&font_info_, 1.0f);
+  int ascent, descent, line_gap;
+  stbtt_GetFontVMetrics(&font_info_, &ascent, &descent, &line_gap);
+  line_height_ = (ascent - descent + line_gap) * font_scale_;
 
-  Texture2DDescription texture_description {
-    .width = 512,
-    .height = 512,
-    .mip_map_count = 0,
-    .format = TextureFormat::RGBA_UINT8,
-    .filter = TextureFilter::TRILINEAR,
+  const Texture2DDescription texture_description = {
+      .width = TEXTURE_SIZE,
+      .height = TEXTURE_SIZE,
+      .mip_map_count = 1,
+      .format = TextureFormat::R_UINT8,
+      .filter = TextureFilter::BILINEAR,
   };
-  std::vector<unsigned char> pixels(texture_description.width * texture_description.height);
+  texture_ = std::make_unique<Texture2D>(context, texture_description);
 
-  const auto* asset_library = GetAssetLibraryForAsset(asset);
-  if (!asset_library) {
-    // TODO: throw some kind of error here
+  free_cells_.reserve(CELL_COUNT);
+  for (std::uint32_t i = CELL_COUNT; i > 0; --i) {
+    free_cells_.push_back(static_cast<std::uint16_t>(i - 1));
   }
-  assert(asset_library != nullptr);
-  const auto file = asset_library->LoadAssetBinaryFile(asset, "ttf");
-  if (!file.has_value()) {
-    // TODO: throw some kind of error here
+  cell_pixels_.resize(CELL_SIZE * CELL_SIZE);
+}
+
+void FontAtlas::BeginFrame() {
+  ++frame_;
+}
+
+const FontAtlas::GlyphMetrics& FontAtlas::GetGlyphMetrics(char32_t codepoint) {
+  return GetGlyph(codepoint).metrics;
+}
+
+float FontAtlas::GetKerning(char32_t previous_codepoint, char32_t codepoint) {
+  const int previous_index = GetGlyph(previous_codepoint).index;
+  return stbtt_GetGlyphKernAdvance(&font_info_, previous_index, GetGlyph(codepoint).index) * font_scale_;
+}
+
+void FontAtlas::PrepareGlyph(char32_t codepoint) {
+  Glyph& glyph = GetGlyph(codepoint);
+  glyph.last_used_frame = frame_;
+  if (!glyph.metrics.has_outline || glyph.cell.has_value()) {
+    return;
   }
-  assert(file.has_value());
-
-  int result =
-      stbtt_BakeFontBitmap(reinterpret_cast<const unsigned char*>(file->data()), 0, height, pixels.data(),
-                           texture_description.width, texture_description.height, 32, 96, baked_characters.data());
-  assert(result > 0);
-
-  // TODO: this texture format stores 1 byte worth of data in 4 bytes. Use a 1 byte/pixel texture.
-  std::vector<unsigned char> wasteful_pixels;
-  wasteful_pixels.reserve(texture_description.width * texture_description.height * 4);
-  int min = 255;
-  for (auto p : pixels) {
-    wasteful_pixels.push_back(255);
-    wasteful_pixels.push_back(255);
-    wasteful_pixels.push_back(255);
-    wasteful_pixels.push_back(p);
-    if (p < min) {
-      min = p;
+
+  const std::optional<std::uint16_t> cell = AllocateCell();
+  if (!cell.has_value()) {
+    if (!logged_full_atlas_) {
+      LogW("Font atlas '{}' is full, a frame uses more than {} different glyphs", asset_, CELL_COUNT);
+      logged_full_atlas_ = true;
     }
+    return;
   }
-  texture_ = std::make_unique<Texture2D>(context, texture_description, wasteful_pixels.data());
+  RenderGlyph(codepoint, &glyph, *cell);
 }
 
-std::array<Shape2D::Vertex, 6> FontAtlas::GetCharacterVertices(char character, Vector2* current_position, Color color) {
+const FontAtlas::GlyphQuad* FontAtlas::FindGlyphQuad(char32_t codepoint) const {
+  const auto glyph = glyphs_.find(codepoint);
+  return glyph != glyphs_.end() && glyph->second.cell.has_value() ? &glyph->second.quad : nullptr;
+}
 
-  stbtt_aligned_quad quad;
-  stbtt_GetBakedQuad(baked_characters.data(), texture_->description().width, texture_->description().width,
-                     character - 32, &current_position->x, &current_position->y, &quad, 1);
+FontAtlas::Glyph& FontAtlas::GetGlyph(char32_t codepoint) {
+  const auto glyph_iterator = glyphs_.find(codepoint);
+  if (glyph_iterator != glyphs_.end()) {
+    return glyph_iterator->second;
+  }
+
+  Glyph glyph{};
+  glyph.index = stbtt_FindGlyphIndex(&font_info_, static_cast<int>(codepoint));
+
+  int advance;
+  int left_side_bearing;
+  stbtt_GetGlyphHMetrics(&font_info_, glyph.index, &advance, &left_side_bearing);
+  glyph.metrics.advance = advance * font_scale_;
+
+  int x0, y0, x1, y1;
+  glyph.metrics.has_outline =
+      stbtt_GetGlyphBox(&font_info_, glyph.index, &x0, &y0, &x1, &y1) != 0 && x0 < x1 && y0 < y1;
+  glyph.metrics.outline_min = Vector2{static_cast<float>(x0), static_cast<float>(y0)} * font_scale_;
+  glyph.metrics.outline_max = Vector2{static_cast<float>(x1), static_cast<float>(y1)} * font_scale_;
+
+  return glyphs_.emplace(codepoint, glyph).first->second;
+}
 
-  uint32_t color_rgba = ConvertToRGBA8(color);
+std::optional<std::uint16_t> FontAtlas::AllocateCell() {
+  if (!free_cells_.empty()) {
+    const std::uint16_t cell = free_cells_.back();
+    free_cells_.pop_back();
+    return cell;
+  }
+
+  // Replace the least recently used glyph that is not used in the current frame
+  std::optional<std::uint16_t> cell;
+  std::uint32_t oldest_frame = frame_;
+  for (std::uint32_t i = 0; i < CELL_COUNT; ++i) {
+    const Glyph& glyph = glyphs_.at(cell_codepoints_[i]);
+    if (glyph.last_used_frame < oldest_frame) {
+      cell = static_cast<std::uint16_t>(i);
+      oldest_frame = glyph.last_used_frame;
+    }
+  }
+  if (cell.has_value()) {
+    glyphs_.at(cell_codepoints_[*cell]).cell.reset();
+    ++generation_;
+  }
+  return cell;
+}
+
+void FontAtlas::RenderGlyph(char32_t codepoint, Glyph* glyph, std::uint16_t cell) {
+  // Glyphs that are larger than usual, e.g., with stacked diacritics, are rendered at a smaller scale to fit into the
+  // cell
+  float scale = stbtt_ScaleForPixelHeight(&font_info_, SDF_FONT_SIZE);
+  int width = 0;
+  int height = 0;
+  int x_offset = 0;
+  int y_offset = 0;
+  unsigned char* pixels = nullptr;
+  while (true) {
+    // The distance field is 0.5 on the outline and falls to 0 at the padding
+    pixels = stbtt_GetGlyphSDF(&font_info_, scale, glyph->index, SDF_PADDING, 128, 128.0f / SDF_PADDING, &width,
+                               &height, &x_offset, &y_offset);
+    if (pixels == nullptr || (width <= static_cast<int>(CELL_SIZE) && height <= static_cast<int>(CELL_SIZE))) {
+      break;
+    }
+    stbtt_FreeSDF(pixels, nullptr);
+    scale *= 0.9f * CELL_SIZE / std::max(width, height);
+  }
+  if (pixels == nullptr) {
+    // The outline is too small to cover a pixel
+    glyph->metrics.has_outline = false;
+    free_cells_.push_back(cell);
+    return;
+  }
+
+  // Clear the whole cell, so the filtering at the border of the glyph does not pick up the previous one
+  std::fill(cell_pixels_.begin(), cell_pixels_.end(), 0);
+  for (int y = 0; y < height; ++y) {
+    std::memcpy(cell_pixels_.data() + y * CELL_SIZE, pixels + y * width, width);
+  }
+  stbtt_FreeSDF(pixels, nullptr);
+
+  const std::uint32_t cells_per_row = TEXTURE_SIZE / CELL_SIZE;
+  const std::uint32_t cell_x = cell % cells_per_row * CELL_SIZE;
+  const std::uint32_t cell_y = cell / cells_per_row * CELL_SIZE;
+  texture_->Write(0, cell_x, cell_y, CELL_SIZE, CELL_SIZE, cell_pixels_.data());
+
+  // The distance field is rendered with the y axis pointing down
+  const float pixel_size = font_scale_ / scale;
+  glyph->quad.min = Vector2{static_cast<float>(x_offset), static_cast<float>(-(y_offset + height))} * pixel_size;
+  glyph->quad.max = Vector2{static_cast<float>(x_offset + width), static_cast<float>(-y_offset)} * pixel_size;
+  glyph->quad.texture_rect = {
+      static_cast<float>(cell_x) / TEXTURE_SIZE,
+      static_cast<float>(cell_y) / TEXTURE_SIZE,
+      static_cast<float>(cell_x + width) / TEXTURE_SIZE,
+      static_cast<float>(cell_y + height) / TEXTURE_SIZE,
+  };
+  glyph->cell = cell;
+  cell_codepoints_[cell] = codepoint;
+}
+
+AssetMemoryUsage GetAssetMemoryUsage(const FontAtlas& font_atlas) {
+  return {
+      .cpu_bytes = font_atlas.font_data().size(),
+      .gpu_bytes = GetAssetMemoryUsage(*font_atlas.texture()).gpu_bytes,
+  };
+}
+
+std::unique_ptr<FontAtlas> CreateFontAtlas(GraphicsContext* context, std::string_view asset, AssetView font_data) {
+  const auto* data = reinterpret_cast<const unsigned char*>(font_data.data().data());
+  stbtt_fontinfo font_info;
+  const int offset = stbtt_GetFontOffsetForIndex(data, 0);
+  if (offset < 0 || stbtt_InitFont(&font_info, data, offset) == 0) {
+    LogE("Failed to load font '{}': invalid TrueType file", asset);
+    return nullptr;
+  }
+
+  return std::make_unique<FontAtlas>(context, asset, std::move(font_data));
+}
+
+std::unique_ptr<FontAtlas> LoadFontAtlas(GraphicsContext* context, std::string_view asset) {
+  const AssetLibrary* asset_library = GetAssetLibraryForAsset(asset);
+  if (asset_library == nullptr) {
+    LogE("Failed to load font '{}': asset library not found", asset);
+    return nullptr;
+  }
+
+  Result<AssetView> font_data = asset_library->LoadAssetFile(asset, "ttf");
+  if (!font_data.has_value()) {
+    LogE("Failed to load font '{}': {}", asset, font_data.error().message);
+    return nullptr;
+  }
 
-  return {{
-    { .x = quad.x0, .y = -quad.y0, .s = quad.s0, .t = quad.t0, .color = color_rgba },
-    { .x = quad.x1, .y = -quad.y0, .s = quad.s1, .t = quad.t0, .color = color_rgba },
-    { .x = quad.x1, .y = -quad.y1, .s = quad.s1, .t = quad.t1, .color = color_rgba },
-    { .x = quad.x0, .y = -quad.y0, .s = quad.s0, .t = quad.t0, .color = color_rgba },
-    { .x = quad.x1, .y = -quad.y1, .s = quad.s1, .t = quad.t1, .color = color_rgba },
-    { .x = quad.x0, .y = -quad.y1, .s = quad.s0, .t = quad.t1, .color = color_rgba },
-  }};
+  return CreateFontAtlas(context, asset, std::move(*font_data));
 }
 
 }  // namespace ovis
@@ -0,0 +1,163 @@
+#include "ovis/rendering2d/render_queue2d.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace ovis {
+
+BlendState GetBlendState(BlendMode2D blend_mode) {
+  BlendState blend_state;
+  blend_state.enabled = true;
+  blend_state.source_color_factor = SourceBlendFactor::SOURCE_ALPHA;
+  switch (blend_mode) {
+    case BlendMode2D::ALPHA:
+      blend_state.destination_color_factor = DestinationBlendFactor::ONE_MINUS_SOURCE_ALPHA;
+      break;
+
+    case BlendMode2D::ADDITIVE:
+      blend_state.destination_color_factor = DestinationBlendFactor::ONE;
+      break;
+  }
+  return blend_state;
+}
+
+std::uint64_t RenderQueue2D::CreateSortKey(std::uint8_t layer, float depth) {
+  // Map the float to an unsigned integer with the same ordering: negative values have all bits flipped, positive ones
+  // only the sign bit. Finally, flip all bits so larger depths come first.
+  std::uint32_t depth_bits = std::bit_cast<std::uint32_t>(depth);
+  depth_bits = (depth_bits & 0x80000000) ? ~depth_bits : (depth_bits | 0x80000000);
+  depth_bits = ~depth_bits;
+
+  return (static_cast<std::uint64_t>(layer) << 56) | (static_cast<std::uint64_t>(depth_bits) << SORT_KEY_SHIFT);
+}
+
+void RenderQueue2D::Clear() {
+  commands_.clear();
+  vertices_.clear();
+  sorted_vertices_.clear();
+  instances_.clear();
+  sorted_instances_.clear();
+  batches_.clear();
+}
+
+std::span<RenderQueue2D::Vertex> RenderQueue2D::Submit(std::uint8_t layer, float depth, Texture2D* texture,
+                                                       BlendMode2D blend_mode, std::size_t vertex_count,
+                                                       bool is_text) {
+  assert(vertex_count % 3 == 0);
+  const auto first_vertex = vertices_.size();
+  commands_.push_back({
+      .sort_key = CreateSortKey(layer, depth),
+      .texture = texture,
+      .blend_mode = blend_mode,
+      .first_element = static_cast<std::uint32_t>(first_vertex),
+      .vertex_count = static_cast<std::uint32_t>(vertex_count),
+      .mesh = 0,
+      .instanced = false,
+      .is_text = is_text,
+  });
+  vertices_.resize(first_vertex + vertex_count);
+  return {vertices_.data() + first_vertex, vertex_count};
+}
+
+RenderQueue2D::Instance& RenderQueue2D::SubmitInstance(std::uint8_t layer, float depth, Texture2D* texture,
+                                                       BlendMode2D blend_mode, std::uint16_t mesh, bool is_text) {
+  commands_.push_back({
+      .sort_key = CreateSortKey(layer, depth),
+      .texture = texture,
+      .blend_mode = blend_mode,
+      .first_element = static_cast<std::uint32_t>(instances_.size()),
+      .vertex_count = 0,
+      .mesh = mesh,
+      .instanced = true,
+      .is_text = is_text,
+  });
+  return instances_.emplace_back();
+}
+
+void RenderQueue2D::Append(const RenderQueue2D& other) {
+  const auto vertex_offset = static_cast<std::uint32_t>(vertices_.size());
+  const auto instance_offset = static_cast<std::uint32_t>(instances_.size());
+  commands_.reserve(commands_.size() + other.commands_.size());
+  for (Command command : other.commands_) {
+    command.first_element += command.instanced ? instance_offset : vertex_offset;
+    commands_.push_back(command);
+  }
+  vertices_.insert(vertices_.end(), other.vertices_.begin(), other.vertices_.end());
+  instances_.insert(instances_.end(), other.instances_.begin(), other.instances_.end());
+}
+
+void RenderQueue2D::Sort() {
+  RadixSortCommands();
+
+  batches_.clear();
+  sorted_vertices_.resize(vertices_.size());
+  sorted_instances_.resize(instances_.size());
+  std::uint32_t vertex_count = 0;
+  std::uint32_t instance_count = 0;
+  for (const auto& command : commands_) {
+    const bool instanced = command.instanced;
+    const std::uint32_t command_instance_count = instanced ? 1 : 0;
+    if (instanced) {
+      sorted_instances_[instance_count] = instances_[command.first_element];
+    } else {
+      std::copy_n(vertices_.begin() + command.first_element, command.vertex_count,
+                  sorted_vertices_.begin() + vertex_count);
+    }
+
+    const BlendMode2D blend_mode = command.blend_mode;
+    if (batches_.size() > 0 && batches_.back().texture == command.texture &&
+        batches_.back().blend_mode == blend_mode && batches_.back().instanced == instanced &&
+        batches_.back().mesh == command.mesh && batches_.back().is_text == command.is_text) {
+      batches_.back().vertex_count += command.vertex_count;
+      batches_.back().instance_count += command_instance_count;
+    } else {
+      batches_.push_back({
+          .texture = command.texture,
+          .blend_mode = blend_mode,
+          .instanced = instanced,
+          .is_text = command.is_text,
+          .mesh = command.mesh,
+          .first_vertex = vertex_count,
+          .vertex_count = command.vertex_count,
+          .first_instance = instance_count,
+          .instance_count = command_instance_count,
+      });
+    }
+    vertex_count += command.vertex_count;
+    instance_count += command_instance_count;
+  }
+}
+
+void RenderQueue2D::RadixSortCommands() {
+  // Least significant digit radix sort with 8 bit digits
+  sort_buffer_.resize(commands_.size());
+  for (int shift = SORT_KEY_SHIFT; shift < 64; shift += 8) {
+    SortCommandsByDigit([shift](const Command& command) { return (command.sort_key >> shift) & 0xff; });
+  }
+}
+
+template <typename DigitFunction>
+void RenderQueue2D::SortCommandsByDigit(DigitFunction digit) {
+  std::array<std::size_t, 256> offsets{};
+  for (const auto& command : commands_) {
+    ++offsets[digit(command)];
+  }
+  // Digits that are the same for all commands (e.g., the layer in most scenes) are skipped
+  if (std::find(offsets.begin(), offsets.end(), commands_.size()) != offsets.end()) {
+    return;
+  }
+
+  std::size_t offset = 0;
+  for (auto& count : offsets) {
+    const std::size_t bucket_size = count;
+    count = offset;
+    offset += bucket_size;
+  }
+  for (const auto& command : commands_) {
+    sort_buffer_[offsets[digit(command)]++] = command;
+  }
+  commands_.swap(sort_buffer_);
+}
+
+}  // namespace ovis
@@ -1,3 +1,11 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "ovis/utils/thread_pool.hpp"
+#include "ovis/core/asset_cache.hpp"
 #include "ovis/core/asset_library.hpp"
 #include "ovis/core/transform.hpp"
 #include "ovis/graphics/graphics_context.hpp"
@@ -9,163 +17,727 @@
 
 namespace ovis {
 
+namespace {
+
+// Separate textures are cached by the file that holds their pixels
+constexpr const char* TEXTURE_FILE_TYPE = "0";
+
+AxisAlignedBoundingBox2D TransformBounds(const Matrix3x4& transform, const AxisAlignedBoundingBox2D& bounds) {
+  const Vector3 center = TransformPosition(transform, Vector3::FromVector2(bounds.center, 0.0f));
+  const Vector2 half_extend = {
+      std::abs(transform[0][0]) * bounds.half_extend.x + std::abs(transform[0][1]) * bounds.half_extend.y,
+      std::abs(transform[1][0]) * bounds.half_extend.x + std::abs(transform[1][1]) * bounds.half_extend.y,
+  };
+  return {Vector2{center.x, center.y}, half_extend};
+}
+
+// The region of the xy plane that is visible in the viewport, assuming an orthographic projection
+AxisAlignedBoundingBox2D ComputeViewBounds(const SceneViewport& viewport) {
+  Vector2 min = Vector2{std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()};
+  Vector2 max = -min;
+  for (const float x : {-1.0f, 1.0f}) {
+    for (const float y : {-1.0f, 1.0f}) {
+      for (const float z : {-1.0f, 1.0f}) {
+        const Vector3 corner = TransformPosition(viewport.clip_to_world, Vector3{x, y, z});
+        min = ovis::min(min, Vector2{corner.x, corner.y});
+        max = ovis::max(max, Vector2{corner.x, corner.y});
+      }
+    }
+  }
+  return AxisAlignedBoundingBox2D::FromMinMax(min, max);
+}
+
+RenderQueue2D::Instance CreateInstance(const Matrix4& to_clip_space, Vector2 size,
+                                       const std::array<float, 4>& texture_rect, std::uint32_t color) {
+  return {
+      .transform = {{to_clip_space[0][0], to_clip_space[0][1], to_clip_space[0][3]},
+                    {to_clip_space[1][0], to_clip_space[1][1], to_clip_space[1][3]}},
+      .size = {size.x, size.y},
+      .texture_rect = {texture_rect[0], texture_rect[1], texture_rect[2], texture_rect[3]},
+      .color = color,
+  };
+}
+
+// Texts that are the same in all properties result in the same glyph run
+bool HasSameGlyphRun(const Text& lhs, const Text& rhs) {
+  return lhs.text == rhs.text && lhs.font == rhs.font && lhs.size == rhs.size && lhs.max_width == rhs.max_width &&
+         lhs.alignment == rhs.alignment && ConvertToRGBA8(lhs.color) == ConvertToRGBA8(rhs.color);
+}
+
+}  // namespace
+
 Renderer2D::Renderer2D(GraphicsContext* graphics_context) : RenderPass("Renderer2D", graphics_context) {
   ExecuteAfter("ClearPass");
   RequireReadAccess<Shape2D>();
   RequireReadAccess<Text>();
+  RequireReadAccess<GlobalTransformMatrices>();
 }
 
-void Renderer2D::CreateResources() {
-  Texture2DDescription empty_texture_desc {
-    .width = 1,
-    .height = 1,
-    .mip_map_count = 1,
-    .format = TextureFormat::RGBA_UINT8,
-    .filter = TextureFilter::POINT
-  };
+Renderer2D::~Renderer2D() {
+  CancelAssetLoads();
+}
 
+void Renderer2D::CreateResources() {
   shape_shader_ = LoadShaderProgram("shape2d", context());
 
-  VertexBufferDescription buffer_desc;
+  StreamingVertexBufferDescription buffer_desc;
   buffer_desc.vertex_size_in_bytes = sizeof(Shape2D::Vertex);
-  buffer_desc.size_in_bytes = sizeof(Shape2D::Vertex) * VERTEX_BUFFER_ELEMENT_COUNT;
-  vertex_buffer_ = std::make_unique<ovis::VertexBuffer>(context(), buffer_desc);
+  buffer_desc.segment_vertex_count = VERTEX_BUFFER_ELEMENT_COUNT;
+  vertex_buffer_ = std::make_unique<StreamingVertexBuffer>(context(), buffer_desc);
 
-  VertexInputDescription vertex_input_desc;
-  vertex_input_desc.vertex_buffers = {vertex_buffer_.get()};
-  vertex_input_desc.vertex_attributes = {
-      {*shape_shader_->GetAttributeLocation("Position"), 0, 0, VertexAttributeType::FLOAT32_VECTOR2},
-      {*shape_shader_->GetAttributeLocation("TextureCoordinates"), 8, 0, VertexAttributeType::FLOAT32_VECTOR2},
-      {*shape_shader_->GetAttributeLocation("Color"), 16, 0, VertexAttributeType::UINT8_NORM_VECTOR4}};
-  vertex_input_ = std::make_unique<VertexInput>(context(), vertex_input_desc);
+  const auto create_vertex_input = [this](ShaderProgram* shader_program) {
+    VertexInputDescription vertex_input_desc;
+    vertex_input_desc.vertex_buffers = {vertex_buffer_->vertex_buffer()};
+    vertex_input_desc.vertex_attributes = {
+        {*shader_program->GetAttributeLocation("Position"), 0, 0, VertexAttributeType::FLOAT32_VECTOR2},
+        {*shader_program->GetAttributeLocation("TextureCoordinates"), 8, 0, VertexAttributeType::FLOAT32_VECTOR2},
+        {*shader_program->GetAttributeLocation("Color"), 16, 0, VertexAttributeType::UINT8_NORM_VECTOR4}};
+    return std::make_unique<VertexInput>(context(), vertex_input_desc);
+  };
+  vertex_input_ = create_vertex_input(shape_shader_.get());
+  text_shader_ = LoadShaderProgram("text2d", context());
+  text_vertex_input_ = create_vertex_input(text_shader_.get());
 
-  const uint32_t white_pixel = 0xffffffff;
-  empty_texture_ = std::make_unique<Texture2D>(context(), empty_texture_desc, &white_pixel);
+#if !OVIS_EMSCRIPTEN
+  instanced_shape_shader_ = LoadShaderProgram("shape2d_instanced", context());
+  instanced_text_shader_ = LoadShaderProgram("text2d_instanced", context());
+
+  VertexBufferDescription geometry_buffer_desc;
+  geometry_buffer_desc.vertex_size_in_bytes = sizeof(Shape2D::Vertex);
+  geometry_buffer_desc.size_in_bytes = sizeof(Shape2D::Vertex) * GEOMETRY_BUFFER_ELEMENT_COUNT;
+  geometry_buffer_desc.usage = BufferUsage::DYNAMIC;
+  geometry_buffer_ = std::make_unique<VertexBuffer>(context(), geometry_buffer_desc);
+  ResetMeshes();
+
+  StreamingVertexBufferDescription instance_buffer_desc;
+  instance_buffer_desc.vertex_size_in_bytes = sizeof(RenderQueue2D::Instance);
+  instance_buffer_desc.segment_vertex_count = INSTANCE_BUFFER_ELEMENT_COUNT;
+  instance_buffer_ = std::make_unique<StreamingVertexBuffer>(context(), instance_buffer_desc);
 
-  font_atlases_.push_back(FontAtlas(context(), "NotoSans-Regular", 32.0f));
+  const auto create_instanced_vertex_input = [this](ShaderProgram* shader_program) {
+    VertexInputDescription vertex_input_desc;
+    vertex_input_desc.vertex_buffers = {geometry_buffer_.get(), instance_buffer_->vertex_buffer()};
+    vertex_input_desc.vertex_attributes = {
+        {*shader_program->GetAttributeLocation("Position"), 0, 0, VertexAttributeType::FLOAT32_VECTOR2},
+        {*shader_program->GetAttributeLocation("TextureCoordinates"), 8, 0, VertexAttributeType::FLOAT32_VECTOR2},
+        {*shader_program->GetAttributeLocation("Color"), 16, 0, VertexAttributeType::UINT8_NORM_VECTOR4},
+        {*shader_program->GetAttributeLocation("TransformRow0"), 0, 1, VertexAttributeType::FLOAT32_VECTOR3, 1},
+        {*shader_program->GetAttributeLocation("TransformRow1"), 12, 1, VertexAttributeType::FLOAT32_VECTOR3, 1},
+        {*shader_program->GetAttributeLocation("Size"), 24, 1, VertexAttributeType::FLOAT32_VECTOR2, 1},
+        {*shader_program->GetAttributeLocation("TextureRect"), 32, 1, VertexAttributeType::FLOAT32_VECTOR4, 1},
+        {*shader_program->GetAttributeLocation("InstanceColor"), 48, 1, VertexAttributeType::UINT8_NORM_VECTOR4, 1}};
+    return std::make_unique<VertexInput>(context(), vertex_input_desc);
+  };
+  instanced_vertex_input_ = create_instanced_vertex_input(instanced_shape_shader_.get());
+  instanced_text_vertex_input_ = create_instanced_vertex_input(instanced_text_shader_.get());
+#endif
+
+  for (const TextureFilter filter : {TextureFilter::POINT, TextureFilter::BILINEAR}) {
+    const TextureAtlasDescription atlas_desc = {
+        .page_width = ATLAS_PAGE_SIZE,
+        .page_height = ATLAS_PAGE_SIZE,
+        .filter = filter,
+    };
+    texture_atlases_[static_cast<std::size_t>(filter)] = std::make_unique<TextureAtlas>(context(), atlas_desc);
+  }
+  const uint32_t white_pixel = 0xffffffff;
+  white_region_ = *texture_atlases_[static_cast<std::size_t>(TextureFilter::BILINEAR)]->Add(1, 1, &white_pixel);
 }
 
 void Renderer2D::ReleaseResources() {
+  CancelAssetLoads();
   vertex_buffer_.reset();
   vertex_input_.reset();
   shape_shader_.reset();
-  empty_texture_.reset();
+  instanced_vertex_input_.reset();
+  instance_buffer_.reset();
+  geometry_buffer_.reset();
+  instanced_shape_shader_.reset();
+  meshes_.clear();
+  geometry_meshes_.clear();
+  ++mesh_generation_;
+  textures_.clear();
+  for (auto& texture_atlas : texture_atlases_) {
+    texture_atlas.reset();
+  }
+  text_vertex_input_.reset();
+  text_shader_.reset();
+  instanced_text_vertex_input_.reset();
+  instanced_text_shader_.reset();
+  for (CullingEntry& culling_entry : culling_entries_) {
+    culling_entry.glyph_run = nullptr;
+  }
+  glyph_runs_.clear();
+  font_atlases_.clear();
 }
 
 void Renderer2D::Render(const SceneUpdate& update, const SceneViewport& viewport) {
-  // // auto& objects_with_shape2d = object_cache_;
-  // std::sort(object_cache_.begin(), object_cache_.end(), [](SceneObject* lhs, SceneObject* rhs) {
-  //   Vector3 lhs_position;
-  //   Transform* lhs_transform = lhs->GetComponent<Transform>();
-  //   if (lhs_transform != nullptr) {
-  //     lhs_position = lhs_transform->world_position();
-  //   }
-
-  //   Vector3 rhs_position;
-  //   Transform* rhs_transform = rhs->GetComponent<Transform>();
-  //   if (rhs_transform != nullptr) {
-  //     rhs_position = rhs_transform->world_position();
-  //   }
-
-  //   // TODO: project into camera view axis instead of using the z coordinates
-  //   return lhs_position.z > rhs_position.z;
-  // });
-  //
-  // auto trnsform_storage = 
+  // Unused geometries are only removed from the buffer by resetting all meshes, so do this before it runs full
+  if (geometry_buffer_ != nullptr && (geometry_buffer_vertex_count_ > GEOMETRY_BUFFER_ELEMENT_COUNT * 3 / 4 ||
+                                      meshes_.size() > std::numeric_limits<std::uint16_t>::max() / 2)) {
+    ResetMeshes();
+  }
+
+  std::erase_if(glyph_runs_, [this](const auto& glyph_run) {
+    return frame_index_ - glyph_run.second.last_used_frame >= GLYPH_RUN_LIFETIME;
+  });
+  ReleaseUnusedTextures();
+  UpdateSpatialGrid(update.scene);
+  visible_entity_indices_.clear();
+  spatial_grid_.Query(ComputeViewBounds(viewport), &visible_entity_indices_);
+  // Draws with the same depth are drawn in the order they are submitted, so submit in entity order to avoid flickering
+  std::sort(visible_entity_indices_.begin(), visible_entity_indices_.end());
+
+  // Requesting textures, uploading meshes and rendering glyphs requires the graphics context, so it is done here before
+  // the vertices are generated on multiple threads
+  for (const auto& [font, font_atlas] : font_atlases_) {
+    if (font_atlas != nullptr) {
+      font_atlas->BeginFrame();
+    }
+  }
+  auto shape_storage = update.scene->GetComponentStorage<Shape2D>();
+  visible_entities_.clear();
+  for (const std::uint32_t entity_index : visible_entity_indices_) {
+    VisibleEntity& visible_entity = visible_entities_.emplace_back();
+    visible_entity.index = entity_index;
+
+    const EntityId entity_id = culling_entries_[entity_index].id;
+    if (shape_storage.EntityHasComponent(entity_id)) {
+      const Shape2D& shape = shape_storage[entity_id];
+      visible_entity.texture_region = GetTextureRegion(shape.texture_asset_id());
+      if (instanced_vertex_input_ != nullptr) {
+        visible_entity.mesh = shape.type() == Shape2D::Type::RECTANGLE && shape.outline_width() == 0.0f
+                                  ? QUAD_MESH
+                                  : GetShapeMesh(entity_index, shape);
+      }
+    }
+    if (GlyphRun* glyph_run = culling_entries_[entity_index].glyph_run; glyph_run != nullptr) {
+      visible_entity.glyph_run = glyph_run;
+      if (glyph_run->prepared_frame != frame_index_) {
+        PrepareGlyphs(glyph_run->font_atlas, glyph_run->layout);
+        glyph_run->prepared_frame = frame_index_;
+        prepared_glyph_runs_.push_back(glyph_run);
+      }
+    }
+  }
+  // Only update the glyph runs after all glyphs are prepared, as preparing a glyph may replace one of another run
+  for (GlyphRun* glyph_run : prepared_glyph_runs_) {
+    UpdateGlyphRun(glyph_run);
+  }
+  prepared_glyph_runs_.clear();
+
+  // The chunks are generated into separate queues and appended in order, so the result does not depend on the number
+  // of threads
+  const std::size_t chunk_count = (visible_entities_.size() + ENTITIES_PER_CHUNK - 1) / ENTITIES_PER_CHUNK;
+  const auto chunk = [this](std::size_t chunk_index) {
+    const std::size_t first_entity = chunk_index * ENTITIES_PER_CHUNK;
+    return std::span<const VisibleEntity>(visible_entities_)
+        .subspan(first_entity, std::min(ENTITIES_PER_CHUNK, visible_entities_.size() - first_entity));
+  };
+
+  render_queue_.Clear();
+  if (chunk_count <= 1) {
+    GenerateDrawCommands(update, viewport, chunk_count == 1 ? chunk(0) : std::span<const VisibleEntity>(),
+                         &render_queue_);
+  } else {
+    if (chunk_queues_.size() < chunk_count) {
+      chunk_queues_.resize(chunk_count);
+    }
+    GetDefaultThreadPool()->ParallelFor(chunk_count, [&](std::size_t chunk_index) {
+      chunk_queues_[chunk_index].Clear();
+      GenerateDrawCommands(update, viewport, chunk(chunk_index), &chunk_queues_[chunk_index]);
+    });
+    for (std::size_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index) {
+      render_queue_.Append(chunk_queues_[chunk_index]);
+    }
+  }
 
+  DrawRenderQueue();
+}
+
+void Renderer2D::GenerateDrawCommands(const SceneUpdate& update, const SceneViewport& viewport,
+                                      std::span<const VisibleEntity> entities, RenderQueue2D* render_queue) {
   auto shape_storage = update.scene->GetComponentStorage<Shape2D>();
-  auto text_storage = update.scene->GetComponentStorage<Text>();
-
-  Texture2D* bound_texture = nullptr;
-  for (Entity& entity : *update.scene) {
-    // Transform* transform = object->GetComponent<Transform>();
-    // const Matrix4 world_to_clip_space =
-    //     transform ? AffineCombine(render_context.world_to_clip_space, transform->local_to_world_matrix())
-    //               : render_context.world_to_clip_space;
-    const Matrix4 world_to_clip_space = Matrix4::Identity();
-
-    if (shape_storage.EntityHasComponent(entity.id)) {
-      const Shape2D& shape = shape_storage[entity.id];
-      const std::span<const Shape2D::Vertex> vertices = shape.vertices();
-
-      const std::string texture_asset = shape.texture_asset();
-      Texture2D* texture = empty_texture_.get();
-      if (texture_asset.size() > 0) {
-        auto texture_iterator = textures_.find(texture_asset);
-        if (texture_iterator == textures_.end()) {
-          texture_iterator = textures_.insert(std::make_pair(texture_asset, LoadTexture2D(texture_asset, context()))).first;
+
+  for (const VisibleEntity& entity : entities) {
+    const CullingEntry& culling_entry = culling_entries_[entity.index];
+    const EntityId entity_id = culling_entry.id;
+    const Matrix4 world_to_clip_space = AffineCombine(viewport.world_to_clip, culling_entry.local_to_world);
+    const float depth = culling_entry.depth;
+
+    if (shape_storage.EntityHasComponent(entity_id)) {
+      const Shape2D& shape = shape_storage[entity_id];
+      const TextureAtlasRegion& texture_region = entity.texture_region;
+      const std::array<float, 4>& texture_rect = texture_region.texture_rect;
+
+      if (entity.mesh.has_value()) {
+        const bool is_quad = *entity.mesh == QUAD_MESH;
+        const Vector2 instance_size = is_quad ? shape.rectangle().size : Vector2::One();
+        render_queue->SubmitInstance(0, depth, texture_region.texture, BlendMode2D::ALPHA, *entity.mesh) =
+            CreateInstance(world_to_clip_space, instance_size, texture_rect,
+                           is_quad ? ConvertToRGBA8(shape.color()) : 0xffffffff);
+      } else {
+        const std::span<const Shape2D::Vertex> vertices = shape.vertices();
+        const std::span<Shape2D::Vertex> queued_vertices =
+            render_queue->Submit(0, depth, texture_region.texture, BlendMode2D::ALPHA, vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+          const Vector2 transformed_position =
+              TransformPosition(world_to_clip_space, Vector3(vertices[i].x, vertices[i].y, 0.0f));
+          queued_vertices[i] = vertices[i];
+          queued_vertices[i].x = transformed_position.x;
+          queued_vertices[i].y = transformed_position.y;
+          queued_vertices[i].s = texture_rect[0] + vertices[i].s * (texture_rect[2] - texture_rect[0]);
+          queued_vertices[i].t = texture_rect[1] + vertices[i].t * (texture_rect[3] - texture_rect[1]);
         }
-        texture = texture_iterator->second.get();
       }
+    }
 
-      if (texture != bound_texture) {
-        DrawShapeVertices();
-        shape_shader_->SetTexture("Texture", texture);
-        bound_texture = texture;
-      } else if (shape_vertex_count_ + vertices.size() > VERTEX_BUFFER_ELEMENT_COUNT) {
-        DrawShapeVertices();
+    if (entity.glyph_run != nullptr && !entity.glyph_run->vertices.empty()) {
+      const GlyphRun& glyph_run = *entity.glyph_run;
+      Texture2D* texture = glyph_run.font_atlas->texture();
+      if (glyph_run.mesh.has_value()) {
+        render_queue->SubmitInstance(0, depth, texture, BlendMode2D::ALPHA, *glyph_run.mesh, true) =
+            CreateInstance(world_to_clip_space, Vector2::One(), {0.0f, 0.0f, 1.0f, 1.0f}, 0xffffffff);
+      } else {
+        const std::span<Shape2D::Vertex> queued_vertices =
+            render_queue->Submit(0, depth, texture, BlendMode2D::ALPHA, glyph_run.vertices.size(), true);
+        for (size_t i = 0; i < glyph_run.vertices.size(); ++i) {
+          const Shape2D::Vertex& vertex = glyph_run.vertices[i];
+          const Vector2 transformed_position =
+              TransformPosition(world_to_clip_space, Vector3(vertex.x, vertex.y, 0.0f));
+          queued_vertices[i] = vertex;
+          queued_vertices[i].x = transformed_position.x;
+          queued_vertices[i].y = transformed_position.y;
+        }
       }
+    }
+  }
+}
 
-      for (size_t i = 0; i < vertices.size(); ++i) {
-        const Vector2 transformed_position = TransformPosition(world_to_clip_space, Vector3(vertices[i].x, vertices[i].y, 0.0f));
-        shape_vertices_[shape_vertex_count_ + i].x = transformed_position.x;
-        shape_vertices_[shape_vertex_count_ + i].y = transformed_position.y;
-        shape_vertices_[shape_vertex_count_ + i].color = vertices[i].color;
+void Renderer2D::UpdateSpatialGrid(Scene* scene) {
+  auto shape_storage = scene->GetComponentStorage<Shape2D>();
+  auto text_storage = scene->GetComponentStorage<Text>();
+  auto transform_storage = scene->GetComponentStorage<GlobalTransformMatrices>();
+
+  ++frame_index_;
+  for (Entity& entity : *scene) {
+    const bool has_shape = shape_storage.EntityHasComponent(entity.id);
+    const bool has_text = text_storage.EntityHasComponent(entity.id);
+    if (!has_shape && !has_text) {
+      continue;
+    }
+
+    const std::uint32_t entity_index = entity.id.index;
+    if (entity_index >= culling_entries_.size()) {
+      culling_entries_.resize(entity_index + 1);
+    }
+    CullingEntry& culling_entry = culling_entries_[entity_index];
+    culling_entry.last_seen_frame = frame_index_;
+
+    const Matrix3x4 local_to_world = transform_storage && transform_storage.EntityHasComponent(entity.id)
+                                         ? transform_storage[entity.id].local_to_world
+                                         : Matrix3x4::IdentityTransformation();
+    const std::uint64_t shape_version = has_shape ? shape_storage[entity.id].version() : 0;
+    // Texts whose font is still loading do not have a glyph run yet, so they are looked up again every frame. The run
+    // only depends on the properties of the text, so it can be kept even if the entity was replaced by another one.
+    const bool text_changed = has_text != (culling_entry.glyph_run != nullptr) ||
+                              (has_text && !HasSameGlyphRun(culling_entry.text, text_storage[entity.id]));
+    if (text_changed) {
+      culling_entry.glyph_run = has_text ? GetGlyphRun(text_storage[entity.id]) : nullptr;
+      if (culling_entry.glyph_run != nullptr) {
+        culling_entry.text = text_storage[entity.id];
       }
-      shape_vertex_count_ += vertices.size();
+    } else if (culling_entry.glyph_run != nullptr) {
+      culling_entry.glyph_run->last_used_frame = frame_index_;
+    }
+    if (!text_changed && spatial_grid_.Contains(entity_index) && culling_entry.id == entity.id &&
+        culling_entry.shape_version == shape_version &&
+        std::memcmp(&culling_entry.local_to_world, &local_to_world, sizeof(Matrix3x4)) == 0) {
+      continue;
+    }
+
+    culling_entry.id = entity.id;
+    culling_entry.local_to_world = local_to_world;
+    culling_entry.shape_version = shape_version;
+    // TODO: project into camera view axis instead of using the z coordinates
+    culling_entry.depth = TransformPosition(local_to_world, Vector3::Zero()).z;
+
+    AxisAlignedBoundingBox2D bounds = has_shape ? shape_storage[entity.id].bounds() : AxisAlignedBoundingBox2D::Empty();
+    if (culling_entry.glyph_run != nullptr) {
+      const AxisAlignedBoundingBox2D& text_bounds = culling_entry.glyph_run->layout.bounds;
+      bounds = has_shape ? AxisAlignedBoundingBox2D::FromMinMax(min(bounds.min(), text_bounds.min()),
+                                                                max(bounds.max(), text_bounds.max()))
+                         : text_bounds;
+    }
+    spatial_grid_.Update(entity_index, TransformBounds(local_to_world, bounds));
+  }
+
+  // Remove the entities that were deleted or lost their components
+  for (std::uint32_t entity_index = 0; entity_index < culling_entries_.size(); ++entity_index) {
+    if (culling_entries_[entity_index].last_seen_frame != frame_index_) {
+      spatial_grid_.Remove(entity_index);
+      // The glyph run is not marked as used anymore and may be removed
+      culling_entries_[entity_index].glyph_run = nullptr;
+    }
+  }
+}
+
+const TextureAtlasRegion& Renderer2D::GetTextureRegion(TextureAssetId texture_asset_id) {
+  if (texture_asset_id == 0) {
+    return white_region_;
+  }
+
+  if (texture_asset_id >= textures_.size()) {
+    textures_.resize(texture_asset_id + 1);
+  }
+  TextureEntry& texture = textures_[texture_asset_id];
+  texture.last_used_frame = frame_index_;
+  if (!texture.region.has_value()) {
+    texture.region = white_region_;
+    RequestTexture(texture_asset_id);
+  }
+  return *texture.region;
+}
+
+void Renderer2D::ReleaseUnusedTextures() {
+  for (TextureEntry& texture : textures_) {
+    // Textures in an atlas cannot be removed from it, so only the separate ones are released
+    if (texture.texture != nullptr && frame_index_ - texture.last_used_frame >= TEXTURE_LIFETIME) {
+      texture = {};
     }
+  }
+  // The released textures stay in the cache until it exceeds its budget
+  context()->asset_cache()->Trim();
+}
+
+namespace {
+
+bool IsPackedIntoAtlas(const Texture2DDescription& description, std::uint32_t page_size) {
+  const std::uint32_t padded_width = description.width + 2 * TextureAtlasDescription().padding;
+  const std::uint32_t padded_height = description.height + 2 * TextureAtlasDescription().padding;
+  return description.filter != TextureFilter::TRILINEAR && padded_width <= page_size && padded_height <= page_size &&
+         (description.format == TextureFormat::RGB_UINT8 || description.format == TextureFormat::RGBA_UINT8);
+}
+
+}  // namespace
+
+void Renderer2D::RequestTexture(TextureAssetId texture_asset_id) {
+  std::string asset_id = GetTextureAssetName(texture_asset_id);
+  // Another renderer may have loaded it already, textures that are packed into an atlas are never in the cache though
+  if (auto texture = context()->asset_cache()->Find<Texture2D>(asset_id, TEXTURE_FILE_TYPE); texture != nullptr) {
+    textures_[texture_asset_id] = {
+        .region = TextureAtlasRegion{.texture = texture.get(), .texture_rect = {0.0f, 0.0f, 1.0f, 1.0f}},
+        .texture = std::move(texture),
+        .last_used_frame = frame_index_,
+    };
+    return;
+  }
 
-    if (text_storage.EntityHasComponent(entity.id)) {
-      const Text& text = text_storage[entity.id];
+  AssetLibrary* asset_library = GetAssetLibraryForAsset(asset_id);
+  if (asset_library == nullptr) {
+    LogE("Failed to load texture '{}': asset library not found", asset_id);
+    return;
+  }
 
-      DrawShapeVertices(); // TODO: check if texture different
-      Vector2 position = Vector2::Zero();
+  const auto load = [asset_library, asset_id]() -> Result<Texture2DData> {
+    Result<Texture2DData> data = LoadTexture2DData(asset_library, asset_id);
+    OVIS_CHECK_RESULT(data);
 
-      if (Texture2D* texture = font_atlases_[0].texture(); texture != bound_texture) {
-        DrawShapeVertices();
-        shape_shader_->SetTexture("Texture", texture);
-        bound_texture = texture;
+    // The atlases only store RGBA pixels, so the conversion is done here on the loader thread
+    if (IsPackedIntoAtlas(data->description, ATLAS_PAGE_SIZE) && data->description.format == TextureFormat::RGB_UINT8) {
+      const std::size_t pixel_count = data->description.width * data->description.height;
+      Blob rgba_pixels(pixel_count * 4);
+      for (std::size_t i = 0; i < pixel_count; ++i) {
+        std::memcpy(&rgba_pixels[i * 4], &data->levels[0].data()[i * 3], 3);
+        rgba_pixels[i * 4 + 3] = std::byte{0xff};
       }
-      for (char character : text.text) {
-        auto vertices = font_atlases_[0].GetCharacterVertices(character, &position, text.color);
-        if (shape_vertex_count_ + vertices.size() > VERTEX_BUFFER_ELEMENT_COUNT) {
-          DrawShapeVertices();
-        }
-        for (auto& vertex : vertices) {
-          const Vector2 transformed_position = TransformPosition(world_to_clip_space, Vector3(vertex.x, vertex.y, 0.0f));
-          vertex.x = transformed_position.x;
-          vertex.y = transformed_position.y;
-        }
+      // Atlases do not use mip maps
+      data->levels.resize(1);
+      data->levels[0] = AssetView(std::move(rgba_pixels));
+      data->description.format = TextureFormat::RGBA_UINT8;
+    }
+    return std::move(*data);
+  };
+  const auto complete = [this, texture_asset_id, asset_id](Result<Texture2DData>&& data) {
+    if (!data.has_value()) {
+      LogE("Failed to load texture '{}': {}", asset_id, data.error().message);
+      return;
+    }
+    AddTexture(texture_asset_id, asset_id, *data);
+  };
+  AddAssetLoad(GetDefaultAssetLoader()->Load<Texture2DData>(AssetLoadPriority::HIGH, load, complete));
+}
 
-        std::memcpy(&shape_vertices_[shape_vertex_count_], vertices.data(), sizeof(Shape2D::Vertex) * vertices.size());
-        shape_vertex_count_ += vertices.size();
+void Renderer2D::AddTexture(TextureAssetId texture_asset_id, const std::string& asset_id, const Texture2DData& data) {
+  TextureEntry& texture = textures_[texture_asset_id];
+  const Texture2DDescription& description = data.description;
+  if (IsPackedIntoAtlas(description, ATLAS_PAGE_SIZE)) {
+    assert(description.format == TextureFormat::RGBA_UINT8);
+    const std::optional<TextureAtlasRegion> region =
+        texture_atlases_[static_cast<std::size_t>(description.filter)]->Add(description.width, description.height,
+                                                                             data.levels[0].data().data());
+    if (region.has_value()) {
+      texture.region = *region;
+      return;
+    }
+  }
+
+  LogV("Texture '{}' is not packed into an atlas", asset_id);
+  texture.texture = std::make_shared<Texture2D>(context(), data);
+  texture.region = TextureAtlasRegion{
+      .texture = texture.texture.get(),
+      .texture_rect = {0.0f, 0.0f, 1.0f, 1.0f},
+  };
+  context()->asset_cache()->Insert(asset_id, TEXTURE_FILE_TYPE, texture.texture);
+}
+
+std::optional<std::uint16_t> Renderer2D::GetShapeMesh(std::uint32_t entity_index, const Shape2D& shape) {
+  if (entity_index >= cached_shapes_.size()) {
+    cached_shapes_.resize(entity_index + 1);
+  }
+  CachedShape& cached_shape = cached_shapes_[entity_index];
+  if (cached_shape.version == shape.version() && cached_shape.mesh_generation == mesh_generation_) {
+    return cached_shape.mesh;
+  }
+
+  std::optional<std::uint16_t> mesh;
+  if (const Shape2DGeometry* geometry = shape.geometry(); geometry != nullptr) {
+    const auto mesh_iterator = geometry_meshes_.find(geometry->id);
+    if (mesh_iterator != geometry_meshes_.end()) {
+      mesh = mesh_iterator->second;
+    } else {
+      mesh = UploadMesh(geometry->vertices);
+      if (mesh.has_value()) {
+        geometry_meshes_.insert(std::make_pair(geometry->id, *mesh));
       }
     }
   }
 
-  DrawShapeVertices();
+  cached_shape = {
+      .version = shape.version(),
+      .mesh_generation = mesh_generation_,
+      .mesh = mesh,
+  };
+  return mesh;
+}
+
+std::optional<std::uint16_t> Renderer2D::UploadMesh(std::span<const Shape2D::Vertex> vertices) {
+  // If the buffer is full, the shape is drawn as triangles until the meshes are reset
+  if (geometry_buffer_vertex_count_ + vertices.size() > GEOMETRY_BUFFER_ELEMENT_COUNT ||
+      meshes_.size() > std::numeric_limits<std::uint16_t>::max()) {
+    return std::nullopt;
+  }
+
+  geometry_buffer_->Write(geometry_buffer_vertex_count_ * sizeof(Shape2D::Vertex),
+                          vertices.size() * sizeof(Shape2D::Vertex), vertices.data());
+  meshes_.push_back({
+      .first_vertex = static_cast<std::uint32_t>(geometry_buffer_vertex_count_),
+      .vertex_count = static_cast<std::uint32_t>(vertices.size()),
+  });
+  geometry_buffer_vertex_count_ += vertices.size();
+  return static_cast<std::uint16_t>(meshes_.size() - 1);
+}
+
+void Renderer2D::ResetMeshes() {
+  meshes_.clear();
+  geometry_meshes_.clear();
+  geometry_buffer_vertex_count_ = 0;
+  ++mesh_generation_;
+
+  // clang-format off
+  const Shape2D::Vertex quad_vertices[] = {
+    { -0.5f, -0.5f, 0.0f, 1.0f, 0xffffffff },
+    {  0.5f, -0.5f, 1.0f, 1.0f, 0xffffffff },
+    {  0.5f,  0.5f, 1.0f, 0.0f, 0xffffffff },
+    { -0.5f, -0.5f, 0.0f, 1.0f, 0xffffffff },
+    {  0.5f,  0.5f, 1.0f, 0.0f, 0xffffffff },
+    { -0.5f,  0.5f, 0.0f, 0.0f, 0xffffffff },
+  };
+  // clang-format on
+  [[maybe_unused]] const auto quad_mesh = UploadMesh(quad_vertices);
+  assert(quad_mesh == QUAD_MESH);
+}
+
+FontAtlas* Renderer2D::GetFontAtlas(const std::string& font) {
+  static const std::string default_font = DEFAULT_FONT;
+  const std::string& font_asset = font.empty() ? default_font : font;
+
+  auto font_atlas = font_atlases_.find(font_asset);
+  if (font_atlas == font_atlases_.end()) {
+    font_atlas = font_atlases_.emplace(font_asset, nullptr).first;
+    RequestFontAtlas(font_asset);
+  }
+  return font_atlas->second.get();
 }
 
-void Renderer2D::DrawShapeVertices() {
-  if (shape_vertex_count_ == 0) {
+void Renderer2D::RequestFontAtlas(const std::string& font) {
+  const AssetLibrary* asset_library = GetAssetLibraryForAsset(font);
+  if (asset_library == nullptr) {
+    LogE("Failed to load font '{}': asset library not found", font);
     return;
   }
-  assert(shape_vertex_count_ % 3 == 0);
 
-  vertex_buffer_->Write(0, shape_vertex_count_ * sizeof(Shape2D::Vertex), shape_vertices_.data());
+  const auto load = [asset_library, font]() { return asset_library->LoadAssetFile(font, "ttf"); };
+  const auto create = [context = context(), font](AssetView&& font_data) -> Result<std::shared_ptr<FontAtlas>> {
+    std::shared_ptr<FontAtlas> font_atlas = CreateFontAtlas(context, font, std::move(font_data));
+    if (font_atlas == nullptr) {
+      return Error("invalid TrueType file");
+    }
+    return font_atlas;
+  };
+  // Called immediately if another renderer already loaded the font
+  const auto ready = [this, font](Result<std::shared_ptr<FontAtlas>>&& font_atlas) {
+    if (!font_atlas.has_value()) {
+      LogE("Failed to load font '{}': {}", font, font_atlas.error().message);
+      return;
+    }
+    font_atlases_[font] = *font_atlas;
+  };
+  AddAssetLoad(context()->asset_cache()->Request<FontAtlas, AssetView>(
+      font, "ttf", GetDefaultAssetLoader(), AssetLoadPriority::HIGH, load, create, ready));
+}
+
+void Renderer2D::AddAssetLoad(AssetLoadHandle asset_load) {
+  std::erase_if(asset_loads_, [](const AssetLoadHandle& asset_load) { return !asset_load.is_pending(); });
+  asset_loads_.push_back(std::move(asset_load));
+}
+
+void Renderer2D::CancelAssetLoads() {
+  for (AssetLoadHandle& asset_load : asset_loads_) {
+    asset_load.Cancel();
+  }
+  asset_loads_.clear();
+}
+
+std::size_t Renderer2D::GlyphRunKeyHash::operator()(const GlyphRunKey& key) const {
+  std::size_t hash = std::hash<std::string>()(key.text);
+  const auto combine = [&hash](std::size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+  combine(std::hash<FontAtlas*>()(key.font_atlas));
+  combine(std::hash<float>()(key.size));
+  combine(std::hash<float>()(key.max_width));
+  combine(std::hash<int>()(static_cast<int>(key.alignment)));
+  combine(std::hash<std::uint32_t>()(key.color));
+  return hash;
+}
+
+Renderer2D::GlyphRun* Renderer2D::GetGlyphRun(const Text& text) {
+  FontAtlas* font_atlas = GetFontAtlas(text.font);
+  if (font_atlas == nullptr) {
+    return nullptr;
+  }
+
+  const float max_width = text.max_width > 0.0f ? text.max_width : std::numeric_limits<float>::infinity();
+  auto [glyph_run_iterator, inserted] = glyph_runs_.try_emplace(GlyphRunKey{
+      .font_atlas = font_atlas,
+      .text = text.text,
+      .size = text.size,
+      .max_width = max_width,
+      .alignment = text.alignment,
+      .color = ConvertToRGBA8(text.color),
+  });
+  GlyphRun& glyph_run = glyph_run_iterator->second;
+  if (inserted) {
+    glyph_run.font_atlas = font_atlas;
+    glyph_run.color = text.color;
+    const TextLayoutOptions options = {.size = text.size, .max_width = max_width, .alignment = text.alignment};
+    LayoutText(font_atlas, text.text, options, &glyph_run.layout);
+  }
+  glyph_run.last_used_frame = frame_index_;
+  return &glyph_run;
+}
+
+void Renderer2D::UpdateGlyphRun(GlyphRun* glyph_run) {
+  const bool vertices_changed = glyph_run->atlas_generation != glyph_run->font_atlas->generation();
+  if (vertices_changed) {
+    glyph_run->vertices.clear();
+    GenerateTextVertices(*glyph_run->font_atlas, glyph_run->layout, glyph_run->color, &glyph_run->vertices);
+    glyph_run->atlas_generation = glyph_run->font_atlas->generation();
+    glyph_run->mesh.reset();
+  }
+
+  // A failed upload is only attempted again after the meshes were reset
+  if (instanced_vertex_input_ != nullptr && (vertices_changed || glyph_run->mesh_generation != mesh_generation_)) {
+    glyph_run->mesh = glyph_run->vertices.empty() ? std::nullopt : UploadMesh(glyph_run->vertices);
+    glyph_run->mesh_generation = mesh_generation_;
+  }
+}
+
+void Renderer2D::DrawRenderQueue() {
+  render_queue_.Sort();
+
+  // Batches are uploaded in chunks that fit into a segment of the vertex buffer. Only whole triangles are put into a
+  // chunk, so a batch that spans multiple chunks can be split at the chunk boundary.
+  constexpr size_t MAX_CHUNK_SIZE = VERTEX_BUFFER_ELEMENT_COUNT / 3 * 3;
+  const std::span<const Shape2D::Vertex> vertices = render_queue_.sorted_vertices();
+  size_t chunk_begin = 0;
+  size_t chunk_end = 0;
+  size_t chunk_start_in_buffer = 0;
+
+  for (const auto& batch : render_queue_.batches()) {
+    if (batch.instanced) {
+      DrawInstances(batch);
+      continue;
+    }
+
+    ShaderProgram* shader_program = shape_shader_.get();
+    VertexInput* vertex_input = vertex_input_.get();
+    if (batch.is_text) {
+      shader_program = text_shader_.get();
+      vertex_input = text_vertex_input_.get();
+    }
+    shader_program->SetTexture("Texture", batch.texture);
+
+    size_t first_vertex = batch.first_vertex;
+    size_t remaining_vertex_count = batch.vertex_count;
+    while (remaining_vertex_count > 0) {
+      if (first_vertex >= chunk_end) {
+        chunk_begin = first_vertex;
+        chunk_end = std::min(vertices.size(), chunk_begin + MAX_CHUNK_SIZE);
+        chunk_start_in_buffer = vertex_buffer_->Write(vertices.subspan(chunk_begin, chunk_end - chunk_begin));
+      }
+      const size_t vertex_count = std::min(remaining_vertex_count, chunk_end - first_vertex);
+
+      DrawItem draw_item;
+      draw_item.vertex_input = vertex_input;
+      draw_item.shader_program = shader_program;
+      draw_item.primitive_topology = PrimitiveTopology::TRIANGLE_LIST;
+      // draw_item.render_target_configuration = viewport()->GetDefaultRenderTargetConfiguration();
+      draw_item.start = chunk_start_in_buffer + first_vertex - chunk_begin;
+      draw_item.count = vertex_count;
+      draw_item.blend_state = GetBlendState(batch.blend_mode);
+      context()->Draw(draw_item);
+
+      first_vertex += vertex_count;
+      remaining_vertex_count -= vertex_count;
+    }
+  }
+}
+
+void Renderer2D::DrawInstances(const RenderQueue2D::Batch& batch) {
+  ShaderProgram* shader_program = instanced_shape_shader_.get();
+  VertexInput* vertex_input = instanced_vertex_input_.get();
+  if (batch.is_text) {
+    shader_program = instanced_text_shader_.get();
+    vertex_input = instanced_text_vertex_input_.get();
+  }
+  shader_program->SetTexture("Texture", batch.texture);
 
-  DrawItem draw_item;
-  draw_item.vertex_input = vertex_input_.get();
-  draw_item.shader_program = shape_shader_.get();
-  draw_item.primitive_topology = PrimitiveTopology::TRIANGLE_LIST;
-  // draw_item.render_target_configuration = viewport()->GetDefaultRenderTargetConfiguration();
-  draw_item.count = shape_vertex_count_;
-  draw_item.blend_state.enabled = true;
-  draw_item.blend_state.source_color_factor = SourceBlendFactor::SOURCE_ALPHA;
-  draw_item.blend_state.destination_color_factor = DestinationBlendFactor::ONE_MINUS_SOURCE_ALPHA;
-  context()->Draw(draw_item);
+  const std::span<const RenderQueue2D::Instance> instances =
+      render_queue_.sorted_instances().subspan(batch.first_instance, batch.instance_count);
+  for (size_t offset = 0; offset < instances.size(); offset += INSTANCE_BUFFER_ELEMENT_COUNT) {
+    const auto chunk = instances.subspan(offset, std::min(INSTANCE_BUFFER_ELEMENT_COUNT, instances.size() - offset));
 
-  shape_vertex_count_ = 0;
+    DrawItem draw_item;
+    draw_item.vertex_input = vertex_input;
+    draw_item.shader_program = shader_program;
+    draw_item.primitive_topology = PrimitiveTopology::TRIANGLE_LIST;
+    draw_item.start = meshes_[batch.mesh].first_vertex;
+    draw_item.count = meshes_[batch.mesh].vertex_count;
+    draw_item.base_instance = instance_buffer_->Write(chunk);
+    draw_item.instance_count = chunk.size();
+    draw_item.blend_state = GetBlendState(batch.blend_mode);
+    context()->Draw(draw_item);
+  }
 }
 
 }  // namespace ovis
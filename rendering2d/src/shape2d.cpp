@@ -1,5 +1,11 @@
 #include "ovis/rendering2d/shape2d.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
 namespace ovis {
 
 void to_json(json& data, const Shape2D& shape2d) {
@@ -47,67 +53,55 @@ void from_json(const json& data, Shape2D& shape2d) {
   }
 }
 
-void Shape2D::SetColor(const Color& color) {
-  color_ = color;
-  Update();
-}
-
-void Shape2D::SetOutlineColor(const Color& color) {
-  outline_color_ = color;
-  Update();
-}
-void Shape2D::SetOutlineWidth(float width) {
-  outline_width_ = width;
-  Update();
-}
-
-void Shape2D::SetRectangle(const Rectangle& rect) {
-  type_ = Type::RECTANGLE;
-  rectangle_ = rect;
-  UpdateRectangle();
-}
-
-void Shape2D::SetEllipse(const Ellipse& ellipse) {
-  type_ = Type::ELLIPSE;
-  ellipse_ = ellipse;
-  UpdateEllipse();
-}
-
-void Shape2D::Update() {
-  switch (type()) {
-    case Type::RECTANGLE:
-      UpdateRectangle();
-      break;
-
-    case Type::ELLIPSE:
-      UpdateEllipse();
-      break;
+namespace {
+
+// All parameters that affect the tessellation of a shape
+struct GeometryKey {
+  Shape2D::Type type;
+  Vector2 size;
+  std::uint32_t num_segments;
+  float outline_width;
+  std::uint32_t color;
+  std::uint32_t outline_color;
+
+  bool operator==(const GeometryKey&) const = default;
+};
+
+struct GeometryKeyHash {
+  std::size_t operator()(const GeometryKey& key) const {
+    std::size_t hash = std::hash<int>()(static_cast<int>(key.type));
+    const auto combine = [&hash](std::size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+    combine(std::hash<float>()(key.size.x));
+    combine(std::hash<float>()(key.size.y));
+    combine(std::hash<std::uint32_t>()(key.num_segments));
+    combine(std::hash<float>()(key.outline_width));
+    combine(std::hash<std::uint32_t>()(key.color));
+    combine(std::hash<std::uint32_t>()(key.outline_color));
+    return hash;
   }
-}
-
-void Shape2D::UpdateRectangle() {
-  assert(type_ == Type::RECTANGLE);
-
-  const Vector2 inner_half_size = 0.5f * rectangle_.size + std::min(outline_width_, 0.0f) * Vector2::One();
-  const Vector2 outer_half_size = inner_half_size + std::abs(outline_width_) * Vector2::One();
-  const uint32_t inner_color = ConvertToRGBA8(color_);
-  const uint32_t outline_color = ConvertToRGBA8(outline_color_);
-  if (outline_width_ == 0.0f) {
-    vertices_ = {
-      { -inner_half_size.x, -inner_half_size.y, 0.0f, 0.0f, inner_color },
-      {  inner_half_size.x, -inner_half_size.y, 0.0f, 0.0f, inner_color },
-      {  inner_half_size.x,  inner_half_size.y, 0.0f, 0.0f, inner_color },
-      { -inner_half_size.x, -inner_half_size.y, 0.0f, 0.0f, inner_color },
-      {  inner_half_size.x,  inner_half_size.y, 0.0f, 0.0f, inner_color },
+};
+
+void TessellateRectangle(const GeometryKey& key, std::vector<Shape2D::Vertex>* vertices) {
+  const Vector2 inner_half_size = 0.5f * key.size + std::min(key.outline_width, 0.0f) * Vector2::One();
+  const Vector2 outer_half_size = inner_half_size + std::abs(key.outline_width) * Vector2::One();
+  const uint32_t inner_color = key.color;
+  const uint32_t outline_color = key.outline_color;
+  if (key.outline_width == 0.0f) {
+    *vertices = {
+      { -inner_half_size.x, -inner_half_size.y, 0.0f, 1.0f, inner_color },
+      {  inner_half_size.x, -inner_half_size.y, 1.0f, 1.0f, inner_color },
+      {  inner_half_size.x,  inner_half_size.y, 1.0f, 0.0f, inner_color },
+      { -inner_half_size.x, -inner_half_size.y, 0.0f, 1.0f, inner_color },
+      {  inner_half_size.x,  inner_half_size.y, 1.0f, 0.0f, inner_color },
       { -inner_half_size.x,  inner_half_size.y, 0.0f, 0.0f, inner_color },
     };
   } else {
-    vertices_ = {
-      { -inner_half_size.x, -inner_half_size.y, 0.0f, 0.0f, inner_color },
-      {  inner_half_size.x, -inner_half_size.y, 0.0f, 0.0f, inner_color },
-      {  inner_half_size.x,  inner_half_size.y, 0.0f, 0.0f, inner_color },
-      { -inner_half_size.x, -inner_half_size.y, 0.0f, 0.0f, inner_color },
-      {  inner_half_size.x,  inner_half_size.y, 0.0f, 0.0f, inner_color },
+    *vertices = {
+      { -inner_half_size.x, -inner_half_size.y, 0.0f, 1.0f, inner_color },
+      {  inner_half_size.x, -inner_half_size.y, 1.0f, 1.0f, inner_color },
+      {  inner_half_size.x,  inner_half_size.y, 1.0f, 0.0f, inner_color },
+      { -inner_half_size.x, -inner_half_size.y, 0.0f, 1.0f, inner_color },
+      {  inner_half_size.x,  inner_half_size.y, 1.0f, 0.0f, inner_color },
       { -inner_half_size.x,  inner_half_size.y, 0.0f, 0.0f, inner_color },
 
       // Top outline
@@ -149,61 +143,197 @@ void Shape2D::UpdateRectangle() {
   }
 }
 
-void Shape2D::UpdateEllipse() {
-  const size_t ellipse_vertices = ellipse_.num_segments * 3;
-  const size_t outline_vertices = outline_width_ == 0.0f ? 0 : ellipse_.num_segments * 3 * 2;
+void TessellateEllipse(const GeometryKey& key, std::vector<Shape2D::Vertex>* vertices) {
+  const size_t ellipse_vertices = key.num_segments * 3;
+  const size_t outline_vertices = key.outline_width == 0.0f ? 0 : key.num_segments * 3 * 2;
 
-  vertices_.clear();
-  vertices_.reserve(ellipse_vertices + outline_vertices);
+  vertices->clear();
+  vertices->reserve(ellipse_vertices + outline_vertices);
 
   // Add ellipse vertices
-  const Vector2 inner_half_size = 0.5f * ellipse_.size + std::min(outline_width_, 0.0f) * Vector2::One();
+  const Vector2 inner_half_size = 0.5f * key.size + std::min(key.outline_width, 0.0f) * Vector2::One();
   {
-    const uint32_t ellipse_color = ConvertToRGBA8(color_);
+    const uint32_t ellipse_color = key.color;
 
     Vector2 previous_position{0.0f, inner_half_size.y};
-    for (int i = 1; i < ellipse_.num_segments; ++i) {
-      const float angle = i * 2.0f * Pi<float>() / ellipse_.num_segments;
+    for (int i = 1; i < key.num_segments; ++i) {
+      const float angle = i * 2.0f * Pi<float>() / key.num_segments;
 
       const Vector2 new_position = inner_half_size * Vector2{std::sin(angle), std::cos(angle)};
-      vertices_.push_back({previous_position.x, previous_position.y, 0.0f, 0.0f, ellipse_color});
-      vertices_.push_back({new_position.x, new_position.y, 0.0f, 0.0f, ellipse_color});
-      vertices_.push_back({0.0f, 0.0f, 0.0f, 0.0f, ellipse_color});
+      vertices->push_back({previous_position.x, previous_position.y, 0.0f, 0.0f, ellipse_color});
+      vertices->push_back({new_position.x, new_position.y, 0.0f, 0.0f, ellipse_color});
+      vertices->push_back({0.0f, 0.0f, 0.0f, 0.0f, ellipse_color});
       previous_position = new_position;
     }
-    vertices_.push_back({previous_position.x, previous_position.y, 0.0f, 0.0f, ellipse_color});
-    vertices_.push_back({0.0f, inner_half_size.y, 0.0f, 0.0f, ellipse_color});
-    vertices_.push_back({0.0f, 0.0f, 0.0f, 0.0f, ellipse_color});
+    vertices->push_back({previous_position.x, previous_position.y, 0.0f, 0.0f, ellipse_color});
+    vertices->push_back({0.0f, inner_half_size.y, 0.0f, 0.0f, ellipse_color});
+    vertices->push_back({0.0f, 0.0f, 0.0f, 0.0f, ellipse_color});
   }
 
   // Add outline vertices
-  if (outline_width_ != 0.0f) {
-    const Vector2 outer_half_size = inner_half_size + std::abs(outline_width_) * Vector2::One();
-    const uint32_t outline_color = ConvertToRGBA8(outline_color_);
+  if (key.outline_width != 0.0f) {
+    const Vector2 outer_half_size = inner_half_size + std::abs(key.outline_width) * Vector2::One();
+    const uint32_t outline_color = key.outline_color;
 
     Vector2 previous_inner_position{0.0f, inner_half_size.y};
     Vector2 previous_outer_position{0.0f, outer_half_size.y};
-    for (int i = 0; i < ellipse_.num_segments; ++i) {
-      const float angle = (i + 1) * 2.0f * Pi<float>() / ellipse_.num_segments;
+    for (int i = 0; i < key.num_segments; ++i) {
+      const float angle = (i + 1) * 2.0f * Pi<float>() / key.num_segments;
 
       const Vector2 direction = Vector2{std::sin(angle), std::cos(angle)};
       const Vector2 new_inner_position = inner_half_size * direction;
       const Vector2 new_outer_position = outer_half_size * direction;
 
-      vertices_.push_back({previous_inner_position.x, previous_inner_position.y, 0.0f, 0.0f, outline_color});
-      vertices_.push_back({new_inner_position.x, new_inner_position.y, 0.0f, 0.0f, outline_color});
-      vertices_.push_back({new_outer_position.x, new_outer_position.y, 0.0f, 0.0f, outline_color});
+      vertices->push_back({previous_inner_position.x, previous_inner_position.y, 0.0f, 0.0f, outline_color});
+      vertices->push_back({new_inner_position.x, new_inner_position.y, 0.0f, 0.0f, outline_color});
+      vertices->push_back({new_outer_position.x, new_outer_position.y, 0.0f, 0.0f, outline_color});
 
-      vertices_.push_back({previous_inner_position.x, previous_inner_position.y, 0.0f, 0.0f, outline_color});
-      vertices_.push_back({new_outer_position.x, new_outer_position.y, 0.0f, 0.0f, outline_color});
-      vertices_.push_back({previous_outer_position.x, previous_outer_position.y, 0.0f, 0.0f, outline_color});
+      vertices->push_back({previous_inner_position.x, previous_inner_position.y, 0.0f, 0.0f, outline_color});
+      vertices->push_back({new_outer_position.x, new_outer_position.y, 0.0f, 0.0f, outline_color});
+      vertices->push_back({previous_outer_position.x, previous_outer_position.y, 0.0f, 0.0f, outline_color});
 
       previous_inner_position = new_inner_position;
       previous_outer_position = new_outer_position;
     }
   }
 
-  assert(vertices_.size() == ellipse_vertices + outline_vertices);
+  assert(vertices->size() == ellipse_vertices + outline_vertices);
+}
+
+std::shared_ptr<const Shape2DGeometry> GetGeometry(const GeometryKey& key) {
+  static std::mutex mutex;
+  static std::unordered_map<GeometryKey, std::weak_ptr<const Shape2DGeometry>, GeometryKeyHash> geometries;
+  static std::uint64_t next_geometry_id = 1;
+  static std::size_t cleanup_threshold = 64;
+
+  std::lock_guard lock(mutex);
+  auto& cached_geometry = geometries[key];
+  if (auto geometry = cached_geometry.lock()) {
+    return geometry;
+  }
+
+  auto geometry = std::make_shared<Shape2DGeometry>();
+  geometry->id = next_geometry_id++;
+  switch (key.type) {
+    case Shape2D::Type::RECTANGLE:
+      TessellateRectangle(key, &geometry->vertices);
+      break;
+
+    case Shape2D::Type::ELLIPSE:
+      TessellateEllipse(key, &geometry->vertices);
+      break;
+  }
+  if (!geometry->vertices.empty()) {
+    Vector2 min = {geometry->vertices[0].x, geometry->vertices[0].y};
+    Vector2 max = min;
+    for (const Shape2D::Vertex& vertex : geometry->vertices) {
+      min = ovis::min(min, Vector2{vertex.x, vertex.y});
+      max = ovis::max(max, Vector2{vertex.x, vertex.y});
+    }
+    geometry->bounds = AxisAlignedBoundingBox2D::FromMinMax(min, max);
+  } else {
+    geometry->bounds = AxisAlignedBoundingBox2D::Empty();
+  }
+  cached_geometry = geometry;
+
+  // Remove the entries of geometries that are not used anymore once in a while
+  if (geometries.size() > cleanup_threshold) {
+    std::erase_if(geometries, [](const auto& entry) { return entry.second.expired(); });
+    cleanup_threshold = std::max<std::size_t>(64, 2 * geometries.size());
+  }
+
+  return geometry;
+}
+
+std::mutex texture_assets_mutex;
+// A deque, so references to the names stay valid when new ones are added
+std::deque<std::string> texture_asset_names = {""};
+std::unordered_map<std::string, TextureAssetId> texture_asset_ids = {{"", 0}};
+
+std::atomic<std::uint64_t> next_shape_version = 1;
+
+}  // namespace
+
+TextureAssetId InternTextureAsset(std::string_view texture_asset) {
+  std::lock_guard lock(texture_assets_mutex);
+  const auto [iterator, inserted] =
+      texture_asset_ids.insert(std::make_pair(std::string(texture_asset), texture_asset_names.size()));
+  if (inserted) {
+    texture_asset_names.emplace_back(texture_asset);
+  }
+  return iterator->second;
+}
+
+std::string GetTextureAssetName(TextureAssetId texture_asset_id) {
+  std::lock_guard lock(texture_assets_mutex);
+  assert(texture_asset_id < texture_asset_names.size());
+  return texture_asset_names[texture_asset_id];
+}
+
+std::span<const Shape2D::Vertex> Shape2D::vertices() const {
+  return geometry_ ? std::span<const Vertex>(geometry_->vertices) : std::span<const Vertex>();
+}
+
+AxisAlignedBoundingBox2D Shape2D::bounds() const {
+  return geometry_ ? geometry_->bounds : AxisAlignedBoundingBox2D::Empty();
+}
+
+void Shape2D::SetColor(const Color& color) {
+  color_ = color;
+  Update();
+}
+
+void Shape2D::SetOutlineColor(const Color& color) {
+  outline_color_ = color;
+  Update();
+}
+void Shape2D::SetOutlineWidth(float width) {
+  outline_width_ = width;
+  Update();
+}
+
+void Shape2D::SetRectangle(const Rectangle& rect) {
+  type_ = Type::RECTANGLE;
+  rectangle_ = rect;
+  Update();
+}
+
+void Shape2D::SetEllipse(const Ellipse& ellipse) {
+  type_ = Type::ELLIPSE;
+  ellipse_ = ellipse;
+  Update();
+}
+
+void Shape2D::SetTexture(const std::string& texture_asset) {
+  texture_asset_ = texture_asset;
+  texture_asset_id_ = InternTextureAsset(texture_asset);
+  UpdateVersion();
+}
+
+void Shape2D::Update() {
+  GeometryKey key = {
+      .type = type_,
+      .num_segments = 0,
+      .outline_width = outline_width_,
+      .color = ConvertToRGBA8(color_),
+      .outline_color = outline_width_ != 0.0f ? ConvertToRGBA8(outline_color_) : 0,
+  };
+  switch (type_) {
+    case Type::RECTANGLE:
+      key.size = rectangle_.size;
+      break;
+
+    case Type::ELLIPSE:
+      key.size = ellipse_.size;
+      key.num_segments = ellipse_.num_segments;
+      break;
+  }
+  geometry_ = GetGeometry(key);
+  UpdateVersion();
+}
+
+void Shape2D::UpdateVersion() {
+  version_ = next_shape_version.fetch_add(1, std::memory_order_relaxed);
 }
 
 OVIS_VM_DEFINE_TYPE_BINDING(Rendering2D, Shape2D) {
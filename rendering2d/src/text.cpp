@@ -6,10 +6,25 @@ void to_json(json& data, const Text& text) {
   data = json::object({
     {"color", text.color},
     {"text", text.text},
+    {"size", text.size},
   });
   if (text.font.size() > 0) {
     data["font"] = text.font;
   }
+  if (text.max_width > 0.0f) {
+    data["maxWidth"] = text.max_width;
+  }
+  switch (text.alignment) {
+    case TextAlignment::LEFT:
+      data["alignment"] = "left";
+      break;
+    case TextAlignment::CENTER:
+      data["alignment"] = "center";
+      break;
+    case TextAlignment::RIGHT:
+      data["alignment"] = "right";
+      break;
+  }
 }
 void from_json(const json& data, Text& text) {
   if (data.contains("color")) {
@@ -29,6 +44,27 @@ void from_json(const json& data, Text& text) {
   } else {
     text.font = "";
   }
+
+  if (data.contains("size")) {
+    text.size = data.at("size");
+  } else {
+    text.size = 32.0f;
+  }
+
+  if (data.contains("maxWidth")) {
+    text.max_width = data.at("maxWidth");
+  } else {
+    text.max_width = 0.0f;
+  }
+
+  const std::string alignment = data.contains("alignment") ? data.at("alignment").get<std::string>() : "left";
+  if (alignment == "center") {
+    text.alignment = TextAlignment::CENTER;
+  } else if (alignment == "right") {
+    text.alignment = TextAlignment::RIGHT;
+  } else {
+    text.alignment = TextAlignment::LEFT;
+  }
 }
 
 OVIS_VM_DEFINE_TYPE_BINDING(Rendering2D, Text) {
@@ -37,6 +73,8 @@ OVIS_VM_DEFINE_TYPE_BINDING(Rendering2D, Text) {
   Text_type->AddProperty<&Text::color>("color");
   Text_type->AddProperty<&Text::text>("text");
   Text_type->AddProperty<&Text::font>("font");
+  Text_type->AddProperty<&Text::size>("size");
+  Text_type->AddProperty<&Text::max_width>("maxWidth");
 }
 
 }  // namespace ovis
@@ -0,0 +1,149 @@
+#include "ovis/rendering2d/text_layout.hpp"
+
+#include <cassert>
+#include <optional>
+
+#include "ovis/utils/utf8.hpp"
+#include "ovis/rendering2d/font_atlas.hpp"
+
+namespace ovis {
+
+void LayoutText(FontAtlas* font_atlas, std::string_view text, const TextLayoutOptions& options, TextLayout* layout) {
+  assert(font_atlas != nullptr);
+  assert(layout != nullptr);
+
+  layout->size = options.size;
+  layout->glyphs.clear();
+
+  // The text is laid out in units of the font size and scaled afterwards
+  struct Line {
+    std::size_t first_glyph;
+    // The width without trailing spaces
+    float width;
+  };
+  std::vector<Line> lines = {{.first_glyph = 0, .width = 0.0f}};
+  const float max_width = options.max_width / options.size;
+  float x = 0.0f;
+  std::optional<char32_t> previous_codepoint;
+  // The first glyph after the last run of spaces in the current line and its position, the line can be broken there
+  std::optional<std::size_t> break_glyph;
+  float break_x = 0.0f;
+  float width_before_break = 0.0f;
+
+  while (!text.empty()) {
+    const char32_t codepoint = pop_codepoint(&text);
+    if (codepoint == U'\n') {
+      lines.push_back({.first_glyph = layout->glyphs.size(), .width = 0.0f});
+      x = 0.0f;
+      previous_codepoint.reset();
+      break_glyph.reset();
+      continue;
+    }
+
+    if (previous_codepoint.has_value()) {
+      x += font_atlas->GetKerning(*previous_codepoint, codepoint);
+    }
+    const FontAtlas::GlyphMetrics& metrics = font_atlas->GetGlyphMetrics(codepoint);
+    previous_codepoint = codepoint;
+
+    if (codepoint == U' ') {
+      if (!break_glyph.has_value() || *break_glyph != layout->glyphs.size()) {
+        width_before_break = lines.back().width;
+      }
+      x += metrics.advance;
+      break_glyph = layout->glyphs.size();
+      break_x = x;
+      continue;
+    }
+
+    if (x + metrics.advance > max_width && break_glyph.has_value()) {
+      // Move the glyphs after the last space to a new line
+      lines.back().width = width_before_break;
+      for (std::size_t i = *break_glyph; i < layout->glyphs.size(); ++i) {
+        layout->glyphs[i].position.x -= break_x;
+      }
+      lines.push_back({.first_glyph = *break_glyph, .width = 0.0f});
+      x -= break_x;
+      break_glyph.reset();
+    }
+
+    if (metrics.has_outline) {
+      layout->glyphs.push_back({.codepoint = codepoint, .position = {x, 0.0f}});
+    }
+    x += metrics.advance;
+    lines.back().width = x;
+  }
+
+  bool is_empty = true;
+  Vector2 min = Vector2::Zero();
+  Vector2 max = Vector2::Zero();
+  for (std::size_t line_index = 0; line_index < lines.size(); ++line_index) {
+    const Line& line = lines[line_index];
+    float offset = 0.0f;
+    switch (options.alignment) {
+      case TextAlignment::LEFT:
+        break;
+      case TextAlignment::CENTER:
+        offset = -0.5f * line.width;
+        break;
+      case TextAlignment::RIGHT:
+        offset = -line.width;
+        break;
+    }
+    const float y = -font_atlas->line_height() * line_index;
+
+    const std::size_t end_glyph =
+        line_index + 1 < lines.size() ? lines[line_index + 1].first_glyph : layout->glyphs.size();
+    for (std::size_t i = line.first_glyph; i < end_glyph; ++i) {
+      TextLayout::Glyph& glyph = layout->glyphs[i];
+      glyph.position = Vector2{glyph.position.x + offset, y};
+
+      const FontAtlas::GlyphMetrics& metrics = font_atlas->GetGlyphMetrics(glyph.codepoint);
+      const Vector2 glyph_min = glyph.position + metrics.outline_min;
+      const Vector2 glyph_max = glyph.position + metrics.outline_max;
+      min = is_empty ? glyph_min : ovis::min(min, glyph_min);
+      max = is_empty ? glyph_max : ovis::max(max, glyph_max);
+      is_empty = false;
+
+      glyph.position *= options.size;
+    }
+  }
+
+  layout->line_count = lines.size();
+  layout->bounds = is_empty ? AxisAlignedBoundingBox2D::Empty()
+                            : AxisAlignedBoundingBox2D::FromMinMax(min * options.size, max * options.size);
+}
+
+void PrepareGlyphs(FontAtlas* font_atlas, const TextLayout& layout) {
+  assert(font_atlas != nullptr);
+  for (const TextLayout::Glyph& glyph : layout.glyphs) {
+    font_atlas->PrepareGlyph(glyph.codepoint);
+  }
+}
+
+void GenerateTextVertices(const FontAtlas& font_atlas, const TextLayout& layout, Color color,
+                          std::vector<Shape2D::Vertex>* vertices) {
+  assert(vertices != nullptr);
+
+  const std::uint32_t color_rgba = ConvertToRGBA8(color);
+  for (const TextLayout::Glyph& glyph : layout.glyphs) {
+    const FontAtlas::GlyphQuad* quad = font_atlas.FindGlyphQuad(glyph.codepoint);
+    if (quad == nullptr) {
+      continue;
+    }
+
+    const float x0 = glyph.position.x + quad->min.x * layout.size;
+    const float x1 = glyph.position.x + quad->max.x * layout.size;
+    const float y0 = glyph.position.y + quad->max.y * layout.size;
+    const float y1 = glyph.position.y + quad->min.y * layout.size;
+    const auto [s0, t0, s1, t1] = quad->texture_rect;
+    vertices->push_back({.x = x0, .y = y0, .s = s0, .t = t0, .color = color_rgba});
+    vertices->push_back({.x = x1, .y = y0, .s = s1, .t = t0, .color = color_rgba});
+    vertices->push_back({.x = x1, .y = y1, .s = s1, .t = t1, .color = color_rgba});
+    vertices->push_back({.x = x0, .y = y0, .s = s0, .t = t0, .color = color_rgba});
+    vertices->push_back({.x = x1, .y = y1, .s = s1, .t = t1, .color = color_rgba});
+    vertices->push_back({.x = x0, .y = y1, .s = s0, .t = t1, .color = color_rgba});
+  }
+}
+
+}  // namespace ovis
@@ -0,0 +1,202 @@
+#include "ovis/rendering2d/texture_atlas.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+
+#include "ovis/utils/log.hpp"
+
+namespace ovis {
+
+SkylinePacker::SkylinePacker(std::uint32_t width, std::uint32_t height) : width_(width), height_(height) {
+  assert(width > 0);
+  assert(height > 0);
+  Clear();
+}
+
+std::optional<PackedRectangle> SkylinePacker::Insert(std::uint32_t width, std::uint32_t height) {
+  if (width == 0 || height == 0 || width > width_ || height > height_) {
+    return std::nullopt;
+  }
+
+  std::optional<std::size_t> best_segment;
+  std::uint32_t best_top = std::numeric_limits<std::uint32_t>::max();
+  std::uint32_t best_segment_width = std::numeric_limits<std::uint32_t>::max();
+  std::uint32_t best_y = 0;
+  for (std::size_t i = 0; i < skyline_.size(); ++i) {
+    const std::optional<std::uint32_t> y = Fit(i, width, height);
+    if (!y.has_value()) {
+      continue;
+    }
+
+    // Prefer the lowest position and break ties with the narrowest segment to leave wide gaps for wide rectangles
+    const std::uint32_t top = *y + height;
+    if (top < best_top || (top == best_top && skyline_[i].width < best_segment_width)) {
+      best_segment = i;
+      best_top = top;
+      best_segment_width = skyline_[i].width;
+      best_y = *y;
+    }
+  }
+
+  if (!best_segment.has_value()) {
+    return std::nullopt;
+  }
+
+  const std::uint32_t x = skyline_[*best_segment].x;
+  AddRectangle(*best_segment, x, best_y, width, height);
+  used_area_ += static_cast<std::uint64_t>(width) * height;
+  return PackedRectangle{.x = x, .y = best_y};
+}
+
+void SkylinePacker::Clear() {
+  skyline_.clear();
+  skyline_.push_back({.x = 0, .y = 0, .width = width_});
+  used_area_ = 0;
+}
+
+std::optional<std::uint32_t> SkylinePacker::Fit(std::size_t segment_index, std::uint32_t width,
+                                                std::uint32_t height) const {
+  if (skyline_[segment_index].x + width > width_) {
+    return std::nullopt;
+  }
+
+  // The rectangle rests on the highest segment it spans
+  std::uint32_t y = 0;
+  std::uint32_t remaining_width = width;
+  for (std::size_t i = segment_index; remaining_width > 0; ++i) {
+    assert(i < skyline_.size());
+    y = std::max(y, skyline_[i].y);
+    if (y + height > height_) {
+      return std::nullopt;
+    }
+    remaining_width -= std::min(remaining_width, skyline_[i].width);
+  }
+  return y;
+}
+
+void SkylinePacker::AddRectangle(std::size_t segment_index, std::uint32_t x, std::uint32_t y, std::uint32_t width,
+                                 std::uint32_t height) {
+  skyline_.insert(skyline_.begin() + segment_index, {.x = x, .y = y + height, .width = width});
+
+  // Cut the segments that are now covered by the rectangle
+  const std::uint32_t right = x + width;
+  const std::size_t first_covered = segment_index + 1;
+  std::size_t last_covered = first_covered;
+  while (last_covered < skyline_.size() && skyline_[last_covered].x + skyline_[last_covered].width <= right) {
+    ++last_covered;
+  }
+  skyline_.erase(skyline_.begin() + first_covered, skyline_.begin() + last_covered);
+  if (first_covered < skyline_.size() && skyline_[first_covered].x < right) {
+    Segment& partially_covered = skyline_[first_covered];
+    partially_covered.width -= right - partially_covered.x;
+    partially_covered.x = right;
+  }
+
+  // Merge neighbouring segments at the same height
+  for (std::size_t i = segment_index > 0 ? segment_index - 1 : 0; i + 1 < skyline_.size() && i <= segment_index + 1;) {
+    if (skyline_[i].y == skyline_[i + 1].y) {
+      skyline_[i].width += skyline_[i + 1].width;
+      skyline_.erase(skyline_.begin() + i + 1);
+    } else {
+      ++i;
+    }
+  }
+}
+
+std::vector<std::optional<PackedRectangle>> PackRectangles(std::span<const RectangleSize> sizes,
+                                                           std::uint32_t page_width, std::uint32_t page_height) {
+  std::vector<std::size_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [sizes](std::size_t lhs, std::size_t rhs) {
+    return sizes[lhs].height != sizes[rhs].height ? sizes[lhs].height > sizes[rhs].height
+                                                  : sizes[lhs].width > sizes[rhs].width;
+  });
+
+  std::vector<std::optional<PackedRectangle>> packed_rectangles(sizes.size());
+  std::vector<SkylinePacker> pages;
+  for (const std::size_t index : order) {
+    const RectangleSize size = sizes[index];
+    if (size.width > page_width || size.height > page_height) {
+      continue;
+    }
+
+    for (std::uint32_t page = 0; !packed_rectangles[index].has_value(); ++page) {
+      if (page == pages.size()) {
+        pages.emplace_back(page_width, page_height);
+      }
+      packed_rectangles[index] = pages[page].Insert(size.width, size.height);
+      if (packed_rectangles[index].has_value()) {
+        packed_rectangles[index]->page = page;
+      }
+    }
+  }
+
+  return packed_rectangles;
+}
+
+TextureAtlas::TextureAtlas(GraphicsContext* context, const TextureAtlasDescription& description)
+    : context_(context), description_(description) {
+  assert(context != nullptr);
+}
+
+std::optional<TextureAtlasRegion> TextureAtlas::Add(std::uint32_t width, std::uint32_t height,
+                                                    const void* rgba_pixels) {
+  const std::uint32_t padding = description_.padding;
+  const std::uint32_t padded_width = width + 2 * padding;
+  const std::uint32_t padded_height = height + 2 * padding;
+  if (width == 0 || height == 0 || padded_width > description_.page_width ||
+      padded_height > description_.page_height) {
+    return std::nullopt;
+  }
+
+  std::optional<PackedRectangle> packed_rectangle;
+  std::size_t page_index = 0;
+  for (; page_index < pages_.size() && !packed_rectangle.has_value(); ++page_index) {
+    packed_rectangle = pages_[page_index].packer.Insert(padded_width, padded_height);
+  }
+  if (packed_rectangle.has_value()) {
+    --page_index;
+  } else {
+    LogV("Creating texture atlas page {}", pages_.size());
+    const Texture2DDescription page_description = {
+        .width = description_.page_width,
+        .height = description_.page_height,
+        .mip_map_count = 1,
+        .format = TextureFormat::RGBA_UINT8,
+        .filter = description_.filter,
+    };
+    pages_.push_back({
+        .texture = std::make_unique<Texture2D>(context_, page_description),
+        .packer = SkylinePacker(description_.page_width, description_.page_height),
+    });
+    page_index = pages_.size() - 1;
+    packed_rectangle = pages_.back().packer.Insert(padded_width, padded_height);
+    assert(packed_rectangle.has_value());
+  }
+
+  // Repeat the edge pixels into the padding
+  const std::uint32_t* pixels = static_cast<const std::uint32_t*>(rgba_pixels);
+  padded_pixels_.resize(static_cast<std::size_t>(padded_width) * padded_height);
+  for (std::uint32_t y = 0; y < padded_height; ++y) {
+    const std::uint32_t source_y = std::clamp<std::int64_t>(static_cast<std::int64_t>(y) - padding, 0, height - 1);
+    for (std::uint32_t x = 0; x < padded_width; ++x) {
+      const std::uint32_t source_x = std::clamp<std::int64_t>(static_cast<std::int64_t>(x) - padding, 0, width - 1);
+      padded_pixels_[y * padded_width + x] = pixels[source_y * width + source_x];
+    }
+  }
+  Texture2D* texture = pages_[page_index].texture.get();
+  texture->Write(0, packed_rectangle->x, packed_rectangle->y, padded_width, padded_height, padded_pixels_.data());
+
+  const float page_width = static_cast<float>(description_.page_width);
+  const float page_height = static_cast<float>(description_.page_height);
+  const std::uint32_t x = packed_rectangle->x + padding;
+  const std::uint32_t y = packed_rectangle->y + padding;
+  return TextureAtlasRegion{
+      .texture = texture,
+      .texture_rect = {x / page_width, y / page_height, (x + width) / page_width, (y + height) / page_height},
+  };
+}
+
+}  // namespace ovis
@@ -0,0 +1,67 @@
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/rendering2d/font_atlas.hpp"
+#include "ovis/test/test_window.hpp"
+
+using namespace ovis;
+
+TEST_CASE("Font atlas renders glyphs on demand", "[ovis][rendering2d][FontAtlas]") {
+  ovis::test::TestWindow window;
+
+  std::unique_ptr<FontAtlas> font_atlas = LoadFontAtlas(&window.graphics_context, "NotoSans-Regular");
+  REQUIRE(font_atlas != nullptr);
+  REQUIRE(font_atlas->texture()->description().format == TextureFormat::R_UINT8);
+  REQUIRE(font_atlas->occupied_cell_count() == 0);
+
+  SECTION("Glyphs without an outline do not occupy a cell") {
+    for (const char32_t codepoint : {U'H', U'ä', U' ', U'l'}) {
+      font_atlas->PrepareGlyph(codepoint);
+    }
+    REQUIRE(font_atlas->occupied_cell_count() == 3);
+    REQUIRE(font_atlas->FindGlyphQuad(U'ä') != nullptr);
+    REQUIRE(font_atlas->FindGlyphQuad(U' ') == nullptr);
+    REQUIRE(font_atlas->FindGlyphQuad(U'x') == nullptr);
+
+    // The quad includes the padding of the distance field
+    const FontAtlas::GlyphMetrics& metrics = font_atlas->GetGlyphMetrics(U'H');
+    const FontAtlas::GlyphQuad* quad = font_atlas->FindGlyphQuad(U'H');
+    REQUIRE(quad->min.x < metrics.outline_min.x);
+    REQUIRE(quad->min.y < metrics.outline_min.y);
+    REQUIRE(quad->max.x > metrics.outline_max.x);
+    REQUIRE(quad->max.y > metrics.outline_max.y);
+  }
+
+  SECTION("The least recently used glyphs are replaced") {
+    font_atlas->PrepareGlyph(U'A');
+    font_atlas->BeginFrame();
+
+    // More glyphs than there are cells, so all cells are used in the current frame afterwards. Only glyphs with an
+    // outline occupy a cell, so the codepoints are checked against the font first.
+    std::vector<char32_t> codepoints;
+    for (char32_t codepoint = 0xa1; codepoint < 0x10000 && codepoints.size() < FontAtlas::CELL_COUNT + 16;
+         ++codepoint) {
+      if (font_atlas->GetGlyphMetrics(codepoint).has_outline) {
+        codepoints.push_back(codepoint);
+      }
+    }
+    REQUIRE(codepoints.size() == FontAtlas::CELL_COUNT + 16);
+
+    const std::uint32_t generation = font_atlas->generation();
+    for (const char32_t codepoint : codepoints) {
+      font_atlas->PrepareGlyph(codepoint);
+    }
+    REQUIRE(font_atlas->occupied_cell_count() == FontAtlas::CELL_COUNT);
+    REQUIRE(font_atlas->FindGlyphQuad(U'A') == nullptr);
+    REQUIRE(font_atlas->generation() != generation);
+
+    // No glyph of the current frame is replaced
+    font_atlas->PrepareGlyph(U'A');
+    REQUIRE(font_atlas->FindGlyphQuad(U'A') == nullptr);
+
+    font_atlas->BeginFrame();
+    font_atlas->PrepareGlyph(U'A');
+    REQUIRE(font_atlas->FindGlyphQuad(U'A') != nullptr);
+  }
+}
@@ -0,0 +1,197 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/rendering2d/render_queue2d.hpp"
+#include "ovis/test/test_window.hpp"
+
+using namespace ovis;
+
+namespace {
+
+void SubmitTriangle(RenderQueue2D* queue, std::uint8_t layer, float depth, Texture2D* texture,
+                    BlendMode2D blend_mode, float x) {
+  for (auto& vertex : queue->Submit(layer, depth, texture, blend_mode, 3)) {
+    vertex = {.x = x, .y = 0.0f, .s = 0.0f, .t = 0.0f, .color = 0xffffffff};
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Sort and batch 2D draw commands", "[ovis][rendering2d][RenderQueue2D]") {
+  ovis::test::TestWindow window;
+
+  Texture2DDescription texture_description{
+      .width = 1, .height = 1, .mip_map_count = 1, .format = TextureFormat::RGBA_UINT8, .filter = TextureFilter::POINT};
+  const uint32_t white_pixel = 0xffffffff;
+  Texture2D first_texture(&window.graphics_context, texture_description, &white_pixel);
+  Texture2D second_texture(&window.graphics_context, texture_description, &white_pixel);
+
+  RenderQueue2D queue;
+
+  SECTION("Consecutive commands with the same texture are merged into one batch") {
+    for (int i = 0; i < 10; ++i) {
+      SubmitTriangle(&queue, 0, 0.0f, i < 5 ? &first_texture : &second_texture, BlendMode2D::ALPHA, i);
+    }
+    queue.Sort();
+    REQUIRE(queue.command_count() == 10);
+    REQUIRE(queue.batches().size() == 2);
+    REQUIRE(queue.batches()[0].texture == &first_texture);
+    REQUIRE(queue.batches()[0].vertex_count == 15);
+    REQUIRE(queue.batches()[1].texture == &second_texture);
+    REQUIRE(queue.batches()[1].vertex_count == 15);
+    REQUIRE(queue.batches()[1].first_vertex == 15);
+    REQUIRE(queue.sorted_vertices().size() == 30);
+  }
+
+  SECTION("Overlapping commands with the same depth keep their submission order") {
+    // The textures may overlap, so they must not be grouped by texture
+    for (int i = 0; i < 10; ++i) {
+      SubmitTriangle(&queue, 0, 0.0f, i % 2 == 0 ? &second_texture : &first_texture, BlendMode2D::ALPHA, i);
+    }
+    queue.Sort();
+    REQUIRE(queue.batches().size() == 10);
+    for (int i = 0; i < 10; ++i) {
+      REQUIRE(queue.batches()[i].texture == (i % 2 == 0 ? &second_texture : &first_texture));
+      REQUIRE(queue.sorted_vertices()[queue.batches()[i].first_vertex].x == i);
+    }
+  }
+
+  SECTION("Texts are drawn after the shape they label") {
+    // Like the renderer: the shape of an entity is submitted before its text at the same depth. The font atlas texture
+    // was created before the texture of the shape, so it has the lower id.
+    SubmitTriangle(&queue, 0, 0.0f, &second_texture, BlendMode2D::ALPHA, 0.0f);
+    for (auto& vertex : queue.Submit(0, 0.0f, &first_texture, BlendMode2D::ALPHA, 3, true)) {
+      vertex = {.x = 1.0f, .y = 0.0f, .s = 0.0f, .t = 0.0f, .color = 0xffffffff};
+    }
+    queue.Sort();
+
+    REQUIRE(queue.batches().size() == 2);
+    REQUIRE(!queue.batches()[0].is_text);
+    REQUIRE(queue.batches()[0].texture == &second_texture);
+    REQUIRE(queue.batches()[1].is_text);
+    REQUIRE(queue.sorted_vertices()[queue.batches()[1].first_vertex].x == 1.0f);
+  }
+
+  SECTION("Commands are sorted by their layer and depth") {
+    SubmitTriangle(&queue, 1, 0.0f, &first_texture, BlendMode2D::ALPHA, 0.0f);
+    SubmitTriangle(&queue, 0, -1.0f, &first_texture, BlendMode2D::ALPHA, 1.0f);
+    SubmitTriangle(&queue, 0, 2.0f, &second_texture, BlendMode2D::ALPHA, 2.0f);
+    SubmitTriangle(&queue, 0, 2.0f, &first_texture, BlendMode2D::ADDITIVE, 3.0f);
+    queue.Sort();
+
+    // The last two commands end up next to each other and use the same state, so they form one batch
+    REQUIRE(queue.batches().size() == 3);
+    REQUIRE(queue.batches()[2].vertex_count == 6);
+    REQUIRE(queue.sorted_vertices()[0].x == 2.0f);
+    REQUIRE(queue.batches()[0].blend_mode == BlendMode2D::ALPHA);
+    REQUIRE(queue.sorted_vertices()[3].x == 3.0f);
+    REQUIRE(queue.batches()[1].blend_mode == BlendMode2D::ADDITIVE);
+    REQUIRE(queue.sorted_vertices()[6].x == 1.0f);
+    REQUIRE(queue.sorted_vertices()[9].x == 0.0f);
+  }
+
+  SECTION("Texts are batched separately from shapes") {
+    SubmitTriangle(&queue, 0, 0.0f, &first_texture, BlendMode2D::ALPHA, 0.0f);
+    for (auto& vertex : queue.Submit(0, 0.0f, &first_texture, BlendMode2D::ALPHA, 3, true)) {
+      vertex = {.x = 1.0f, .y = 0.0f, .s = 0.0f, .t = 0.0f, .color = 0xffffffff};
+    }
+    queue.Sort();
+
+    REQUIRE(queue.batches().size() == 2);
+    REQUIRE(!queue.batches()[0].is_text);
+    REQUIRE(queue.batches()[1].is_text);
+    REQUIRE(queue.sorted_vertices()[queue.batches()[1].first_vertex].x == 1.0f);
+  }
+
+  SECTION("Instances are batched separately from triangles") {
+    SubmitTriangle(&queue, 0, 1.0f, &first_texture, BlendMode2D::ALPHA, 0.0f);
+    SubmitTriangle(&queue, 0, 1.0f, &first_texture, BlendMode2D::ALPHA, 1.0f);
+    queue.SubmitInstance(0, 1.0f, &first_texture, BlendMode2D::ALPHA, 0).size[0] = 1.0f;
+    queue.SubmitInstance(0, 1.0f, &first_texture, BlendMode2D::ALPHA, 0).size[0] = 2.0f;
+    queue.SubmitInstance(0, 0.0f, &first_texture, BlendMode2D::ALPHA, 0).size[0] = 3.0f;
+    queue.Sort();
+
+    REQUIRE(queue.batches().size() == 2);
+    REQUIRE(!queue.batches()[0].instanced);
+    REQUIRE(queue.batches()[0].vertex_count == 6);
+    REQUIRE(queue.batches()[1].instanced);
+    REQUIRE(queue.batches()[1].instance_count == 3);
+    REQUIRE(queue.sorted_instances().size() == 3);
+    REQUIRE(queue.sorted_instances()[0].size[0] == 1.0f);
+    REQUIRE(queue.sorted_instances()[1].size[0] == 2.0f);
+    REQUIRE(queue.sorted_instances()[2].size[0] == 3.0f);
+  }
+
+  SECTION("Instances and triangles with the same depth keep their submission order") {
+    // Like a text on the triangle path that labels an instanced rectangle and a rectangle drawn over that text
+    queue.SubmitInstance(0, 0.0f, &first_texture, BlendMode2D::ALPHA, 0).size[0] = 1.0f;
+    for (auto& vertex : queue.Submit(0, 0.0f, &second_texture, BlendMode2D::ALPHA, 3, true)) {
+      vertex = {.x = 2.0f, .y = 0.0f, .s = 0.0f, .t = 0.0f, .color = 0xffffffff};
+    }
+    queue.SubmitInstance(0, 0.0f, &first_texture, BlendMode2D::ALPHA, 0).size[0] = 3.0f;
+    queue.Sort();
+
+    REQUIRE(queue.batches().size() == 3);
+    REQUIRE(queue.batches()[0].instanced);
+    REQUIRE(queue.batches()[0].first_instance == 0);
+    REQUIRE(!queue.batches()[1].instanced);
+    REQUIRE(queue.batches()[1].is_text);
+    REQUIRE(queue.batches()[2].instanced);
+    REQUIRE(queue.batches()[2].first_instance == 1);
+    REQUIRE(queue.sorted_instances()[0].size[0] == 1.0f);
+    REQUIRE(queue.sorted_instances()[1].size[0] == 3.0f);
+  }
+
+  SECTION("Instances of different meshes with the same depth keep their submission order") {
+    for (int i = 0; i < 6; ++i) {
+      queue.SubmitInstance(0, 0.0f, &first_texture, BlendMode2D::ALPHA, i < 4 ? i / 2 : 0).size[0] = i;
+    }
+    queue.Sort();
+
+    // Meshes 0, 0, 1, 1, 0, 0
+    REQUIRE(queue.batches().size() == 3);
+    REQUIRE(queue.batches()[0].mesh == 0);
+    REQUIRE(queue.batches()[1].mesh == 1);
+    REQUIRE(queue.batches()[2].mesh == 0);
+    for (int i = 0; i < 3; ++i) {
+      REQUIRE(queue.batches()[i].instance_count == 2);
+    }
+    for (int i = 0; i < 6; ++i) {
+      REQUIRE(queue.sorted_instances()[i].size[0] == i);
+    }
+  }
+
+  SECTION("Appended queues keep the submission order") {
+    RenderQueue2D second_queue;
+    SubmitTriangle(&queue, 0, 0.0f, &first_texture, BlendMode2D::ALPHA, 1.0f);
+    queue.SubmitInstance(0, 0.0f, &first_texture, BlendMode2D::ALPHA, 0).size[0] = 1.0f;
+    SubmitTriangle(&second_queue, 0, 0.0f, &first_texture, BlendMode2D::ALPHA, 2.0f);
+    second_queue.SubmitInstance(0, 0.0f, &first_texture, BlendMode2D::ALPHA, 0).size[0] = 2.0f;
+
+    RenderQueue2D appended_queue;
+    appended_queue.Append(queue);
+    appended_queue.Append(second_queue);
+    appended_queue.Sort();
+
+    REQUIRE(appended_queue.command_count() == 4);
+    // Triangles and instances alternate, so none of them can be merged
+    REQUIRE(appended_queue.batches().size() == 4);
+    REQUIRE(!appended_queue.batches()[0].instanced);
+    REQUIRE(appended_queue.batches()[1].instanced);
+    REQUIRE(!appended_queue.batches()[2].instanced);
+    REQUIRE(appended_queue.batches()[3].instanced);
+    REQUIRE(appended_queue.sorted_vertices().size() == 6);
+    REQUIRE(appended_queue.sorted_vertices()[0].x == 1.0f);
+    REQUIRE(appended_queue.sorted_vertices()[3].x == 2.0f);
+    REQUIRE(appended_queue.sorted_instances().size() == 2);
+    REQUIRE(appended_queue.sorted_instances()[0].size[0] == 1.0f);
+    REQUIRE(appended_queue.sorted_instances()[1].size[0] == 2.0f);
+  }
+
+  SECTION("Clearing the queue removes all commands") {
+    SubmitTriangle(&queue, 0, 0.0f, &first_texture, BlendMode2D::ALPHA, 0.0f);
+    queue.Clear();
+    queue.Sort();
+    REQUIRE(queue.command_count() == 0);
+    REQUIRE(queue.batches().empty());
+  }
+}
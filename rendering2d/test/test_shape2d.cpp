@@ -12,3 +12,30 @@ TEST_CASE("Deserialize scene object with Shape2D", "[ovis][rendering2d][Shape2d]
   )"_json;
   REQUIRE(shape.color() == Color(0.5, 1.0, 0.5, 1.0));
 }
+
+TEST_CASE("Shapes with the same parameters share their geometry", "[ovis][rendering2d][Shape2d]") {
+  Shape2D first;
+  first.SetEllipse({.size = {2.0f, 1.0f}, .num_segments = 16});
+  Shape2D second;
+  second.SetEllipse({.size = {2.0f, 1.0f}, .num_segments = 16});
+  REQUIRE(first.geometry() != nullptr);
+  REQUIRE(first.geometry() == second.geometry());
+
+  const std::uint64_t version = second.version();
+  second.SetOutlineWidth(0.1f);
+  REQUIRE(second.version() != version);
+  REQUIRE(first.geometry() != second.geometry());
+  REQUIRE(first.geometry()->id != second.geometry()->id);
+}
+
+TEST_CASE("Texture asset names are interned", "[ovis][rendering2d][Shape2d]") {
+  Shape2D shape;
+  REQUIRE(shape.texture_asset_id() == 0);
+
+  const std::uint64_t version = shape.version();
+  shape.SetTexture("test_texture");
+  REQUIRE(shape.version() != version);
+  REQUIRE(shape.texture_asset_id() == InternTextureAsset("test_texture"));
+  REQUIRE(GetTextureAssetName(shape.texture_asset_id()) == "test_texture");
+  REQUIRE(InternTextureAsset("") == 0);
+}
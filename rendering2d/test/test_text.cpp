@@ -0,0 +1,29 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/rendering2d/text.hpp"
+
+using namespace ovis;
+
+TEST_CASE("Deserialize scene object with Text", "[ovis][rendering2d][Text]") {
+  Text text = R"(
+  {
+    "text": "Hello",
+    "maxWidth": 10,
+    "alignment": "center"
+  }
+  )"_json;
+  REQUIRE(text.text == "Hello");
+  REQUIRE(text.max_width == 10.0f);
+  REQUIRE(text.alignment == TextAlignment::CENTER);
+  REQUIRE(text.size == 32.0f);
+}
+
+TEST_CASE("Serialize Text", "[ovis][rendering2d][Text]") {
+  const Text text = {.text = "Hello", .font = "font", .size = 12.0f, .alignment = TextAlignment::RIGHT};
+  const Text deserialized = json(text);
+  REQUIRE(deserialized.text == "Hello");
+  REQUIRE(deserialized.font == "font");
+  REQUIRE(deserialized.size == 12.0f);
+  REQUIRE(deserialized.max_width == 0.0f);
+  REQUIRE(deserialized.alignment == TextAlignment::RIGHT);
+}
@@ -0,0 +1,86 @@
+#include "catch2/catch_approx.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/rendering2d/font_atlas.hpp"
+#include "ovis/rendering2d/text_layout.hpp"
+#include "ovis/test/test_window.hpp"
+
+using namespace ovis;
+
+TEST_CASE("Lay out texts", "[ovis][rendering2d][LayoutText]") {
+  ovis::test::TestWindow window;
+
+  std::unique_ptr<FontAtlas> font_atlas = LoadFontAtlas(&window.graphics_context, "NotoSans-Regular");
+  REQUIRE(font_atlas != nullptr);
+
+  TextLayout layout;
+
+  SECTION("Spaces are not part of the glyphs") {
+    LayoutText(font_atlas.get(), "Hello World", {}, &layout);
+    REQUIRE(layout.glyphs.size() == 10);
+    REQUIRE(layout.line_count == 1);
+    REQUIRE(layout.glyphs[0].codepoint == U'H');
+    REQUIRE(layout.glyphs[0].position.x == 0.0f);
+    REQUIRE(layout.glyphs[5].codepoint == U'W');
+    REQUIRE(layout.glyphs[5].position.x > layout.glyphs[4].position.x);
+  }
+
+  SECTION("Lines are separated by line breaks") {
+    LayoutText(font_atlas.get(), "Hello\nWorld", {}, &layout);
+    REQUIRE(layout.line_count == 2);
+    REQUIRE(layout.glyphs[5].position.x == 0.0f);
+    REQUIRE(layout.glyphs[5].position.y == Catch::Approx(-font_atlas->line_height() * 32.0f));
+  }
+
+  SECTION("Lines are broken at spaces to fit the maximum width") {
+    LayoutText(font_atlas.get(), "Hello World", {}, &layout);
+    const float width = layout.bounds.max().x;
+
+    TextLayoutOptions options;
+    options.max_width = width * 0.75f;
+    LayoutText(font_atlas.get(), "Hello World", options, &layout);
+    REQUIRE(layout.line_count == 2);
+    REQUIRE(layout.bounds.max().x <= options.max_width);
+    REQUIRE(layout.glyphs[5].position.x == Catch::Approx(0.0f).margin(1.0f));
+
+    // Words that are wider than the maximum width are kept on one line
+    options.max_width = 1.0f;
+    LayoutText(font_atlas.get(), "Hello", options, &layout);
+    REQUIRE(layout.line_count == 1);
+  }
+
+  SECTION("Lines are aligned around the origin") {
+    TextLayoutOptions options;
+    options.alignment = TextAlignment::CENTER;
+    LayoutText(font_atlas.get(), "Hello", options, &layout);
+    REQUIRE(layout.bounds.center.x == Catch::Approx(0.0f).margin(2.0f));
+
+    options.alignment = TextAlignment::RIGHT;
+    LayoutText(font_atlas.get(), "Hello", options, &layout);
+    REQUIRE(layout.bounds.max().x <= 0.5f);
+    REQUIRE(layout.bounds.min().x < 0.0f);
+  }
+
+  SECTION("The layout scales with the size") {
+    TextLayoutOptions options;
+    options.size = 16.0f;
+    LayoutText(font_atlas.get(), "Hello", options, &layout);
+    const Vector2 half_extend = layout.bounds.half_extend;
+
+    options.size = 32.0f;
+    LayoutText(font_atlas.get(), "Hello", options, &layout);
+    REQUIRE(layout.bounds.half_extend.x == Catch::Approx(half_extend.x * 2.0f));
+    REQUIRE(layout.bounds.half_extend.y == Catch::Approx(half_extend.y * 2.0f));
+  }
+
+  SECTION("Vertices are generated for the glyphs in the atlas") {
+    LayoutText(font_atlas.get(), "Hello World", {}, &layout);
+    std::vector<Shape2D::Vertex> vertices;
+    GenerateTextVertices(*font_atlas, layout, Color::White(), &vertices);
+    REQUIRE(vertices.empty());
+
+    PrepareGlyphs(font_atlas.get(), layout);
+    GenerateTextVertices(*font_atlas, layout, Color::White(), &vertices);
+    REQUIRE(vertices.size() == 10 * 6);
+  }
+}
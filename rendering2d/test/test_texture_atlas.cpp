@@ -0,0 +1,101 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/rendering2d/texture_atlas.hpp"
+#include "ovis/test/test_window.hpp"
+
+using namespace ovis;
+
+namespace {
+
+bool Overlap(const PackedRectangle& first, RectangleSize first_size, const PackedRectangle& second,
+             RectangleSize second_size) {
+  return first.page == second.page && first.x < second.x + second_size.width &&
+         second.x < first.x + first_size.width && first.y < second.y + second_size.height &&
+         second.y < first.y + first_size.height;
+}
+
+}  // namespace
+
+TEST_CASE("Pack rectangles with a skyline", "[ovis][rendering2d][SkylinePacker]") {
+  SkylinePacker packer(64, 64);
+
+  SECTION("Rectangles do not overlap and stay inside the page") {
+    std::vector<RectangleSize> sizes;
+    std::vector<PackedRectangle> packed_rectangles;
+    for (std::uint32_t i = 0; i < 32; ++i) {
+      const RectangleSize size = {.width = 4 + i % 7, .height = 3 + i % 5};
+      const auto packed_rectangle = packer.Insert(size.width, size.height);
+      REQUIRE(packed_rectangle.has_value());
+      REQUIRE(packed_rectangle->x + size.width <= 64);
+      REQUIRE(packed_rectangle->y + size.height <= 64);
+      sizes.push_back(size);
+      packed_rectangles.push_back(*packed_rectangle);
+    }
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+      for (std::size_t j = i + 1; j < sizes.size(); ++j) {
+        REQUIRE(!Overlap(packed_rectangles[i], sizes[i], packed_rectangles[j], sizes[j]));
+      }
+    }
+  }
+
+  SECTION("A full page rejects further rectangles") {
+    for (int i = 0; i < 16; ++i) {
+      REQUIRE(packer.Insert(16, 16).has_value());
+    }
+    REQUIRE(packer.occupancy() == 1.0f);
+    REQUIRE(!packer.Insert(1, 1).has_value());
+
+    packer.Clear();
+    REQUIRE(packer.Insert(64, 64).has_value());
+  }
+
+  SECTION("Rectangles larger than the page are rejected") {
+    REQUIRE(!packer.Insert(65, 1).has_value());
+    REQUIRE(!packer.Insert(1, 65).has_value());
+  }
+}
+
+TEST_CASE("Pack rectangles into multiple pages", "[ovis][rendering2d][SkylinePacker]") {
+  const std::vector<RectangleSize> sizes = {{32, 32}, {64, 64}, {32, 32}, {16, 8}, {128, 1}};
+  const auto packed_rectangles = PackRectangles(sizes, 64, 64);
+
+  REQUIRE(packed_rectangles.size() == sizes.size());
+  REQUIRE(!packed_rectangles[4].has_value());
+  for (std::size_t i = 0; i < 4; ++i) {
+    REQUIRE(packed_rectangles[i].has_value());
+    for (std::size_t j = i + 1; j < 4; ++j) {
+      REQUIRE(!Overlap(*packed_rectangles[i], sizes[i], *packed_rectangles[j], sizes[j]));
+    }
+  }
+  // The largest rectangle is packed first and fills the first page
+  REQUIRE(packed_rectangles[1]->page == 0);
+  REQUIRE(packed_rectangles[0]->page == 1);
+}
+
+TEST_CASE("Add images to a texture atlas", "[ovis][rendering2d][TextureAtlas]") {
+  ovis::test::TestWindow window;
+  TextureAtlas atlas(&window.graphics_context, {.page_width = 16, .page_height = 16, .padding = 1});
+
+  const std::uint32_t pixels[4] = {0xff0000ff, 0xff00ff00, 0xffff0000, 0xffffffff};
+  const auto first_region = atlas.Add(2, 2, pixels);
+  REQUIRE(first_region.has_value());
+  REQUIRE(first_region->texture_rect[0] == 1.0f / 16.0f);
+  REQUIRE(first_region->texture_rect[1] == 1.0f / 16.0f);
+  REQUIRE(first_region->texture_rect[2] == 3.0f / 16.0f);
+  REQUIRE(first_region->texture_rect[3] == 3.0f / 16.0f);
+
+  const auto second_region = atlas.Add(2, 2, pixels);
+  REQUIRE(second_region.has_value());
+  REQUIRE(second_region->texture == first_region->texture);
+  REQUIRE(atlas.page_count() == 1);
+
+  // Does not fit into the remaining space of the first page
+  const std::uint32_t large_pixels[14 * 14] = {};
+  const auto third_region = atlas.Add(14, 14, large_pixels);
+  REQUIRE(third_region.has_value());
+  REQUIRE(third_region->texture != first_region->texture);
+  REQUIRE(atlas.page_count() == 2);
+
+  // Does not fit into a page with its padding
+  REQUIRE(!atlas.Add(15, 1, large_pixels).has_value());
+}
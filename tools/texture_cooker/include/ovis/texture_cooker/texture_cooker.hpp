@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "ovis/utils/file.hpp"
+#include "ovis/utils/result.hpp"
+#include "ovis/graphics/texture.hpp"
+
+namespace ovis {
+
+struct TextureCookerOptions {
+  // RGB_UINT8, RGBA_UINT8, RGB_BC1 or RGBA_BC3
+  TextureFormat format = TextureFormat::RGBA_BC3;
+  TextureFilter filter = TextureFilter::TRILINEAR;
+  bool generate_mip_maps = true;
+};
+
+// Halves the size of a level of RGBA_UINT8 pixels with a box filter. The color channels are averaged in linear space,
+// as averaging the sRGB values darkens the smaller levels.
+Blob DownsampleTextureLevel(std::size_t width, std::size_t height, std::span<const std::byte> rgba_pixels);
+
+// Converts an image of RGBA_UINT8 pixels into the files of a texture2d asset: the "json" file with the description and
+// one file per mip map level, named "0", "1", etc. The files can be passed to AssetLibrary::CreateAsset().
+Result<std::vector<std::pair<std::string, std::variant<std::string, Blob>>>> CookTexture(
+    std::size_t width, std::size_t height, std::span<const std::byte> rgba_pixels,
+    const TextureCookerOptions& options);
+
+}  // namespace ovis
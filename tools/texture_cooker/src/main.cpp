@@ -0,0 +1,108 @@
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "stb_image.h"
+
+#include "ovis/utils/log.hpp"
+#include "ovis/core/asset_library.hpp"
+#include "ovis/texture_cooker/texture_cooker.hpp"
+
+namespace {
+
+void PrintUsage() {
+  ovis::LogI(
+      "Usage: ovis-texture-cooker [options] image asset_directory asset_id\n"
+      "Options:\n"
+      "  --format rgb|rgba|bc1|bc3  Format of the texture (default: bc3)\n"
+      "  --filter point|bilinear|trilinear  Filter of the texture (default: trilinear)\n"
+      "  --no-mip-maps  Only store the first level, requires point or bilinear filtering");
+}
+
+}  // namespace
+
+// Converts an image into a texture2d asset with a precomputed mip chain in a block compressed format, so the engine
+// can upload it without converting or generating anything at runtime. An existing asset with the same id is replaced.
+int main(int argc, char* argv[]) {
+  using namespace ovis;
+
+  Log::AddListener(ConsoleLogger);
+
+  TextureCookerOptions options;
+  int argument_index = 1;
+  for (; argument_index < argc && std::strncmp(argv[argument_index], "--", 2) == 0; ++argument_index) {
+    const std::string_view option = argv[argument_index];
+    const std::string_view value = argument_index + 1 < argc ? argv[argument_index + 1] : "";
+    if (option == "--format") {
+      if (value == "rgb") {
+        options.format = TextureFormat::RGB_UINT8;
+      } else if (value == "rgba") {
+        options.format = TextureFormat::RGBA_UINT8;
+      } else if (value == "bc1") {
+        options.format = TextureFormat::RGB_BC1;
+      } else if (value == "bc3") {
+        options.format = TextureFormat::RGBA_BC3;
+      } else {
+        LogE("Invalid format: {}", value);
+        return -1;
+      }
+      ++argument_index;
+    } else if (option == "--filter") {
+      if (value == "point") {
+        options.filter = TextureFilter::POINT;
+      } else if (value == "bilinear") {
+        options.filter = TextureFilter::BILINEAR;
+      } else if (value == "trilinear") {
+        options.filter = TextureFilter::TRILINEAR;
+      } else {
+        LogE("Invalid filter: {}", value);
+        return -1;
+      }
+      ++argument_index;
+    } else if (option == "--no-mip-maps") {
+      options.generate_mip_maps = false;
+    } else {
+      LogE("Unknown option: {}", option);
+      PrintUsage();
+      return -1;
+    }
+  }
+  if (argc - argument_index != 3) {
+    PrintUsage();
+    return -1;
+  }
+  const char* image_filename = argv[argument_index];
+  const std::string_view asset_directory = argv[argument_index + 1];
+  const std::string_view asset_id = argv[argument_index + 2];
+
+  int width;
+  int height;
+  stbi_uc* pixels = stbi_load(image_filename, &width, &height, nullptr, 4);
+  if (pixels == nullptr) {
+    LogE("Failed to load image '{}': {}", image_filename, stbi_failure_reason());
+    return -1;
+  }
+  const std::span<const std::byte> rgba_pixels(reinterpret_cast<const std::byte*>(pixels),
+                                               static_cast<std::size_t>(width) * height * 4);
+  auto files = CookTexture(width, height, rgba_pixels, options);
+  stbi_image_free(pixels);
+  if (!files) {
+    LogE("Failed to cook texture '{}': {}", image_filename, files.error().message);
+    return -1;
+  }
+
+  DirectoryAssetLibrary asset_library(asset_directory);
+  if (asset_library.Contains(asset_id)) {
+    if (auto result = asset_library.DeleteAsset(asset_id); !result) {
+      LogE("Failed to replace asset '{}': {}", asset_id, result.error().message);
+      return -1;
+    }
+  }
+  if (auto result = asset_library.CreateAsset(asset_id, "texture2d", *files); !result) {
+    LogE("Failed to write asset '{}': {}", asset_id, result.error().message);
+    return -1;
+  }
+
+  LogI("Cooked '{}' into '{}' ({}x{}, {} levels)", image_filename, asset_id, width, height, files->size() - 1);
+  return 0;
+}
@@ -0,0 +1,149 @@
+#include "ovis/texture_cooker/texture_cooker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "ovis/utils/json.hpp"
+#include "ovis/graphics/texture_compression.hpp"
+
+namespace ovis {
+
+namespace {
+
+float ConvertSRGBToLinear(std::uint8_t value) {
+  const float normalized = value / 255.0f;
+  return normalized <= 0.04045f ? normalized / 12.92f : std::pow((normalized + 0.055f) / 1.055f, 2.4f);
+}
+
+std::uint8_t ConvertLinearToSRGB(float value) {
+  const float srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+  return static_cast<std::uint8_t>(std::clamp(std::lround(srgb * 255.0f), 0l, 255l));
+}
+
+const char* GetFormatName(TextureFormat format) {
+  switch (format) {
+    case TextureFormat::RGB_UINT8:
+      return "RGB_UINT8";
+    case TextureFormat::RGBA_UINT8:
+      return "RGBA_UINT8";
+    case TextureFormat::RGB_BC1:
+      return "RGB_BC1";
+    case TextureFormat::RGBA_BC3:
+      return "RGBA_BC3";
+    default:
+      return nullptr;
+  }
+}
+
+const char* GetFilterName(TextureFilter filter) {
+  switch (filter) {
+    case TextureFilter::POINT:
+      return "point";
+    case TextureFilter::BILINEAR:
+      return "bilinear";
+    case TextureFilter::TRILINEAR:
+      return "trilinear";
+  }
+  return nullptr;
+}
+
+Blob EncodeTextureLevel(TextureFormat format, std::size_t width, std::size_t height,
+                        std::span<const std::byte> rgba_pixels) {
+  switch (format) {
+    case TextureFormat::RGB_UINT8: {
+      Blob rgb_pixels(width * height * 3);
+      for (std::size_t i = 0; i < width * height; ++i) {
+        std::memcpy(&rgb_pixels[i * 3], &rgba_pixels[i * 4], 3);
+      }
+      return rgb_pixels;
+    }
+
+    case TextureFormat::RGBA_UINT8:
+      return Blob(rgba_pixels.begin(), rgba_pixels.end());
+
+    default:
+      return CompressTextureLevel(format, width, height, rgba_pixels);
+  }
+}
+
+}  // namespace
+
+Blob DownsampleTextureLevel(std::size_t width, std::size_t height, std::span<const std::byte> rgba_pixels) {
+  assert(rgba_pixels.size() == width * height * 4);
+  const std::size_t level_width = GetMipMapLevelExtent(width, 1);
+  const std::size_t level_height = GetMipMapLevelExtent(height, 1);
+  Blob level_pixels(level_width * level_height * 4);
+
+  for (std::size_t y = 0; y < level_height; ++y) {
+    for (std::size_t x = 0; x < level_width; ++x) {
+      // Odd extents repeat the last row or column
+      const std::array<std::size_t, 2> source_xs = {std::min(2 * x, width - 1), std::min(2 * x + 1, width - 1)};
+      const std::array<std::size_t, 2> source_ys = {std::min(2 * y, height - 1), std::min(2 * y + 1, height - 1)};
+      std::array<float, 4> sum = {};
+      for (const std::size_t source_y : source_ys) {
+        for (const std::size_t source_x : source_xs) {
+          const std::byte* source = &rgba_pixels[(source_y * width + source_x) * 4];
+          for (int channel = 0; channel < 3; ++channel) {
+            sum[channel] += ConvertSRGBToLinear(std::to_integer<std::uint8_t>(source[channel]));
+          }
+          sum[3] += std::to_integer<std::uint8_t>(source[3]);
+        }
+      }
+
+      std::byte* destination = &level_pixels[(y * level_width + x) * 4];
+      for (int channel = 0; channel < 3; ++channel) {
+        destination[channel] = static_cast<std::byte>(ConvertLinearToSRGB(sum[channel] / 4.0f));
+      }
+      destination[3] = static_cast<std::byte>(std::lround(sum[3] / 4.0f));
+    }
+  }
+
+  return level_pixels;
+}
+
+Result<std::vector<std::pair<std::string, std::variant<std::string, Blob>>>> CookTexture(
+    std::size_t width, std::size_t height, std::span<const std::byte> rgba_pixels,
+    const TextureCookerOptions& options) {
+  if (width == 0 || height == 0 || rgba_pixels.size() != width * height * 4) {
+    return Error("Invalid image of size {}x{} with {} bytes", width, height, rgba_pixels.size());
+  }
+  const char* format_name = GetFormatName(options.format);
+  if (format_name == nullptr) {
+    return Error("Textures cannot be cooked into format {}", static_cast<int>(options.format));
+  }
+  if (options.filter == TextureFilter::TRILINEAR && !options.generate_mip_maps) {
+    return Error("Trilinear filtering requires mip maps");
+  }
+
+  const std::size_t mip_map_count = options.generate_mip_maps ? GetCompleteMipMapCount(width, height) : 1;
+  const json description = {
+      {"width", width},
+      {"height", height},
+      {"mip_map_count", mip_map_count},
+      {"format", format_name},
+      {"filter", GetFilterName(options.filter)},
+  };
+
+  std::vector<std::pair<std::string, std::variant<std::string, Blob>>> files;
+  files.emplace_back("json", description.dump(2));
+
+  Blob level_pixels(rgba_pixels.begin(), rgba_pixels.end());
+  for (std::size_t level = 0; level < mip_map_count; ++level) {
+    const std::size_t level_width = GetMipMapLevelExtent(width, level);
+    const std::size_t level_height = GetMipMapLevelExtent(height, level);
+    if (level > 0) {
+      level_pixels = DownsampleTextureLevel(GetMipMapLevelExtent(width, level - 1),
+                                            GetMipMapLevelExtent(height, level - 1), level_pixels);
+    }
+    files.emplace_back(std::to_string(level),
+                       EncodeTextureLevel(options.format, level_width, level_height, level_pixels));
+  }
+
+  return std::move(files);
+}
+
+}  // namespace ovis
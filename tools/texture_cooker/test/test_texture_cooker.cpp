@@ -0,0 +1,105 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <variant>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/utils/json.hpp"
+#include "ovis/graphics/texture_compression.hpp"
+#include "ovis/test/require_result.hpp"
+#include "ovis/texture_cooker/texture_cooker.hpp"
+
+using namespace ovis;
+
+namespace {
+
+Blob CreateSolidImage(std::size_t width, std::size_t height, std::array<std::uint8_t, 4> color) {
+  Blob rgba_pixels(width * height * 4);
+  for (std::size_t i = 0; i < rgba_pixels.size(); ++i) {
+    rgba_pixels[i] = static_cast<std::byte>(color[i % 4]);
+  }
+  return rgba_pixels;
+}
+
+}  // namespace
+
+TEST_CASE("Downsample texture levels", "[ovis][texture_cooker]") {
+  SECTION("Odd sizes repeat the last row and column") {
+    const Blob level = DownsampleTextureLevel(5, 3, CreateSolidImage(5, 3, {10, 20, 30, 40}));
+    REQUIRE(level.size() == 2 * 1 * 4);
+    REQUIRE(level == CreateSolidImage(2, 1, {10, 20, 30, 40}));
+  }
+
+  SECTION("A single row halves the width only") {
+    const Blob level = DownsampleTextureLevel(4, 1, CreateSolidImage(4, 1, {10, 20, 30, 40}));
+    REQUIRE(level.size() == 2 * 1 * 4);
+  }
+
+  SECTION("A single pixel stays a single pixel") {
+    const Blob level = DownsampleTextureLevel(1, 1, CreateSolidImage(1, 1, {10, 20, 30, 40}));
+    REQUIRE(level == CreateSolidImage(1, 1, {10, 20, 30, 40}));
+  }
+
+  SECTION("Colors are averaged in linear space") {
+    const Blob rgba_pixels = {
+        std::byte{0},   std::byte{0},   std::byte{0},   std::byte{0},
+        std::byte{255}, std::byte{255}, std::byte{255}, std::byte{255},
+    };
+    const Blob level = DownsampleTextureLevel(2, 1, rgba_pixels);
+    REQUIRE(level.size() == 4);
+    // Half of the linear intensity is about 188 in sRGB, averaging the sRGB values would give 128
+    REQUIRE(std::to_integer<int>(level[0]) >= 185);
+    REQUIRE(std::to_integer<int>(level[0]) <= 190);
+    REQUIRE(std::to_integer<int>(level[3]) == 128);
+  }
+}
+
+TEST_CASE("Cook textures", "[ovis][texture_cooker]") {
+  for (const TextureFormat format : {TextureFormat::RGB_BC1, TextureFormat::RGBA_BC3}) {
+    // The size is not a multiple of the block size, so every level has partial blocks
+    const auto files = CookTexture(7, 5, CreateSolidImage(7, 5, {200, 100, 50, 255}), {.format = format});
+    REQUIRE_RESULT(files);
+
+    // The description and one file per level down to 1x1: 7x5, 3x2 and 1x1
+    REQUIRE(files->size() == 4);
+    REQUIRE(files->at(0).first == "json");
+    const json description = json::parse(std::get<std::string>(files->at(0).second));
+    REQUIRE(description.at("width") == 7);
+    REQUIRE(description.at("height") == 5);
+    REQUIRE(description.at("mip_map_count") == 3);
+    REQUIRE(description.at("format") == (format == TextureFormat::RGB_BC1 ? "RGB_BC1" : "RGBA_BC3"));
+
+    for (std::size_t level = 0; level < 3; ++level) {
+      REQUIRE(files->at(level + 1).first == std::to_string(level));
+      const Blob& blocks = std::get<Blob>(files->at(level + 1).second);
+      const std::size_t level_width = GetMipMapLevelExtent(7, level);
+      const std::size_t level_height = GetMipMapLevelExtent(5, level);
+      REQUIRE(blocks.size() == GetTextureLevelSize(format, level_width, level_height));
+
+      const Blob rgba_pixels = DecompressTextureLevel(format, level_width, level_height, blocks);
+      for (std::size_t i = 0; i < rgba_pixels.size(); i += 4) {
+        REQUIRE(std::abs(std::to_integer<int>(rgba_pixels[i + 0]) - 200) <= 4);
+        REQUIRE(std::abs(std::to_integer<int>(rgba_pixels[i + 1]) - 100) <= 4);
+        REQUIRE(std::abs(std::to_integer<int>(rgba_pixels[i + 2]) - 50) <= 4);
+        REQUIRE(std::to_integer<int>(rgba_pixels[i + 3]) == 255);
+      }
+    }
+  }
+
+  SECTION("A single pixel has a single level") {
+    const auto files = CookTexture(1, 1, CreateSolidImage(1, 1, {1, 2, 3, 4}), {});
+    REQUIRE_RESULT(files);
+    REQUIRE(files->size() == 2);
+    REQUIRE(std::get<Blob>(files->at(1).second).size() == 16);
+  }
+
+  SECTION("Invalid images and options are rejected") {
+    REQUIRE(!CookTexture(0, 1, {}, {}));
+    REQUIRE(!CookTexture(2, 2, CreateSolidImage(1, 1, {1, 2, 3, 4}), {}));
+    REQUIRE(!CookTexture(1, 1, CreateSolidImage(1, 1, {1, 2, 3, 4}), {.format = TextureFormat::DEPTH_FLOAT32}));
+    REQUIRE(!CookTexture(1, 1, CreateSolidImage(1, 1, {1, 2, 3, 4}), {.generate_mip_maps = false}));
+  }
+}
@@ -11,4 +11,9 @@ inline const void* OffsetAddress(const void* address, std::uintptr_t offset) {
   return reinterpret_cast<const uint8_t*>(address) + offset;
 }
 
+// Returns the number of heap allocations made by the calling thread so far. Allocations are only counted if built-in
+// profiling is enabled via the OVIS_ENABLE_BUILT_IN_PROFILING CMake option, which replaces the global operator new.
+// Otherwise, this always returns 0.
+std::uint64_t GetThreadAllocationCount();
+
 }  // namespace ovis
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+
+#include <ovis/utils/class.hpp>
+#include <ovis/utils/file.hpp>
+#include <ovis/utils/result.hpp>
+
+namespace ovis {
+
+// Maps a file read-only into memory, so its contents are only read from the disk when they are accessed and are shared
+// with the page cache instead of being copied. On platforms without mmap() the whole file is read instead.
+class MemoryMappedFile {
+  MAKE_NON_COPY_OR_MOVABLE(MemoryMappedFile);
+
+ public:
+  ~MemoryMappedFile();
+
+  static Result<std::unique_ptr<MemoryMappedFile>> Open(const std::string& filename);
+
+  std::span<const std::byte> data() const { return {data_, size_}; }
+  std::size_t size() const { return size_; }
+
+ private:
+  MemoryMappedFile() = default;
+
+  const std::byte* data_ = nullptr;
+  std::size_t size_ = 0;
+#if _WIN32
+  Blob contents_;
+#endif
+};
+
+}  // namespace ovis
@@ -27,16 +27,18 @@ class ProfilingLog final {
 
   static ProfilingLog* default_log();
 
+  // Writes a measurement that is not made by a profiler, e.g., a summary of several frames
+  void Write(std::uint64_t frame_id, const std::string& profiler_id, double measurement_value, const std::string& unit);
+  void Write(const std::string& profiler_id, double measurement_value, const std::string& unit);
+
  private:
-  std::uint64_t current_frame_id_;
+  std::uint64_t current_frame_id_ = 0;
   std::ofstream profiling_log_;
   std::vector<Profiler*> profilers_;
   char delimiter_;
 
   void AddProfiler(Profiler* profiler);
   void RemoveProfiler(Profiler* profiler);
-  void Write(std::uint64_t frame_id, const std::string& profiler_id, double measurement_value, const std::string& unit);
-  void Write(const std::string& profiler_id, double measurement_value, const std::string& unit);
 };
 
 class Profiler {
@@ -52,6 +54,8 @@ class Profiler {
   void ExtractLastMeasurements(double* buffer, size_t buffer_size, size_t* extracted_value_count);
 
  protected:
+  inline ProfilingLog* profiling_log() const { return profiling_log_; }
+
   void AddMeasurement(std::uint64_t frame_id, double measurement);
   void AddMeasurement(double measurement);
 
@@ -89,4 +93,24 @@ class CPUTimeProfiler : public Profiler {
   bool measurement_started_ = false;
 };
 
+// Counts how often something happens per frame, e.g., the number of draw calls. The count of a frame is added as a
+// measurement as soon as something is counted in a later frame.
+class CounterProfiler : public Profiler {
+ public:
+  CounterProfiler(const std::string& id);
+
+  inline void Count(std::uint64_t count = 1) {
+    if (profiling_log()->current_frame() != frame_id_) {
+      AddMeasurement(frame_id_, count_);
+      frame_id_ = profiling_log()->current_frame();
+      count_ = 0;
+    }
+    count_ += count;
+  }
+
+ private:
+  std::uint64_t frame_id_;
+  std::uint64_t count_ = 0;
+};
+
 }  // namespace ovis
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ovis {
+
+// A fixed number of worker threads that execute tasks in the order they were submitted. A pool without any threads
+// executes every task immediately on the calling thread, which is used on platforms without threads, e.g., when
+// building for the web.
+class ThreadPool {
+ public:
+  explicit ThreadPool(std::size_t thread_count);
+  ThreadPool(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  inline std::size_t thread_count() const { return threads_.size(); }
+
+  // Executes the function on one of the worker threads. The result, or the exception thrown by the function, is
+  // available via the returned future.
+  template <typename Function>
+  std::future<std::invoke_result_t<Function>> Submit(Function&& function) {
+    using ResultType = std::invoke_result_t<Function>;
+    // std::function requires a copyable function, which std::packaged_task is not
+    auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<Function>(function));
+    std::future<ResultType> result = task->get_future();
+    Enqueue([task]() { (*task)(); });
+    return result;
+  }
+
+  // Calls function(i) for every i in [0, count) and returns once all calls have finished. The calling thread takes part
+  // in the work, so this can be called from within a task of the pool. The function must not throw.
+  void ParallelFor(std::size_t count, const std::function<void(std::size_t)>& function);
+
+ private:
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable task_available_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopping_ = false;
+
+  void Enqueue(std::function<void()> task);
+  void Run();
+};
+
+// The pool that is shared by the engine systems. It has one thread less than the hardware has cores, as the main
+// thread is expected to take part in the work.
+ThreadPool* GetDefaultThreadPool();
+
+}  // namespace ovis
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <ovis/utils/class.hpp>
+#include <ovis/utils/result.hpp>
+
+// Measures the time until the end of the current scope as a zone of the trace. The name must be a string literal or
+// live as long as the program. Zones are only recorded while a TraceWriter exists, otherwise they cost a single atomic
+// load.
+#define OVIS_TRACE_ZONE(name)                                                       \
+  static const ::ovis::TraceNameId OVIS_TRACE_CONCAT(ovis_trace_name_, __LINE__) =  \
+      ::ovis::RegisterTraceName(name);                                              \
+  const ::ovis::TraceZone OVIS_TRACE_CONCAT(ovis_trace_zone_, __LINE__)(OVIS_TRACE_CONCAT(ovis_trace_name_, __LINE__))
+
+// Like OVIS_TRACE_ZONE() for names that are only known at runtime, e.g., the id of an asset. The name expression is
+// only evaluated while tracing. The name is stored with the zone instead of being registered, so it costs a string copy
+// per zone but does not grow the name table.
+#define OVIS_TRACE_DYNAMIC_ZONE(name)                                    \
+  const ::ovis::TraceZone OVIS_TRACE_CONCAT(ovis_trace_zone_, __LINE__)( \
+      ::ovis::DynamicTraceName{}, [&]() { return std::string(name); })
+
+#define OVIS_TRACE_CONCAT_IMPL(a, b) a##b
+#define OVIS_TRACE_CONCAT(a, b) OVIS_TRACE_CONCAT_IMPL(a, b)
+
+namespace ovis {
+
+using TraceNameId = std::uint32_t;
+
+// The name id of zones created by OVIS_TRACE_DYNAMIC_ZONE(), their name is stored in the trace buffer instead
+constexpr TraceNameId DYNAMIC_TRACE_NAME = 0;
+
+// Tag for constructing a TraceZone with a dynamic name
+struct DynamicTraceName {};
+
+// Returns the id of the name, which is the same for every call with the same name. The mutex that protects the names
+// is locked, so the id should be looked up once and stored, like OVIS_TRACE_ZONE() does. Registered names are never
+// removed, so only names from a fixed set should be registered.
+TraceNameId RegisterTraceName(std::string_view name);
+std::string GetTraceName(TraceNameId id);
+
+namespace detail {
+
+extern std::atomic<bool> tracing_enabled;
+
+inline std::uint64_t GetTraceTimestamp() {
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct TraceEvent {
+  std::uint64_t begin;
+  std::uint64_t end;
+  TraceNameId name;
+  std::uint32_t depth;
+};
+
+// The zones of one thread. It is a lock-free ring buffer with the thread as the only producer and the TraceWriter as
+// the only consumer. If the writer does not keep up, new zones are dropped.
+class TraceBuffer {
+ public:
+  static constexpr std::size_t CAPACITY = 1 << 14;
+
+  explicit TraceBuffer(std::uint32_t thread_index) : thread_index_(thread_index) {}
+
+  std::uint32_t thread_index() const { return thread_index_; }
+  std::uint32_t depth() const { return depth_; }
+  std::uint64_t dropped_event_count() const { return dropped_event_count_.load(std::memory_order_relaxed); }
+
+  // Only called by the thread of the buffer. Zones named DYNAMIC_TRACE_NAME pass their name as dynamic_name.
+  std::uint32_t BeginZone() { return depth_++; }
+  void EndZone(const TraceEvent& event, std::string&& dynamic_name = {}) {
+    --depth_;
+    const std::uint64_t write_index = write_index_.load(std::memory_order_relaxed);
+    if (write_index - cached_read_index_ == CAPACITY) {
+      cached_read_index_ = read_index_.load(std::memory_order_acquire);
+      if (write_index - cached_read_index_ == CAPACITY) {
+        dropped_event_count_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+    }
+    events_[write_index % CAPACITY] = event;
+    if (event.name == DYNAMIC_TRACE_NAME) {
+      if (dynamic_names_ == nullptr) {
+        dynamic_names_ = std::make_unique<std::string[]>(CAPACITY);
+      }
+      dynamic_names_[write_index % CAPACITY] = std::move(dynamic_name);
+    }
+    write_index_.store(write_index + 1, std::memory_order_release);
+  }
+
+  // Only called by the writer. Calls function(event, dynamic_name) for every event recorded since the last call. The
+  // dynamic name is empty unless the event is named DYNAMIC_TRACE_NAME.
+  template <typename Function>
+  void ConsumeEvents(Function&& function) {
+    const std::uint64_t read_index = read_index_.load(std::memory_order_relaxed);
+    const std::uint64_t write_index = write_index_.load(std::memory_order_acquire);
+    for (std::uint64_t i = read_index; i < write_index; ++i) {
+      const TraceEvent& event = events_[i % CAPACITY];
+      function(event, event.name == DYNAMIC_TRACE_NAME ? std::string_view(dynamic_names_[i % CAPACITY])
+                                                       : std::string_view());
+    }
+    read_index_.store(write_index, std::memory_order_release);
+  }
+
+ private:
+  std::array<TraceEvent, CAPACITY> events_;
+  // Parallel to events_, only allocated once the thread ends its first dynamic zone
+  std::unique_ptr<std::string[]> dynamic_names_;
+  // Kept on separate cache lines, so the producer and the consumer do not invalidate each other's line on every event
+  alignas(64) std::atomic<std::uint64_t> write_index_ = 0;
+  std::uint64_t cached_read_index_ = 0;
+  std::uint32_t depth_ = 0;
+  std::uint32_t thread_index_;
+  alignas(64) std::atomic<std::uint64_t> read_index_ = 0;
+  std::atomic<std::uint64_t> dropped_event_count_ = 0;
+};
+
+// The buffers are never destroyed, so zones that end after their thread was registered stay valid
+TraceBuffer* RegisterThreadTraceBuffer();
+
+inline TraceBuffer* GetThreadTraceBuffer() {
+  thread_local TraceBuffer* buffer = RegisterThreadTraceBuffer();
+  return buffer;
+}
+
+}  // namespace detail
+
+inline bool IsTracing() {
+  return detail::tracing_enabled.load(std::memory_order_relaxed);
+}
+
+// Records the time between its construction and destruction. Zones that are constructed within another zone on the
+// same thread are nested in it.
+class TraceZone {
+  MAKE_NON_COPY_OR_MOVABLE(TraceZone);
+
+ public:
+  explicit TraceZone(TraceNameId name) : name_(name) {
+    if (IsTracing()) {
+      buffer_ = detail::GetThreadTraceBuffer();
+      depth_ = buffer_->BeginZone();
+      begin_ = detail::GetTraceTimestamp();
+    }
+  }
+
+  // Calls name() to get the name of the zone, but only while tracing
+  template <typename NameFunction>
+  TraceZone(DynamicTraceName, NameFunction&& name) : name_(DYNAMIC_TRACE_NAME) {
+    if (IsTracing()) {
+      dynamic_name_ = name();
+      buffer_ = detail::GetThreadTraceBuffer();
+      depth_ = buffer_->BeginZone();
+      begin_ = detail::GetTraceTimestamp();
+    }
+  }
+
+  ~TraceZone() {
+    if (buffer_ != nullptr) {
+      buffer_->EndZone({.begin = begin_, .end = detail::GetTraceTimestamp(), .name = name_, .depth = depth_},
+                       std::move(dynamic_name_));
+    }
+  }
+
+ private:
+  detail::TraceBuffer* buffer_ = nullptr;
+  std::uint64_t begin_;
+  TraceNameId name_;
+  std::uint32_t depth_;
+  std::string dynamic_name_;
+};
+
+enum class TraceFormat {
+  // The Trace Event Format of Chrome, which can be opened in chrome://tracing or https://ui.perfetto.dev
+  CHROME_JSON,
+  // The magic "OVISTRC1" followed by a sequence of records, each starting with a one byte tag:
+  //   1: name: u32 name id, u32 length, characters
+  //   2: zone: u32 thread index, u32 name id, u32 depth, u64 begin, u64 duration
+  //   3: dynamic zone: u32 thread index, u32 name length, characters, u32 depth, u64 begin, u64 duration
+  // Times are in nanoseconds since the start of the trace. Names are written before the first zone that uses them. All
+  // values are in the byte order of the machine that recorded the trace.
+  BINARY,
+};
+
+// Records all zones while it exists and writes them to the output. Only one writer may exist at a time. A background
+// thread collects the zones from the threads regularly, so their buffers do not run full. Without threads, e.g., when
+// building for the web, Flush() has to be called regularly instead.
+class TraceWriter {
+  MAKE_NON_COPY_OR_MOVABLE(TraceWriter);
+
+ public:
+  // The output must outlive the writer
+  TraceWriter(std::ostream* output, TraceFormat format);
+  ~TraceWriter();
+
+  static Result<std::unique_ptr<TraceWriter>> Open(const std::string& filename, TraceFormat format);
+
+  // Writes the zones that ended so far
+  void Flush();
+
+  // The number of zones that were lost because the buffer of their thread was full
+  std::uint64_t dropped_zone_count() const;
+
+ private:
+  std::unique_ptr<std::ostream> file_;
+  std::ostream* output_;
+  TraceFormat format_;
+  std::uint64_t start_time_;
+  std::uint64_t initial_dropped_zone_count_;
+
+  std::mutex mutex_;
+  // The names that were already written, JSON escaped for the Chrome format
+  std::vector<std::string> written_names_;
+  bool is_first_event_ = true;
+
+#if !OVIS_EMSCRIPTEN
+  std::thread thread_;
+  std::condition_variable stop_requested_;
+  bool stopping_ = false;
+#endif
+
+  void WriteEvent(std::uint32_t thread_index, const detail::TraceEvent& event, std::string_view dynamic_name);
+  const std::string& GetWrittenName(TraceNameId name);
+};
+
+}  // namespace ovis
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstddef>
 #include <string>
 #include <string_view>
 
@@ -33,4 +34,14 @@ inline std::string replace_all(std::string_view string, std::string_view source,
   return result;
 }
 
+// Returned for invalid UTF-8 sequences
+constexpr char32_t REPLACEMENT_CHARACTER = 0xfffd;
+
+// Decodes the code point at the start of the UTF-8 encoded string and removes its bytes from the string. Invalid,
+// overlong or truncated sequences decode to REPLACEMENT_CHARACTER and only their first byte is removed, so decoding
+// always makes progress. The string must not be empty.
+char32_t pop_codepoint(std::string_view* string);
+
+std::size_t count_codepoints(std::string_view string);
+
 }  // namespace ovis
@@ -1 +1,52 @@
 #include "ovis/utils/memory.hpp"
+
+#if OVIS_ENABLE_BUILT_IN_PROFILING
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace ovis {
+
+#if OVIS_ENABLE_BUILT_IN_PROFILING
+
+namespace {
+
+thread_local std::uint64_t thread_allocation_count = 0;
+
+}  // namespace
+
+std::uint64_t GetThreadAllocationCount() {
+  return thread_allocation_count;
+}
+
+#else
+
+std::uint64_t GetThreadAllocationCount() {
+  return 0;
+}
+
+#endif
+
+}  // namespace ovis
+
+#if OVIS_ENABLE_BUILT_IN_PROFILING
+
+// The array and nothrow versions call these by default
+void* operator new(std::size_t size) {
+  ++ovis::thread_allocation_count;
+  void* memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+#endif
@@ -0,0 +1,58 @@
+#include <ovis/utils/memory_mapped_file.hpp>
+
+#if !_WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ovis {
+
+MemoryMappedFile::~MemoryMappedFile() {
+#if !_WIN32
+  if (size_ > 0) {
+    munmap(const_cast<std::byte*>(data_), size_);
+  }
+#endif
+}
+
+Result<std::unique_ptr<MemoryMappedFile>> MemoryMappedFile::Open(const std::string& filename) {
+  std::unique_ptr<MemoryMappedFile> file(new MemoryMappedFile());
+
+#if _WIN32
+  Result<Blob> contents = LoadBinaryFile(filename);
+  OVIS_CHECK_RESULT(contents);
+  file->contents_ = std::move(*contents);
+  file->data_ = file->contents_.data();
+  file->size_ = file->contents_.size();
+#else
+  const int descriptor = open(filename.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    return Error("Cannot open file: {}", filename);
+  }
+
+  struct stat file_status;
+  if (fstat(descriptor, &file_status) != 0) {
+    close(descriptor);
+    return Error("Cannot determine the size of file: {}", filename);
+  }
+
+  // Mapping an empty file fails, so it is represented by an empty span
+  if (file_status.st_size > 0) {
+    void* data = mmap(nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (data == MAP_FAILED) {
+      close(descriptor);
+      return Error("Cannot map file: {}", filename);
+    }
+    file->data_ = static_cast<const std::byte*>(data);
+    file->size_ = file_status.st_size;
+  }
+  // The mapping stays valid after the descriptor is closed
+  close(descriptor);
+#endif
+
+  return std::move(file);
+}
+
+}  // namespace ovis
@@ -52,7 +52,6 @@ void ProfilingLog::Write(std::uint64_t frame_id, const std::string& profiler_id,
                          const std::string& unit) {
   profiling_log_ << frame_id << delimiter_ << profiler_id << delimiter_ << measurement_value << delimiter_ << unit
                  << '\n';
-  profiling_log_.flush();
 }
 
 void ProfilingLog::Write(const std::string& profiler_id, double measurement_value, const std::string& unit) {
@@ -123,4 +122,7 @@ void Profiler::AppendMeasurement(double measurement) {
 CPUTimeProfiler::CPUTimeProfiler(const std::string& id)
     : Profiler(ProfilingLog::default_log(), "CPU::" + id, "ms"), measurement_started_(false) {}
 
+CounterProfiler::CounterProfiler(const std::string& id)
+    : Profiler(ProfilingLog::default_log(), id, "count"), frame_id_(profiling_log()->current_frame()) {}
+
 }  // namespace ovis
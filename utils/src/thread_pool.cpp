@@ -0,0 +1,108 @@
+#include "ovis/utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace ovis {
+
+ThreadPool::ThreadPool(std::size_t thread_count) {
+  threads_.reserve(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    threads_.emplace_back(&ThreadPool::Run, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  task_available_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::ParallelFor(std::size_t count, const std::function<void(std::size_t)>& function) {
+  if (count == 0) {
+    return;
+  }
+  if (count == 1 || threads_.empty()) {
+    for (std::size_t i = 0; i < count; ++i) {
+      function(i);
+    }
+    return;
+  }
+
+  // Helpers may only start after all work is done, so the state must outlive this call. They never touch the function
+  // in that case as there is no index left to claim.
+  struct State {
+    std::atomic<std::size_t> next_index = 0;
+    std::atomic<std::size_t> remaining_count;
+    std::mutex mutex;
+    std::condition_variable finished;
+  };
+  auto state = std::make_shared<State>();
+  state->remaining_count = count;
+
+  const auto work = [state, count, &function]() {
+    for (std::size_t i = state->next_index++; i < count; i = state->next_index++) {
+      function(i);
+      if (--state->remaining_count == 0) {
+        std::lock_guard lock(state->mutex);
+        state->finished.notify_all();
+      }
+    }
+  };
+
+  const std::size_t helper_count = std::min(count - 1, threads_.size());
+  for (std::size_t i = 0; i < helper_count; ++i) {
+    Enqueue(work);
+  }
+  work();
+
+  std::unique_lock lock(state->mutex);
+  state->finished.wait(lock, [&state]() { return state->remaining_count == 0; });
+}
+
+void ThreadPool::Enqueue(std::function<void()> task) {
+  if (threads_.empty()) {
+    task();
+    return;
+  }
+
+  {
+    std::lock_guard lock(mutex_);
+    assert(!stopping_);
+    tasks_.push_back(std::move(task));
+  }
+  task_available_.notify_one();
+}
+
+void ThreadPool::Run() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock lock(mutex_);
+      task_available_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+ThreadPool* GetDefaultThreadPool() {
+#if OVIS_EMSCRIPTEN
+  static ThreadPool thread_pool(0);
+#else
+  static ThreadPool thread_pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+#endif
+  return &thread_pool;
+}
+
+}  // namespace ovis
@@ -0,0 +1,231 @@
+#include <cassert>
+#include <fstream>
+#include <unordered_map>
+
+#include <ovis/utils/json.hpp>
+#include <ovis/utils/log.hpp>
+#include <ovis/utils/trace.hpp>
+
+namespace ovis {
+
+namespace detail {
+
+std::atomic<bool> tracing_enabled = false;
+
+}  // namespace detail
+
+namespace {
+
+struct TraceRegistry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<detail::TraceBuffer>> buffers;
+  // The id 0 is reserved for DYNAMIC_TRACE_NAME
+  std::vector<std::string> names = {""};
+  std::unordered_map<std::string, TraceNameId> name_ids;
+};
+
+TraceRegistry* GetTraceRegistry() {
+  // Never destroyed, so threads that end after the static destructors ran can still access it
+  static TraceRegistry* registry = new TraceRegistry();
+  return registry;
+}
+
+// The function is called without holding the registry mutex, so it may look up names
+template <typename Function>
+void ForEachTraceBuffer(Function&& function) {
+  TraceRegistry* registry = GetTraceRegistry();
+  std::vector<detail::TraceBuffer*> buffers;
+  {
+    std::lock_guard lock(registry->mutex);
+    buffers.reserve(registry->buffers.size());
+    for (const auto& buffer : registry->buffers) {
+      buffers.push_back(buffer.get());
+    }
+  }
+  // Buffers are never destroyed, so the pointers stay valid after unlocking
+  for (detail::TraceBuffer* buffer : buffers) {
+    function(buffer);
+  }
+}
+
+std::uint64_t GetDroppedZoneCount() {
+  std::uint64_t dropped_zone_count = 0;
+  ForEachTraceBuffer([&](detail::TraceBuffer* buffer) { dropped_zone_count += buffer->dropped_event_count(); });
+  return dropped_zone_count;
+}
+
+template <typename T>
+void WriteBinary(std::ostream* output, T value) {
+  static_assert(std::is_integral_v<T>);
+  output->write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}  // namespace
+
+TraceNameId RegisterTraceName(std::string_view name) {
+  TraceRegistry* registry = GetTraceRegistry();
+  std::lock_guard lock(registry->mutex);
+  const auto [name_id, inserted] =
+      registry->name_ids.insert(std::make_pair(std::string(name), static_cast<TraceNameId>(registry->names.size())));
+  if (inserted) {
+    registry->names.emplace_back(name);
+  }
+  return name_id->second;
+}
+
+std::string GetTraceName(TraceNameId id) {
+  TraceRegistry* registry = GetTraceRegistry();
+  std::lock_guard lock(registry->mutex);
+  assert(id < registry->names.size());
+  return registry->names[id];
+}
+
+namespace detail {
+
+TraceBuffer* RegisterThreadTraceBuffer() {
+  TraceRegistry* registry = GetTraceRegistry();
+  std::lock_guard lock(registry->mutex);
+  registry->buffers.push_back(std::make_unique<TraceBuffer>(static_cast<std::uint32_t>(registry->buffers.size())));
+  return registry->buffers.back().get();
+}
+
+}  // namespace detail
+
+TraceWriter::TraceWriter(std::ostream* output, TraceFormat format) : output_(output), format_(format) {
+  assert(output != nullptr);
+  [[maybe_unused]] const bool was_tracing = detail::tracing_enabled.exchange(true);
+  assert(!was_tracing);
+
+  // Zones that are still in the buffers belong to a previous trace
+  start_time_ = detail::GetTraceTimestamp();
+  ForEachTraceBuffer([](detail::TraceBuffer* buffer) { buffer->ConsumeEvents([](const detail::TraceEvent&, std::string_view) {}); });
+  initial_dropped_zone_count_ = GetDroppedZoneCount();
+
+  switch (format_) {
+    case TraceFormat::CHROME_JSON:
+      *output_ << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+      break;
+    case TraceFormat::BINARY:
+      output_->write("OVISTRC1", 8);
+      break;
+  }
+
+#if !OVIS_EMSCRIPTEN
+  thread_ = std::thread([this]() {
+    std::unique_lock lock(mutex_);
+    while (!stop_requested_.wait_for(lock, std::chrono::milliseconds(10), [this]() { return stopping_; })) {
+      lock.unlock();
+      Flush();
+      lock.lock();
+    }
+  });
+#endif
+}
+
+TraceWriter::~TraceWriter() {
+#if !OVIS_EMSCRIPTEN
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  stop_requested_.notify_one();
+  thread_.join();
+#endif
+
+  detail::tracing_enabled = false;
+  Flush();
+  if (format_ == TraceFormat::CHROME_JSON) {
+    *output_ << "\n]}\n";
+  }
+  output_->flush();
+
+  if (const std::uint64_t dropped_zone_count = this->dropped_zone_count(); dropped_zone_count > 0) {
+    LogW("{} trace zones were dropped because the trace buffers were full", dropped_zone_count);
+  }
+}
+
+Result<std::unique_ptr<TraceWriter>> TraceWriter::Open(const std::string& filename, TraceFormat format) {
+  auto file = std::make_unique<std::ofstream>(filename, std::ios::binary);
+  if (!file->is_open()) {
+    return Error("Cannot open file: {}", filename);
+  }
+  auto writer = std::make_unique<TraceWriter>(file.get(), format);
+  writer->file_ = std::move(file);
+  return writer;
+}
+
+void TraceWriter::Flush() {
+  std::lock_guard lock(mutex_);
+  ForEachTraceBuffer([this](detail::TraceBuffer* buffer) {
+    buffer->ConsumeEvents([this, buffer](const detail::TraceEvent& event, std::string_view dynamic_name) {
+      // The zone started before the trace
+      if (event.begin >= start_time_) {
+        WriteEvent(buffer->thread_index(), event, dynamic_name);
+      }
+    });
+  });
+}
+
+std::uint64_t TraceWriter::dropped_zone_count() const {
+  return GetDroppedZoneCount() - initial_dropped_zone_count_;
+}
+
+void TraceWriter::WriteEvent(std::uint32_t thread_index, const detail::TraceEvent& event,
+                             std::string_view dynamic_name) {
+  const bool is_dynamic = event.name == DYNAMIC_TRACE_NAME;
+  switch (format_) {
+    case TraceFormat::CHROME_JSON:
+      // Timestamps are in microseconds
+      *output_ << (is_first_event_ ? "\n" : ",\n")
+               << fmt::format(R"({{"name":{},"ph":"X","pid":0,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                              is_dynamic ? json(std::string(dynamic_name)).dump() : GetWrittenName(event.name), thread_index,
+                              (event.begin - start_time_) / 1000.0, (event.end - event.begin) / 1000.0);
+      break;
+
+    case TraceFormat::BINARY:
+      if (is_dynamic) {
+        WriteBinary<std::uint8_t>(output_, 3);
+        WriteBinary(output_, thread_index);
+        WriteBinary(output_, static_cast<std::uint32_t>(dynamic_name.size()));
+        output_->write(dynamic_name.data(), dynamic_name.size());
+      } else {
+        // Writes the name record if this is the first zone with the name
+        GetWrittenName(event.name);
+        WriteBinary<std::uint8_t>(output_, 2);
+        WriteBinary(output_, thread_index);
+        WriteBinary(output_, event.name);
+      }
+      WriteBinary(output_, event.depth);
+      WriteBinary(output_, event.begin - start_time_);
+      WriteBinary(output_, event.end - event.begin);
+      break;
+  }
+  is_first_event_ = false;
+}
+
+const std::string& TraceWriter::GetWrittenName(TraceNameId name) {
+  if (name >= written_names_.size()) {
+    written_names_.resize(name + 1);
+  }
+  std::string& written_name = written_names_[name];
+  if (written_name.empty()) {
+    const std::string trace_name = GetTraceName(name);
+    switch (format_) {
+      case TraceFormat::CHROME_JSON:
+        written_name = json(trace_name).dump();
+        break;
+
+      case TraceFormat::BINARY:
+        WriteBinary<std::uint8_t>(output_, 1);
+        WriteBinary(output_, name);
+        WriteBinary(output_, static_cast<std::uint32_t>(trace_name.size()));
+        output_->write(trace_name.data(), trace_name.size());
+        // Only marks the name as written, the binary format refers to names by their id
+        written_name = "-";
+        break;
+    }
+  }
+  return written_name;
+}
+
+}  // namespace ovis
@@ -1,3 +1,67 @@
+#include <cassert>
+
 #include <ovis/utils/utf8.hpp>
 
-namespace ovis {}  // namespace ovis
+namespace ovis {
+
+char32_t pop_codepoint(std::string_view* string) {
+  assert(string != nullptr);
+  assert(!string->empty());
+
+  const auto byte = [string](std::size_t index) { return static_cast<unsigned char>((*string)[index]); };
+  const unsigned char first_byte = byte(0);
+
+  std::size_t length;
+  char32_t codepoint;
+  char32_t min_codepoint;
+  if (first_byte < 0x80) {
+    string->remove_prefix(1);
+    return first_byte;
+  } else if ((first_byte & 0xe0) == 0xc0) {
+    length = 2;
+    codepoint = first_byte & 0x1f;
+    min_codepoint = 0x80;
+  } else if ((first_byte & 0xf0) == 0xe0) {
+    length = 3;
+    codepoint = first_byte & 0x0f;
+    min_codepoint = 0x800;
+  } else if ((first_byte & 0xf8) == 0xf0) {
+    length = 4;
+    codepoint = first_byte & 0x07;
+    min_codepoint = 0x10000;
+  } else {
+    string->remove_prefix(1);
+    return REPLACEMENT_CHARACTER;
+  }
+
+  if (string->size() < length) {
+    string->remove_prefix(1);
+    return REPLACEMENT_CHARACTER;
+  }
+  for (std::size_t i = 1; i < length; ++i) {
+    if ((byte(i) & 0xc0) != 0x80) {
+      string->remove_prefix(1);
+      return REPLACEMENT_CHARACTER;
+    }
+    codepoint = (codepoint << 6) | (byte(i) & 0x3f);
+  }
+
+  const bool is_surrogate = codepoint >= 0xd800 && codepoint <= 0xdfff;
+  if (codepoint < min_codepoint || codepoint > 0x10ffff || is_surrogate) {
+    string->remove_prefix(1);
+    return REPLACEMENT_CHARACTER;
+  }
+  string->remove_prefix(length);
+  return codepoint;
+}
+
+std::size_t count_codepoints(std::string_view string) {
+  std::size_t count = 0;
+  while (!string.empty()) {
+    pop_codepoint(&string);
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace ovis
@@ -0,0 +1,30 @@
+#include "ovis/utils/memory.hpp"
+
+#include <memory>
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+
+TEST_CASE("Count thread allocations", "[ovis][utils][memory]") {
+  using namespace ovis;
+
+  const std::uint64_t allocation_count = GetThreadAllocationCount();
+  auto value = std::make_unique<int>(42);
+  auto values = std::make_unique<int[]>(16);
+
+#if OVIS_ENABLE_BUILT_IN_PROFILING
+  REQUIRE(GetThreadAllocationCount() == allocation_count + 2);
+
+  // Each thread has its own count
+  std::uint64_t other_thread_allocation_count = 0;
+  std::thread([&other_thread_allocation_count]() {
+    const std::uint64_t initial_count = GetThreadAllocationCount();
+    auto other_value = std::make_unique<int>(0);
+    other_thread_allocation_count = GetThreadAllocationCount() - initial_count;
+  }).join();
+  REQUIRE(other_thread_allocation_count == 1);
+#else
+  REQUIRE(allocation_count == 0);
+  REQUIRE(GetThreadAllocationCount() == 0);
+#endif
+}
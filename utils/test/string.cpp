@@ -7,3 +7,29 @@ TEST_CASE("replace_all", "[ovis][utils][string]") {
 
   REQUIRE(replace_all("test/test", "/", "/abc/") == "test/abc/test");
 }
+
+TEST_CASE("pop_codepoint", "[ovis][utils][string]") {
+  using namespace ovis;
+
+  SECTION("valid sequences") {
+    std::string_view string = "aä€\U0001f600";
+    REQUIRE(count_codepoints(string) == 4);
+    REQUIRE(pop_codepoint(&string) == U'a');
+    REQUIRE(pop_codepoint(&string) == U'ä');
+    REQUIRE(pop_codepoint(&string) == U'€');
+    REQUIRE(pop_codepoint(&string) == U'\U0001f600');
+    REQUIRE(string.empty());
+  }
+
+  SECTION("invalid sequences") {
+    // A lone continuation byte, an overlong encoding of '/', a surrogate and a truncated sequence
+    std::string_view string = "\x80" "\xc0\xaf" "\xed\xa0\x80" "\xe2\x82";
+    std::size_t count = 0;
+    while (!string.empty()) {
+      REQUIRE(pop_codepoint(&string) == REPLACEMENT_CHARACTER);
+      ++count;
+    }
+    // Every byte of the invalid sequences is replaced separately
+    REQUIRE(count == 8);
+  }
+}
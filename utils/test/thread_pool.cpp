@@ -0,0 +1,37 @@
+#include "ovis/utils/thread_pool.hpp"
+
+#include <atomic>
+#include <stdexcept>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/generators/catch_generators.hpp"
+
+TEST_CASE("ThreadPool", "[ovis][utils]") {
+  using namespace ovis;
+
+  const std::size_t thread_count = GENERATE(0, 1, 4);
+  ThreadPool thread_pool(thread_count);
+  REQUIRE(thread_pool.thread_count() == thread_count);
+
+  SECTION("Submit tasks") {
+    std::future<int> result = thread_pool.Submit([]() { return 42; });
+    REQUIRE(result.get() == 42);
+
+    std::future<void> exception = thread_pool.Submit([]() { throw std::runtime_error("error"); });
+    REQUIRE_THROWS_AS(exception.get(), std::runtime_error);
+  }
+
+  SECTION("Parallel for") {
+    std::vector<int> values(1000, 0);
+    thread_pool.ParallelFor(values.size(), [&values](std::size_t i) { values[i] = static_cast<int>(i); });
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      REQUIRE(values[i] == static_cast<int>(i));
+    }
+  }
+
+  SECTION("Nested parallel for") {
+    std::atomic<int> call_count = 0;
+    thread_pool.ParallelFor(8, [&](std::size_t) { thread_pool.ParallelFor(8, [&](std::size_t) { ++call_count; }); });
+    REQUIRE(call_count == 64);
+  }
+}
@@ -0,0 +1,88 @@
+#include "ovis/utils/trace.hpp"
+
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "ovis/utils/json.hpp"
+
+TEST_CASE("Trace", "[ovis][utils][trace]") {
+  using namespace ovis;
+
+  REQUIRE(RegisterTraceName("Trace") == RegisterTraceName("Trace"));
+  REQUIRE(GetTraceName(RegisterTraceName("Trace")) == "Trace");
+
+  // Not recorded as there is no writer
+  { OVIS_TRACE_ZONE("Untraced"); }
+  REQUIRE(!IsTracing());
+
+  SECTION("Chrome trace") {
+    std::ostringstream output;
+    {
+      TraceWriter writer(&output, TraceFormat::CHROME_JSON);
+      REQUIRE(IsTracing());
+      {
+        OVIS_TRACE_ZONE("Outer");
+        { OVIS_TRACE_ZONE("Inner"); }
+        // Flushing while zones are pending must not block on the name registry
+        writer.Flush();
+      }
+      std::thread([]() { OVIS_TRACE_DYNAMIC_ZONE(std::string("Thread")); }).join();
+      writer.Flush();
+    }
+    REQUIRE(!IsTracing());
+
+    const json trace = json::parse(output.str());
+    const auto find_event = [&trace](std::string_view name) {
+      for (const json& event : trace.at("traceEvents")) {
+        if (event.at("name") == name) {
+          return event;
+        }
+      }
+      FAIL("No event named " << name);
+      return json();
+    };
+    REQUIRE(trace.at("traceEvents").size() == 3);
+
+    const json outer = find_event("Outer");
+    const json inner = find_event("Inner");
+    const json thread = find_event("Thread");
+    REQUIRE(inner.at("ts") >= outer.at("ts"));
+    REQUIRE(inner.at("ts").get<double>() + inner.at("dur").get<double>() <=
+            outer.at("ts").get<double>() + outer.at("dur").get<double>() + 0.001);
+    REQUIRE(inner.at("tid") == outer.at("tid"));
+    REQUIRE(thread.at("tid") != outer.at("tid"));
+  }
+
+  SECTION("Binary trace") {
+    std::ostringstream output;
+    {
+      TraceWriter writer(&output, TraceFormat::BINARY);
+      OVIS_TRACE_ZONE("Binary");
+    }
+
+    const std::string trace = output.str();
+    REQUIRE(trace.substr(0, 8) == "OVISTRC1");
+    // A name record followed by a zone record
+    REQUIRE(trace.size() == 8 + (1 + 4 + 4 + std::strlen("Binary")) + (1 + 4 + 4 + 4 + 8 + 8));
+    REQUIRE(trace[8] == 1);
+    REQUIRE(trace.substr(17, 6) == "Binary");
+    REQUIRE(trace[23] == 2);
+  }
+
+  SECTION("Binary trace with a dynamic zone") {
+    std::ostringstream output;
+    {
+      TraceWriter writer(&output, TraceFormat::BINARY);
+      OVIS_TRACE_DYNAMIC_ZONE(std::string("Dynamic"));
+    }
+
+    const std::string trace = output.str();
+    // Dynamic zones carry their name instead of a name record
+    REQUIRE(trace.size() == 8 + (1 + 4 + 4 + std::strlen("Dynamic") + 4 + 8 + 8));
+    REQUIRE(trace[8] == 3);
+    REQUIRE(trace.substr(17, 7) == "Dynamic");
+  }
+}
@@ -58,7 +58,7 @@ class ContiguousStorage {
   }
 
   Result<> ConstructRange(SizeType index, SizeType count) {
-    assert(index + count < capacity());
+    assert(index + count <= capacity());
     return memory_layout_.ConstructN(GetElementAddress(index), count);
   }
 
@@ -68,7 +68,7 @@ class ContiguousStorage {
   }
 
   Result<> CopyToRange(SizeType index, SizeType count, const void* source) {
-    assert(index + count < capacity());
+    assert(index + count <= capacity());
     return memory_layout_.CopyN(GetElementAddress(index), source, count);
   }
 
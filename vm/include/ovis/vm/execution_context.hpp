@@ -5,6 +5,7 @@
 
 #include "ovis/utils/result.hpp"
 #include "ovis/utils/not_null.hpp"
+#include "ovis/utils/trace.hpp"
 #include "ovis/vm/function_handle.hpp"
 #include "ovis/vm/virtual_machine_instructions.hpp"
 
@@ -151,6 +152,7 @@ inline ValueStorage& ExecutionContext::GetStackValue(std::size_t offset) {
 
 template <typename ReturnType = void, typename... ArgumentTypes>
 inline Result<ReturnType> ExecutionContext::Call(FunctionHandle handle, ArgumentTypes&&... arguments) {
+  OVIS_TRACE_ZONE("ExecutionContext::Call");
 #ifndef NDEBUG
   const auto stack_size_before_call = stack_size();
 #endif
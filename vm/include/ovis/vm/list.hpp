@@ -1,7 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include <new>
+#include <utility>
 
+#include "ovis/utils/native_type_id.hpp"
 #include "ovis/utils/not_null.hpp"
 #include "ovis/utils/result.hpp"
 #include "ovis/vm/contiguous_storage.hpp"
@@ -50,6 +53,20 @@ class List {
   }
 
   Result<> Add(const Value& value);
+  // Appends copies of all elements of other. Both lists must have the same element type.
+  Result<> Append(const List& other);
+
+  // Constructs a new element directly at the end of the list. T must be the native type of the element type of the
+  // list. In contrast to Add() the element is not default constructed and copied afterwards.
+  template <typename T, typename... ConstructorArguments>
+  Result<> Emplace(ConstructorArguments&&... arguments) {
+    assert(memory_layout().native_type_id == TypeOf<T>);
+    OVIS_CHECK_RESULT(GrowIfFull());
+    new (storage_[size()]) T(std::forward<ConstructorArguments>(arguments)...);
+    ++size_;
+    return Success;
+  }
+
   Result<> Remove(SizeType index);
 
   template <typename T>
@@ -69,6 +86,7 @@ class List {
   ContiguousStorage storage_;
   SizeType size_ = 0;
 
+  Result<> GrowIfFull();
   Result<> AddInternal(const void* source);
 };
 
@@ -287,13 +287,26 @@ TypeDescription VirtualMachine::CreateTypeDescription(std::string_view name, std
 
 template <typename T>
 TypeId VirtualMachine::GetTypeId() {
-  auto type_id = GetTypeId(TypeOf<T>);
   if constexpr (!std::is_same_v<void,T> && !std::is_same_v<void*,T>) {
+    // Looking up the id by its native type id requires a linear search over all registered types, so remember the
+    // result. The cached id is validated against the registration, thus, it is also correct if multiple virtual
+    // machines are used or if the type has been deregistered in the meantime.
+    static thread_local TypeId cached_type_id = Type::NONE_ID;
+    if (cached_type_id.index < registered_types_.size() && registered_types_[cached_type_id.index].id == cached_type_id &&
+        registered_types_[cached_type_id.index].native_type_id == TypeOf<T> &&
+        registered_types_[cached_type_id.index].type) {
+      return cached_type_id;
+    }
+
+    auto type_id = GetTypeId(TypeOf<T>);
     if (!registered_types_[type_id.index].type) {
       registered_types_[type_id.index].type = std::make_shared<Type>(type_id, CreateTypeDescription<T>("", ""));
     }
+    cached_type_id = type_id;
+    return type_id;
+  } else {
+    return GetTypeId(TypeOf<T>);
   }
-  return type_id;
 }
 
 template <typename T>
@@ -67,6 +67,7 @@ Result<> List::Reserve(SizeType new_capacity) {
   ContiguousStorage new_storage(memory_layout(), new_capacity);
   OVIS_CHECK_RESULT(new_storage.ConstructRange(0, size()));
   OVIS_CHECK_RESULT(new_storage.CopyToRange(0, size(), storage_.data()));
+  storage_.DestructRange(0, size());
   swap(storage_, new_storage);
   return Success;
 }
@@ -91,6 +92,24 @@ Result<> List::Add(const Value& value) {
   return AddInternal(value.GetValuePointer());
 }
 
+Result<> List::Append(const List& other) {
+  if (other.element_type() != element_type()) {
+    return Error("Invalid type.");
+  }
+  if (other.size() == 0) {
+    return Success;
+  }
+
+  OVIS_CHECK_RESULT(Reserve(size() + other.size()));
+  OVIS_CHECK_RESULT(storage_.ConstructRange(size(), other.size()));
+  if (auto result = storage_.CopyToRange(size(), other.size(), other.storage_.data()); !result) {
+    storage_.DestructRange(size(), other.size());
+    return std::move(result);
+  }
+  size_ += other.size();
+  return Success;
+}
+
 Result<> List::Remove(SizeType index) {
   if (index >= size()) {
     return Error("Index out of bounds");
@@ -104,12 +123,16 @@ Result<> List::Remove(SizeType index) {
   return Success;
 }
 
-Result<> List::AddInternal(const void* source) {
+Result<> List::GrowIfFull() {
   if (size() == capacity()) {
     const auto new_capacity = size() + size() / 2 + 1; // +1 to handle 0 and 1 case.
-    Reserve(new_capacity);
+    return Reserve(new_capacity);
   }
+  return Success;
+}
 
+Result<> List::AddInternal(const void* source) {
+  OVIS_CHECK_RESULT(GrowIfFull());
   OVIS_CHECK_RESULT(storage_.Construct(size()));
   if (auto result = storage_.CopyTo(size(), source); !result) {
     storage_.Destruct(size());
@@ -34,6 +34,25 @@ TEST_CASE("Test virtual machine", "[ovis][vm][VirtualMachine]") {
   }
 }
 
+TEST_CASE("Type ids of native types stay valid", "[ovis][vm][VirtualMachine]") {
+  struct NativeType {
+    int value;
+  };
+
+  VirtualMachine vm;
+  const TypeId type_id = vm.GetTypeId<NativeType>();
+  REQUIRE(vm.GetTypeId<NativeType>() == type_id);
+  REQUIRE(vm.GetType<NativeType>()->id() == type_id);
+
+  REQUIRE(vm.DeregisterType(type_id));
+  const TypeId new_type_id = vm.GetTypeId<NativeType>();
+  REQUIRE(new_type_id != type_id);
+  REQUIRE(vm.GetType(new_type_id) != nullptr);
+
+  VirtualMachine other_vm;
+  REQUIRE(other_vm.GetType(other_vm.GetTypeId<NativeType>()) != nullptr);
+}
+
 // TEST_CASE("Allocate instructions", "[ovis][core][vm]") {
 //   const auto offset = vm::AllocateInstructions(100);
 //   const auto instructions = vm::GetConstantRange(offset, 100);